@@ -85,43 +85,23 @@ int _anjay_dm_res_read(anjay_t *anjay,
                        size_t buffer_size,
                        size_t *out_bytes_read);
 
-static inline int _anjay_dm_res_read_string(anjay_t *anjay,
-                                            const anjay_uri_path_t *path,
-                                            char *buffer,
-                                            size_t buffer_size) {
-    assert(buffer && buffer_size > 0);
-    size_t bytes_read;
-    int result = _anjay_dm_res_read(anjay, path, buffer, buffer_size - 1,
-                                    &bytes_read);
-    if (!result) {
-        buffer[bytes_read] = '\0';
-    }
-    return result;
-}
+/**
+ * Typed Resource read helpers. The value is captured directly from the
+ * anjay_ret_* call made by the read handler; an error is returned if the
+ * handler returns a value of a different type.
+ */
+int _anjay_dm_res_read_string(anjay_t *anjay,
+                              const anjay_uri_path_t *path,
+                              char *buffer,
+                              size_t buffer_size);
 
-static inline int _anjay_dm_res_read_i64(anjay_t *anjay,
-                                         const anjay_uri_path_t *path,
-                                         int64_t *out_value) {
-    size_t bytes_read;
-    int result = _anjay_dm_res_read(anjay, path, (char *) out_value,
-                                    sizeof(*out_value), &bytes_read);
-    if (result) {
-        return result;
-    }
-    return bytes_read != sizeof(*out_value);
-}
+int _anjay_dm_res_read_i64(anjay_t *anjay,
+                           const anjay_uri_path_t *path,
+                           int64_t *out_value);
 
-static inline int _anjay_dm_res_read_bool(anjay_t *anjay,
-                                          const anjay_uri_path_t *path,
-                                          bool *out_value) {
-    size_t bytes_read;
-    int result = _anjay_dm_res_read(anjay, path, (char *) out_value,
-                                    sizeof(*out_value), &bytes_read);
-    if (result) {
-        return result;
-    }
-    return bytes_read != sizeof(*out_value);
-}
+int _anjay_dm_res_read_bool(anjay_t *anjay,
+                            const anjay_uri_path_t *path,
+                            bool *out_value);
 
 typedef struct anjay_dm anjay_dm_t;
 
@@ -199,6 +179,25 @@ int _anjay_dm_instance_it(anjay_t *anjay,
                           anjay_iid_t *out,
                           void **cookie,
                           const anjay_dm_module_t *current_module);
+/**
+ * Checks whether the instance_list handler may be used in place of
+ * instance_it for a given Object, with respect to the overlay system (i.e. it
+ * is implemented and not shadowed by an overlay implementing only
+ * instance_it).
+ */
+bool _anjay_dm_instance_list_usable(anjay_t *anjay,
+                                    const anjay_dm_object_def_t *const *obj_ptr,
+                                    const anjay_dm_module_t *current_module);
+/**
+ * Retrieves the sorted array of Object Instance IDs using the instance_list
+ * handler. Shall only be called if @ref _anjay_dm_instance_list_usable
+ * returned true for the same arguments.
+ */
+int _anjay_dm_instance_list(anjay_t *anjay,
+                            const anjay_dm_object_def_t *const *obj_ptr,
+                            const anjay_iid_t **out_iids,
+                            size_t *out_count,
+                            const anjay_dm_module_t *current_module);
 int _anjay_dm_instance_reset(anjay_t *anjay,
                              const anjay_dm_object_def_t *const *obj_ptr,
                              anjay_iid_t iid,
@@ -255,6 +254,26 @@ int _anjay_dm_resource_read(anjay_t *anjay,
                             anjay_rid_t rid,
                             anjay_output_ctx_t *ctx,
                             const anjay_dm_module_t *current_module);
+/**
+ * Checks whether the instance_read_all handler may be used in place of reading
+ * each Resource separately, with respect to the overlay system (i.e. it is
+ * implemented and no overlay implements any of resource_present,
+ * resource_operations or resource_read).
+ */
+bool _anjay_dm_instance_read_all_usable(
+        anjay_t *anjay,
+        const anjay_dm_object_def_t *const *obj_ptr,
+        const anjay_dm_module_t *current_module);
+/**
+ * Reads all Resources of an Object Instance using the instance_read_all
+ * handler. Shall only be called if @ref _anjay_dm_instance_read_all_usable
+ * returned true for the same arguments.
+ */
+int _anjay_dm_instance_read_all(anjay_t *anjay,
+                                const anjay_dm_object_def_t *const *obj_ptr,
+                                anjay_iid_t iid,
+                                anjay_output_ctx_t *ctx,
+                                const anjay_dm_module_t *current_module);
 int _anjay_dm_resource_write(anjay_t *anjay,
                              const anjay_dm_object_def_t *const *obj_ptr,
                              anjay_iid_t iid,
@@ -106,6 +106,9 @@ typedef struct anjay_configuration {
      *
      * NOTE: while a single cache is used for all LwM2M servers, cached
      * responses are tied to a particular server and not reused for other ones.
+     *
+     * The cache is a ring buffer - when it is full, oldest responses are
+     * evicted first. See @ref anjay_get_msg_cache_stats .
      */
     size_t msg_cache_size;
 
@@ -169,6 +172,28 @@ typedef struct anjay_configuration {
      * to false, Concatenated SMS may be used in cases when it is impossible to
      * split the message in another way, e.g. during DTLS handshake. */
     bool prefer_multipart_sms;
+
+    /** If set to true, Read operations on whole Objects that yield TLV
+     * payloads are performed in two passes: the size of each encoded Object
+     * Instance is calculated first, and then its contents are written directly
+     * into the response. This limits memory usage to what is necessary for a
+     * single CoAP block, regardless of the Object Instance size.
+     *
+     * NOTE: In this mode, read handlers are called twice for each Resource.
+     * They MUST return exactly the same data both times, otherwise the request
+     * fails. */
+    bool two_pass_tlv_object_reads;
+
+    /** Maximum number of messages handled by a single @ref anjay_serve call.
+     *
+     * After handling the message that made the socket readable, Anjay keeps
+     * reading further messages that are already queued on the same socket,
+     * without waiting for more, until none are left or this limit is reached.
+     * This saves a poll() round trip per message when a server sends a burst of
+     * requests, while the limit bounds the time other sockets have to wait.
+     *
+     * If set to 0 or 1, exactly one message is read per call. */
+    size_t max_messages_per_serve;
 } anjay_configuration_t;
 
 /**
@@ -234,11 +259,17 @@ AVS_LIST(avs_net_abstract_socket_t *const) anjay_get_sockets(anjay_t *anjay);
 /**
  * Reads a message from given @p ready_socket and handles it appropriately.
  *
+ * If @ref anjay_configuration_t::max_messages_per_serve is greater than 1,
+ * messages already queued on a server socket are handled as well, up to that
+ * limit. Reading them stops early on a network error, or when handling a
+ * message closes or reconnects the socket.
+ *
  * @param anjay        Anjay object to operate on.
  * @param ready_socket A socket to read the message from.
  *
  * @returns 0 on success, a negative value in case of error. Note that it
  *          includes non-fatal errors, such as receiving a malformed packet.
+ *          Only the result of handling the first message is reported.
  */
 int anjay_serve(anjay_t *anjay,
                 avs_net_abstract_socket_t *ready_socket);
@@ -169,6 +169,41 @@ int anjay_dm_instance_it_SINGLE(anjay_t *anjay,
                                 anjay_iid_t *out,
                                 void **cookie);
 
+/**
+ * An optional handler that returns IDs of all Object Instances at once, as an
+ * array sorted in strictly ascending order.
+ *
+ * If implemented, it is used instead of @ref anjay_dm_instance_it_t and
+ * @ref anjay_dm_instance_present_t defined alongside it (the latter is then
+ * answered by a binary search over the array), so both of these may be left
+ * NULL. It is intended for Objects with large numbers of Instances that
+ * already keep their Instance IDs in a sorted array.
+ *
+ * @param       anjay     Anjay object to operate on.
+ * @param       obj_ptr   Object definition pointer, as passed to
+ *                        @ref anjay_register_object .
+ * @param[out]  out_iids  Pointer to the array of Instance IDs. The array is
+ *                        NOT copied by the library, and MUST remain valid and
+ *                        unchanged until the set of Instances is modified
+ *                        (e.g. by @ref anjay_dm_instance_create_t or
+ *                        @ref anjay_dm_instance_remove_t) or control returns
+ *                        from the library to top-level user code, whichever
+ *                        comes first. May be set to NULL if
+ *                        <c>*out_count == 0</c>.
+ * @param[out]  out_count Number of elements in the @p out_iids array.
+ *
+ * @returns This handler should return:
+ * - 0 on success,
+ * - a negative value in case of error. If it returns one of ANJAY_ERR_
+ *   constants, the response message will have an appropriate CoAP response
+ *   code. Otherwise, the device will respond with an unspecified (but valid)
+ *   error code.
+ */
+typedef int anjay_dm_instance_list_t(anjay_t *anjay,
+                                     const anjay_dm_object_def_t *const *obj_ptr,
+                                     const anjay_iid_t **out_iids,
+                                     size_t *out_count);
+
 /**
  * A handler that checks if an Object Instance with given Instance ID exists.
  *
@@ -421,6 +456,40 @@ typedef int anjay_dm_resource_read_t(anjay_t *anjay,
                                      anjay_rid_t rid,
                                      anjay_output_ctx_t *ctx);
 
+/**
+ * An optional handler that reads all readable Resources of an Object Instance
+ * in a single call. If implemented, the library uses it instead of calling
+ * @ref anjay_dm_resource_present_t , @ref anjay_dm_resource_operations_t and
+ * @ref anjay_dm_resource_read_t for each supported Resource whenever a whole
+ * Object Instance is read (Read and Observe on Object and Object Instance
+ * paths). Reads of a single Resource still use
+ * @ref anjay_dm_resource_read_t .
+ *
+ * The handler MUST call @ref anjay_ret_resource_id before returning the value
+ * of each Resource. Resources shall be returned in ascending order of their
+ * IDs, and only those that are PRESENT, listed in
+ * <c>supported_rids</c> and readable (see @ref anjay_dm_resource_operations_t)
+ * shall be returned - the library does not verify that.
+ *
+ * @param anjay   Anjay object to operate on.
+ * @param obj_ptr Object definition pointer, as passed to
+ *                @ref anjay_register_object .
+ * @param iid     Object Instance ID, guaranteed to be PRESENT.
+ * @param ctx     Output context to write the Resource IDs and values to using
+ *                the anjay_ret_* function family.
+ *
+ * @returns This handler should return:
+ * - 0 on success,
+ * - a negative value in case of error. If it returns one of ANJAY_ERR_
+ *   constants, it will be used as a hint for the CoAP response code to use,
+ *   just like in case of @ref anjay_dm_resource_read_t .
+ */
+typedef int
+anjay_dm_instance_read_all_t(anjay_t *anjay,
+                             const anjay_dm_object_def_t *const *obj_ptr,
+                             anjay_iid_t iid,
+                             anjay_output_ctx_t *ctx);
+
 /**
  * A handler that writes the Resource value.
  *
@@ -702,6 +771,12 @@ typedef struct {
     anjay_dm_transaction_commit_t *transaction_commit;
     /** Rollback changes made in a transaction, @ref anjay_dm_transaction_rollback_t */
     anjay_dm_transaction_rollback_t *transaction_rollback;
+
+    /** Get values of all readable Resources in an Object Instance,
+     * @ref anjay_dm_instance_read_all_t */
+    anjay_dm_instance_read_all_t *instance_read_all;
+    /** Get a sorted array of all Object Instance IDs, @ref anjay_dm_instance_list_t */
+    anjay_dm_instance_list_t *instance_list;
 } anjay_dm_handlers_t;
 
 /** A simple array-plus-size container for a list of supported Resource IDs. */
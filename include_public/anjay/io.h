@@ -100,6 +100,75 @@ int anjay_ret_bytes_append(anjay_ret_bytes_ctx_t *ctx,
  */
 int anjay_ret_bytes(anjay_output_ctx_t *ctx, const void *data, size_t length);
 
+/**
+ * Callback used by @ref anjay_ret_bytes_from_reader to pull a chunk of a data
+ * blob from the application.
+ *
+ * The callback MUST fill the whole @p buffer, i.e. write exactly
+ * @p buffer_size bytes of the blob, starting at the @p offset position.
+ *
+ * @param arg         Opaque argument passed to
+ *                    @ref anjay_ret_bytes_from_reader.
+ * @param offset      Offset within the blob of the first byte to read.
+ * @param buffer      Buffer to fill.
+ * @param buffer_size Number of bytes to write into @p buffer.
+ *
+ * @returns 0 on success, a negative value in case of error.
+ */
+typedef int anjay_ret_bytes_reader_t(void *arg,
+                                     size_t offset,
+                                     void *buffer,
+                                     size_t buffer_size);
+
+/**
+ * Returns a blob of data from the data model handler, pulling its contents
+ * from the application in chunks.
+ *
+ * This is an alternative to @ref anjay_ret_bytes_begin that does not require
+ * the handler to keep its own copy buffer: Anjay calls @p reader for
+ * consecutive small chunks of the blob, and passes each of them to the output
+ * context as soon as it is read.
+ *
+ * Note that this is not a zero-copy API. Each chunk is read into a small
+ * temporary buffer, and then copied into the response message the same way as
+ * with @ref anjay_ret_bytes_append . What it saves is the need to hold the blob
+ * in the handler, not the copying itself.
+ *
+ * Whether the whole blob ends up in memory anyway depends on the output
+ * context. When reading a single Resource, it is streamed into the response
+ * block by block. However, nested TLV entries are buffered in full until their
+ * length is known, so a TLV Read on a whole Object Instance or Object may hold
+ * the encoded blob in memory. For Object reads, this can be avoided by
+ * enabling @ref anjay_configuration_t::two_pass_tlv_object_reads .
+ *
+ * Example: file content in a RPC response.
+ *
+ * @code
+ * static int read_file(void *file, size_t offset, void *buf, size_t size) {
+ *     if (fseek((FILE *) file, (long) offset, SEEK_SET)
+ *             || fread(buf, 1, size, (FILE *) file) != size) {
+ *         return -1;
+ *     }
+ *     return 0;
+ * }
+ *
+ * // ...
+ * return anjay_ret_bytes_from_reader(ctx, filesize, read_file, file);
+ * @endcode
+ *
+ * @param ctx    Output context to write data into.
+ * @param length Size of the whole blob.
+ * @param reader Callback used to read consecutive chunks of the blob.
+ * @param arg    Opaque argument passed to @p reader.
+ *
+ * @returns 0 on success, a negative value in case of error. If @p reader fails,
+ *          its return value is propagated.
+ */
+int anjay_ret_bytes_from_reader(anjay_output_ctx_t *ctx,
+                                size_t length,
+                                anjay_ret_bytes_reader_t *reader,
+                                void *arg);
+
 /**
  * Returns a null-terminated string from the data model handler.
  *
@@ -236,6 +305,28 @@ int anjay_ret_array_index(anjay_output_ctx_t *array_ctx, anjay_riid_t index);
  */
 int anjay_ret_array_finish(anjay_output_ctx_t *array_ctx);
 
+/**
+ * Assigns a Resource ID to the next value returned using one of the
+ * anjay_ret_* functions. Intended to be used only from within the
+ * @ref anjay_dm_instance_read_all_t handler.
+ *
+ * Example usage:
+ * @code
+ * if (anjay_ret_resource_id(ctx, 0)
+ *         || anjay_ret_i32(ctx, 42)
+ *         || anjay_ret_resource_id(ctx, 1)
+ *         || anjay_ret_string(ctx, "foo")) {
+ *     return ANJAY_ERR_INTERNAL;
+ * }
+ * @endcode
+ *
+ * @param ctx Output context to operate on.
+ * @param rid Resource ID to assign.
+ *
+ * @returns 0 on success, a negative value in case of error.
+ */
+int anjay_ret_resource_id(anjay_output_ctx_t *ctx, anjay_rid_t rid);
+
 /** Type used to retrieve RPC content. */
 typedef struct anjay_input_ctx_struct anjay_input_ctx_t;
 
@@ -16,6 +16,8 @@
 #ifndef ANJAY_INCLUDE_ANJAY_STATS_H
 #define ANJAY_INCLUDE_ANJAY_STATS_H
 
+#include <anjay/core.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -51,6 +53,152 @@ uint64_t anjay_get_num_incoming_retransmissions(anjay_t *anjay);
  */
 uint64_t anjay_get_num_outgoing_retransmissions(anjay_t *anjay);
 
+/** Statistics of the cache of CoAP responses. */
+typedef struct {
+    /** Number of retransmitted requests answered with a cached response */
+    uint64_t hits;
+    /** Number of incoming requests with no cached response */
+    uint64_t misses;
+    /**
+     * Number of responses dropped before their EXCHANGE_LIFETIME passed, to
+     * make space for newer ones. A steadily growing value suggests that
+     * @ref anjay_configuration_t::msg_cache_size is too small.
+     */
+    uint64_t evictions;
+    /** Number of bytes currently occupied by cached responses */
+    size_t bytes_used;
+    /** Total number of bytes available for cached responses */
+    size_t capacity;
+} anjay_msg_cache_stats_t;
+
+/**
+ * Retrieves statistics of the cache of CoAP responses.
+ *
+ * @param anjay     Anjay object to operate on.
+ * @param out_stats Structure filled with the statistics on success.
+ *
+ * @returns 0 on success, a negative value if the cache is disabled, i.e.
+ *          @ref anjay_configuration_t::msg_cache_size was set to 0.
+ */
+int anjay_get_msg_cache_stats(anjay_t *anjay,
+                              anjay_msg_cache_stats_t *out_stats);
+
+/** Kinds of data model handlers, as defined in @ref anjay_dm_handlers_t. */
+typedef enum {
+    ANJAY_DM_HANDLER_OBJECT_READ_DEFAULT_ATTRS,
+    ANJAY_DM_HANDLER_OBJECT_WRITE_DEFAULT_ATTRS,
+    ANJAY_DM_HANDLER_INSTANCE_IT,
+    ANJAY_DM_HANDLER_INSTANCE_PRESENT,
+    ANJAY_DM_HANDLER_INSTANCE_LIST,
+    ANJAY_DM_HANDLER_INSTANCE_RESET,
+    ANJAY_DM_HANDLER_INSTANCE_CREATE,
+    ANJAY_DM_HANDLER_INSTANCE_REMOVE,
+    ANJAY_DM_HANDLER_INSTANCE_READ_DEFAULT_ATTRS,
+    ANJAY_DM_HANDLER_INSTANCE_WRITE_DEFAULT_ATTRS,
+    ANJAY_DM_HANDLER_RESOURCE_PRESENT,
+    ANJAY_DM_HANDLER_RESOURCE_OPERATIONS,
+    ANJAY_DM_HANDLER_RESOURCE_READ,
+    ANJAY_DM_HANDLER_INSTANCE_READ_ALL,
+    ANJAY_DM_HANDLER_RESOURCE_WRITE,
+    ANJAY_DM_HANDLER_RESOURCE_EXECUTE,
+    ANJAY_DM_HANDLER_RESOURCE_DIM,
+    ANJAY_DM_HANDLER_RESOURCE_READ_ATTRS,
+    ANJAY_DM_HANDLER_RESOURCE_WRITE_ATTRS,
+    ANJAY_DM_HANDLER_TRANSACTION_BEGIN,
+    ANJAY_DM_HANDLER_TRANSACTION_VALIDATE,
+    ANJAY_DM_HANDLER_TRANSACTION_COMMIT,
+    ANJAY_DM_HANDLER_TRANSACTION_ROLLBACK
+} anjay_dm_handler_kind_t;
+
+/** Accumulated statistics of calls to a single data model handler. */
+typedef struct {
+    /** Number of times the handler was called */
+    uint64_t call_count;
+    /** Total wall time spent inside the handler */
+    avs_time_duration_t total_time;
+    /** Longest wall time spent inside a single call to the handler */
+    avs_time_duration_t max_time;
+} anjay_dm_handler_stats_t;
+
+/**
+ * Retrieves statistics of calls made by the library to a specific handler of
+ * an Object.
+ *
+ * Only calls made by the library itself are accounted for - calls that data
+ * model modules make to underlying handlers are included in the time measured
+ * for the outermost handler.
+ *
+ * NOTE: When WITH_DM_STATS is disabled this function always fails.
+ *
+ * @param anjay     Anjay object to operate on.
+ * @param oid       ID of the Object to query.
+ * @param kind      Kind of handler to query.
+ * @param out_stats Structure filled with the statistics on success. If the
+ *                  handler has never been called, it is zero-filled.
+ *
+ * @returns 0 on success, a negative value in case of error.
+ */
+int anjay_get_dm_handler_stats(anjay_t *anjay,
+                               anjay_oid_t oid,
+                               anjay_dm_handler_kind_t kind,
+                               anjay_dm_handler_stats_t *out_stats);
+
+/**
+ * Clears all statistics of data model handler calls.
+ *
+ * NOTE: When WITH_DM_STATS is disabled this function does nothing.
+ *
+ * @param anjay Anjay object to operate on.
+ */
+void anjay_reset_dm_handler_stats(anjay_t *anjay);
+
+/**
+ * Round-trip time estimates kept for the connection with a single server.
+ *
+ * Exchanges that finished without retransmissions feed the "strong" estimator;
+ * those that needed one or two retransmissions feed the "weak" one, with
+ * the RTT measured since the first transmission. Both are combined into
+ * the ACK_TIMEOUT used for subsequent Confirmable messages.
+ */
+typedef struct {
+    /** Smoothed RTT of exchanges without retransmissions */
+    avs_time_duration_t strong_rtt;
+    /** RTT variation of exchanges without retransmissions */
+    avs_time_duration_t strong_rttvar;
+    /** Number of exchanges without retransmissions measured so far */
+    uint64_t strong_samples;
+    /** Smoothed RTT of exchanges that needed retransmissions */
+    avs_time_duration_t weak_rtt;
+    /** RTT variation of exchanges that needed retransmissions */
+    avs_time_duration_t weak_rttvar;
+    /** Number of exchanges with retransmissions measured so far */
+    uint64_t weak_samples;
+    /**
+     * ACK_TIMEOUT currently used for the server. Equal to the one configured
+     * in @ref anjay_configuration_t::udp_tx_params until the first sample is
+     * taken.
+     */
+    avs_time_duration_t ack_timeout;
+} anjay_server_rtt_stats_t;
+
+/**
+ * Retrieves the round-trip time estimates for the connection with a server.
+ * Estimates are discarded whenever the connection is re-created.
+ *
+ * NOTE: When WITH_RTT_ESTIMATION is disabled this function always fails.
+ *
+ * @param anjay     Anjay object to operate on.
+ * @param ssid      Short Server ID of the server to query, or
+ *                  @ref ANJAY_SSID_BOOTSTRAP for the Bootstrap Server.
+ * @param out_stats Structure filled with the statistics on success.
+ *
+ * @returns 0 on success, a negative value if RTT estimation support is
+ *          disabled or there is no active server with given @p ssid .
+ */
+int anjay_get_server_rtt_stats(anjay_t *anjay,
+                               anjay_ssid_t ssid,
+                               anjay_server_rtt_stats_t *out_stats);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -74,36 +74,56 @@ static int read_resources(anjay_t *anjay,
     return 0;
 }
 
-static int get_mask_from_ctx(anjay_input_ctx_t *ctx,
-                             anjay_ssid_t *inout_ssid,
-                             anjay_access_mask_t *out_mask) {
-    anjay_input_ctx_t *array_ctx = anjay_get_array(ctx);
-    if (!array_ctx) {
+typedef struct {
+    anjay_ssid_t ssid_lookup;
+    anjay_ssid_t found_ssid;
+    anjay_access_mask_t mask;
+    size_t num_entries;
+    bool found_specific;
+} acl_lookup_t;
+
+static int acl_entry_handler(void *lookup_, const anjay_output_value_t *value) {
+    acl_lookup_t *lookup = (acl_lookup_t *) lookup_;
+    if (!value->is_array_element || value->type != ANJAY_OUTPUT_VALUE_INT
+            || value->value.i != (int32_t) value->value.i) {
         return -1;
     }
+    ++lookup->num_entries;
+    if (!lookup->found_specific
+            && (value->riid == lookup->ssid_lookup || value->riid == 0)) {
+        // Found an entry for the given ssid or the default ACL entry
+        lookup->found_ssid = value->riid;
+        lookup->mask = (anjay_access_mask_t) value->value.i;
+        // non-zero SSID means not the default
+        lookup->found_specific = !!value->riid;
+    }
+    return 0;
+}
 
-    anjay_ssid_t ssid_lookup = *inout_ssid;
-    int32_t num_iterations = 0;
-    int result = 0;
-    uint16_t current_ssid;
-    int32_t current_mask;
-    *out_mask = ANJAY_ACCESS_MASK_NONE;
-    while (!(result = anjay_get_array_index(array_ctx, &current_ssid))
-            && !(result = anjay_get_i32(array_ctx, &current_mask))) {
-        if (current_ssid == ssid_lookup || current_ssid == 0) {
-            // Found an entry for the given ssid or the default ACL entry
-            *inout_ssid = current_ssid;
-            *out_mask = (anjay_access_mask_t) current_mask;
-            if (current_ssid) {
-                // not the default
-                return 0;
-            }
-        }
-        ++num_iterations;
+static int get_mask_from_acl(anjay_t *anjay,
+                             anjay_iid_t ac_iid,
+                             anjay_ssid_t *inout_ssid,
+                             anjay_access_mask_t *out_mask) {
+    const anjay_uri_path_t path =
+            MAKE_RESOURCE_PATH(ANJAY_DM_OID_ACCESS_CONTROL, ac_iid,
+                               ANJAY_DM_RID_ACCESS_CONTROL_ACL);
+    acl_lookup_t lookup = {
+        .ssid_lookup = *inout_ssid,
+        .mask = ANJAY_ACCESS_MASK_NONE
+    };
+    int result = _anjay_dm_res_read_values(anjay, &path, acl_entry_handler,
+                                           &lookup, NULL, 0);
+    if (result) {
+        return result;
     }
-    // use the invalid SSID as a result if the ACL is empty
-    *inout_ssid = (num_iterations ? 0 : UINT16_MAX);
-    return result == ANJAY_GET_INDEX_END ? 0 : result;
+    if (lookup.found_specific) {
+        *inout_ssid = lookup.found_ssid;
+    } else {
+        // use the invalid SSID as a result if the ACL is empty
+        *inout_ssid = (lookup.num_entries ? 0 : UINT16_MAX);
+    }
+    *out_mask = lookup.mask;
+    return 0;
 }
 
 static int get_mask(anjay_t *anjay,
@@ -124,21 +144,9 @@ static int get_mask(anjay_t *anjay,
         return ANJAY_DM_FOREACH_CONTINUE;
     }
 
-    const anjay_uri_path_t path =
-            MAKE_RESOURCE_PATH(ANJAY_DM_OID_ACCESS_CONTROL,
-                               (anjay_iid_t) ac_iid,
-                               ANJAY_DM_RID_ACCESS_CONTROL_ACL);
-
-    anjay_input_ctx_t *ctx = _anjay_dm_read_as_input_ctx(anjay, &path);
-    if (!ctx) {
-        return -1;
-    }
-
     anjay_ssid_t found_ssid = data->ssid;
     anjay_access_mask_t mask;
-    int result = get_mask_from_ctx(ctx, &found_ssid, &mask);
-    _anjay_input_ctx_destroy(&ctx);
-
+    int result = get_mask_from_acl(anjay, ac_iid, &found_ssid, &mask);
     if (result) {
         anjay_log(ERROR, "failed to read ACL!");
         return result;
@@ -43,6 +43,7 @@
 #include "coap/id_source/auto.h"
 #include "interface/bootstrap_core.h"
 #include "interface/register.h"
+#include "io/numbers.h"
 
 VISIBILITY_SOURCE_BEGIN
 
@@ -59,6 +60,8 @@ static int init(anjay_t *anjay,
         return -1;
     }
 
+    anjay->two_pass_tlv_object_reads = config->two_pass_tlv_object_reads;
+    anjay->max_messages_per_serve = AVS_MAX(config->max_messages_per_serve, 1);
     anjay->udp_socket_config = config->udp_socket_config;
     anjay->udp_listen_port = config->udp_listen_port;
 
@@ -78,7 +81,17 @@ static int init(anjay_t *anjay,
 
     anjay->servers = _anjay_servers_create();
 
-    if (avs_coap_ctx_create(&anjay->coap_ctx, config->msg_cache_size)) {
+    // retransmitted requests are detected using anjay->msg_cache instead of
+    // the cache built into the CoAP context
+    if (avs_coap_ctx_create(&anjay->coap_ctx, 0)) {
+        return -1;
+    }
+
+    if (config->msg_cache_size
+            && !(anjay->msg_cache =
+                    _anjay_coap_msg_cache_create(config->msg_cache_size))) {
+        anjay_log(ERROR, "could not create message cache");
+        avs_coap_ctx_cleanup(&anjay->coap_ctx);
         return -1;
     }
 
@@ -94,9 +107,11 @@ static int init(anjay_t *anjay,
     if (_anjay_coap_stream_create(&anjay->comm_stream, anjay->coap_ctx,
                                   anjay->in_buffer, anjay->in_buffer_size,
                                   anjay->out_buffer, anjay->out_buffer_size)) {
+        _anjay_coap_msg_cache_release(&anjay->msg_cache);
         avs_coap_ctx_cleanup(&anjay->coap_ctx);
         return -1;
     }
+    _anjay_coap_stream_set_msg_cache(anjay->comm_stream, anjay->msg_cache);
 
     anjay->sched = _anjay_sched_new(anjay);
     if (!anjay->sched) {
@@ -150,6 +165,17 @@ anjay_t *anjay_new(const anjay_configuration_t *config) {
 }
 
 void _anjay_release_server_stream_without_scheduling_queue(anjay_t *anjay) {
+#ifdef WITH_RTT_ESTIMATION
+    avs_time_duration_t rtt;
+    unsigned retransmissions;
+    if (anjay->current_connection.server
+            && !_anjay_coap_stream_take_rtt_sample(anjay->comm_stream, &rtt,
+                                                   &retransmissions)) {
+        _anjay_connection_rtt_sample(
+                anjay, _anjay_get_server_connection(anjay->current_connection),
+                rtt, retransmissions);
+    }
+#endif // WITH_RTT_ESTIMATION
     memset(&anjay->current_connection, 0, sizeof(anjay->current_connection));
     if (avs_stream_net_setsock(anjay->comm_stream, NULL)) {
         anjay_log(ERROR, "could not set stream socket to NULL");
@@ -171,6 +197,7 @@ void anjay_delete(anjay_t *anjay) {
 
     assert(avs_stream_net_getsock(anjay->comm_stream) == NULL);
     avs_stream_cleanup(&anjay->comm_stream);
+    _anjay_coap_msg_cache_release(&anjay->msg_cache);
 
     _anjay_dm_cleanup(anjay);
     _anjay_observe_cleanup(anjay);
@@ -181,34 +208,60 @@ void anjay_delete(anjay_t *anjay) {
     free(anjay);
 }
 
-static void split_query_string(char *query,
-                               const char **out_key,
-                               const char **out_value) {
-    char *eq = strchr(query, '=');
+/**
+ * Non-NULL-terminated string pointing into a CoAP option value. Absent values
+ * have NULL data.
+ */
+typedef struct {
+    const char *data;
+    size_t size;
+} opt_string_t;
+
+static opt_string_t opt_string(const avs_coap_opt_t *opt) {
+    return (opt_string_t) {
+        .data = (const char *) avs_coap_opt_value(opt),
+        .size = avs_coap_opt_content_length(opt)
+    };
+}
+
+static bool opt_string_equal(opt_string_t str, const char *expected) {
+    return str.data
+            && str.size == strlen(expected)
+            && !memcmp(str.data, expected, str.size);
+}
+
+static void split_query_string(opt_string_t query,
+                               opt_string_t *out_key,
+                               opt_string_t *out_value) {
+    const char *eq = (const char *) memchr(query.data, '=', query.size);
 
     *out_key = query;
 
     if (eq) {
-        *eq = '\0';
-        *out_value = eq + 1;
+        out_key->size = (size_t) (eq - query.data);
+        out_value->data = eq + 1;
+        out_value->size = query.size - out_key->size - 1;
     } else {
-        *out_value = NULL;
+        out_value->data = NULL;
+        out_value->size = 0;
     }
 }
 
-static int parse_nullable_time(const char *key_str,
-                               const char *period_str,
+static int parse_nullable_time(opt_string_t key,
+                               opt_string_t period,
                                bool *out_present,
                                time_t *out_value) {
-    long long num;
+    int64_t num;
     if (*out_present) {
-        anjay_log(WARNING, "Duplicated attribute in query string: %s", key_str);
+        anjay_log(WARNING, "Duplicated attribute in query string: %.*s",
+                  (int) key.size, key.data);
         return -1;
-    } else if (!period_str) {
+    } else if (!period.data) {
         *out_present = true;
         *out_value = ANJAY_ATTRIB_PERIOD_NONE;
         return 0;
-    } else if (_anjay_safe_strtoll(period_str, &num) || num < 0) {
+    } else if (_anjay_string_to_i64(period.data, period.size, &num)
+                   || num < 0) {
         return -1;
     } else {
         *out_present = true;
@@ -217,18 +270,20 @@ static int parse_nullable_time(const char *key_str,
     }
 }
 
-static int parse_nullable_double(const char *key_str,
-                                 const char *double_str,
+static int parse_nullable_double(opt_string_t key,
+                                 opt_string_t value,
                                  bool *out_present,
                                  double *out_value) {
     if (*out_present) {
-        anjay_log(WARNING, "Duplicated attribute in query string: %s", key_str);
+        anjay_log(WARNING, "Duplicated attribute in query string: %.*s",
+                  (int) key.size, key.data);
         return -1;
-    } else if (!double_str) {
+    } else if (!value.data) {
         *out_present = true;
         *out_value = ANJAY_ATTRIB_VALUE_NONE;
         return 0;
-    } else if (_anjay_safe_strtod(double_str, out_value) || isnan(*out_value)) {
+    } else if (_anjay_string_to_double(value.data, value.size, out_value)
+                   || isnan(*out_value)) {
         return -1;
     } else {
         *out_present = true;
@@ -237,58 +292,60 @@ static int parse_nullable_double(const char *key_str,
 }
 
 #ifdef WITH_CON_ATTR
-static int parse_con(const char *value,
+static int parse_con(opt_string_t value,
                      bool *out_present,
                      anjay_dm_con_attr_t *out_value) {
     if (*out_present) {
         anjay_log(WARNING, "Duplicated attribute in query string: con");
         return -1;
-    } else if (!value) {
+    } else if (!value.data) {
         *out_present = true;
         *out_value = ANJAY_DM_CON_ATTR_DEFAULT;
         return 0;
-    } else if (strcmp(value, "0") == 0) {
+    } else if (opt_string_equal(value, "0")) {
         *out_present = true;
         *out_value = ANJAY_DM_CON_ATTR_NON;
         return 0;
-    } else if (strcmp(value, "1") == 0) {
+    } else if (opt_string_equal(value, "1")) {
         *out_present = true;
         *out_value = ANJAY_DM_CON_ATTR_CON;
         return 0;
     } else {
-        anjay_log(WARNING, "Invalid con attribute value: %s", value);
+        anjay_log(WARNING, "Invalid con attribute value: %.*s",
+                  (int) value.size, value.data);
         return -1;
     }
 }
 #endif // WITH_CON_ATTR
 
 static int parse_attribute(anjay_request_attributes_t *out_attrs,
-                           const char *key,
-                           const char *value) {
-    if (!strcmp(key, ANJAY_ATTR_PMIN)) {
+                           opt_string_t key,
+                           opt_string_t value) {
+    if (opt_string_equal(key, ANJAY_ATTR_PMIN)) {
         return parse_nullable_time(
                 key, value, &out_attrs->has_min_period,
                 &out_attrs->values.standard.common.min_period);
-    } else if (!strcmp(key, ANJAY_ATTR_PMAX)) {
+    } else if (opt_string_equal(key, ANJAY_ATTR_PMAX)) {
         return parse_nullable_time(
                 key, value, &out_attrs->has_max_period,
                 &out_attrs->values.standard.common.max_period);
-    } else if (!strcmp(key, ANJAY_ATTR_GT)) {
+    } else if (opt_string_equal(key, ANJAY_ATTR_GT)) {
         return parse_nullable_double(key, value, &out_attrs->has_greater_than,
                                      &out_attrs->values.standard.greater_than);
-    } else if (!strcmp(key, ANJAY_ATTR_LT)) {
+    } else if (opt_string_equal(key, ANJAY_ATTR_LT)) {
         return parse_nullable_double(key, value, &out_attrs->has_less_than,
                                      &out_attrs->values.standard.less_than);
-    } else if (!strcmp(key, ANJAY_ATTR_ST)) {
+    } else if (opt_string_equal(key, ANJAY_ATTR_ST)) {
         return parse_nullable_double(key, value, &out_attrs->has_step,
                                      &out_attrs->values.standard.step);
 #ifdef WITH_CON_ATTR
-    } else if (!strcmp(key, ANJAY_CUSTOM_ATTR_CON)) {
+    } else if (opt_string_equal(key, ANJAY_CUSTOM_ATTR_CON)) {
         return parse_con(value, &out_attrs->custom.has_con,
                          &out_attrs->values.custom.data.con);
 #endif // WITH_CON_ATTR
     } else {
-        anjay_log(ERROR, "unrecognized query string: %s = %s", key, value);
+        anjay_log(ERROR, "unrecognized query string: %.*s",
+                  (int) key.size, key.data);
         return -1;
     }
 }
@@ -298,31 +355,28 @@ static int parse_attributes(const avs_coap_msg_t *msg,
     memset(out_attrs, 0, sizeof(*out_attrs));
     out_attrs->values = ANJAY_DM_INTERNAL_RES_ATTRS_EMPTY;
 
-    char buffer[ANJAY_MAX_URI_QUERY_SEGMENT_SIZE];
-    size_t attr_size;
-
-    int result;
-    avs_coap_opt_iterator_t it = AVS_COAP_OPT_ITERATOR_EMPTY;
-    while ((result = avs_coap_msg_get_option_string_it(
-                    msg, AVS_COAP_OPT_URI_QUERY, &it,
-                    &attr_size, buffer, sizeof(buffer) - 1)) == 0) {
-        const char *key;
-        const char *value;
+    for (avs_coap_opt_iterator_t optit = avs_coap_opt_begin(msg);
+            !avs_coap_opt_end(&optit); avs_coap_opt_next(&optit)) {
+        const uint32_t optnum = avs_coap_opt_number(&optit);
+        if (optnum < AVS_COAP_OPT_URI_QUERY) {
+            continue;
+        } else if (optnum > AVS_COAP_OPT_URI_QUERY) {
+            // options are sorted by number
+            break;
+        }
 
-        buffer[attr_size] = '\0';
-        split_query_string(buffer, &key, &value);
+        const opt_string_t query = opt_string(optit.curr_opt);
+        opt_string_t key;
+        opt_string_t value;
+        split_query_string(query, &key, &value);
 
         if (parse_attribute(out_attrs, key, value)) {
-            anjay_log(ERROR, "invalid query string: %s = %s", key, value);
+            anjay_log(ERROR, "invalid query string: %.*s",
+                      (int) query.size, query.data);
             return -1;
         }
     }
 
-    if (result < 0) {
-        anjay_log(ERROR, "could not read Request-Query");
-        return -1;
-    }
-
     return 0;
 }
 
@@ -433,14 +487,15 @@ static int parse_action(const avs_coap_msg_t *msg,
                           &inout_request->action);
 }
 
-static int parse_request_uri_segment(const char *uri,
+static int parse_request_uri_segment(opt_string_t segment,
                                      uint16_t *out_id,
                                      uint16_t max_valid_id) {
-    long long num;
-    if (_anjay_safe_strtoll(uri, &num)
+    int64_t num;
+    if (_anjay_string_to_i64(segment.data, segment.size, &num)
             || num < 0
             || num > max_valid_id) {
-        anjay_log(ERROR, "invalid Uri-Path segment: %s", uri);
+        anjay_log(ERROR, "invalid Uri-Path segment: %.*s",
+                  (int) segment.size, segment.data);
         return -1;
     }
 
@@ -448,38 +503,24 @@ static int parse_request_uri_segment(const char *uri,
     return 0;
 }
 
-static int parse_bs_uri(const avs_coap_msg_t *msg, bool *out_is_bs) {
-    char uri[ANJAY_MAX_URI_SEGMENT_SIZE] = "";
-    size_t uri_size;
-
-    *out_is_bs = false;
-
-    avs_coap_opt_iterator_t optit = AVS_COAP_OPT_ITERATOR_EMPTY;
-    int result = avs_coap_msg_get_option_string_it(
-            msg, AVS_COAP_OPT_URI_PATH, &optit,
-            &uri_size, uri, sizeof(uri) - 1);
-    if (result) {
-        return (result == AVS_COAP_OPTION_MISSING) ? 0 : result;
-    }
+static bool is_bs_uri(const avs_coap_msg_t *msg) {
+    size_t segments = 0;
+    bool first_is_bs = false;
 
-    if (strcmp(uri, "bs") == 0) {
-        result = avs_coap_msg_get_option_string_it(
-                msg, AVS_COAP_OPT_URI_PATH, &optit,
-                &uri_size, uri, sizeof(uri) - 1);
-        if (result == AVS_COAP_OPTION_MISSING) {
-            *out_is_bs = true;
-            return 0;
+    for (avs_coap_opt_iterator_t optit = avs_coap_opt_begin(msg);
+            !avs_coap_opt_end(&optit) && segments < 2;
+            avs_coap_opt_next(&optit)) {
+        if (avs_coap_opt_number(&optit) == AVS_COAP_OPT_URI_PATH
+                && segments++ == 0) {
+            first_is_bs = opt_string_equal(opt_string(optit.curr_opt), "bs");
         }
     }
 
-    return result;
+    return segments == 1 && first_is_bs;
 }
 
-static int parse_dm_uri(const avs_coap_msg_t *msg,
+int _anjay_parse_dm_uri(const avs_coap_msg_t *msg,
                         anjay_uri_path_t *out_uri) {
-    char uri[ANJAY_MAX_URI_SEGMENT_SIZE] = "";
-    size_t uri_size;
-
     out_uri->has_oid = false;
     out_uri->has_iid = false;
     out_uri->has_rid = false;
@@ -494,30 +535,27 @@ static int parse_dm_uri(const avs_coap_msg_t *msg,
         { &out_uri->rid, &out_uri->has_rid, UINT16_MAX }
     };
 
-    avs_coap_opt_iterator_t optit = AVS_COAP_OPT_ITERATOR_EMPTY;
-    for (size_t i = 0; i < AVS_ARRAY_SIZE(ids); ++i) {
-        int result = avs_coap_msg_get_option_string_it(
-                    msg, AVS_COAP_OPT_URI_PATH, &optit,
-                    &uri_size, uri, sizeof(uri) - 1);
-        if (result == AVS_COAP_OPTION_MISSING) {
-            return 0;
-        } else if (result) {
-            return result;
+    size_t i = 0;
+    for (avs_coap_opt_iterator_t optit = avs_coap_opt_begin(msg);
+            !avs_coap_opt_end(&optit); avs_coap_opt_next(&optit)) {
+        const uint32_t optnum = avs_coap_opt_number(&optit);
+        if (optnum < AVS_COAP_OPT_URI_PATH) {
+            continue;
+        } else if (optnum > AVS_COAP_OPT_URI_PATH) {
+            // options are sorted by number
+            break;
         }
 
-        if (parse_request_uri_segment(uri, ids[i].id, ids[i].max_valid_value)) {
+        // 3 or more segments...
+        if (i >= AVS_ARRAY_SIZE(ids)) {
+            anjay_log(ERROR, "prefixed Uri-Path are not supported");
             return -1;
         }
-        *ids[i].has_id = true;
-    }
-
-    // 3 or more segments...
-    if (avs_coap_msg_get_option_string_it(
-                    msg, AVS_COAP_OPT_URI_PATH, &optit,
-                    &uri_size, uri, sizeof(uri) - 1)
-            != AVS_COAP_OPTION_MISSING) {
-        anjay_log(ERROR, "prefixed Uri-Path are not supported");
-        return -1;
+        if (parse_request_uri_segment(opt_string(optit.curr_opt), ids[i].id,
+                                      ids[i].max_valid_value)) {
+            return -1;
+        }
+        *ids[i++].has_id = true;
     }
     return 0;
 }
@@ -525,17 +563,13 @@ static int parse_dm_uri(const avs_coap_msg_t *msg,
 static int parse_request_uri(const avs_coap_msg_t *msg,
                              bool *out_is_bs,
                              anjay_uri_path_t *out_uri) {
-    int result = parse_bs_uri(msg, out_is_bs);
-    if (result) {
-        return result;
-    }
-    if (*out_is_bs) {
+    if ((*out_is_bs = is_bs_uri(msg))) {
         out_uri->has_oid = false;
         out_uri->has_iid = false;
         out_uri->has_rid = false;
         return 0;
     } else {
-        return parse_dm_uri(msg, out_uri);
+        return _anjay_parse_dm_uri(msg, out_uri);
     }
 }
 
@@ -609,15 +643,68 @@ static bool critical_option_validator(uint8_t msg_code, uint32_t optnum) {
     }
 }
 
+static bool is_request_identity_opt(uint32_t optnum) {
+    switch (optnum) {
+    case AVS_COAP_OPT_OBSERVE:
+    case AVS_COAP_OPT_URI_PATH:
+    case AVS_COAP_OPT_CONTENT_FORMAT:
+    case AVS_COAP_OPT_URI_QUERY:
+    case AVS_COAP_OPT_ACCEPT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static uint64_t fingerprint_update(uint64_t hash,
+                                   const void *data,
+                                   size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ ((const uint8_t *) data)[i]) * UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+/**
+ * Computes a 64-bit FNV-1a hash of everything @ref parse_request looks at:
+ * message type, code and raw values of the options it interprets. BLOCK
+ * options are not included, so all blocks of a single request yield the same
+ * fingerprint.
+ */
+static uint64_t request_fingerprint(const avs_coap_msg_t *msg) {
+    const uint8_t header[] = {
+        (uint8_t) avs_coap_msg_get_type(msg),
+        avs_coap_msg_get_code(msg)
+    };
+    uint64_t hash = fingerprint_update(UINT64_C(14695981039346656037),
+                                       header, sizeof(header));
+
+    for (avs_coap_opt_iterator_t optit = avs_coap_opt_begin(msg);
+            !avs_coap_opt_end(&optit); avs_coap_opt_next(&optit)) {
+        const uint32_t optnum = avs_coap_opt_number(&optit);
+        if (is_request_identity_opt(optnum)) {
+            const uint32_t length =
+                    avs_coap_opt_content_length(optit.curr_opt);
+            hash = fingerprint_update(hash, &optnum, sizeof(optnum));
+            hash = fingerprint_update(hash, &length, sizeof(length));
+            hash = fingerprint_update(hash, avs_coap_opt_value(optit.curr_opt),
+                                      length);
+        }
+    }
+    return hash;
+}
+
+/**
+ * Checks whether @p msg is a further block of the request whose fingerprint
+ * was computed with @ref request_fingerprint . Options are compared in their
+ * encoded form, so this is stricter than comparing parsed requests.
+ */
 static int block_request_equality_validator(const avs_coap_msg_t *msg,
-                                            void *orig_request_) {
-    const anjay_request_t *orig_request =
-            (const anjay_request_t *) orig_request_;
-    anjay_request_t block_request;
+                                            void *orig_fingerprint_) {
+    const uint64_t *orig_fingerprint = (const uint64_t *) orig_fingerprint_;
     if (avs_coap_msg_validate_critical_options(msg,
                                                critical_option_validator)
-            || parse_request(msg, &block_request)
-            || !_anjay_request_equal(&block_request, orig_request)) {
+            || request_fingerprint(msg) != *orig_fingerprint) {
         return -1;
     }
     return 0;
@@ -682,12 +769,33 @@ static int handle_incoming_message(anjay_t *anjay) {
         } else if (result == AVS_COAP_CTX_ERR_MSG_WAS_PING) {
             anjay_log(TRACE, "received CoAP ping");
             result = 0;
+        } else if (result == AVS_COAP_CTX_ERR_TIMEOUT) {
+            anjay_log(TRACE, "no message received");
         } else {
             anjay_log(ERROR, "received packet is not a valid CoAP message");
         }
         goto cleanup;
     }
 
+    if (!avs_coap_msg_code_is_request(avs_coap_msg_get_code(request_msg))) {
+        if (!_anjay_server_handle_async_response(anjay, request_msg)) {
+            result = 0;
+            goto cleanup;
+        }
+        if (avs_coap_msg_get_type(request_msg) != AVS_COAP_MSG_RESET) {
+            anjay_log(DEBUG, "unexpected response received, ignoring");
+            if (avs_coap_msg_get_type(request_msg)
+                    == AVS_COAP_MSG_CONFIRMABLE) {
+                avs_coap_ctx_send_empty(
+                        anjay->coap_ctx,
+                        avs_stream_net_getsock(anjay->comm_stream),
+                        AVS_COAP_MSG_RESET, avs_coap_msg_get_id(request_msg));
+            }
+            result = -1;
+            goto cleanup;
+        }
+    }
+
     avs_coap_msg_identity_t request_identity = AVS_COAP_MSG_IDENTITY_EMPTY;
     anjay_request_t request;
     if (_anjay_coap_stream_get_request_identity(anjay->comm_stream,
@@ -705,8 +813,10 @@ static int handle_incoming_message(anjay_t *anjay) {
         goto cleanup;
     }
 
+    uint64_t fingerprint = request_fingerprint(request_msg);
     _anjay_coap_stream_set_block_request_validator(
-            anjay->comm_stream, block_request_equality_validator, &request);
+            anjay->comm_stream, block_request_equality_validator,
+            &fingerprint);
     result = handle_request(anjay, &request_identity, &request);
 
 cleanup:
@@ -724,11 +834,19 @@ _anjay_get_server_connection(anjay_connection_ref_t ref) {
     }
 }
 
+avs_coap_tx_params_t _anjay_connection_tx_params(anjay_t *anjay,
+                                                 anjay_connection_ref_t ref) {
+    assert(ref.conn_type == ANJAY_CONNECTION_UDP);
+    avs_coap_tx_params_t tx_params = anjay->udp_tx_params;
+    _anjay_connection_rtt_apply(_anjay_get_server_connection(ref), &tx_params);
+    return tx_params;
+}
+
 int _anjay_bind_server_stream(anjay_t *anjay, anjay_connection_ref_t ref) {
-    const avs_coap_tx_params_t *tx_params;
+    avs_coap_tx_params_t tx_params;
     switch (ref.conn_type) {
     case ANJAY_CONNECTION_UDP:
-        tx_params = &anjay->udp_tx_params;
+        tx_params = _anjay_connection_tx_params(anjay, ref);
         break;
     default:
         assert(0 && "Should never happen");
@@ -743,7 +861,7 @@ int _anjay_bind_server_stream(anjay_t *anjay, anjay_connection_ref_t ref) {
     }
     if (avs_stream_net_setsock(anjay->comm_stream, socket)
             || _anjay_coap_stream_set_tx_params(anjay->comm_stream,
-                                                tx_params)) {
+                                                &tx_params)) {
         anjay_log(ERROR, "could not set stream socket");
         return -1;
     }
@@ -854,8 +972,8 @@ size_t _anjay_num_non_bootstrap_servers(anjay_t *anjay) {
     return num_servers;
 }
 
-static int udp_serve(anjay_t *anjay,
-                     avs_net_abstract_socket_t *ready_socket) {
+static int udp_serve_message(anjay_t *anjay,
+                             avs_net_abstract_socket_t *ready_socket) {
     anjay_connection_ref_t connection = {
         .server = _anjay_servers_find_by_udp_socket(&anjay->servers,
                                                     ready_socket),
@@ -871,6 +989,67 @@ static int udp_serve(anjay_t *anjay,
     return result;
 }
 
+/**
+ * Handlers of served messages may reconnect or close the server's socket,
+ * so it has to be looked up again before each use after serving one.
+ */
+static bool is_udp_socket_online(anjay_t *anjay,
+                                 avs_net_abstract_socket_t *socket) {
+    anjay_active_server_info_t *server =
+            _anjay_servers_find_by_udp_socket(&anjay->servers, socket);
+    return server && _anjay_connection_get_online_socket(
+                             &server->udp_connection) == socket;
+}
+
+static void udp_serve_queued_messages(anjay_t *anjay,
+                                      avs_net_abstract_socket_t *ready_socket,
+                                      size_t limit) {
+    avs_net_socket_opt_value_t original_recv_timeout;
+    if (avs_net_socket_get_opt(ready_socket, AVS_NET_SOCKET_OPT_RECV_TIMEOUT,
+                               &original_recv_timeout)
+            || avs_net_socket_set_opt(ready_socket,
+                                      AVS_NET_SOCKET_OPT_RECV_TIMEOUT,
+                                      (avs_net_socket_opt_value_t) {
+                                          .recv_timeout = AVS_TIME_DURATION_ZERO
+                                      })) {
+        anjay_log(WARNING, "could not set socket recv timeout");
+        return;
+    }
+
+    size_t served = 0;
+    while (served < limit && is_udp_socket_online(anjay, ready_socket)) {
+        int result = udp_serve_message(anjay, ready_socket);
+        if (result == AVS_COAP_CTX_ERR_TIMEOUT) {
+            break;
+        } else if (result == AVS_COAP_CTX_ERR_NETWORK) {
+            anjay_log(WARNING, "network error while serving queued messages");
+            break;
+        }
+        ++served;
+    }
+    anjay_log(TRACE, "handled %lu queued message(s)", (unsigned long) served);
+
+    if (!is_udp_socket_online(anjay, ready_socket)) {
+        anjay_log(DEBUG, "socket closed while serving queued messages, not "
+                  "restoring its recv timeout");
+    } else if (avs_net_socket_set_opt(ready_socket,
+                                      AVS_NET_SOCKET_OPT_RECV_TIMEOUT,
+                                      original_recv_timeout)) {
+        anjay_log(ERROR, "could not restore socket recv timeout");
+    }
+}
+
+static int udp_serve(anjay_t *anjay,
+                     avs_net_abstract_socket_t *ready_socket) {
+    int result = udp_serve_message(anjay, ready_socket);
+    if (anjay->max_messages_per_serve > 1
+            && is_udp_socket_online(anjay, ready_socket)) {
+        udp_serve_queued_messages(anjay, ready_socket,
+                                  anjay->max_messages_per_serve - 1);
+    }
+    return result;
+}
+
 static int sms_serve(anjay_t *anjay) {
     (void) anjay;
     assert(0 && "SMS not supported in this version of Anjay");
@@ -980,9 +1159,15 @@ uint64_t anjay_get_rx_bytes(anjay_t *anjay) {
 #endif
 }
 
+static uint64_t msg_cache_hits(anjay_t *anjay) {
+    return anjay->msg_cache
+            ? _anjay_coap_msg_cache_get_stats(anjay->msg_cache).hits : 0;
+}
+
 uint64_t anjay_get_num_incoming_retransmissions(anjay_t *anjay) {
 #ifdef WITH_NET_STATS
-    return avs_coap_ctx_get_num_incoming_retransmissions(anjay->coap_ctx);
+    return avs_coap_ctx_get_num_incoming_retransmissions(anjay->coap_ctx)
+            + msg_cache_hits(anjay);
 #else
     (void) anjay;
     return 0;
@@ -991,13 +1176,30 @@ uint64_t anjay_get_num_incoming_retransmissions(anjay_t *anjay) {
 
 uint64_t anjay_get_num_outgoing_retransmissions(anjay_t *anjay) {
 #ifdef WITH_NET_STATS
-    return avs_coap_ctx_get_num_outgoing_retransmissions(anjay->coap_ctx);
+    return avs_coap_ctx_get_num_outgoing_retransmissions(anjay->coap_ctx)
+            + msg_cache_hits(anjay);
 #else
     (void) anjay;
     return 0;
 #endif
 }
 
+int anjay_get_msg_cache_stats(anjay_t *anjay,
+                              anjay_msg_cache_stats_t *out_stats) {
+    if (!anjay->msg_cache) {
+        anjay_log(ERROR, "message cache disabled");
+        return -1;
+    }
+    const coap_msg_cache_stats_t stats =
+            _anjay_coap_msg_cache_get_stats(anjay->msg_cache);
+    out_stats->hits = stats.hits;
+    out_stats->misses = stats.misses;
+    out_stats->evictions = stats.evictions;
+    out_stats->bytes_used = stats.bytes_used;
+    out_stats->capacity = stats.capacity;
+    return 0;
+}
+
 #ifdef ANJAY_TEST
 #include "test/anjay.c"
 #endif // ANJAY_TEST
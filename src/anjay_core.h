@@ -27,6 +27,7 @@
 #include "servers.h"
 #include "utils_core.h"
 #include "downloader.h"
+#include "coap/msg_cache.h"
 #include "interface/bootstrap_core.h"
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
@@ -58,12 +59,15 @@ struct anjay_struct {
 #endif
     avs_coap_tx_params_t udp_tx_params;
     avs_coap_ctx_t *coap_ctx;
+    coap_msg_cache_t *msg_cache;
     avs_stream_abstract_t *comm_stream;
     anjay_connection_ref_t current_connection;
     anjay_scheduled_notify_t scheduled_notify;
 
     const char *endpoint_name;
     anjay_transaction_state_t transaction_state;
+    bool two_pass_tlv_object_reads;
+    size_t max_messages_per_serve;
 
     uint8_t *in_buffer;
     size_t in_buffer_size;
@@ -94,6 +98,14 @@ void _anjay_release_server_stream(anjay_t *anjay);
 
 size_t _anjay_num_non_bootstrap_servers(anjay_t *anjay);
 
+/**
+ * Parses the Uri-Path options of a data model request into @p out_uri.
+ *
+ * @returns 0 on success, or a non-zero value if the path is not a valid
+ *          LwM2M data model path.
+ */
+int _anjay_parse_dm_uri(const avs_coap_msg_t *msg, anjay_uri_path_t *out_uri);
+
 /**
  * @param anjay Pointer to the Anjay object, passed to scheduled jobs. Not
  *              dereferenced by the scheduler object.
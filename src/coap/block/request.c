@@ -82,18 +82,16 @@ static int block_request_update_block_option(coap_block_transfer_ctx_t *ctx,
 
     coap_log(DEBUG, "server requested block size change: %u", block->size);
 
-    if (block->seq_num != 0) {
-        coap_log(WARNING, "server requested block size change in the middle of "
-                 "a transfer");
-        return -1;
-    }
-
     if (block->size > ctx->block.size) {
         coap_log(WARNING, "server requested block size bigger than original"
                  "(%u, was %u)", block->size, ctx->block.size);
         return -1;
     }
 
+    /* RFC 7959, 2.5: the server may request a smaller block size in any
+     * 2.31 Continue response, not only the first one. Its Block1 option
+     * acknowledges the block we sent, so the next block starts right after it
+     * - which, expressed in units of the new size, is: */
     uint32_t size_ratio = ctx->block.size / block->size;
     ctx->block.seq_num = (ctx->block.seq_num + 1) * size_ratio;
     ctx->block.size = block->size;
@@ -15,6 +15,8 @@
  */
 
 #include <config.h>
+
+#include <inttypes.h>
 #include <string.h>
 
 #define ANJAY_COAP_STREAM_INTERNALS
@@ -38,15 +40,32 @@ static int handle_block_size_renegotiation(coap_block_transfer_ctx_t *ctx,
                  "%u B", ctx->block.size, block2->size);
         return -1;
     } else if (block2->size < ctx->block.size) {
-        if (block2->seq_num != 0 || ctx->num_sent_blocks != 0) {
-            coap_log(ERROR, "client changed block size in the middle of block "
-                     "transfer");
-            return -1;
+        /* RFC 7959, 2.4: the client may request a smaller block size at any
+         * point of the transfer. Block numbers in its requests are then
+         * expressed in units of the new size, so the position in the transfer
+         * needs to be translated before comparing sequence numbers.
+         *
+         * The payload of last sent block is still in the block builder, so it
+         * may be either repeated using the smaller size (block2->seq_num
+         * pointing at its beginning), or the transfer may continue right after
+         * it. */
+        uint32_t size_ratio = (uint32_t) (ctx->block.size / block2->size);
+        uint32_t last_block_start = ctx->block.seq_num * size_ratio;
+        uint32_t next_block_start = (ctx->block.seq_num + 1) * size_ratio;
+
+        if (block2->seq_num == last_block_start) {
+            ctx->block.seq_num = last_block_start;
+        } else if (block2->seq_num == next_block_start) {
+            ctx->block.seq_num = next_block_start - 1;
         } else {
-            coap_log(TRACE, "lowering block size to %u B on client request",
-                     block2->size);
-            ctx->block.size = block2->size;
+            coap_log(ERROR, "client changed block size to %u B at unexpected "
+                     "block %" PRIu32, block2->size, block2->seq_num);
+            return -1;
         }
+
+        coap_log(TRACE, "lowering block size to %u B on client request",
+                 block2->size);
+        ctx->block.size = block2->size;
     }
 
     return 0;
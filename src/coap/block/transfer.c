@@ -115,6 +115,7 @@ _anjay_coap_block_transfer_new(uint16_t max_block_size,
         .num_sent_blocks = 0,
         .coap_ctx = stream_data->coap_ctx,
         .socket = stream_data->socket,
+        .msg_cache = stream_data->msg_cache,
         .in = &stream_data->in,
         .block_builder = avs_coap_block_builder_init(&stream_data->out.builder),
         .info = stream_data->out.info,
@@ -181,7 +182,7 @@ static int accept_response_with_timeout(coap_block_transfer_ctx_t *ctx,
 
     int handler_retval;
     int result = _anjay_coap_common_recv_msg_with_timeout(
-            ctx->coap_ctx, ctx->socket, ctx->in, &recv_timeout,
+            ctx->coap_ctx, ctx->socket, ctx->in, ctx->msg_cache, &recv_timeout,
             block_recv, &block_recv_data, &handler_retval);
 
     if (result == AVS_COAP_CTX_ERR_TIMEOUT) {
@@ -191,6 +192,9 @@ static int accept_response_with_timeout(coap_block_transfer_ctx_t *ctx,
     return result ? result : handler_retval;
 }
 
+/* Block-wise transfers are stop-and-wait: each block is sent and its response
+ * is awaited synchronously before the next one is prepared, so there is never
+ * more than one block in flight (NSTART = 1, RFC 7252, 4.7). */
 static int send_block_msg(coap_block_transfer_ctx_t *ctx,
                           const avs_coap_msg_t *msg) {
     coap_log(TRACE, "sending block %" PRIu32 " (size %" PRIu16 ", payload size "
@@ -212,6 +216,8 @@ static int send_block_msg(coap_block_transfer_ctx_t *ctx,
             coap_log(ERROR, "cannot send block message");
             break;
         }
+        _anjay_coap_common_cache_response(ctx->msg_cache, ctx->coap_ctx,
+                                          ctx->socket, msg);
 
         if (!should_wait_for_response(ctx)) {
             break;
@@ -271,8 +277,6 @@ static bool has_full_intermediate_block(const coap_block_transfer_ctx_t *ctx) {
 static int send_next_block(coap_block_transfer_ctx_t *ctx,
                            avs_coap_aligned_msg_buffer_t *buffer,
                            size_t buffer_size) {
-    ctx->info.identity = _anjay_coap_id_source_get(ctx->id_source);
-
     const avs_coap_msg_t *msg = NULL;
     int result;
 
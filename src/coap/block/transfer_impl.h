@@ -78,6 +78,7 @@ struct coap_block_transfer_ctx {
 
     avs_coap_ctx_t *coap_ctx;
     avs_net_abstract_socket_t *socket;
+    coap_msg_cache_t *msg_cache;
     coap_input_buffer_t *in;
     avs_coap_msg_info_t info;
     avs_coap_block_builder_t block_builder;
@@ -23,6 +23,9 @@
 
 #include "../utils_core.h"
 
+#include "msg_cache.h"
+#include "notify_template.h"
+
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
 #define ANJAY_COAP_STREAM_EXTENSION 0x436F4150UL /* CoAP */
@@ -68,6 +71,28 @@ int _anjay_coap_stream_set_tx_params(
         avs_stream_abstract_t *stream,
         const avs_coap_tx_params_t *tx_params);
 
+/**
+ * Makes the stream store responses it sends in @p cache and resend them when
+ * a retransmitted request is received, instead of handling it again. The cache
+ * is not owned by the stream; pass NULL to disable caching.
+ */
+void _anjay_coap_stream_set_msg_cache(avs_stream_abstract_t *stream,
+                                      coap_msg_cache_t *cache);
+
+#ifdef WITH_RTT_ESTIMATION
+/**
+ * Retrieves the round-trip time of the last Confirmable request sent on
+ * @p stream that got acknowledged, measured since its first transmission, and
+ * forgets it.
+ *
+ * @returns 0 on success, a negative value if no such request was sent since
+ *          the last call.
+ */
+int _anjay_coap_stream_take_rtt_sample(avs_stream_abstract_t *stream,
+                                       avs_time_duration_t *out_rtt,
+                                       unsigned *out_retransmissions);
+#endif // WITH_RTT_ESTIMATION
+
 int _anjay_coap_stream_setup_response(avs_stream_abstract_t *stream,
                                       const anjay_msg_details_t *details);
 
@@ -76,9 +101,51 @@ int _anjay_coap_stream_setup_request(
         const anjay_msg_details_t *details,
         const avs_coap_token_t *token);
 
+/**
+ * Prepares an Observe notification with a complete payload, built from
+ * a template instead of message details. This is a faster equivalent of
+ * @ref _anjay_coap_stream_setup_request followed by writing the payload.
+ * The notification is sent with @ref avs_stream_finish_message , as usual.
+ *
+ * @param stream       CoAP stream to operate on.
+ * @param tpl          Template of the notification.
+ * @param type         Message type.
+ * @param token        Token of the notification; has to be the same as the one
+ *                     @p tpl was initialized with.
+ * @param payload      Payload of the notification.
+ * @param payload_size Number of bytes of payload.
+ *
+ * @returns 0 on success, or a negative value in case of error, or if the
+ *          notification does not fit in a single message - in that case the
+ *          stream is reset, and the notification has to be set up with
+ *          @ref _anjay_coap_stream_setup_request instead, so that it may be
+ *          sent block-wise.
+ */
+int _anjay_coap_stream_setup_notification(avs_stream_abstract_t *stream,
+                                          const coap_notify_template_t *tpl,
+                                          avs_coap_msg_type_t type,
+                                          const avs_coap_token_t *token,
+                                          const void *payload,
+                                          size_t payload_size);
+
 int _anjay_coap_stream_set_error(avs_stream_abstract_t *stream,
                                  uint8_t code);
 
+/**
+ * Builds the request prepared with @ref _anjay_coap_stream_setup_request
+ * without sending it, so that the exchange may be driven by the caller.
+ *
+ * NOTE: The message is stored in the stream output buffer, so the pointer is
+ * only valid until the stream is reset.
+ *
+ * @returns 0 on success, or a negative value if there is no prepared request,
+ *          or if its payload did not fit in a single message and a block-wise
+ *          transfer has already been started - in that case the request has to
+ *          be finished with @ref avs_stream_finish_message .
+ */
+int _anjay_coap_stream_build_request(avs_stream_abstract_t *stream,
+                                     const avs_coap_msg_t **out_msg);
+
 /** NOTE: Pointer acquired with this function is only valid until receiving next
  * CoAP packet. Note that this might mean invalidation during the same stream
  * exchange if block transfer is in progress. */
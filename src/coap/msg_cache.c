@@ -0,0 +1,335 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <avsystem/commons/defs.h>
+
+#include "coap_log.h"
+#include "msg_cache.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+#define NO_ENTRY SIZE_MAX
+
+#define ENTRY_ALIGNMENT AVS_ALIGNOF(avs_max_align_t)
+
+// used to pick the number of hash buckets for given capacity
+#define EXPECTED_ENTRY_SIZE 64
+#define MIN_BUCKET_COUNT 16
+
+/*
+ * Each entry is laid out in the ring buffer as:
+ *
+ *   cache_entry_t | endpoint | padding | avs_coap_msg_t | padding
+ *
+ * where endpoint is the remote host and port, both NULL-terminated.
+ */
+typedef struct {
+    // offset of the next entry in the same hash bucket, or NO_ENTRY
+    size_t next;
+    // total size of the entry, including padding
+    size_t size;
+    avs_time_monotonic_t expiration_time;
+    uint32_t hash;
+    uint16_t msg_id;
+    uint16_t endpoint_size;
+} cache_entry_t;
+
+struct coap_msg_cache {
+    uint8_t *buffer;
+    size_t capacity;
+
+    /*
+     * Entries occupy [head, tail) if !wrapped, or [head, data_end) followed
+     * by [0, tail) otherwise. Entries are always evicted from the head, which
+     * holds the oldest one.
+     */
+    size_t head;
+    size_t tail;
+    size_t data_end;
+    bool wrapped;
+    size_t entry_count;
+
+    // each bucket holds the offset of the newest entry with matching hash
+    size_t *buckets;
+    size_t bucket_mask;
+
+    coap_msg_cache_stats_t stats;
+};
+
+static size_t align_size(size_t size) {
+    return (size + ENTRY_ALIGNMENT - 1) / ENTRY_ALIGNMENT * ENTRY_ALIGNMENT;
+}
+
+static size_t msg_size(const avs_coap_msg_t *msg) {
+    return offsetof(avs_coap_msg_t, header) + msg->length;
+}
+
+static size_t msg_offset(size_t endpoint_size) {
+    return align_size(sizeof(cache_entry_t) + endpoint_size);
+}
+
+static cache_entry_t *entry_at(const coap_msg_cache_t *cache, size_t offset) {
+    assert(offset + sizeof(cache_entry_t) <= cache->capacity);
+    return (cache_entry_t *) (cache->buffer + offset);
+}
+
+static const char *entry_endpoint(const cache_entry_t *entry) {
+    return (const char *) entry + sizeof(cache_entry_t);
+}
+
+static const avs_coap_msg_t *entry_msg(const cache_entry_t *entry) {
+    return (const avs_coap_msg_t *) ((const uint8_t *) entry
+                                     + msg_offset(entry->endpoint_size));
+}
+
+/**
+ * Writes "host\0port\0" into @p buffer .
+ *
+ * @returns number of bytes written, or 0 if @p buffer is too small.
+ */
+static size_t make_endpoint(char *buffer,
+                            size_t buffer_size,
+                            const char *host,
+                            const char *port) {
+    const size_t host_size = strlen(host) + 1;
+    const size_t port_size = strlen(port) + 1;
+    if (host_size + port_size > buffer_size) {
+        return 0;
+    }
+    memcpy(buffer, host, host_size);
+    memcpy(buffer + host_size, port, port_size);
+    return host_size + port_size;
+}
+
+/** 32-bit FNV-1a over the endpoint and message ID. */
+static uint32_t hash_key(const char *endpoint,
+                         size_t endpoint_size,
+                         uint16_t msg_id) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < endpoint_size; ++i) {
+        hash = (hash ^ (uint8_t) endpoint[i]) * 16777619U;
+    }
+    hash = (hash ^ (uint8_t) (msg_id >> 8)) * 16777619U;
+    hash = (hash ^ (uint8_t) msg_id) * 16777619U;
+    return hash;
+}
+
+static size_t *bucket_for(coap_msg_cache_t *cache, uint32_t hash) {
+    return &cache->buckets[hash & cache->bucket_mask];
+}
+
+static size_t bucket_count_for_capacity(size_t capacity) {
+    size_t count = MIN_BUCKET_COUNT;
+    while (count < capacity / EXPECTED_ENTRY_SIZE && count < SIZE_MAX / 2) {
+        count *= 2;
+    }
+    return count;
+}
+
+coap_msg_cache_t *_anjay_coap_msg_cache_create(size_t capacity) {
+    capacity = capacity / ENTRY_ALIGNMENT * ENTRY_ALIGNMENT;
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    coap_msg_cache_t *cache =
+            (coap_msg_cache_t *) calloc(1, sizeof(coap_msg_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+
+    const size_t bucket_count = bucket_count_for_capacity(capacity);
+    cache->buffer = (uint8_t *) malloc(capacity);
+    cache->buckets = (size_t *) malloc(bucket_count * sizeof(size_t));
+    if (!cache->buffer || !cache->buckets) {
+        coap_log(ERROR, "out of memory");
+        _anjay_coap_msg_cache_release(&cache);
+        return NULL;
+    }
+
+    cache->capacity = capacity;
+    cache->bucket_mask = bucket_count - 1;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        cache->buckets[i] = NO_ENTRY;
+    }
+    cache->stats.capacity = capacity;
+    return cache;
+}
+
+void _anjay_coap_msg_cache_release(coap_msg_cache_t **cache_ptr) {
+    if (cache_ptr && *cache_ptr) {
+        free((*cache_ptr)->buffer);
+        free((*cache_ptr)->buckets);
+        free(*cache_ptr);
+        *cache_ptr = NULL;
+    }
+}
+
+static void unlink_entry(coap_msg_cache_t *cache,
+                         size_t offset,
+                         const cache_entry_t *entry) {
+    size_t *it = bucket_for(cache, entry->hash);
+    while (*it != offset) {
+        assert(*it != NO_ENTRY);
+        it = &entry_at(cache, *it)->next;
+    }
+    *it = entry->next;
+}
+
+static void drop_oldest(coap_msg_cache_t *cache) {
+    assert(cache->entry_count > 0);
+    const cache_entry_t *entry = entry_at(cache, cache->head);
+    unlink_entry(cache, cache->head, entry);
+
+    cache->head += entry->size;
+    cache->stats.bytes_used -= entry->size;
+    --cache->entry_count;
+
+    if (cache->entry_count == 0) {
+        cache->head = 0;
+        cache->tail = 0;
+        cache->wrapped = false;
+    } else if (cache->wrapped && cache->head == cache->data_end) {
+        cache->head = 0;
+        cache->wrapped = false;
+    }
+}
+
+static void drop_expired(coap_msg_cache_t *cache, avs_time_monotonic_t now) {
+    while (cache->entry_count > 0
+            && !avs_time_monotonic_before(
+                    now, entry_at(cache, cache->head)->expiration_time)) {
+        drop_oldest(cache);
+    }
+}
+
+/**
+ * Finds a place for an entry of @p size bytes, evicting the oldest entries
+ * if necessary.
+ *
+ * @returns Offset of the space reserved for the entry.
+ */
+static size_t reserve_space(coap_msg_cache_t *cache, size_t size) {
+    assert(size <= cache->capacity);
+    while (true) {
+        if (!cache->wrapped) {
+            if (cache->capacity - cache->tail >= size) {
+                break;
+            }
+            if (cache->head >= size) {
+                cache->data_end = cache->tail;
+                cache->tail = 0;
+                cache->wrapped = cache->entry_count > 0;
+                break;
+            }
+        } else if (cache->head - cache->tail >= size) {
+            break;
+        }
+
+        ++cache->stats.evictions;
+        drop_oldest(cache);
+    }
+
+    const size_t offset = cache->tail;
+    cache->tail += size;
+    return offset;
+}
+
+int _anjay_coap_msg_cache_add(coap_msg_cache_t *cache,
+                              const char *remote_host,
+                              const char *remote_port,
+                              const avs_coap_msg_t *msg,
+                              avs_time_duration_t lifetime) {
+    char endpoint[UINT8_MAX];
+    const size_t endpoint_size = make_endpoint(endpoint, sizeof(endpoint),
+                                               remote_host, remote_port);
+    if (!endpoint_size) {
+        coap_log(DEBUG, "remote endpoint name too long to cache a response");
+        return -1;
+    }
+
+    const size_t entry_size =
+            align_size(msg_offset(endpoint_size) + msg_size(msg));
+    if (entry_size > cache->capacity) {
+        coap_log(DEBUG, "message too big to cache: %lu/%lu B",
+                 (unsigned long) entry_size, (unsigned long) cache->capacity);
+        return -1;
+    }
+
+    const avs_time_monotonic_t now = avs_time_monotonic_now();
+    drop_expired(cache, now);
+
+    const size_t offset = reserve_space(cache, entry_size);
+    cache_entry_t *entry = entry_at(cache, offset);
+    *entry = (cache_entry_t) {
+        .size = entry_size,
+        .expiration_time = avs_time_monotonic_add(now, lifetime),
+        .hash = hash_key(endpoint, endpoint_size, avs_coap_msg_get_id(msg)),
+        .msg_id = avs_coap_msg_get_id(msg),
+        .endpoint_size = (uint16_t) endpoint_size
+    };
+    memcpy((uint8_t *) entry + sizeof(cache_entry_t), endpoint, endpoint_size);
+    memcpy((uint8_t *) entry + msg_offset(endpoint_size), msg, msg_size(msg));
+
+    size_t *bucket = bucket_for(cache, entry->hash);
+    entry->next = *bucket;
+    *bucket = offset;
+
+    ++cache->entry_count;
+    cache->stats.bytes_used += entry_size;
+    return 0;
+}
+
+const avs_coap_msg_t *_anjay_coap_msg_cache_get(coap_msg_cache_t *cache,
+                                                const char *remote_host,
+                                                const char *remote_port,
+                                                uint16_t msg_id) {
+    char endpoint[UINT8_MAX];
+    const size_t endpoint_size = make_endpoint(endpoint, sizeof(endpoint),
+                                               remote_host, remote_port);
+    if (endpoint_size) {
+        const avs_time_monotonic_t now = avs_time_monotonic_now();
+        const uint32_t hash = hash_key(endpoint, endpoint_size, msg_id);
+        for (size_t offset = *bucket_for(cache, hash); offset != NO_ENTRY;
+                offset = entry_at(cache, offset)->next) {
+            const cache_entry_t *entry = entry_at(cache, offset);
+            if (entry->hash == hash
+                    && entry->msg_id == msg_id
+                    && entry->endpoint_size == endpoint_size
+                    && !memcmp(entry_endpoint(entry), endpoint, endpoint_size)
+                    && avs_time_monotonic_before(now,
+                                                 entry->expiration_time)) {
+                ++cache->stats.hits;
+                return entry_msg(entry);
+            }
+        }
+    }
+
+    ++cache->stats.misses;
+    return NULL;
+}
+
+coap_msg_cache_stats_t
+_anjay_coap_msg_cache_get_stats(const coap_msg_cache_t *cache) {
+    return cache->stats;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_COAP_MSG_CACHE_H
+#define ANJAY_COAP_MSG_CACHE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <avsystem/commons/coap/msg.h>
+#include <avsystem/commons/time.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+/**
+ * Cache of CoAP responses, used to respond to retransmitted requests without
+ * handling them again.
+ *
+ * Entries are keyed by remote endpoint and message ID, indexed with a hash
+ * table and stored back to back in a single ring buffer of fixed size. When
+ * there is not enough space for a new entry, the oldest ones are evicted.
+ */
+typedef struct coap_msg_cache coap_msg_cache_t;
+
+typedef struct {
+    /** Number of lookups that found a cached response */
+    uint64_t hits;
+    /** Number of lookups that did not find any cached response */
+    uint64_t misses;
+    /** Number of entries dropped before expiring to make space for new ones */
+    uint64_t evictions;
+    /** Number of bytes currently used by cached entries */
+    size_t bytes_used;
+    /** Size of the ring buffer entries are stored in */
+    size_t capacity;
+} coap_msg_cache_stats_t;
+
+/**
+ * @returns Cache able to hold up to @p capacity bytes of entries (including
+ *          per-entry overhead), or NULL if @p capacity is 0 or there is not
+ *          enough memory.
+ */
+coap_msg_cache_t *_anjay_coap_msg_cache_create(size_t capacity);
+
+void _anjay_coap_msg_cache_release(coap_msg_cache_t **cache_ptr);
+
+/**
+ * Stores a copy of @p msg sent to a given remote endpoint. The entry expires
+ * after @p lifetime passes.
+ *
+ * If an entry for the same endpoint and message ID already exists, it is
+ * shadowed by the new one.
+ *
+ * @returns 0 on success, a negative value if the message is too big to fit in
+ *          the cache at all.
+ */
+int _anjay_coap_msg_cache_add(coap_msg_cache_t *cache,
+                              const char *remote_host,
+                              const char *remote_port,
+                              const avs_coap_msg_t *msg,
+                              avs_time_duration_t lifetime);
+
+/**
+ * Looks up a message sent to a given remote endpoint with message ID
+ * @p msg_id .
+ *
+ * @returns Cached message, or NULL if there is none or it already expired.
+ *          The pointer is valid until the next call to
+ *          @ref _anjay_coap_msg_cache_add .
+ */
+const avs_coap_msg_t *_anjay_coap_msg_cache_get(coap_msg_cache_t *cache,
+                                                const char *remote_host,
+                                                const char *remote_port,
+                                                uint16_t msg_id);
+
+coap_msg_cache_stats_t
+_anjay_coap_msg_cache_get_stats(const coap_msg_cache_t *cache);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif // ANJAY_COAP_MSG_CACHE_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "coap_log.h"
+#include "notify_template.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+#define COAP_VERSION 1
+
+static size_t uint_size(uint32_t value) {
+    size_t size = 0;
+    for (; value; value >>= 8) {
+        ++size;
+    }
+    return size;
+}
+
+/**
+ * Writes the minimal big-endian representation of @p value , as required for
+ * uint option values by RFC 7252, 3.2.
+ *
+ * @returns number of bytes written, 0 to 4.
+ */
+static size_t encode_uint(uint8_t *out, uint32_t value) {
+    const size_t size = uint_size(value);
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = (uint8_t) (value >> (8 * (size - 1 - i)));
+    }
+    return size;
+}
+
+/**
+ * Encodes an option with an uint value. Only deltas lower than 13 are
+ * supported, which is enough for options used in notifications.
+ */
+static size_t encode_uint_opt(uint8_t *out, uint16_t delta, uint32_t value) {
+    assert(delta < 13);
+    const size_t value_size = encode_uint(out + 1, value);
+    out[0] = (uint8_t) ((delta << 4) | value_size);
+    return 1 + value_size;
+}
+
+int _anjay_coap_notify_template_init(coap_notify_template_t *tpl,
+                                     const avs_coap_token_t *token,
+                                     uint8_t code,
+                                     uint16_t format) {
+    if (token->size > AVS_COAP_MAX_TOKEN_LENGTH) {
+        coap_log(ERROR, "invalid token size (must be <= 8)");
+        return -1;
+    }
+
+    memset(tpl, 0, sizeof(*tpl));
+    tpl->head[0] = (uint8_t) ((COAP_VERSION << 6) | token->size);
+    tpl->head[1] = code;
+    memcpy(&tpl->head[sizeof(avs_coap_msg_header_t)], token->bytes,
+           token->size);
+    tpl->head_size = (uint8_t) (sizeof(avs_coap_msg_header_t) + token->size);
+
+    if (format != AVS_COAP_FORMAT_NONE) {
+        tpl->tail_size = (uint8_t) encode_uint_opt(
+                tpl->tail, AVS_COAP_OPT_CONTENT_FORMAT - AVS_COAP_OPT_OBSERVE,
+                format);
+    }
+    tpl->format = format;
+    return 0;
+}
+
+bool _anjay_coap_notify_template_matches(const coap_notify_template_t *tpl,
+                                         const avs_coap_token_t *token,
+                                         uint8_t code,
+                                         uint16_t format) {
+    return tpl->head_size == sizeof(avs_coap_msg_header_t) + token->size
+            && tpl->head[1] == code
+            && tpl->format == format
+            && !memcmp(&tpl->head[sizeof(avs_coap_msg_header_t)],
+                       token->bytes, token->size);
+}
+
+static size_t msg_length(const coap_notify_template_t *tpl,
+                         uint32_t observe,
+                         size_t payload_size) {
+    return tpl->head_size + 1 + uint_size(observe) + tpl->tail_size
+           + (payload_size ? 1 + payload_size : 0);
+}
+
+size_t _anjay_coap_notify_template_msg_size(const coap_notify_template_t *tpl,
+                                            uint32_t observe,
+                                            size_t payload_size) {
+    return offsetof(avs_coap_msg_t, header)
+           + msg_length(tpl, observe, payload_size);
+}
+
+const avs_coap_msg_t *
+_anjay_coap_notify_template_build(const coap_notify_template_t *tpl,
+                                  avs_coap_msg_type_t type,
+                                  uint16_t msg_id,
+                                  uint32_t observe,
+                                  const void *payload,
+                                  size_t payload_size,
+                                  avs_coap_aligned_msg_buffer_t *buffer,
+                                  size_t buffer_size) {
+    assert(tpl->head_size >= sizeof(avs_coap_msg_header_t));
+
+    if (_anjay_coap_notify_template_msg_size(tpl, observe, payload_size)
+            > buffer_size) {
+        return NULL;
+    }
+
+    avs_coap_msg_t *msg = (avs_coap_msg_t *) buffer;
+    msg->length = (uint32_t) msg_length(tpl, observe, payload_size);
+
+    uint8_t *ptr = (uint8_t *) &msg->header;
+    memcpy(ptr, tpl->head, tpl->head_size);
+    msg->header.version_type_token_length |= (uint8_t) ((type & 0x3) << 4);
+    msg->header.message_id[0] = (uint8_t) (msg_id >> 8);
+    msg->header.message_id[1] = (uint8_t) msg_id;
+    ptr += tpl->head_size;
+
+    ptr += encode_uint_opt(ptr, AVS_COAP_OPT_OBSERVE, observe);
+    memcpy(ptr, tpl->tail, tpl->tail_size);
+    ptr += tpl->tail_size;
+
+    if (payload_size) {
+        *ptr++ = AVS_COAP_PAYLOAD_MARKER;
+        memcpy(ptr, payload, payload_size);
+    }
+
+    assert(avs_coap_msg_is_valid(msg));
+    return msg;
+}
+
+#ifdef ANJAY_TEST
+#include "test/notify_template.c"
+#endif
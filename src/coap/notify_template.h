@@ -0,0 +1,101 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_COAP_NOTIFY_TEMPLATE_H
+#define ANJAY_COAP_NOTIFY_TEMPLATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <avsystem/commons/coap/msg.h>
+#include <avsystem/commons/coap/msg_builder.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+// option header and 2-byte value of Content-Format
+#define COAP_NOTIFY_TEMPLATE_MAX_TAIL_SIZE 3
+
+/**
+ * Pre-encoded form of Observe notifications sent for a single observation.
+ *
+ * Notifications differ from each other only in message type, message ID,
+ * Observe option value and payload. The template keeps everything else -
+ * the header with code and token, and Content-Format option - already encoded,
+ * so that a notification may be built by copying it and patching the variable
+ * parts in, without going through avs_coap_msg_info_t and allocating its
+ * option list for every message.
+ *
+ * A zero-initialized template is valid, and does not match any notification.
+ */
+typedef struct {
+    // CoAP header and token; type and message ID are patched in when building
+    uint8_t head[sizeof(avs_coap_msg_header_t) + AVS_COAP_MAX_TOKEN_LENGTH];
+    uint8_t head_size;
+    // options that follow Observe, with deltas relative to it
+    uint8_t tail[COAP_NOTIFY_TEMPLATE_MAX_TAIL_SIZE];
+    uint8_t tail_size;
+    uint16_t format;
+} coap_notify_template_t;
+
+/**
+ * Encodes a template of notifications with given @p token , @p code and
+ * Content-Format @p format (AVS_COAP_FORMAT_NONE if no Content-Format option
+ * shall be included).
+ *
+ * @returns 0 on success, a negative value if @p token is invalid.
+ */
+int _anjay_coap_notify_template_init(coap_notify_template_t *tpl,
+                                     const avs_coap_token_t *token,
+                                     uint8_t code,
+                                     uint16_t format);
+
+/**
+ * @returns true if @p tpl was initialized with given parameters, and thus may
+ *          be reused for a notification with them.
+ */
+bool _anjay_coap_notify_template_matches(const coap_notify_template_t *tpl,
+                                         const avs_coap_token_t *token,
+                                         uint8_t code,
+                                         uint16_t format);
+
+/**
+ * @returns Size of the buffer needed to build a notification from @p tpl with
+ *          given Observe option value and @p payload_size bytes of payload.
+ */
+size_t _anjay_coap_notify_template_msg_size(const coap_notify_template_t *tpl,
+                                            uint32_t observe,
+                                            size_t payload_size);
+
+/**
+ * Builds a notification from @p tpl into @p buffer .
+ *
+ * @returns Built message, or NULL if it would not fit in @p buffer_size bytes,
+ *          in which case it needs to be sent block-wise.
+ */
+const avs_coap_msg_t *
+_anjay_coap_notify_template_build(const coap_notify_template_t *tpl,
+                                  avs_coap_msg_type_t type,
+                                  uint16_t msg_id,
+                                  uint32_t observe,
+                                  const void *payload,
+                                  size_t payload_size,
+                                  avs_coap_aligned_msg_buffer_t *buffer,
+                                  size_t buffer_size);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif /* ANJAY_COAP_NOTIFY_TEMPLATE_H */
@@ -85,6 +85,39 @@ int _anjay_coap_client_setup_request(coap_client_t *client,
     return 0;
 }
 
+int _anjay_coap_client_setup_notification(coap_client_t *client,
+                                          coap_id_source_t *id_source,
+                                          const coap_notify_template_t *tpl,
+                                          avs_coap_msg_type_t type,
+                                          const avs_coap_token_t *token,
+                                          const void *payload,
+                                          size_t payload_size) {
+    if (client->state != COAP_CLIENT_STATE_RESET) {
+        coap_log(TRACE, "unexpected client state: %d", client->state);
+        return -1;
+    }
+
+    assert(_anjay_coap_out_is_reset(&client->common.out));
+    _anjay_coap_out_setup_mtu(&client->common.out, client->common.socket);
+
+    const uint32_t observe = _anjay_coap_common_timestamp();
+    if (!_anjay_coap_out_notification_fits(&client->common.out, tpl, observe,
+                                           payload_size)) {
+        coap_log(TRACE, "notification does not fit in a single message");
+        return -1;
+    }
+
+    avs_coap_msg_identity_t identity = _anjay_coap_id_source_get(id_source);
+    identity.token = *token;
+    _anjay_coap_out_setup_notification(&client->common.out, tpl, type,
+                                       identity.msg_id, observe,
+                                       payload, payload_size);
+
+    client->last_request_identity = identity;
+    client->state = COAP_CLIENT_STATE_HAS_REQUEST_HEADER;
+    return 0;
+}
+
 typedef enum check_result {
     CHECK_UNEXPECTED_CONFIRMABLE = -2,
     CHECK_INVALID_RESPONSE = -1,
@@ -222,7 +255,8 @@ static int accept_response_with_timeout(coap_client_t *client,
     int recv_result = -1;
     int result = _anjay_coap_common_recv_msg_with_timeout(
             client->common.coap_ctx, client->common.socket, &client->common.in,
-            &timeout, process_received, client, &recv_result);
+            client->common.msg_cache, &timeout, process_received, client,
+            &recv_result);
     if (result) {
         return result;
     }
@@ -278,6 +312,9 @@ static int send_confirmable_with_retry(coap_client_t *client,
         .retry_count = 0,
         .recv_timeout = AVS_TIME_DURATION_ZERO
     };
+#ifdef WITH_RTT_ESTIMATION
+    const avs_time_monotonic_t first_send_time = avs_time_monotonic_now();
+#endif // WITH_RTT_ESTIMATION
     int result;
     do {
         if ((result = send_and_update_retry_state(client, msg, &retry_state))) {
@@ -303,6 +340,15 @@ static int send_confirmable_with_retry(coap_client_t *client,
     if (result != 0) {
         client->state = COAP_CLIENT_STATE_HAS_REQUEST_HEADER;
     }
+#ifdef WITH_RTT_ESTIMATION
+    if (result == 0) {
+        client->common.has_rtt_sample = true;
+        client->common.rtt_sample =
+                avs_time_monotonic_diff(avs_time_monotonic_now(),
+                                        first_send_time);
+        client->common.rtt_sample_retransmissions = retry_state.retry_count - 1;
+    }
+#endif // WITH_RTT_ESTIMATION
 
     assert(client->state == COAP_CLIENT_STATE_HAS_REQUEST_HEADER
            || client->state == COAP_CLIENT_STATE_HAS_SEPARATE_ACK
@@ -334,6 +380,21 @@ int _anjay_coap_client_get_or_receive_msg(coap_client_t *client,
     return 0;
 }
 
+int _anjay_coap_client_build_request(coap_client_t *client,
+                                     const avs_coap_msg_t **out_msg) {
+    if (client->state != COAP_CLIENT_STATE_HAS_REQUEST_HEADER) {
+        coap_log(TRACE, "unexpected client state: %d", client->state);
+        return -1;
+    }
+    if (has_block_ctx(client)) {
+        coap_log(TRACE, "block-wise request already in progress");
+        return -1;
+    }
+
+    *out_msg = _anjay_coap_out_build_msg(&client->common.out);
+    return 0;
+}
+
 int _anjay_coap_client_finish_request(coap_client_t *client) {
     if (client->state != COAP_CLIENT_STATE_HAS_REQUEST_HEADER) {
         coap_log(TRACE, "unexpected client state: %d", client->state);
@@ -407,6 +468,11 @@ int _anjay_coap_client_write(coap_client_t *client,
     (void) client; (void) id_source;
     size_t bytes_written = 0;
 
+    if (client->common.out.prebuilt_msg) {
+        coap_log(ERROR, "notification payload is already set");
+        return -1;
+    }
+
     if (!has_block_ctx(client)) {
         bytes_written = _anjay_coap_out_write(&client->common.out,
                                               data, data_length);
@@ -90,6 +90,25 @@ _anjay_coap_client_setup_request(coap_client_t *client,
                                  const anjay_msg_details_t *details,
                                  const avs_coap_msg_identity_t *identity);
 
+/**
+ * Prepares an Observe notification built from a template, along with its
+ * payload - no further data may be written. A message ID is taken from
+ * @p id_source only if the notification fits in a single message.
+ *
+ * @returns
+ * - 0 on success,
+ * - a negative value in case of error, or if the notification does not fit in
+ *   a single message - in that case it has to be set up with
+ *   @ref _anjay_coap_client_setup_request instead.
+ */
+int _anjay_coap_client_setup_notification(coap_client_t *client,
+                                          coap_id_source_t *id_source,
+                                          const coap_notify_template_t *tpl,
+                                          avs_coap_msg_type_t type,
+                                          const avs_coap_token_t *token,
+                                          const void *payload,
+                                          size_t payload_size);
+
 #define COAP_CLIENT_RECEIVE_RESET 1
 
 /**
@@ -103,6 +122,17 @@ _anjay_coap_client_setup_request(coap_client_t *client,
 int _anjay_coap_client_get_or_receive_msg(coap_client_t *client,
                                           const avs_coap_msg_t **out_msg);
 
+/**
+ * Builds the prepared request without sending it.
+ *
+ * @returns
+ * - 0 on success,
+ * - a negative value if there is no prepared request or a block-wise transfer
+ *   has been started.
+ */
+int _anjay_coap_client_build_request(coap_client_t *client,
+                                     const avs_coap_msg_t **out_msg);
+
 /**
  * Sends the prepared request. If it's a Confirmable message, waits until
  * the server acknowledges it or retransmission limit is reached.
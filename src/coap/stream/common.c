@@ -103,6 +103,7 @@ static void set_socket_timeout(avs_net_abstract_socket_t *socket,
 int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
                                              avs_net_abstract_socket_t *socket,
                                              coap_input_buffer_t *in,
+                                             coap_msg_cache_t *msg_cache,
                                              avs_time_duration_t *inout_timeout,
                                              recv_msg_handler_t *handle_msg,
                                              void *handle_msg_data,
@@ -123,7 +124,7 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
     while (avs_time_duration_less(AVS_TIME_DURATION_ZERO, *inout_timeout)) {
         set_socket_timeout(socket, *inout_timeout);
 
-        result = _anjay_coap_in_get_next_message(in, ctx, socket);
+        result = _anjay_coap_in_get_next_message(in, ctx, socket, msg_cache);
         switch (result) {
         case AVS_COAP_CTX_ERR_TIMEOUT:
             *inout_timeout = AVS_TIME_DURATION_ZERO;
@@ -177,3 +178,64 @@ exit:
     assert(result <= 0);
     return result;
 }
+
+typedef struct {
+    char host[ANJAY_MAX_URL_HOSTNAME_SIZE];
+    char port[ANJAY_MAX_URL_PORT_SIZE];
+} remote_endpoint_t;
+
+static int get_remote_endpoint(avs_net_abstract_socket_t *socket,
+                               remote_endpoint_t *out_endpoint) {
+    if (avs_net_socket_get_remote_host(socket, out_endpoint->host,
+                                       sizeof(out_endpoint->host))
+            || avs_net_socket_get_remote_port(socket, out_endpoint->port,
+                                              sizeof(out_endpoint->port))) {
+        coap_log(DEBUG, "could not get remote endpoint of the socket");
+        return -1;
+    }
+    return 0;
+}
+
+void _anjay_coap_common_cache_response(coap_msg_cache_t *cache,
+                                       avs_coap_ctx_t *ctx,
+                                       avs_net_abstract_socket_t *socket,
+                                       const avs_coap_msg_t *msg) {
+    // only piggybacked responses (and empty ACKs) share the message ID with
+    // the request they respond to
+    if (!cache || avs_coap_msg_get_type(msg) != AVS_COAP_MSG_ACKNOWLEDGEMENT) {
+        return;
+    }
+
+    remote_endpoint_t endpoint;
+    if (!get_remote_endpoint(socket, &endpoint)) {
+        avs_coap_tx_params_t tx_params = avs_coap_ctx_get_tx_params(ctx);
+        _anjay_coap_msg_cache_add(cache, endpoint.host, endpoint.port, msg,
+                                  avs_coap_exchange_lifetime(&tx_params));
+    }
+}
+
+int _anjay_coap_common_resend_cached_response(coap_msg_cache_t *cache,
+                                              avs_coap_ctx_t *ctx,
+                                              avs_net_abstract_socket_t *socket,
+                                              const avs_coap_msg_t *request) {
+    if (!cache) {
+        return -1;
+    }
+
+    remote_endpoint_t endpoint;
+    if (get_remote_endpoint(socket, &endpoint)) {
+        return -1;
+    }
+
+    const avs_coap_msg_t *response = _anjay_coap_msg_cache_get(
+            cache, endpoint.host, endpoint.port, avs_coap_msg_get_id(request));
+    if (!response) {
+        return -1;
+    }
+
+    coap_log(DEBUG, "duplicate request, sending cached response");
+    if (avs_coap_ctx_send(ctx, socket, response)) {
+        coap_log(DEBUG, "could not send cached response");
+    }
+    return 0;
+}
@@ -20,6 +20,7 @@
 #include <avsystem/commons/coap/msg_builder.h>
 
 #include "../coap_stream.h"
+#include "../msg_cache.h"
 #include "in.h"
 #include "out.h"
 
@@ -35,6 +36,17 @@ typedef struct coap_stream_common {
 
     coap_input_buffer_t in;
     coap_output_buffer_t out;
+
+    // not owned; NULL if responses are not cached
+    coap_msg_cache_t *msg_cache;
+
+#ifdef WITH_RTT_ESTIMATION
+    // round-trip time of the last acknowledged Confirmable request, see
+    // _anjay_coap_stream_take_rtt_sample()
+    bool has_rtt_sample;
+    avs_time_duration_t rtt_sample;
+    unsigned rtt_sample_retransmissions;
+#endif // WITH_RTT_ESTIMATION
 } coap_stream_common_t;
 
 int _anjay_coap_common_fill_msg_info(avs_coap_msg_info_t *info,
@@ -70,6 +82,8 @@ typedef int recv_msg_handler_t(const avs_coap_msg_t *msg,
  * @param        coap_ctx           Context to use for CoAP message handling.
  * @param        socket             Socket to wait on.
  * @param        in                 Input buffer for the incoming message.
+ * @param        msg_cache          Cache of sent responses, used to answer
+ *                                  retransmitted requests. May be NULL.
  * @param[inout] inout_timeout      Maximum time to wait for a message. Will be
  *                                  decremented by the time spent waiting on the
  *                                  message.
@@ -88,6 +102,7 @@ typedef int recv_msg_handler_t(const avs_coap_msg_t *msg,
 int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
                                              avs_net_abstract_socket_t *socket,
                                              coap_input_buffer_t *in,
+                                             coap_msg_cache_t *msg_cache,
                                              avs_time_duration_t *inout_timeout,
                                              recv_msg_handler_t *handle_msg,
                                              void *handle_msg_data,
@@ -95,6 +110,27 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
 
 uint32_t _anjay_coap_common_timestamp(void);
 
+/**
+ * Stores @p msg sent through @p socket in @p cache , if it is a response.
+ * Does nothing if @p cache is NULL.
+ */
+void _anjay_coap_common_cache_response(coap_msg_cache_t *cache,
+                                       avs_coap_ctx_t *ctx,
+                                       avs_net_abstract_socket_t *socket,
+                                       const avs_coap_msg_t *msg);
+
+/**
+ * Looks up a response to @p request received from @p socket in @p cache and
+ * sends it again, if found.
+ *
+ * @returns 0 if the cached response was sent, a non-zero value if there was
+ *          none or @p cache is NULL.
+ */
+int _anjay_coap_common_resend_cached_response(coap_msg_cache_t *cache,
+                                              avs_coap_ctx_t *ctx,
+                                              avs_net_abstract_socket_t *socket,
+                                              const avs_coap_msg_t *request);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif // SRC_COAP_STREAM_COMMON_H
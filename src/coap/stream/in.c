@@ -34,7 +34,8 @@ VISIBILITY_SOURCE_BEGIN
 
 int _anjay_coap_in_get_next_message(coap_input_buffer_t *in,
                                     avs_coap_ctx_t *ctx,
-                                    avs_net_abstract_socket_t *socket) {
+                                    avs_net_abstract_socket_t *socket,
+                                    coap_msg_cache_t *msg_cache) {
     int result = avs_coap_ctx_recv(ctx, socket, (avs_coap_msg_t *) in->buffer,
                                    in->buffer_size);
     if (result) {
@@ -48,6 +49,11 @@ int _anjay_coap_in_get_next_message(coap_input_buffer_t *in,
     }
 
     const avs_coap_msg_t *msg = _anjay_coap_in_get_message(in);
+    if (avs_coap_msg_code_is_request(avs_coap_msg_get_code(msg))
+            && !_anjay_coap_common_resend_cached_response(msg_cache, ctx,
+                                                          socket, msg)) {
+        return AVS_COAP_CTX_ERR_DUPLICATE;
+    }
 
     in->payload_off = 0;
     in->payload = (const uint8_t *)avs_coap_msg_payload(msg);
@@ -21,6 +21,7 @@
 #include <stddef.h>
 
 #include "../../utils_core.h"
+#include "../msg_cache.h"
 
 #include <avsystem/commons/coap/msg.h>
 #include <avsystem/commons/coap/ctx.h>
@@ -73,11 +74,16 @@ _anjay_coap_in_get_payload_size(const coap_input_buffer_t *in) {
  * to @p in buffer being too small), then it responds with 413 Request Entity
  * Too Large to the sender.
  *
+ * If the message is a retransmitted request whose response is stored in
+ * @p msg_cache , that response is sent again and AVS_COAP_CTX_ERR_DUPLICATE is
+ * returned. @p msg_cache may be NULL.
+ *
  * @return 0 on success, one of AVS_COAP_SOCKET_ERR_* in case of failure
  */
 int _anjay_coap_in_get_next_message(coap_input_buffer_t *in,
                                     avs_coap_ctx_t *ctx,
-                                    avs_net_abstract_socket_t *socket);
+                                    avs_net_abstract_socket_t *socket,
+                                    coap_msg_cache_t *msg_cache);
 
 void _anjay_coap_in_read(coap_input_buffer_t *in,
                          size_t *out_bytes_read,
@@ -38,7 +38,8 @@ coap_output_buffer_t _anjay_coap_out_init(uint8_t *buffer,
         .buffer_capacity = buffer_capacity,
         .dgram_layer_mtu = buffer_capacity,
         .info = avs_coap_msg_info_init(),
-        .builder = AVS_COAP_MSG_BUILDER_UNINITIALIZED
+        .builder = AVS_COAP_MSG_BUILDER_UNINITIALIZED,
+        .prebuilt_msg = NULL
     };
 }
 
@@ -46,6 +47,7 @@ void _anjay_coap_out_reset(coap_output_buffer_t *out) {
     out->dgram_layer_mtu = out->buffer_capacity;
     avs_coap_msg_info_reset(&out->info);
     out->builder = AVS_COAP_MSG_BUILDER_UNINITIALIZED;
+    out->prebuilt_msg = NULL;
 }
 
 void _anjay_coap_out_setup_mtu(coap_output_buffer_t *out,
@@ -114,6 +116,31 @@ int _anjay_coap_out_setup_msg(coap_output_buffer_t *out,
             effective_buffer_capacity(out), &out->info);
 }
 
+bool _anjay_coap_out_notification_fits(coap_output_buffer_t *out,
+                                       const coap_notify_template_t *tpl,
+                                       uint32_t observe,
+                                       size_t payload_size) {
+    return _anjay_coap_notify_template_msg_size(tpl, observe, payload_size)
+            <= effective_buffer_capacity(out);
+}
+
+void _anjay_coap_out_setup_notification(coap_output_buffer_t *out,
+                                        const coap_notify_template_t *tpl,
+                                        avs_coap_msg_type_t type,
+                                        uint16_t msg_id,
+                                        uint32_t observe,
+                                        const void *payload,
+                                        size_t payload_size) {
+    assert(_anjay_coap_out_is_reset(out));
+    assert(_anjay_coap_out_notification_fits(out, tpl, observe, payload_size));
+
+    out->prebuilt_msg = _anjay_coap_notify_template_build(
+            tpl, type, msg_id, observe, payload, payload_size,
+            avs_coap_ensure_aligned_buffer(out->buffer),
+            effective_buffer_capacity(out));
+    assert(out->prebuilt_msg);
+}
+
 int _anjay_coap_out_update_msg_header(coap_output_buffer_t *out,
                                       const avs_coap_msg_identity_t *id,
                                       const avs_coap_block_info_t *block) {
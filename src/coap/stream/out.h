@@ -26,6 +26,7 @@
 #include <avsystem/commons/coap/ctx.h>
 
 #include "../coap_stream.h"
+#include "../notify_template.h"
 
 #ifndef ANJAY_COAP_STREAM_INTERNALS
 #error "Headers from coap/stream are not meant to be included from outside"
@@ -51,6 +52,10 @@ typedef struct coap_output_buffer {
 
     avs_coap_msg_info_t info;
     avs_coap_msg_builder_t builder;
+
+    // complete message built without the builder, see
+    // _anjay_coap_out_setup_notification()
+    const avs_coap_msg_t *prebuilt_msg;
 } coap_output_buffer_t;
 
 coap_output_buffer_t _anjay_coap_out_init(uint8_t *payload_buffer,
@@ -77,7 +82,8 @@ void _anjay_coap_out_setup_mtu(coap_output_buffer_t *out,
  * @returns true if the buffer does not contain any data yet, false otherwise.
  */
 static inline bool _anjay_coap_out_is_reset(coap_output_buffer_t *out) {
-    return !avs_coap_msg_builder_is_initialized(&out->builder);
+    return !out->prebuilt_msg
+            && !avs_coap_msg_builder_is_initialized(&out->builder);
 }
 
 /**
@@ -93,6 +99,39 @@ int _anjay_coap_out_setup_msg(coap_output_buffer_t *out,
                               const anjay_msg_details_t *details,
                               const avs_coap_block_info_t *block);
 
+/**
+ * @returns true if a notification built from @p tpl , with given Observe
+ *          option value and @p payload_size bytes of payload, fits in the
+ *          buffer as a single message.
+ */
+bool _anjay_coap_out_notification_fits(coap_output_buffer_t *out,
+                                       const coap_notify_template_t *tpl,
+                                       uint32_t observe,
+                                       size_t payload_size);
+
+/**
+ * Builds a complete Observe notification from a template, with its payload.
+ * Unlike @ref _anjay_coap_out_setup_msg , no payload may be written afterwards.
+ *
+ * NOTE: The notification has to fit in the buffer, as checked with
+ * @ref _anjay_coap_out_notification_fits .
+ *
+ * @param out          Buffer to operate on.
+ * @param tpl          Template of the notification.
+ * @param type         Message type.
+ * @param msg_id       Message ID.
+ * @param observe      Value of the Observe option.
+ * @param payload      Payload of the notification.
+ * @param payload_size Number of bytes of payload.
+ */
+void _anjay_coap_out_setup_notification(coap_output_buffer_t *out,
+                                        const coap_notify_template_t *tpl,
+                                        avs_coap_msg_type_t type,
+                                        uint16_t msg_id,
+                                        uint32_t observe,
+                                        const void *payload,
+                                        size_t payload_size);
+
 /**
  * Resets message ID, token and acknowledged BLOCK option for the message being
  * constructed.
@@ -125,6 +164,9 @@ size_t _anjay_coap_out_write(coap_output_buffer_t *out,
 
 static inline const avs_coap_msg_t *
 _anjay_coap_out_build_msg(coap_output_buffer_t *out) {
+    if (out->prebuilt_msg) {
+        return out->prebuilt_msg;
+    }
     return avs_coap_msg_builder_get_msg(&out->builder);
 }
 
@@ -172,6 +172,11 @@ int _anjay_coap_server_finish_response(coap_server_t *server) {
                 _anjay_coap_out_build_msg(&server->common.out);
         result = avs_coap_ctx_send(server->common.coap_ctx,
                                    server->common.socket, msg);
+        if (!result) {
+            _anjay_coap_common_cache_response(server->common.msg_cache,
+                                              server->common.coap_ctx,
+                                              server->common.socket, msg);
+        }
     }
     return result;
 }
@@ -229,14 +234,15 @@ static process_result_t process_initial_request(coap_server_t *server,
                                                 const avs_coap_msg_t *msg) {
     assert(is_server_reset(server));
 
-    avs_coap_msg_type_t type = avs_coap_msg_get_type(msg);
-    if (!avs_coap_msg_is_request(msg)
-            // incoming Reset may still require some kind of reaction,
-            // so it should be handled by upper layers
-            && type != AVS_COAP_MSG_RESET) {
-        coap_log(DEBUG, "invalid request: %s",
+    if (!avs_coap_msg_is_request(msg)) {
+        // incoming Reset may still require some kind of reaction, and other
+        // messages may be responses to requests sent asynchronously, so they
+        // should be handled by upper layers
+        coap_log(TRACE, "not a request: %s",
                  AVS_COAP_CODE_STRING(avs_coap_msg_get_code(msg)));
-        return PROCESS_INITIAL_INVALID_REQUEST;
+        server->state = COAP_SERVER_STATE_HAS_REQUEST;
+        server->request_identity = avs_coap_msg_get_identity(msg);
+        return PROCESS_INITIAL_OK;
     }
 
     avs_coap_block_info_t block1;
@@ -292,7 +298,8 @@ static process_result_t process_initial_request(coap_server_t *server,
 static int receive_request(coap_server_t *server) {
     int result = _anjay_coap_in_get_next_message(&server->common.in,
                                                  server->common.coap_ctx,
-                                                 server->common.socket);
+                                                 server->common.socket,
+                                                 server->common.msg_cache);
     if (result == AVS_COAP_CTX_ERR_MSG_TOO_LONG) {
         const avs_coap_msg_t *partial_msg =
                 (avs_coap_msg_t *) server->common.in.buffer;
@@ -514,9 +521,11 @@ static int send_continue(coap_server_t *server,
     const avs_coap_msg_t *msg = avs_coap_msg_build_without_payload(
             avs_coap_ensure_aligned_buffer(storage),
             storage_size, &info);
-    if (msg) {
-        result = avs_coap_ctx_send(server->common.coap_ctx,
-                                   server->common.socket, msg);
+    if (msg && !(result = avs_coap_ctx_send(server->common.coap_ctx,
+                                            server->common.socket, msg))) {
+        _anjay_coap_common_cache_response(server->common.msg_cache,
+                                          server->common.coap_ctx,
+                                          server->common.socket, msg);
     }
 
     free(storage);
@@ -568,8 +577,8 @@ static int receive_next_block_with_timeout(coap_server_t *server) {
         int recv_result = -1;
         int result = _anjay_coap_common_recv_msg_with_timeout(
                 server->common.coap_ctx, server->common.socket,
-                &server->common.in, &timeout, receive_next_block, server,
-                &recv_result);
+                &server->common.in, server->common.msg_cache, &timeout,
+                receive_next_block, server, &recv_result);
         if (result) {
             return result;
         }
@@ -343,6 +343,30 @@ int _anjay_coap_stream_set_tx_params(
     return 0;
 }
 
+void _anjay_coap_stream_set_msg_cache(avs_stream_abstract_t *stream_,
+                                      coap_msg_cache_t *cache) {
+    coap_stream_t *stream = (coap_stream_t*) stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+    stream->data.common.msg_cache = cache;
+}
+
+#ifdef WITH_RTT_ESTIMATION
+int _anjay_coap_stream_take_rtt_sample(avs_stream_abstract_t *stream_,
+                                       avs_time_duration_t *out_rtt,
+                                       unsigned *out_retransmissions) {
+    coap_stream_t *stream = (coap_stream_t*) stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+    coap_stream_common_t *common = &stream->data.common;
+    if (!common->has_rtt_sample) {
+        return -1;
+    }
+    *out_rtt = common->rtt_sample;
+    *out_retransmissions = common->rtt_sample_retransmissions;
+    common->has_rtt_sample = false;
+    return 0;
+}
+#endif // WITH_RTT_ESTIMATION
+
 int _anjay_coap_stream_setup_response(avs_stream_abstract_t *stream,
                                       const anjay_msg_details_t *details) {
     const anjay_coap_stream_ext_t *coap = (const anjay_coap_stream_ext_t *)
@@ -355,12 +379,7 @@ int _anjay_coap_stream_setup_response(avs_stream_abstract_t *stream,
     return -1;
 }
 
-int _anjay_coap_stream_setup_request(
-        avs_stream_abstract_t *stream_,
-        const anjay_msg_details_t *details,
-        const avs_coap_token_t *token) {
-    coap_stream_t *stream = (coap_stream_t*)stream_;
-    assert(stream->vtable == &COAP_STREAM_VTABLE);
+static int become_requesting_client(coap_stream_t *stream) {
     switch (stream->state) {
     case STREAM_STATE_SERVER:
         coap_log(ERROR, "setup_request called while in SERVER state");
@@ -376,6 +395,19 @@ int _anjay_coap_stream_setup_request(
     }
 
     become_client(stream);
+    return 0;
+}
+
+int _anjay_coap_stream_setup_request(
+        avs_stream_abstract_t *stream_,
+        const anjay_msg_details_t *details,
+        const avs_coap_token_t *token) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+    int result = become_requesting_client(stream);
+    if (result) {
+        return result;
+    }
 
     avs_coap_msg_identity_t identity =
             _anjay_coap_id_source_get(stream->id_source);
@@ -383,7 +415,6 @@ int _anjay_coap_stream_setup_request(
         identity.token = *token;
     }
 
-    int result;
     if ((result = _anjay_coap_client_setup_request(get_client(stream),
                                                    details, &identity))) {
         reset(stream);
@@ -391,6 +422,27 @@ int _anjay_coap_stream_setup_request(
     return result;
 }
 
+int _anjay_coap_stream_setup_notification(avs_stream_abstract_t *stream_,
+                                          const coap_notify_template_t *tpl,
+                                          avs_coap_msg_type_t type,
+                                          const avs_coap_token_t *token,
+                                          const void *payload,
+                                          size_t payload_size) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+    int result = become_requesting_client(stream);
+    if (result) {
+        return result;
+    }
+
+    if ((result = _anjay_coap_client_setup_notification(
+            get_client(stream), stream->id_source, tpl, type, token,
+            payload, payload_size))) {
+        reset(stream);
+    }
+    return result;
+}
+
 int _anjay_coap_stream_set_error(avs_stream_abstract_t *stream_,
                                  uint8_t code) {
     coap_stream_t *stream = (coap_stream_t*)stream_;
@@ -405,6 +457,20 @@ int _anjay_coap_stream_set_error(avs_stream_abstract_t *stream_,
     return 0;
 }
 
+int _anjay_coap_stream_build_request(avs_stream_abstract_t *stream_,
+                                     const avs_coap_msg_t **out_msg) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+
+    if (stream->state != STREAM_STATE_CLIENT) {
+        coap_log(ERROR, "build_request only makes sense on a client mode "
+                 "stream");
+        return -1;
+    }
+
+    return _anjay_coap_client_build_request(get_client(stream), out_msg);
+}
+
 int _anjay_coap_stream_get_incoming_msg(avs_stream_abstract_t *stream_,
                                         const avs_coap_msg_t **out_msg) {
     coap_stream_t *stream = (coap_stream_t*)stream_;
@@ -31,6 +31,9 @@
 #include "../stream/stream_internal.h"
 #include "../block/response.h"
 #include "../block/transfer_impl.h"
+#include "../id_source/static.h"
+
+#include "utils.h"
 
 typedef struct test_ctx {
     avs_net_abstract_socket_t *mocksock;
@@ -195,3 +198,159 @@ AVS_UNIT_TEST(block_response, considers_buffer_size) {
                 4096),
             0);
 }
+
+typedef struct {
+    test_ctx_t test;
+    coap_id_source_t *id_source;
+    coap_block_transfer_ctx_t *ctx;
+} renegotiation_env_t;
+
+static renegotiation_env_t renegotiation_setup(uint16_t max_block_size) {
+    renegotiation_env_t env = {
+        .test = setup(4096, 4096)
+    };
+
+    avs_coap_msg_identity_t id = AVS_COAP_MSG_IDENTITY_EMPTY;
+    anjay_msg_details_t details = {
+        .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+        .msg_code = AVS_COAP_CODE_CONTENT,
+        .format = AVS_COAP_FORMAT_NONE
+    };
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_out_setup_msg(&coap_stream(&env.test)->data.common.out,
+                                      &id, &details, NULL));
+    env.id_source = _anjay_coap_id_source_new_static(&id);
+    AVS_UNIT_ASSERT_NOT_NULL(env.id_source);
+    env.ctx = _anjay_coap_block_response_new(
+            max_block_size, &coap_stream(&env.test)->data.common,
+            env.id_source, NULL);
+    AVS_UNIT_ASSERT_NOT_NULL(env.ctx);
+    AVS_UNIT_ASSERT_EQUAL(env.ctx->block.size, max_block_size);
+    return env;
+}
+
+static void renegotiation_teardown(renegotiation_env_t *env) {
+    _anjay_coap_block_transfer_delete(&env->ctx);
+    _anjay_coap_id_source_release(&env->id_source);
+    teardown(&env->test);
+}
+
+// 200 bytes; every 16-byte chunk is distinct, so that a block sent from a wrong
+// offset does not go unnoticed
+#define RENEGOTIATION_PAYLOAD \
+    "A123456789abcdefB123456789abcdefC123456789abcdefD123456789abcdef" \
+    "E123456789abcdefF123456789abcdefG123456789abcdefH123456789abcdef" \
+    "I123456789abcdefJ123456789abcdefK123456789abcdefL123456789abcdef" \
+    "M1234567"
+
+static void expect_block(renegotiation_env_t *env,
+                         uint16_t msg_id,
+                         uint32_t seq_num,
+                         uint16_t size) {
+    const avs_coap_msg_t *msg =
+            COAP_MSG(ACK, CONTENT, ID(msg_id),
+                     BLOCK2(seq_num, size, RENEGOTIATION_PAYLOAD));
+    avs_unit_mocksock_expect_output(env->test.mocksock,
+                                    &msg->content, msg->length);
+}
+
+static void request_block(renegotiation_env_t *env,
+                          uint16_t msg_id,
+                          uint32_t seq_num,
+                          uint16_t size) {
+    const avs_coap_msg_t *msg =
+            COAP_MSG(CON, GET, ID(msg_id), BLOCK2(seq_num, size));
+    avs_unit_mocksock_input(env->test.mocksock, &msg->content, msg->length);
+}
+
+static void send_renegotiation_payload(renegotiation_env_t *env) {
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_coap_block_transfer_write(
+            env->ctx, RENEGOTIATION_PAYLOAD,
+            sizeof(RENEGOTIATION_PAYLOAD) - 1));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_coap_block_transfer_finish(env->ctx));
+    avs_unit_mocksock_assert_expects_met(env->test.mocksock);
+}
+
+AVS_UNIT_TEST(block_response, size_renegotiation_mid_transfer_next_block) {
+    renegotiation_env_t env = renegotiation_setup(64);
+    expect_block(&env, 0, 0, 64);
+    request_block(&env, 1, 1, 64);
+    expect_block(&env, 1, 1, 64);
+    // block 1 (64 B) sent; client asks for the next one using 16 B blocks:
+    // bytes 128-143 are expected
+    request_block(&env, 2, 8, 16);
+    expect_block(&env, 2, 8, 16);
+    for (uint32_t seq_num = 9; seq_num * 16 < 200; ++seq_num) {
+        request_block(&env, (uint16_t) (seq_num - 6), seq_num, 16);
+        expect_block(&env, (uint16_t) (seq_num - 6), seq_num, 16);
+    }
+    send_renegotiation_payload(&env);
+    renegotiation_teardown(&env);
+}
+
+AVS_UNIT_TEST(block_response, size_renegotiation_mid_transfer_repeat_block) {
+    renegotiation_env_t env = renegotiation_setup(64);
+    expect_block(&env, 0, 0, 64);
+    request_block(&env, 1, 1, 64);
+    expect_block(&env, 1, 1, 64);
+    // block 1 (64 B) sent; client asks for it again using 16 B blocks:
+    // bytes 64-79 are expected
+    request_block(&env, 2, 4, 16);
+    expect_block(&env, 2, 4, 16);
+    for (uint32_t seq_num = 5; seq_num * 16 < 200; ++seq_num) {
+        request_block(&env, (uint16_t) (seq_num - 2), seq_num, 16);
+        expect_block(&env, (uint16_t) (seq_num - 2), seq_num, 16);
+    }
+    send_renegotiation_payload(&env);
+    renegotiation_teardown(&env);
+}
+
+static void expect_remote_endpoint(renegotiation_env_t *env) {
+    avs_unit_mocksock_expect_remote_host(env->test.mocksock, "127.0.0.1");
+    avs_unit_mocksock_expect_remote_port(env->test.mocksock, "5683");
+}
+
+AVS_UNIT_TEST(block_response, duplicate_request_answered_from_cache) {
+    renegotiation_env_t env = renegotiation_setup(64);
+    coap_msg_cache_t *cache = _anjay_coap_msg_cache_create(4096);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+    env.ctx->msg_cache = cache;
+
+    expect_block(&env, 0, 0, 64);
+    expect_remote_endpoint(&env); // block 0 cached
+    // the ACK with block 0 got lost, so the request is retransmitted while
+    // the transfer waits for a request for block 1
+    request_block(&env, 0, 0, 64);
+    expect_remote_endpoint(&env); // cache lookup - hit
+    expect_block(&env, 0, 0, 64);
+    for (uint32_t seq_num = 1; seq_num * 64 < 200; ++seq_num) {
+        request_block(&env, (uint16_t) seq_num, seq_num, 64);
+        expect_remote_endpoint(&env); // cache lookup - miss
+        expect_block(&env, (uint16_t) seq_num, seq_num, 64);
+        expect_remote_endpoint(&env); // block cached
+    }
+    send_renegotiation_payload(&env);
+
+    const coap_msg_cache_stats_t stats =
+            _anjay_coap_msg_cache_get_stats(cache);
+    AVS_UNIT_ASSERT_EQUAL(stats.hits, 1);
+    AVS_UNIT_ASSERT_EQUAL(stats.misses, 3);
+    renegotiation_teardown(&env);
+    _anjay_coap_msg_cache_release(&cache);
+}
+
+AVS_UNIT_TEST(block_response, size_renegotiation_mid_transfer_misaligned) {
+    // block 2 (1024 B) sent; 256 B block 10 is in the middle of it
+    renegotiation_env_t env = renegotiation_setup(1024);
+    env.ctx->block.seq_num = 2;
+    const avs_coap_msg_t *last_response =
+            COAP_MSG(ACK, CONTENT, ID(1), BLOCK2(2, 1024));
+    bool wait_for_next = true;
+    uint8_t error_code = 0;
+    AVS_UNIT_ASSERT_FAILED(env.ctx->block_recv_handler(
+            env.ctx->block_recv_handler_arg,
+            COAP_MSG(CON, GET, ID(2), BLOCK2(10, 256)), last_response, env.ctx,
+            &wait_for_next, &error_code));
+    AVS_UNIT_ASSERT_EQUAL(env.ctx->block.size, 1024);
+    renegotiation_teardown(&env);
+}
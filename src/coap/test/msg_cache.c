@@ -0,0 +1,176 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay_test/mock_clock.h>
+
+#include "../../utils_core.h"
+#include "../msg_cache.h"
+
+#include "utils.h"
+
+#define LIFETIME avs_time_duration_from_scalar(247, AVS_TIME_S)
+
+static void assert_msg_equal(const avs_coap_msg_t *expected,
+                             const avs_coap_msg_t *actual) {
+    AVS_UNIT_ASSERT_NOT_NULL(actual);
+    AVS_UNIT_ASSERT_EQUAL(expected->length, actual->length);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(expected->content, actual->content,
+                                      expected->length);
+}
+
+static size_t entry_size(const avs_coap_msg_t *msg) {
+    coap_msg_cache_t *cache = _anjay_coap_msg_cache_create(4096);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_msg_cache_add(cache, "host", "port", msg, LIFETIME));
+    const size_t size = _anjay_coap_msg_cache_get_stats(cache).bytes_used;
+    _anjay_coap_msg_cache_release(&cache);
+    return size;
+}
+
+AVS_UNIT_TEST(coap_msg_cache, zero_capacity) {
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_create(0));
+}
+
+AVS_UNIT_TEST(coap_msg_cache, hit_and_miss) {
+    coap_msg_cache_t *cache = _anjay_coap_msg_cache_create(4096);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+
+    const avs_coap_msg_t *msg =
+            COAP_MSG(ACK, CONTENT, ID(1, "tok"), PAYLOAD("content"));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_msg_cache_add(cache, "host", "5683", msg, LIFETIME));
+
+    assert_msg_equal(msg, _anjay_coap_msg_cache_get(cache, "host", "5683", 1));
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_get(cache, "host", "5683", 2));
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_get(cache, "host", "5684", 1));
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_get(cache, "host5", "683", 1));
+
+    const coap_msg_cache_stats_t stats =
+            _anjay_coap_msg_cache_get_stats(cache);
+    AVS_UNIT_ASSERT_EQUAL(stats.hits, 1);
+    AVS_UNIT_ASSERT_EQUAL(stats.misses, 3);
+    AVS_UNIT_ASSERT_EQUAL(stats.evictions, 0);
+    AVS_UNIT_ASSERT_TRUE(stats.bytes_used > 0);
+    AVS_UNIT_ASSERT_TRUE(stats.bytes_used <= stats.capacity);
+
+    _anjay_coap_msg_cache_release(&cache);
+    AVS_UNIT_ASSERT_NULL(cache);
+}
+
+AVS_UNIT_TEST(coap_msg_cache, newest_entry_shadows_older_one) {
+    coap_msg_cache_t *cache = _anjay_coap_msg_cache_create(4096);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+
+    const avs_coap_msg_t *old_msg =
+            COAP_MSG(ACK, CONTENT, ID(1, "tok"), PAYLOAD("old"));
+    const avs_coap_msg_t *new_msg =
+            COAP_MSG(ACK, CONTENT, ID(1, "tok"), PAYLOAD("new"));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_msg_cache_add(cache, "host", "port", old_msg,
+                                      LIFETIME));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_msg_cache_add(cache, "host", "port", new_msg,
+                                      LIFETIME));
+    assert_msg_equal(new_msg,
+                     _anjay_coap_msg_cache_get(cache, "host", "port", 1));
+
+    _anjay_coap_msg_cache_release(&cache);
+}
+
+AVS_UNIT_TEST(coap_msg_cache, too_big) {
+    const avs_coap_msg_t *msg =
+            COAP_MSG(ACK, CONTENT, ID(1), PAYLOAD("content"));
+    coap_msg_cache_t *cache =
+            _anjay_coap_msg_cache_create(entry_size(msg) - 1);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+    AVS_UNIT_ASSERT_FAILED(
+            _anjay_coap_msg_cache_add(cache, "host", "port", msg, LIFETIME));
+    AVS_UNIT_ASSERT_EQUAL(_anjay_coap_msg_cache_get_stats(cache).bytes_used, 0);
+    _anjay_coap_msg_cache_release(&cache);
+}
+
+AVS_UNIT_TEST(coap_msg_cache, evicts_oldest_and_wraps_around) {
+    const avs_coap_msg_t *msgs[] = {
+        COAP_MSG(ACK, CONTENT, ID(1), PAYLOAD("first")),
+        COAP_MSG(ACK, CONTENT, ID(2), PAYLOAD("secnd")),
+        COAP_MSG(ACK, CONTENT, ID(3), PAYLOAD("third")),
+        COAP_MSG(ACK, CONTENT, ID(4), PAYLOAD("forth"))
+    };
+    const size_t size = entry_size(msgs[0]);
+
+    // room for two and a half entries
+    coap_msg_cache_t *cache = _anjay_coap_msg_cache_create(size * 5 / 2);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(msgs); ++i) {
+        AVS_UNIT_ASSERT_SUCCESS(
+                _anjay_coap_msg_cache_add(cache, "host", "port", msgs[i],
+                                          LIFETIME));
+    }
+
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_get(cache, "host", "port", 1));
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_get(cache, "host", "port", 2));
+    assert_msg_equal(msgs[2],
+                     _anjay_coap_msg_cache_get(cache, "host", "port", 3));
+    assert_msg_equal(msgs[3],
+                     _anjay_coap_msg_cache_get(cache, "host", "port", 4));
+
+    const coap_msg_cache_stats_t stats =
+            _anjay_coap_msg_cache_get_stats(cache);
+    AVS_UNIT_ASSERT_EQUAL(stats.evictions, 2);
+    AVS_UNIT_ASSERT_EQUAL(stats.bytes_used, 2 * size);
+
+    _anjay_coap_msg_cache_release(&cache);
+}
+
+AVS_UNIT_TEST(coap_msg_cache, expired_entries) {
+    _anjay_mock_clock_start(avs_time_monotonic_from_scalar(100, AVS_TIME_S));
+
+    coap_msg_cache_t *cache = _anjay_coap_msg_cache_create(4096);
+    AVS_UNIT_ASSERT_NOT_NULL(cache);
+
+    const avs_coap_msg_t *first =
+            COAP_MSG(ACK, CONTENT, ID(1), PAYLOAD("first"));
+    const avs_coap_msg_t *second =
+            COAP_MSG(ACK, CONTENT, ID(2), PAYLOAD("second"));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_msg_cache_add(cache, "host", "port", first, LIFETIME));
+
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(246, AVS_TIME_S));
+    assert_msg_equal(first,
+                     _anjay_coap_msg_cache_get(cache, "host", "port", 1));
+
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_S));
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_msg_cache_get(cache, "host", "port", 1));
+
+    // expired entries are dropped, not evicted
+    const size_t first_size = _anjay_coap_msg_cache_get_stats(cache).bytes_used;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_msg_cache_add(cache, "host", "port", second, LIFETIME));
+    const coap_msg_cache_stats_t stats =
+            _anjay_coap_msg_cache_get_stats(cache);
+    AVS_UNIT_ASSERT_EQUAL(stats.evictions, 0);
+    AVS_UNIT_ASSERT_TRUE(stats.bytes_used >= first_size);
+    AVS_UNIT_ASSERT_TRUE(stats.bytes_used < 2 * first_size);
+
+    _anjay_coap_msg_cache_release(&cache);
+    _anjay_mock_clock_finish();
+}
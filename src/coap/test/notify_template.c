@@ -0,0 +1,148 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <avsystem/commons/unit/test.h>
+
+#include "../../utils_core.h"
+#include "../content_format.h"
+
+#include "utils.h"
+
+typedef union {
+    avs_max_align_t align;
+    uint8_t bytes[256];
+} msg_buffer_t;
+
+#define TOKEN(Bytes) \
+    ((const avs_coap_token_t) { sizeof(Bytes) - 1, Bytes })
+
+static const avs_coap_msg_t *build_expected(msg_buffer_t *buffer,
+                                            avs_coap_msg_type_t type,
+                                            uint8_t code,
+                                            const avs_coap_msg_identity_t *id,
+                                            uint32_t observe,
+                                            uint16_t format,
+                                            const char *payload) {
+    avs_coap_msg_info_t info = avs_coap_msg_info_init();
+    info.type = type;
+    info.code = code;
+    info.identity = *id;
+    AVS_UNIT_ASSERT_SUCCESS(
+            avs_coap_msg_info_opt_u32(&info, AVS_COAP_OPT_OBSERVE, observe));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_content_format(&info,
+                                                                 format));
+
+    avs_coap_msg_builder_t builder;
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_builder_init(
+            &builder, avs_coap_ensure_aligned_buffer(buffer), sizeof(*buffer),
+            &info));
+    AVS_UNIT_ASSERT_EQUAL(avs_coap_msg_builder_payload(&builder, payload,
+                                                       strlen(payload)),
+                          strlen(payload));
+    avs_coap_msg_info_reset(&info);
+    return avs_coap_msg_builder_get_msg(&builder);
+}
+
+static void assert_same_as_built_from_info(avs_coap_msg_type_t type,
+                                           uint8_t code,
+                                           const avs_coap_msg_identity_t *id,
+                                           uint32_t observe,
+                                           uint16_t format,
+                                           const char *payload) {
+    coap_notify_template_t tpl;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_coap_notify_template_init(&tpl, &id->token, code, format));
+    AVS_UNIT_ASSERT_TRUE(
+            _anjay_coap_notify_template_matches(&tpl, &id->token, code,
+                                                format));
+
+    msg_buffer_t expected_buffer;
+    const avs_coap_msg_t *expected = build_expected(
+            &expected_buffer, type, code, id, observe, format, payload);
+
+    msg_buffer_t actual_buffer;
+    const avs_coap_msg_t *actual = _anjay_coap_notify_template_build(
+            &tpl, type, id->msg_id, observe, payload, strlen(payload),
+            avs_coap_ensure_aligned_buffer(&actual_buffer),
+            sizeof(actual_buffer));
+    AVS_UNIT_ASSERT_NOT_NULL(actual);
+    AVS_UNIT_ASSERT_EQUAL(
+            _anjay_coap_notify_template_msg_size(&tpl, observe,
+                                                 strlen(payload)),
+            offsetof(avs_coap_msg_t, header) + actual->length);
+    AVS_UNIT_ASSERT_EQUAL(actual->length, expected->length);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(&actual->header, &expected->header,
+                                      expected->length);
+}
+
+AVS_UNIT_TEST(coap_notify_template, same_as_built_from_info) {
+    const avs_coap_msg_identity_t id = { 0x1234, TOKEN("token") };
+    assert_same_as_built_from_info(AVS_COAP_MSG_NON_CONFIRMABLE,
+                                   AVS_COAP_CODE_CONTENT, &id, 0x123456,
+                                   ANJAY_COAP_FORMAT_PLAINTEXT, "42");
+    assert_same_as_built_from_info(AVS_COAP_MSG_CONFIRMABLE,
+                                   AVS_COAP_CODE_CONTENT, &id, 0x12,
+                                   ANJAY_COAP_FORMAT_TLV, "\xC1\x00\x2A");
+    assert_same_as_built_from_info(AVS_COAP_MSG_NON_CONFIRMABLE,
+                                   AVS_COAP_CODE_CONTENT, &id, 0,
+                                   AVS_COAP_FORMAT_NONE, "");
+}
+
+AVS_UNIT_TEST(coap_notify_template, empty_token) {
+    const avs_coap_msg_identity_t id = { 0, TOKEN("") };
+    assert_same_as_built_from_info(AVS_COAP_MSG_CONFIRMABLE,
+                                   AVS_COAP_CODE_CONTENT, &id, 0x1234,
+                                   ANJAY_COAP_FORMAT_JSON, "{}");
+}
+
+AVS_UNIT_TEST(coap_notify_template, matches) {
+    const avs_coap_token_t token = TOKEN("token");
+    coap_notify_template_t tpl;
+    memset(&tpl, 0, sizeof(tpl));
+    AVS_UNIT_ASSERT_FALSE(_anjay_coap_notify_template_matches(
+            &tpl, &token, AVS_COAP_CODE_CONTENT, ANJAY_COAP_FORMAT_TLV));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_coap_notify_template_init(
+            &tpl, &token, AVS_COAP_CODE_CONTENT, ANJAY_COAP_FORMAT_TLV));
+    AVS_UNIT_ASSERT_TRUE(_anjay_coap_notify_template_matches(
+            &tpl, &token, AVS_COAP_CODE_CONTENT, ANJAY_COAP_FORMAT_TLV));
+    AVS_UNIT_ASSERT_FALSE(_anjay_coap_notify_template_matches(
+            &tpl, &token, AVS_COAP_CODE_CONTENT, ANJAY_COAP_FORMAT_JSON));
+    AVS_UNIT_ASSERT_FALSE(_anjay_coap_notify_template_matches(
+            &tpl, &token, AVS_COAP_CODE_NOT_FOUND, ANJAY_COAP_FORMAT_TLV));
+    AVS_UNIT_ASSERT_FALSE(_anjay_coap_notify_template_matches(
+            &tpl, &TOKEN("tokem"), AVS_COAP_CODE_CONTENT,
+            ANJAY_COAP_FORMAT_TLV));
+    AVS_UNIT_ASSERT_FALSE(_anjay_coap_notify_template_matches(
+            &tpl, &TOKEN("toke"), AVS_COAP_CODE_CONTENT,
+            ANJAY_COAP_FORMAT_TLV));
+}
+
+AVS_UNIT_TEST(coap_notify_template, too_small_buffer) {
+    const avs_coap_token_t token = TOKEN("token");
+    coap_notify_template_t tpl;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_coap_notify_template_init(
+            &tpl, &token, AVS_COAP_CODE_CONTENT, ANJAY_COAP_FORMAT_PLAINTEXT));
+
+    const size_t size = _anjay_coap_notify_template_msg_size(&tpl, 1, 4);
+    msg_buffer_t buffer;
+    AVS_UNIT_ASSERT_NULL(_anjay_coap_notify_template_build(
+            &tpl, AVS_COAP_MSG_NON_CONFIRMABLE, 0, 1, "1234", 4,
+            avs_coap_ensure_aligned_buffer(&buffer), size - 1));
+    AVS_UNIT_ASSERT_NOT_NULL(_anjay_coap_notify_template_build(
+            &tpl, AVS_COAP_MSG_NON_CONFIRMABLE, 0, 1, "1234", 4,
+            avs_coap_ensure_aligned_buffer(&buffer), size));
+}
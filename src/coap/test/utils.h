@@ -186,6 +186,26 @@ coap_msg__(avs_coap_aligned_msg_buffer_t *buf,
     .payload = (Payload), \
     .payload_size = sizeof(Payload) - 1,
 
+/**
+ * Used in COAP_MSG to define BLOCK1 option, and optionally add block payload.
+ * Arguments are the same as for BLOCK2.
+ */
+#define BLOCK1(Seq, Size, ... /* Payload */) \
+    .block1 = { \
+        .type = AVS_COAP_BLOCK1, \
+        .valid = true, \
+        .seq_num = (assert((Seq) < (1 << 23)), (uint32_t)(Seq)), \
+        .size = (assert((Size) < (1 << 15)), (uint16_t)(Size)), \
+        .has_more = ((Seq + 1) * (Size) + 1 < sizeof("" __VA_ARGS__)) \
+    }, \
+    .block2 = {}, \
+    .payload = ((const uint8_t*)("" __VA_ARGS__)) + (Seq) * (Size), \
+    .payload_size = sizeof("" __VA_ARGS__) == sizeof("") \
+            ? 0 \
+            : ((((Seq) + 1) * (Size) + 1 < sizeof("" __VA_ARGS__)) \
+                ? (Size) \
+                : (sizeof("" __VA_ARGS__) - 1 - (Seq) * (Size)))
+
 /**
  * Used in COAP_MSG to define BLOCK2 option, and optionally add block payload.
  * @p Seq     - the block sequence number.
@@ -92,13 +92,72 @@ bool _anjay_dm_handler_implemented(anjay_t *anjay,
     return get_handler(anjay, obj_ptr, current_module, handler_offset) != NULL;
 }
 
+#ifdef WITH_DM_STATS
+
+#define DM_HANDLER_KIND_object_read_default_attrs \
+        ANJAY_DM_HANDLER_OBJECT_READ_DEFAULT_ATTRS
+#define DM_HANDLER_KIND_object_write_default_attrs \
+        ANJAY_DM_HANDLER_OBJECT_WRITE_DEFAULT_ATTRS
+#define DM_HANDLER_KIND_instance_it ANJAY_DM_HANDLER_INSTANCE_IT
+#define DM_HANDLER_KIND_instance_present ANJAY_DM_HANDLER_INSTANCE_PRESENT
+#define DM_HANDLER_KIND_instance_list ANJAY_DM_HANDLER_INSTANCE_LIST
+#define DM_HANDLER_KIND_instance_reset ANJAY_DM_HANDLER_INSTANCE_RESET
+#define DM_HANDLER_KIND_instance_create ANJAY_DM_HANDLER_INSTANCE_CREATE
+#define DM_HANDLER_KIND_instance_remove ANJAY_DM_HANDLER_INSTANCE_REMOVE
+#define DM_HANDLER_KIND_instance_read_default_attrs \
+        ANJAY_DM_HANDLER_INSTANCE_READ_DEFAULT_ATTRS
+#define DM_HANDLER_KIND_instance_write_default_attrs \
+        ANJAY_DM_HANDLER_INSTANCE_WRITE_DEFAULT_ATTRS
+#define DM_HANDLER_KIND_resource_present ANJAY_DM_HANDLER_RESOURCE_PRESENT
+#define DM_HANDLER_KIND_resource_operations ANJAY_DM_HANDLER_RESOURCE_OPERATIONS
+#define DM_HANDLER_KIND_resource_read ANJAY_DM_HANDLER_RESOURCE_READ
+#define DM_HANDLER_KIND_instance_read_all ANJAY_DM_HANDLER_INSTANCE_READ_ALL
+#define DM_HANDLER_KIND_resource_write ANJAY_DM_HANDLER_RESOURCE_WRITE
+#define DM_HANDLER_KIND_resource_execute ANJAY_DM_HANDLER_RESOURCE_EXECUTE
+#define DM_HANDLER_KIND_resource_dim ANJAY_DM_HANDLER_RESOURCE_DIM
+#define DM_HANDLER_KIND_resource_read_attrs ANJAY_DM_HANDLER_RESOURCE_READ_ATTRS
+#define DM_HANDLER_KIND_resource_write_attrs \
+        ANJAY_DM_HANDLER_RESOURCE_WRITE_ATTRS
+#define DM_HANDLER_KIND_transaction_begin ANJAY_DM_HANDLER_TRANSACTION_BEGIN
+#define DM_HANDLER_KIND_transaction_validate \
+        ANJAY_DM_HANDLER_TRANSACTION_VALIDATE
+#define DM_HANDLER_KIND_transaction_commit ANJAY_DM_HANDLER_TRANSACTION_COMMIT
+#define DM_HANDLER_KIND_transaction_rollback \
+        ANJAY_DM_HANDLER_TRANSACTION_ROLLBACK
+
+/**
+ * Calls are only accounted for when made directly by the library, i.e. with
+ * no current module - time spent in handlers called by overlay modules is
+ * already included in the measurement of the outermost call.
+ */
+#define CALL_HANDLER(Anjay, ObjPtr, Current, Handler, HandlerName, ...) \
+    do { \
+        if (Current) { \
+            return (Handler)->HandlerName(__VA_ARGS__); \
+        } \
+        avs_time_monotonic_t handler_start_time = avs_time_monotonic_now(); \
+        int handler_result = (Handler)->HandlerName(__VA_ARGS__); \
+        _anjay_dm_stats_record((Anjay), (*(ObjPtr))->oid, \
+                               DM_HANDLER_KIND_##HandlerName, \
+                               handler_start_time); \
+        return handler_result; \
+    } while (0)
+
+#else // WITH_DM_STATS
+
+#define CALL_HANDLER(Anjay, ObjPtr, Current, Handler, HandlerName, ...) \
+    return (Handler)->HandlerName(__VA_ARGS__)
+
+#endif // WITH_DM_STATS
+
 #define CHECKED_TAIL_CALL_HANDLER(Anjay, ObjPtr, Current, HandlerName, ...) \
     do { \
         const anjay_dm_handlers_t *handler = \
                 get_handler((Anjay), (ObjPtr), (Current), \
                             offsetof(anjay_dm_handlers_t, HandlerName)); \
         if (handler) { \
-            return handler->HandlerName(__VA_ARGS__); \
+            CALL_HANDLER((Anjay), (ObjPtr), (Current), handler, HandlerName, \
+                         __VA_ARGS__); \
         } else { \
             anjay_log(ERROR, #HandlerName " handler not set for object /%u", \
                       (*(ObjPtr))->oid); \
@@ -128,11 +187,171 @@ int _anjay_dm_object_write_default_attrs(anjay_t *anjay,
                               anjay, obj_ptr, ssid, &attrs->standard);
 }
 
+/**
+ * Returns the handler set providing instance_list, but only if it is not
+ * shadowed by a handler at the given offset implemented in a different layer
+ * (e.g. an overlay wrapping instance_it) - in that case the latter needs to be
+ * called instead.
+ */
+static const anjay_dm_handlers_t *
+get_instance_list_handler(anjay_t *anjay,
+                          const anjay_dm_object_def_t *const *obj_ptr,
+                          const anjay_dm_module_t *current_module,
+                          size_t replaced_handler_offset) {
+    const anjay_dm_handlers_t *list_handler =
+            get_handler(anjay, obj_ptr, current_module,
+                        offsetof(anjay_dm_handlers_t, instance_list));
+    if (list_handler) {
+        const anjay_dm_handlers_t *replaced_handler =
+                get_handler(anjay, obj_ptr, current_module,
+                            replaced_handler_offset);
+        if (replaced_handler && replaced_handler != list_handler) {
+            return NULL;
+        }
+    }
+    return list_handler;
+}
+
+static int invoke_instance_list(anjay_t *anjay,
+                                const anjay_dm_object_def_t *const *obj_ptr,
+                                const anjay_dm_handlers_t *handler,
+                                const anjay_iid_t **out_iids,
+                                size_t *out_count,
+                                const anjay_dm_module_t *current_module) {
+    (void) current_module;
+    CALL_HANDLER(anjay, obj_ptr, current_module, handler, instance_list,
+                 anjay, obj_ptr, out_iids, out_count);
+}
+
+#ifndef NDEBUG
+static bool iids_strictly_ascending(const anjay_iid_t *iids, size_t count) {
+    for (size_t i = 1; i < count; ++i) {
+        if (iids[i] <= iids[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif // NDEBUG
+
+static int call_instance_list(anjay_t *anjay,
+                              const anjay_dm_object_def_t *const *obj_ptr,
+                              const anjay_dm_handlers_t *handler,
+                              const anjay_iid_t **out_iids,
+                              size_t *out_count,
+                              const anjay_dm_module_t *current_module) {
+    dm_log(TRACE, "instance_list /%u", (*obj_ptr)->oid);
+    *out_iids = NULL;
+    *out_count = 0;
+    int result = invoke_instance_list(anjay, obj_ptr, handler, out_iids,
+                                      out_count, current_module);
+    if (!result && *out_count && !*out_iids) {
+        dm_log(ERROR, "instance_list /%u returned NULL array of %lu elements",
+               (*obj_ptr)->oid, (unsigned long) *out_count);
+        return ANJAY_ERR_INTERNAL;
+    }
+#ifndef NDEBUG
+    // checking the order takes linear time, which would defeat the purpose of
+    // binary search in instance_present_from_list(), so it is debug-only
+    if (!result && !iids_strictly_ascending(*out_iids, *out_count)) {
+        dm_log(ERROR, "instance_list /%u is not strictly ascending",
+               (*obj_ptr)->oid);
+        return ANJAY_ERR_INTERNAL;
+    }
+#endif // NDEBUG
+    return result;
+}
+
+bool _anjay_dm_instance_list_usable(anjay_t *anjay,
+                                    const anjay_dm_object_def_t *const *obj_ptr,
+                                    const anjay_dm_module_t *current_module) {
+    return get_instance_list_handler(anjay, obj_ptr, current_module,
+                                     offsetof(anjay_dm_handlers_t,
+                                              instance_it)) != NULL;
+}
+
+int _anjay_dm_instance_list(anjay_t *anjay,
+                            const anjay_dm_object_def_t *const *obj_ptr,
+                            const anjay_iid_t **out_iids,
+                            size_t *out_count,
+                            const anjay_dm_module_t *current_module) {
+    const anjay_dm_handlers_t *handler =
+            get_instance_list_handler(anjay, obj_ptr, current_module,
+                                      offsetof(anjay_dm_handlers_t,
+                                               instance_it));
+    if (!handler) {
+        anjay_log(ERROR, "instance_list handler not usable for object /%u",
+                  (*obj_ptr)->oid);
+        return ANJAY_ERR_METHOD_NOT_ALLOWED;
+    }
+    return call_instance_list(anjay, obj_ptr, handler, out_iids, out_count,
+                              current_module);
+}
+
+static int instance_it_from_list(anjay_t *anjay,
+                                 const anjay_dm_object_def_t *const *obj_ptr,
+                                 const anjay_dm_handlers_t *handler,
+                                 anjay_iid_t *out,
+                                 void **cookie,
+                                 const anjay_dm_module_t *current_module) {
+    const anjay_iid_t *iids;
+    size_t count;
+    int result = call_instance_list(anjay, obj_ptr, handler, &iids, &count,
+                                    current_module);
+    if (result) {
+        return result;
+    }
+    size_t index = (size_t) (uintptr_t) *cookie;
+    if (index < count) {
+        *out = iids[index];
+        *cookie = (void *) (uintptr_t) (index + 1);
+    } else {
+        *out = ANJAY_IID_INVALID;
+    }
+    return 0;
+}
+
+static int
+instance_present_from_list(anjay_t *anjay,
+                           const anjay_dm_object_def_t *const *obj_ptr,
+                           const anjay_dm_handlers_t *handler,
+                           anjay_iid_t iid,
+                           const anjay_dm_module_t *current_module) {
+    const anjay_iid_t *iids;
+    size_t count;
+    int result = call_instance_list(anjay, obj_ptr, handler, &iids, &count,
+                                    current_module);
+    if (result) {
+        return result;
+    }
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (iids[mid] < iid) {
+            lo = mid + 1;
+        } else if (iids[mid] > iid) {
+            hi = mid;
+        } else {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 int _anjay_dm_instance_it(anjay_t *anjay,
                           const anjay_dm_object_def_t *const *obj_ptr,
                           anjay_iid_t *out,
                           void **cookie,
                           const anjay_dm_module_t *current_module) {
+    const anjay_dm_handlers_t *list_handler =
+            get_instance_list_handler(anjay, obj_ptr, current_module,
+                                      offsetof(anjay_dm_handlers_t,
+                                               instance_it));
+    if (list_handler) {
+        return instance_it_from_list(anjay, obj_ptr, list_handler, out, cookie,
+                                     current_module);
+    }
     dm_log(TRACE, "instance_it /%u", (*obj_ptr)->oid);
     CHECKED_TAIL_CALL_HANDLER(anjay, obj_ptr, current_module,
                               instance_it, anjay, obj_ptr, out, cookie);
@@ -155,6 +374,14 @@ int _anjay_dm_instance_present(anjay_t *anjay,
                                const anjay_dm_object_def_t *const *obj_ptr,
                                anjay_iid_t iid,
                                const anjay_dm_module_t *current_module) {
+    const anjay_dm_handlers_t *list_handler =
+            get_instance_list_handler(anjay, obj_ptr, current_module,
+                                      offsetof(anjay_dm_handlers_t,
+                                               instance_present));
+    if (list_handler) {
+        return instance_present_from_list(anjay, obj_ptr, list_handler, iid,
+                                          current_module);
+    }
     dm_log(TRACE, "instance_present /%u/%u", (*obj_ptr)->oid, iid);
     CHECKED_TAIL_CALL_HANDLER(anjay, obj_ptr, current_module,
                               instance_present, anjay, obj_ptr, iid);
@@ -285,6 +512,62 @@ int _anjay_dm_resource_read(anjay_t *anjay,
                               resource_read, anjay, obj_ptr, iid, rid, ctx);
 }
 
+/**
+ * Returns the handler set providing instance_read_all, but only if none of the
+ * per-Resource handlers it replaces is implemented in a different layer (e.g.
+ * an overlay wrapping resource_present) - in that case the per-Resource
+ * handlers need to be called instead, so that the overlay sees every call.
+ */
+static const anjay_dm_handlers_t *
+get_instance_read_all_handler(anjay_t *anjay,
+                              const anjay_dm_object_def_t *const *obj_ptr,
+                              const anjay_dm_module_t *current_module) {
+    static const size_t REPLACED_HANDLER_OFFSETS[] = {
+        offsetof(anjay_dm_handlers_t, resource_present),
+        offsetof(anjay_dm_handlers_t, resource_operations),
+        offsetof(anjay_dm_handlers_t, resource_read)
+    };
+    const anjay_dm_handlers_t *read_all_handler =
+            get_handler(anjay, obj_ptr, current_module,
+                        offsetof(anjay_dm_handlers_t, instance_read_all));
+    for (size_t i = 0; read_all_handler
+                       && i < AVS_ARRAY_SIZE(REPLACED_HANDLER_OFFSETS); ++i) {
+        const anjay_dm_handlers_t *replaced_handler =
+                get_handler(anjay, obj_ptr, current_module,
+                            REPLACED_HANDLER_OFFSETS[i]);
+        if (replaced_handler && replaced_handler != read_all_handler) {
+            return NULL;
+        }
+    }
+    return read_all_handler;
+}
+
+bool _anjay_dm_instance_read_all_usable(
+        anjay_t *anjay,
+        const anjay_dm_object_def_t *const *obj_ptr,
+        const anjay_dm_module_t *current_module) {
+    return get_instance_read_all_handler(anjay, obj_ptr,
+                                         current_module) != NULL;
+}
+
+int _anjay_dm_instance_read_all(anjay_t *anjay,
+                                const anjay_dm_object_def_t *const *obj_ptr,
+                                anjay_iid_t iid,
+                                anjay_output_ctx_t *ctx,
+                                const anjay_dm_module_t *current_module) {
+    anjay_log(TRACE, "instance_read_all /%u/%u", (*obj_ptr)->oid, iid);
+    const anjay_dm_handlers_t *handler =
+            get_instance_read_all_handler(anjay, obj_ptr, current_module);
+    if (!handler) {
+        anjay_log(ERROR,
+                  "instance_read_all handler not usable for object /%u",
+                  (*obj_ptr)->oid);
+        return ANJAY_ERR_METHOD_NOT_ALLOWED;
+    }
+    CALL_HANDLER(anjay, obj_ptr, current_module, handler, instance_read_all,
+                 anjay, obj_ptr, iid, ctx);
+}
+
 int _anjay_dm_resource_write(anjay_t *anjay,
                              const anjay_dm_object_def_t *const *obj_ptr,
                              anjay_iid_t iid,
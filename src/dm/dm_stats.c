@@ -0,0 +1,108 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "../anjay_core.h"
+#include "dm_stats.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+#ifdef WITH_DM_STATS
+
+static AVS_LIST(anjay_dm_object_stats_t) *
+find_object_stats_ptr(anjay_t *anjay, anjay_oid_t oid) {
+    AVS_LIST(anjay_dm_object_stats_t) *it;
+    AVS_LIST_FOREACH_PTR(it, &anjay->dm.stats) {
+        if ((*it)->oid >= oid) {
+            break;
+        }
+    }
+    return it;
+}
+
+void _anjay_dm_stats_record(anjay_t *anjay,
+                            anjay_oid_t oid,
+                            anjay_dm_handler_kind_t kind,
+                            avs_time_monotonic_t start_time) {
+    avs_time_duration_t elapsed =
+            avs_time_monotonic_diff(avs_time_monotonic_now(), start_time);
+    assert((size_t) kind < ANJAY_DM_HANDLER_KIND_COUNT);
+
+    AVS_LIST(anjay_dm_object_stats_t) *stats_ptr =
+            find_object_stats_ptr(anjay, oid);
+    if (!*stats_ptr || (*stats_ptr)->oid != oid) {
+        AVS_LIST(anjay_dm_object_stats_t) new_stats =
+                AVS_LIST_NEW_ELEMENT(anjay_dm_object_stats_t);
+        if (!new_stats) {
+            anjay_log(ERROR, "out of memory");
+            return;
+        }
+        new_stats->oid = oid;
+        AVS_LIST_INSERT(stats_ptr, new_stats);
+    }
+
+    anjay_dm_handler_stats_t *stats = &(*stats_ptr)->handlers[kind];
+    ++stats->call_count;
+    stats->total_time = avs_time_duration_add(stats->total_time, elapsed);
+    if (avs_time_duration_less(stats->max_time, elapsed)) {
+        stats->max_time = elapsed;
+    }
+}
+
+void _anjay_dm_stats_cleanup(anjay_t *anjay) {
+    AVS_LIST_CLEAR(&anjay->dm.stats);
+}
+
+#endif // WITH_DM_STATS
+
+int anjay_get_dm_handler_stats(anjay_t *anjay,
+                               anjay_oid_t oid,
+                               anjay_dm_handler_kind_t kind,
+                               anjay_dm_handler_stats_t *out_stats) {
+#ifdef WITH_DM_STATS
+    if ((size_t) kind >= ANJAY_DM_HANDLER_KIND_COUNT) {
+        anjay_log(ERROR, "invalid handler kind: %d", (int) kind);
+        return -1;
+    }
+    AVS_LIST(anjay_dm_object_stats_t) *stats_ptr =
+            find_object_stats_ptr(anjay, oid);
+    if (*stats_ptr && (*stats_ptr)->oid == oid) {
+        *out_stats = (*stats_ptr)->handlers[kind];
+    } else {
+        memset(out_stats, 0, sizeof(*out_stats));
+    }
+    return 0;
+#else
+    (void) anjay;
+    (void) oid;
+    (void) kind;
+    (void) out_stats;
+    anjay_log(ERROR, "data model statistics support disabled");
+    return -1;
+#endif
+}
+
+void anjay_reset_dm_handler_stats(anjay_t *anjay) {
+#ifdef WITH_DM_STATS
+    _anjay_dm_stats_cleanup(anjay);
+#else
+    (void) anjay;
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ANJAY_DM_STATS_H
+#define ANJAY_DM_STATS_H
+
+#include <avsystem/commons/list.h>
+#include <avsystem/commons/time.h>
+
+#include <anjay/stats.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+#ifdef WITH_DM_STATS
+
+#define ANJAY_DM_HANDLER_KIND_COUNT \
+        ((size_t) ANJAY_DM_HANDLER_TRANSACTION_ROLLBACK + 1)
+
+typedef struct {
+    anjay_oid_t oid;
+    anjay_dm_handler_stats_t handlers[ANJAY_DM_HANDLER_KIND_COUNT];
+} anjay_dm_object_stats_t;
+
+/**
+ * Accounts a single call to a data model handler that started at
+ * @p start_time and has just returned.
+ */
+void _anjay_dm_stats_record(anjay_t *anjay,
+                            anjay_oid_t oid,
+                            anjay_dm_handler_kind_t kind,
+                            avs_time_monotonic_t start_time);
+
+void _anjay_dm_stats_cleanup(anjay_t *anjay);
+
+#else // WITH_DM_STATS
+
+#define _anjay_dm_stats_cleanup(Anjay) ((void) 0)
+
+#endif // WITH_DM_STATS
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif // ANJAY_DM_STATS_H
@@ -24,7 +24,6 @@
 
 #include <anjay/core.h>
 #include <avsystem/commons/stream.h>
-#include <avsystem/commons/stream/stream_membuf.h>
 #include <avsystem/commons/stream_v_table.h>
 #include <avsystem/commons/utils.h>
 
@@ -212,6 +211,7 @@ void _anjay_dm_cleanup(anjay_t *anjay) {
     }
 
     AVS_LIST_CLEAR(&anjay->dm.objects);
+    _anjay_dm_stats_cleanup(anjay);
 }
 
 const anjay_dm_object_def_t *const *
@@ -389,6 +389,9 @@ static int read_instance(anjay_t *anjay,
                          const anjay_dm_object_def_t *const *obj,
                          anjay_iid_t iid,
                          anjay_output_ctx_t *out_ctx) {
+    if (_anjay_dm_instance_read_all_usable(anjay, obj, NULL)) {
+        return _anjay_dm_instance_read_all(anjay, obj, iid, out_ctx, NULL);
+    }
     for (size_t i = 0; i < (*obj)->supported_rids.count; ++i) {
         int result = ensure_resource_present(anjay, obj, iid,
                                              (*obj)->supported_rids.rids[i]);
@@ -406,15 +409,41 @@ static int read_instance(anjay_t *anjay,
     return 0;
 }
 
+static int measure_instance(anjay_t *anjay,
+                            const anjay_dm_object_def_t *const *obj,
+                            anjay_iid_t iid,
+                            size_t *out_size) {
+    int size_ctx_errno = 0;
+    anjay_output_ctx_t *size_ctx =
+            _anjay_output_tlv_size_ctx_create(&size_ctx_errno);
+    if (!size_ctx) {
+        return ANJAY_ERR_INTERNAL;
+    }
+    int result = read_instance(anjay, obj, iid, size_ctx);
+    *out_size = _anjay_output_tlv_size(size_ctx);
+    _anjay_output_ctx_destroy(&size_ctx);
+    return result;
+}
+
 static int read_instance_wrapped(anjay_t *anjay,
                                  const anjay_dm_object_def_t *const *obj,
                                  anjay_iid_t iid,
+                                 bool two_pass,
                                  anjay_output_ctx_t *out_ctx) {
-    int result = _anjay_output_set_id(out_ctx, ANJAY_ID_IID, iid);
+    size_t instance_size = 0;
+    int result = 0;
+    if (two_pass) {
+        result = measure_instance(anjay, obj, iid, &instance_size);
+    }
+    if (!result) {
+        result = _anjay_output_set_id(out_ctx, ANJAY_ID_IID, iid);
+    }
     if (result) {
         return result;
     }
-    anjay_output_ctx_t *instance_ctx = _anjay_output_object_start(out_ctx);
+    anjay_output_ctx_t *instance_ctx =
+            two_pass ? _anjay_output_object_start_sized(out_ctx, instance_size)
+                     : _anjay_output_object_start(out_ctx);
     if (!instance_ctx) {
         return ANJAY_ERR_INTERNAL;
     }
@@ -438,6 +467,14 @@ static int read_object(anjay_t *anjay,
         .action = ANJAY_ACTION_READ
     };
 
+    /* the output context used for Object reads is TLV unless another format has
+     * been explicitly requested */
+    bool two_pass = anjay->two_pass_tlv_object_reads
+            && (details->requested_format == AVS_COAP_FORMAT_NONE
+                    || _anjay_translate_legacy_content_format(
+                            details->requested_format)
+                            == ANJAY_COAP_FORMAT_TLV);
+
     while (!result
             && !(result = _anjay_dm_instance_it(anjay, obj, &iid, &cookie,
                                                 NULL))
@@ -446,7 +483,7 @@ static int read_object(anjay_t *anjay,
         if (!_anjay_access_control_action_allowed(anjay, &info)) {
             continue;
         }
-        result = read_instance_wrapped(anjay, obj, iid, out_ctx);
+        result = read_instance_wrapped(anjay, obj, iid, two_pass, out_ctx);
     }
     return result;
 }
@@ -464,12 +501,19 @@ dm_read_spawn_ctx(avs_stream_abstract_t *stream,
             ret = _anjay_handle_requested_format(&requested_format,
                                                  ANJAY_COAP_FORMAT_JSON);
         }
+#endif
+#ifdef WITH_SENML_CBOR
+        if (ret) {
+            ret = _anjay_handle_requested_format(&requested_format,
+                                                 ANJAY_COAP_FORMAT_SENML_CBOR);
+        }
 #endif
         if (ret) {
             *errno_ptr = ret;
             anjay_log(ERROR,
                       "Got option: Accept: %" PRIu16 ", but reads on "
-                      "non-resource paths only support TLV and JSON formats",
+                      "non-resource paths only support TLV, JSON and SenML "
+                      "CBOR formats",
                       details->requested_format);
             return NULL;
         }
@@ -1436,46 +1480,97 @@ int _anjay_dm_res_read(anjay_t *anjay,
     return result;
 }
 
-struct anjay_dm_multires_read_ctx_struct {
-    anjay_input_ctx_t *input_ctx;
-};
-
-static avs_stream_abstract_t *
-read_tlv_to_membuf(anjay_t *anjay, const anjay_uri_path_t *path) {
+int _anjay_dm_res_read_values(anjay_t *anjay,
+                              const anjay_uri_path_t *path,
+                              anjay_output_value_handler_t *handler,
+                              void *handler_arg,
+                              char *bytes_buffer,
+                              size_t bytes_buffer_size) {
     ASSERT_RESOURCE_PATH(*path);
-    const anjay_dm_object_def_t * const *obj =
+    const anjay_dm_object_def_t *const *obj =
             _anjay_dm_find_object_by_oid(anjay, path->oid);
     if (!obj) {
         anjay_log(ERROR, "unregistered Object ID: %u", path->oid);
-        return NULL;
+        return -1;
     }
-    avs_stream_abstract_t *membuf = avs_stream_membuf_create();
-    if (!membuf) {
-        return NULL;
+
+    anjay_output_value_ctx_t ctx =
+            _anjay_output_value_ctx_init(handler, handler_arg,
+                                         bytes_buffer, bytes_buffer_size);
+    int result = ensure_resource_supported_and_present(
+            anjay, obj, path->iid, path->rid);
+    if (!result) {
+        result = read_resource_internal(anjay, obj, path->iid, path->rid,
+                                        (anjay_output_ctx_t *) &ctx);
     }
-    anjay_output_ctx_t *out = _anjay_output_raw_tlv_create(membuf);
-    if (!out || read_resource(anjay, obj, path->iid, path->rid, out)) {
-        avs_stream_cleanup(&membuf);
+    if (!result && (ctx.in_array || !ctx.value_returned)) {
+        anjay_log(ERROR, "no complete value returned for %s",
+                  ANJAY_DEBUG_MAKE_PATH(path));
+        result = -1;
     }
-    _anjay_output_ctx_destroy(&out);
-    return membuf;
+    return result;
 }
 
-anjay_input_ctx_t *
-_anjay_dm_read_as_input_ctx(anjay_t *anjay, const anjay_uri_path_t *path) {
-    ASSERT_RESOURCE_PATH(*path);
-    avs_stream_abstract_t *membuf = read_tlv_to_membuf(anjay, path);
-    if (!membuf) {
-        return NULL;
+static int store_i64_value(void *out, const anjay_output_value_t *value) {
+    if (value->is_array_element || value->type != ANJAY_OUTPUT_VALUE_INT) {
+        return -1;
     }
-    anjay_input_ctx_t *out = NULL;
-    if (_anjay_input_tlv_create(&out, &membuf, true)) {
-        anjay_log(ERROR, "could not create the input context");
-        avs_stream_cleanup(&membuf);
-        return NULL;
+    *(int64_t *) out = value->value.i;
+    return 0;
+}
+
+int _anjay_dm_res_read_i64(anjay_t *anjay,
+                           const anjay_uri_path_t *path,
+                           int64_t *out_value) {
+    return _anjay_dm_res_read_values(anjay, path, store_i64_value, out_value,
+                                     NULL, 0);
+}
+
+static int store_bool_value(void *out, const anjay_output_value_t *value) {
+    if (value->is_array_element || value->type != ANJAY_OUTPUT_VALUE_BOOL) {
+        return -1;
     }
-    assert(!membuf);
-    return out;
+    *(bool *) out = value->value.b;
+    return 0;
+}
+
+int _anjay_dm_res_read_bool(anjay_t *anjay,
+                            const anjay_uri_path_t *path,
+                            bool *out_value) {
+    return _anjay_dm_res_read_values(anjay, path, store_bool_value, out_value,
+                                     NULL, 0);
+}
+
+typedef struct {
+    char *buffer;
+    size_t buffer_size;
+} string_value_buffer_t;
+
+static int store_string_value(void *out_, const anjay_output_value_t *value) {
+    string_value_buffer_t *out = (string_value_buffer_t *) out_;
+    if (value->is_array_element
+            || (value->type != ANJAY_OUTPUT_VALUE_STRING
+                    && value->type != ANJAY_OUTPUT_VALUE_BYTES)
+            || value->value.bytes.size >= out->buffer_size) {
+        return -1;
+    }
+    // opaque data is already gathered in out->buffer, hence memmove()
+    memmove(out->buffer, value->value.bytes.data, value->value.bytes.size);
+    out->buffer[value->value.bytes.size] = '\0';
+    return 0;
+}
+
+int _anjay_dm_res_read_string(anjay_t *anjay,
+                              const anjay_uri_path_t *path,
+                              char *buffer,
+                              size_t buffer_size) {
+    assert(buffer && buffer_size > 0);
+    string_value_buffer_t out = {
+        .buffer = buffer,
+        .buffer_size = buffer_size
+    };
+    return _anjay_dm_res_read_values(anjay, path, store_string_value, &out,
+                                     buffer, buffer_size - 1);
 }
 
 anjay_ssid_t _anjay_dm_current_ssid(anjay_t *anjay) {
@@ -28,6 +28,8 @@
 #include "coap/coap_stream.h"
 #include "observe_core.h"
 #include "dm/dm_attributes.h"
+#include "dm/dm_stats.h"
+#include "io_core.h"
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
@@ -39,6 +41,9 @@ typedef struct {
 struct anjay_dm {
     AVS_LIST(const anjay_dm_object_def_t *const *) objects;
     AVS_LIST(anjay_dm_installed_module_t) modules;
+#ifdef WITH_DM_STATS
+    AVS_LIST(anjay_dm_object_stats_t) stats;
+#endif // WITH_DM_STATS
 };
 
 void _anjay_dm_cleanup(anjay_t *anjay);
@@ -55,51 +60,6 @@ typedef struct {
     anjay_dm_internal_res_attrs_t values;
 } anjay_request_attributes_t;
 
-static inline bool _anjay_double_attr_equal(double left, double right) {
-    return isnan(left) ? isnan(right) : (left == right);
-}
-
-static inline bool
-_anjay_request_attributes_equal(const anjay_request_attributes_t *left,
-                                const anjay_request_attributes_t *right) {
-    return (left->has_min_period
-                    ? (right->has_min_period
-                            && left->values.standard.common.min_period
-                                    == right->values.standard.common.min_period)
-                    : !right->has_min_period)
-            && (left->has_max_period
-                    ? (right->has_max_period
-                            && left->values.standard.common.max_period
-                                    == right->values.standard.common.max_period)
-                    : !right->has_max_period)
-            && (left->has_greater_than
-                    ? (right->has_greater_than
-                            && _anjay_double_attr_equal(
-                                    left->values.standard.greater_than,
-                                    right->values.standard.greater_than))
-                    : !right->has_greater_than)
-            && (left->has_less_than
-                    ? (right->has_less_than
-                            && _anjay_double_attr_equal(
-                                    left->values.standard.less_than,
-                                    right->values.standard.less_than))
-                    : !right->has_less_than)
-            && (left->has_step
-                    ? (right->has_step
-                            && _anjay_double_attr_equal(
-                                    left->values.standard.step,
-                                    right->values.standard.step))
-                    : !right->has_step)
-#ifdef WITH_CON_ATTR
-            && (left->custom.has_con
-                    ? (right->custom.has_con
-                            && left->values.custom.data.con
-                                    == right->values.custom.data.con)
-                    : !right->custom.has_con)
-#endif // WITH_CON_ATTR
-            ;
-}
-
 typedef struct {
     avs_coap_msg_type_t msg_type;
     uint8_t request_code;
@@ -116,20 +76,6 @@ typedef struct {
     anjay_request_attributes_t attributes;
 } anjay_request_t;
 
-static inline bool _anjay_request_equal(const anjay_request_t *left,
-                                        const anjay_request_t *right) {
-    return left->msg_type == right->msg_type
-            && left->request_code == right->request_code
-            && left->is_bs_uri == right->is_bs_uri
-            && _anjay_uri_path_equal(&left->uri, &right->uri)
-            && left->action == right->action
-            && left->content_format == right->content_format
-            && left->requested_format == right->requested_format
-            && left->observe == right->observe
-            && _anjay_request_attributes_equal(&left->attributes,
-                                               &right->attributes);
-}
-
 typedef struct {
     anjay_ssid_t ssid;
     uint16_t request_msg_id;
@@ -179,8 +125,18 @@ int _anjay_dm_perform_action(anjay_t *anjay,
                              const avs_coap_msg_identity_t *request_identity,
                              const anjay_request_t *request);
 
-anjay_input_ctx_t *_anjay_dm_read_as_input_ctx(anjay_t *anjay,
-                                               const anjay_uri_path_t *path);
+/**
+ * Reads a Resource, passing each value returned by the read handler to
+ * @p handler without any intermediate serialization. For Multiple Resources,
+ * @p handler is called once per Resource Instance. Opaque values are gathered
+ * in @p bytes_buffer, which may be NULL if they are not expected.
+ */
+int _anjay_dm_res_read_values(anjay_t *anjay,
+                              const anjay_uri_path_t *path,
+                              anjay_output_value_handler_t *handler,
+                              void *handler_arg,
+                              char *bytes_buffer,
+                              size_t bytes_buffer_size);
 
 const char *_anjay_debug_make_path__(char *buffer,
                                      size_t buffer_size,
@@ -35,6 +35,13 @@
 
 VISIBILITY_SOURCE_BEGIN
 
+/** Request Bootstrap is retried with exponential backoff, starting with
+ * REQUEST_BOOTSTRAP_BACKOFF_INITIAL_DELAY_S seconds and capped at
+ * REQUEST_BOOTSTRAP_BACKOFF_MAX_DELAY_S seconds. The backoff is reset once
+ * the Bootstrap Server acknowledges the request. */
+#define REQUEST_BOOTSTRAP_BACKOFF_INITIAL_DELAY_S 3
+#define REQUEST_BOOTSTRAP_BACKOFF_MAX_DELAY_S 120
+
 static void cancel_client_initiated_bootstrap(anjay_t *anjay) {
     _anjay_sched_del(anjay->sched,
                      &anjay->bootstrap.client_initiated_bootstrap_handle);
@@ -623,13 +630,7 @@ int _anjay_bootstrap_perform_action(anjay_t *anjay,
     return invoke_action(anjay, request);
 }
 
-static int check_request_bootstrap_response(avs_stream_abstract_t *stream) {
-    const avs_coap_msg_t *response;
-    if (_anjay_coap_stream_get_incoming_msg(stream, &response)) {
-        anjay_log(ERROR, "could not get response");
-        return -1;
-    }
-
+static int check_request_bootstrap_response(const avs_coap_msg_t *response) {
     const uint8_t code = avs_coap_msg_get_code(response);
     if (code != AVS_COAP_CODE_CHANGED) {
         anjay_log(ERROR, "server responded with %s (expected %s)",
@@ -641,6 +642,40 @@ static int check_request_bootstrap_response(avs_stream_abstract_t *stream) {
     return 0;
 }
 
+static int schedule_request_bootstrap(anjay_t *anjay, int64_t holdoff_s);
+
+static int64_t next_request_bootstrap_retry_delay_s(anjay_t *anjay) {
+    int64_t delay_s = anjay->bootstrap.request_bootstrap_retry_delay_s;
+    if (delay_s <= 0) {
+        delay_s = REQUEST_BOOTSTRAP_BACKOFF_INITIAL_DELAY_S;
+    }
+    anjay->bootstrap.request_bootstrap_retry_delay_s =
+            AVS_MIN(2 * delay_s, REQUEST_BOOTSTRAP_BACKOFF_MAX_DELAY_S);
+    return delay_s;
+}
+
+static void on_request_bootstrap_response(anjay_t *anjay,
+                                          anjay_active_server_info_t *server,
+                                          const avs_coap_msg_t *response,
+                                          int result,
+                                          void *dummy) {
+    (void) dummy;
+    if (!result && !(result = check_request_bootstrap_response(response))) {
+        anjay_log(INFO, "Request Bootstrap acknowledged");
+        anjay->bootstrap.request_bootstrap_retry_delay_s = 0;
+        start_bootstrap_if_not_already_started(anjay);
+        return;
+    }
+
+    anjay_log(ERROR, "could not request bootstrap");
+    if (result == AVS_COAP_CTX_ERR_NETWORK) {
+        _anjay_schedule_server_reconnect(anjay, server);
+    } else if (!anjay->bootstrap.client_initiated_bootstrap_handle) {
+        schedule_request_bootstrap(anjay,
+                                   next_request_bootstrap_retry_delay_s(anjay));
+    }
+}
+
 static int send_request_bootstrap(anjay_t *anjay) {
     const anjay_url_t *const server_uri =
             &anjay->current_connection.server->uri;
@@ -667,9 +702,8 @@ static int send_request_bootstrap(anjay_t *anjay) {
 
     if ((result = _anjay_coap_stream_setup_request(anjay->comm_stream, &details,
                                                    NULL))
-            || (result = avs_stream_finish_message(anjay->comm_stream))
-            || (result = check_request_bootstrap_response(
-                    anjay->comm_stream))) {
+            || (result = _anjay_server_send_async_request(
+                    anjay, on_request_bootstrap_response, NULL, NULL))) {
         anjay_log(ERROR, "could not request bootstrap");
     } else {
         anjay_log(INFO, "Request Bootstrap sent");
@@ -688,8 +722,10 @@ static int schedule_request_bootstrap(anjay_t *anjay, int64_t holdoff_s) {
     avs_time_duration_t delay =
             avs_time_duration_from_scalar(holdoff_s, AVS_TIME_S);
     anjay_sched_retryable_backoff_t backoff = {
-        .delay = avs_time_duration_from_scalar(3, AVS_TIME_S),
-        .max_delay = avs_time_duration_from_scalar(120, AVS_TIME_S)
+        .delay = avs_time_duration_from_scalar(
+                REQUEST_BOOTSTRAP_BACKOFF_INITIAL_DELAY_S, AVS_TIME_S),
+        .max_delay = avs_time_duration_from_scalar(
+                REQUEST_BOOTSTRAP_BACKOFF_MAX_DELAY_S, AVS_TIME_S)
     };
 
     if (_anjay_sched_retryable(
@@ -718,6 +754,10 @@ static int request_bootstrap(anjay_t *anjay, void *dummy) {
     if (!server || _anjay_server_setup_registration_connection(server)) {
         return -1;
     }
+    if (server->pending_request) {
+        anjay_log(DEBUG, "Request Bootstrap already in progress");
+        return -1;
+    }
     anjay_connection_ref_t connection = {
         .server = server,
         .conn_type = server->registration_info.conn_type
@@ -735,8 +775,6 @@ static int request_bootstrap(anjay_t *anjay, void *dummy) {
         _anjay_schedule_server_reconnect(anjay, server);
     } else if (result) {
         anjay_log(ERROR, "could not send Request Bootstrap");
-    } else {
-        start_bootstrap_if_not_already_started(anjay);
     }
 
     avs_stream_reset(anjay->comm_stream);
@@ -31,6 +31,8 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
 typedef struct {
     bool in_progress;
     anjay_sched_handle_t client_initiated_bootstrap_handle;
+    // delay before retrying a rejected Request Bootstrap; 0 before the first
+    int64_t request_bootstrap_retry_delay_s;
     anjay_sched_handle_t purge_bootstrap_handle;
     anjay_notify_queue_t notification_queue;
 } anjay_bootstrap_t;
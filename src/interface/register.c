@@ -152,8 +152,8 @@ static int get_server_lifetime(anjay_t *anjay,
     return 0;
 }
 
-static int send_register(anjay_t *anjay,
-                         const anjay_update_parameters_t *params) {
+static int setup_register_request(anjay_t *anjay,
+                                  const anjay_update_parameters_t *params) {
     const anjay_url_t *const server_uri =
             &anjay->current_connection.server->uri;
     anjay_msg_details_t details = {
@@ -183,11 +183,9 @@ static int send_register(anjay_t *anjay,
     }
 
     if (_anjay_coap_stream_setup_request(anjay->comm_stream, &details, NULL)
-            || send_objects_list(anjay->comm_stream, params->dm)
-            || avs_stream_finish_message(anjay->comm_stream)) {
-        anjay_log(ERROR, "could not send Register message");
+            || send_objects_list(anjay->comm_stream, params->dm)) {
+        anjay_log(ERROR, "could not prepare Register message");
     } else {
-        anjay_log(INFO, "Register sent");
         result = 0;
     }
 
@@ -198,14 +196,8 @@ cleanup:
 }
 
 static int
-check_register_response(avs_stream_abstract_t *stream,
+check_register_response(const avs_coap_msg_t *response,
                         AVS_LIST(const anjay_string_t) *out_endpoint_path) {
-    const avs_coap_msg_t *response;
-    if (_anjay_coap_stream_get_incoming_msg(stream, &response)) {
-        anjay_log(ERROR, "could not get response");
-        return -1;
-    }
-
     if (avs_coap_msg_get_code(response) != AVS_COAP_CODE_CREATED) {
         anjay_log(ERROR, "server responded with %s (expected %s)",
                   AVS_COAP_CODE_STRING(avs_coap_msg_get_code(response)),
@@ -266,6 +258,34 @@ static int compare_iids(const void *left_, const void *right_, size_t size) {
     }
 }
 
+static bool instances_sorted(AVS_LIST(const anjay_iid_t) instances) {
+    if (instances) {
+        AVS_LIST(const anjay_iid_t) next;
+        while ((next = AVS_LIST_NEXT(instances))) {
+            if (*next <= *instances) {
+                return false;
+            }
+            instances = next;
+        }
+    }
+    return true;
+}
+
+static int
+query_dm_instance_list(anjay_t *anjay,
+                       const anjay_dm_object_def_t *const *obj,
+                       AVS_LIST(anjay_iid_t) **cache_instance_insert_ptr) {
+    const anjay_iid_t *iids;
+    size_t count;
+    int retval = _anjay_dm_instance_list(anjay, obj, &iids, &count, NULL);
+    for (size_t i = 0; !retval && i < count; ++i) {
+        // the array is already sorted, so no AVS_LIST_SORT() is necessary
+        retval = query_dm_instance(anjay, obj, iids[i],
+                                   cache_instance_insert_ptr);
+    }
+    return retval;
+}
+
 static int query_dm_object(anjay_t *anjay,
                            const anjay_dm_object_def_t *const *obj,
                            void *cache_object_insert_ptr_) {
@@ -290,9 +310,12 @@ static int query_dm_object(anjay_t *anjay,
     new_object->oid = (*obj)->oid;
     new_object->version = (*obj)->version;
     AVS_LIST(anjay_iid_t) *instance_insert_ptr = &new_object->instances;
+    if (_anjay_dm_instance_list_usable(anjay, obj, NULL)) {
+        return query_dm_instance_list(anjay, obj, &instance_insert_ptr);
+    }
     int retval = _anjay_dm_foreach_instance(anjay, obj, query_dm_instance,
                                             &instance_insert_ptr);
-    if (!retval) {
+    if (!retval && !instances_sorted(new_object->instances)) {
         AVS_LIST_SORT(&new_object->instances, compare_iids);
     }
     return retval;
@@ -370,32 +393,75 @@ void _anjay_registration_info_cleanup(anjay_registration_info_t *info) {
     cleanup_update_parameters(&info->last_update_params);
 }
 
-int _anjay_register(anjay_t *anjay) {
-    anjay_update_parameters_t new_params;
-    if (init_update_parameters(anjay, &new_params)) {
-        return -1;
+typedef struct {
+    anjay_update_parameters_t params;
+    anjay_registration_finished_t *on_finished;
+} registration_request_arg_t;
+
+static void free_registration_request_arg(void *arg_) {
+    registration_request_arg_t *arg = (registration_request_arg_t *) arg_;
+    cleanup_update_parameters(&arg->params);
+    free(arg);
+}
+
+static registration_request_arg_t *
+create_registration_request_arg(anjay_t *anjay,
+                                anjay_registration_finished_t *on_finished) {
+    registration_request_arg_t *arg = (registration_request_arg_t *)
+            calloc(1, sizeof(registration_request_arg_t));
+    if (!arg) {
+        anjay_log(ERROR, "out of memory");
+        return NULL;
     }
+    if (init_update_parameters(anjay, &arg->params)) {
+        free(arg);
+        return NULL;
+    }
+    arg->on_finished = on_finished;
+    return arg;
+}
 
+static void on_register_response(anjay_t *anjay,
+                                 anjay_active_server_info_t *server,
+                                 const avs_coap_msg_t *response,
+                                 int result,
+                                 void *arg_) {
+    registration_request_arg_t *arg = (registration_request_arg_t *) arg_;
     AVS_LIST(const anjay_string_t) endpoint_path = NULL;
-    int result = -1;
 
-    if (send_register(anjay, &new_params)
-            || check_register_response(anjay->comm_stream, &endpoint_path)) {
-        anjay_log(ERROR, "could not register to server %u",
-                  _anjay_dm_current_ssid(anjay));
-        goto fail;
+    if (result
+            || (result = check_register_response(response, &endpoint_path))) {
+        anjay_log(ERROR, "could not register to server %u", server->ssid);
+    } else {
+        _anjay_registration_info_cleanup(&server->registration_info);
+        registration_info_init(&server->registration_info, &endpoint_path,
+                               &arg->params);
     }
 
-    _anjay_registration_info_cleanup(
-            &anjay->current_connection.server->registration_info);
-    registration_info_init(
-            &anjay->current_connection.server->registration_info,
-            &endpoint_path, &new_params);
-    result = 0;
-
-fail:
-    cleanup_update_parameters(&new_params);
     AVS_LIST_CLEAR(&endpoint_path);
+    arg->on_finished(anjay, server, result);
+}
+
+int _anjay_register(anjay_t *anjay,
+                    anjay_registration_finished_t *on_finished) {
+    registration_request_arg_t *arg =
+            create_registration_request_arg(anjay, on_finished);
+    if (!arg) {
+        return -1;
+    }
+
+    if (setup_register_request(anjay, &arg->params)) {
+        free_registration_request_arg(arg);
+        return -1;
+    }
+
+    int result = _anjay_server_send_async_request(
+            anjay, on_register_response, arg, free_registration_request_arg);
+    if (result) {
+        anjay_log(ERROR, "could not send Register message");
+    } else {
+        anjay_log(INFO, "Register sent");
+    }
     return result;
 }
 
@@ -431,8 +497,8 @@ static bool dm_caches_equal(AVS_LIST(anjay_dm_cache_object_t) left,
     return !(left || right);
 }
 
-static int send_update(anjay_t *anjay,
-                       const anjay_update_parameters_t *new_params) {
+static int setup_update_request(anjay_t *anjay,
+                                const anjay_update_parameters_t *new_params) {
     const anjay_active_server_info_t *server = anjay->current_connection.server;
     const anjay_update_parameters_t *old_params =
             &server->registration_info.last_update_params;
@@ -464,12 +530,8 @@ static int send_update(anjay_t *anjay,
                                                    NULL))
             || (dm_changed_since_last_update
                 && (result = send_objects_list(anjay->comm_stream,
-                                               new_params->dm)))
-            || (result = avs_stream_finish_message(anjay->comm_stream))) {
-        anjay_log(ERROR, "could not send Update message");
-    } else {
-        anjay_log(INFO, "Update sent");
-        result = 0;
+                                               new_params->dm)))) {
+        anjay_log(ERROR, "could not prepare Update message");
     }
 
     // request_uri must not be cleared here
@@ -477,13 +539,7 @@ static int send_update(anjay_t *anjay,
     return result;
 }
 
-static int check_update_response(avs_stream_abstract_t *stream) {
-    const avs_coap_msg_t *response;
-    if (_anjay_coap_stream_get_incoming_msg(stream, &response)) {
-        anjay_log(ERROR, "could not get response");
-        return -1;
-    }
-
+static int check_update_response(const avs_coap_msg_t *response) {
     const uint8_t code = avs_coap_msg_get_code(response);
     if (code == AVS_COAP_CODE_CHANGED) {
         anjay_log(INFO, "registration successfully updated");
@@ -516,59 +572,74 @@ static int check_update_response(avs_stream_abstract_t *stream) {
     }
 }
 
-int _anjay_update_registration(anjay_t *anjay) {
-    anjay_update_parameters_t new_params;
-    if (init_update_parameters(anjay, &new_params)) {
-        return -1;
-    }
+static void on_update_response(anjay_t *anjay,
+                               anjay_active_server_info_t *server,
+                               const avs_coap_msg_t *response,
+                               int result,
+                               void *arg_) {
+    registration_request_arg_t *arg = (registration_request_arg_t *) arg_;
 
-    int retval = -1;
-    if ((retval = send_update(anjay, &new_params))
-            || (retval = check_update_response(anjay->comm_stream))) {
+    if (result || (result = check_update_response(response))) {
         anjay_log(ERROR, "could not update registration");
-        goto finish;
+    } else {
+        update_registration_info(&server->registration_info, &arg->params);
     }
 
-    update_registration_info(
-            &anjay->current_connection.server->registration_info, &new_params);
-    retval = 0;
-
-finish:
-    cleanup_update_parameters(&new_params);
-    return retval;
+    arg->on_finished(anjay, server, result);
 }
 
-static int check_deregister_response(avs_stream_abstract_t *stream) {
-    const avs_coap_msg_t *response;
-    if (_anjay_coap_stream_get_incoming_msg(stream, &response)) {
-        anjay_log(ERROR, "could not get response");
+int _anjay_update_registration(anjay_t *anjay,
+                               anjay_registration_finished_t *on_finished) {
+    registration_request_arg_t *arg =
+            create_registration_request_arg(anjay, on_finished);
+    if (!arg) {
         return -1;
     }
 
-    const uint8_t code = avs_coap_msg_get_code(response);
-    if (code != AVS_COAP_CODE_DELETED) {
-        anjay_log(ERROR, "server responded with %s (expected %s)",
-                  AVS_COAP_CODE_STRING(code),
-                  AVS_COAP_CODE_STRING(AVS_COAP_CODE_DELETED));
+    if (setup_update_request(anjay, &arg->params)) {
+        free_registration_request_arg(arg);
         return -1;
     }
 
-    return 0;
+    int result = _anjay_server_send_async_request(
+            anjay, on_update_response, arg, free_registration_request_arg);
+    if (result) {
+        anjay_log(ERROR, "could not send Update message");
+    } else {
+        anjay_log(INFO, "Update sent");
+    }
+    return result;
 }
 
-int _anjay_deregister(anjay_t *anjay) {
+static int setup_deregister_request(anjay_t *anjay) {
     anjay_msg_details_t details = {
         .msg_type = AVS_COAP_MSG_CONFIRMABLE,
         .msg_code = AVS_COAP_CODE_DELETE,
         .format = AVS_COAP_FORMAT_NONE,
         .uri_path = anjay->current_connection.server->registration_info.endpoint_path
     };
+    return _anjay_coap_stream_setup_request(anjay->comm_stream, &details, NULL);
+}
 
+static int check_deregister_response(const avs_coap_msg_t *response) {
+    const uint8_t code = avs_coap_msg_get_code(response);
+    if (code != AVS_COAP_CODE_DELETED) {
+        anjay_log(ERROR, "server responded with %s (expected %s)",
+                  AVS_COAP_CODE_STRING(code),
+                  AVS_COAP_CODE_STRING(AVS_COAP_CODE_DELETED));
+        return -1;
+    }
+    return 0;
+}
+
+int _anjay_deregister(anjay_t *anjay) {
+    const avs_coap_msg_t *response;
     int result;
-    if ((result = _anjay_coap_stream_setup_request(anjay->comm_stream, &details,
-                                                   NULL))
+    if ((result = setup_deregister_request(anjay))
             || (result = avs_stream_finish_message(anjay->comm_stream))
-            || (result = check_deregister_response(anjay->comm_stream))) {
+            || (result = _anjay_coap_stream_get_incoming_msg(anjay->comm_stream,
+                                                             &response))
+            || (result = check_deregister_response(response))) {
         anjay_log(ERROR, "Could not perform De-registration");
     } else {
         anjay_log(INFO, "De-register sent");
@@ -576,6 +647,49 @@ int _anjay_deregister(anjay_t *anjay) {
     return result;
 }
 
+typedef struct {
+    anjay_registration_finished_t *on_finished;
+} deregister_request_arg_t;
+
+static void on_deregister_response(anjay_t *anjay,
+                                   anjay_active_server_info_t *server,
+                                   const avs_coap_msg_t *response,
+                                   int result,
+                                   void *arg_) {
+    deregister_request_arg_t *arg = (deregister_request_arg_t *) arg_;
+    if (result || (result = check_deregister_response(response))) {
+        anjay_log(ERROR, "could not de-register from server %u", server->ssid);
+    } else {
+        anjay_log(INFO, "De-registered from server %u", server->ssid);
+    }
+    arg->on_finished(anjay, server, result);
+}
+
+int _anjay_deregister_async(anjay_t *anjay,
+                            anjay_registration_finished_t *on_finished) {
+    deregister_request_arg_t *arg = (deregister_request_arg_t *)
+            calloc(1, sizeof(deregister_request_arg_t));
+    if (!arg) {
+        anjay_log(ERROR, "out of memory");
+        return -1;
+    }
+    arg->on_finished = on_finished;
+
+    if (setup_deregister_request(anjay)) {
+        free(arg);
+        return -1;
+    }
+
+    int result = _anjay_server_send_async_request(
+            anjay, on_deregister_response, arg, free);
+    if (result) {
+        anjay_log(ERROR, "could not send De-Register message");
+    } else {
+        anjay_log(INFO, "De-register sent");
+    }
+    return result;
+}
+
 avs_time_duration_t
 _anjay_register_time_remaining(const anjay_registration_info_t *info) {
     return avs_time_monotonic_diff(info->expire_time, avs_time_monotonic_now());
@@ -23,21 +23,57 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
 
 void _anjay_registration_info_cleanup(anjay_registration_info_t *info);
 
-int _anjay_register(anjay_t *anjay);
+/**
+ * Called from a scheduler job once a Register, Update or De-register exchange
+ * started with @ref _anjay_register , @ref _anjay_update_registration or
+ * @ref _anjay_deregister_async is finished. No stream is bound while it is
+ * called.
+ *
+ * @p result is:
+ * - 0 on success, in which case @p server registration info is already
+ *   updated,
+ * - a negative value on error,
+ * - ANJAY_REGISTRATION_UPDATE_REJECTED if the server responded to an Update
+ *   with 4.xx error so the Update message should not be retransmitted.
+ */
+typedef void anjay_registration_finished_t(anjay_t *anjay,
+                                           anjay_active_server_info_t *server,
+                                           int result);
+
+/**
+ * Sends the Register message through the currently bound stream without
+ * waiting for the response. @p on_finished is called when the exchange is
+ * finished, unless the request is cancelled before.
+ *
+ * @returns 0 if the request was sent, a negative value otherwise. In the
+ *          latter case @p on_finished will not be called.
+ */
+int _anjay_register(anjay_t *anjay,
+                    anjay_registration_finished_t *on_finished);
 
 #define ANJAY_REGISTRATION_UPDATE_REJECTED 1
 
 /**
- * @returns:
- * - 0 on success,
- * - a negative value on error,
- * - ANJAY_REGISTRATION_UPDATE_REJECTED if the server responded with 4.xx error
- *   so the Update message should not be retransmitted.
+ * Sends the Update message in the same manner as @ref _anjay_register .
  */
-int _anjay_update_registration(anjay_t *anjay);
+int _anjay_update_registration(anjay_t *anjay,
+                               anjay_registration_finished_t *on_finished);
 
+/**
+ * Sends the De-Register message through the currently bound stream and waits
+ * for the response, retransmitting the request if necessary. Used only when
+ * there is no event loop left to drive an asynchronous exchange.
+ */
 int _anjay_deregister(anjay_t *anjay);
 
+/**
+ * Sends the De-Register message in the same manner as @ref _anjay_register .
+ * @p on_finished is called with a non-zero result if the server did not
+ * respond with 2.02 Deleted.
+ */
+int _anjay_deregister_async(anjay_t *anjay,
+                            anjay_registration_finished_t *on_finished);
+
 /**
  * @returns Amount of time from now until the server registration expires.
  */
@@ -18,6 +18,7 @@
 
 #include <errno.h>
 
+#include <avsystem/commons/coap/msg_builder.h>
 #include <avsystem/commons/unit/test.h>
 
 #include <anjay_test/dm.h>
@@ -721,6 +722,49 @@ AVS_UNIT_TEST(bootstrap_backoff, backoff) {
     DM_TEST_FINISH;
 }
 
+static void handle_request_bootstrap_response(anjay_t *anjay, uint8_t code) {
+    union {
+        avs_max_align_t align;
+        uint8_t bytes[64];
+    } buffer;
+    avs_coap_msg_info_t info = avs_coap_msg_info_init();
+    info.type = AVS_COAP_MSG_ACKNOWLEDGEMENT;
+    info.code = code;
+    avs_coap_msg_builder_t builder;
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_builder_init(
+            &builder, avs_coap_ensure_aligned_buffer(&buffer), sizeof(buffer),
+            &info));
+    on_request_bootstrap_response(anjay, anjay->servers.active,
+                                  avs_coap_msg_builder_get_msg(&builder), 0,
+                                  NULL);
+}
+
+AVS_UNIT_TEST(bootstrap_backoff, rejected_responses) {
+    DM_TEST_INIT_WITH_SSIDS(ANJAY_SSID_BOOTSTRAP);
+
+    // Request Bootstrap rejected by the server is retried with the same
+    // exponential backoff, even though each retry is a separate job
+    int64_t expected_delay_s = 3;
+    for (int i = 0; i < 8; ++i) {
+        handle_request_bootstrap_response(anjay, AVS_COAP_CODE_BAD_REQUEST);
+        avs_time_duration_t sched_job_delay;
+        AVS_UNIT_ASSERT_SUCCESS(anjay_sched_time_to_next(anjay,
+                                                         &sched_job_delay));
+        AVS_UNIT_ASSERT_TRUE(
+                llabs(duration_to_ns(sched_job_delay)
+                      - expected_delay_s * 1000000000) < 10);
+        _anjay_sched_del(anjay->sched,
+                         &anjay->bootstrap.client_initiated_bootstrap_handle);
+        expected_delay_s = AVS_MIN(2 * expected_delay_s, 120);
+    }
+
+    // the backoff is reset once the request gets acknowledged
+    handle_request_bootstrap_response(anjay, AVS_COAP_CODE_CHANGED);
+    AVS_UNIT_ASSERT_EQUAL(anjay->bootstrap.request_bootstrap_retry_delay_s, 0);
+
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(bootstrap_reconnect, reconnect) {
     DM_TEST_INIT_WITH_SSIDS(ANJAY_SSID_BOOTSTRAP);
     AVS_UNIT_ASSERT_SUCCESS(schedule_request_bootstrap(anjay, 0));
@@ -749,10 +793,16 @@ AVS_UNIT_TEST(bootstrap_reconnect, reconnect) {
             "\xB2" "bs" // Uri-Path
             "\x4D\x0B" "ep=urn:dev:os:anjay-test"; // Uri-Query
     avs_unit_mocksock_expect_output(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_NOT_NULL(anjay->servers.active->pending_request);
+
+    // the response is handled asynchronously, by anjay_serve()
     static const char RESPONSE[] =
             "\x60\x41\x69\xEE";
     avs_unit_mocksock_input(mocksocks[0], RESPONSE, sizeof(RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
     AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
 
     DM_TEST_FINISH;
 }
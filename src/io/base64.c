@@ -0,0 +1,147 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include "base64.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+static const char BASE64_ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#define INV 0xFF
+
+// maps each character to its 6-bit value, or INV if it is not a valid digit
+static const uint8_t BASE64_DECODE_TABLE[256] = {
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  0x3E, INV,  INV,  INV,  0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B,
+    0x3C, 0x3D, INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,
+    0x17, 0x18, 0x19, INV,  INV,  INV,  INV,  INV,
+    INV,  0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20,
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30,
+    0x31, 0x32, 0x33, INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV,
+    INV,  INV,  INV,  INV,  INV,  INV,  INV,  INV
+};
+
+size_t _anjay_base64_encode(char *out, const uint8_t *in, size_t in_size) {
+    char *ptr = out;
+    const uint8_t *end = in + in_size - in_size % 3;
+    // bulk of the data: whole triplets, no padding involved
+    for (; in < end; in += 3, ptr += 4) {
+        uint32_t value = ((uint32_t) in[0] << 16)
+                         | ((uint32_t) in[1] << 8)
+                         | (uint32_t) in[2];
+        ptr[0] = BASE64_ALPHABET[(value >> 18) & 0x3F];
+        ptr[1] = BASE64_ALPHABET[(value >> 12) & 0x3F];
+        ptr[2] = BASE64_ALPHABET[(value >> 6) & 0x3F];
+        ptr[3] = BASE64_ALPHABET[value & 0x3F];
+    }
+    switch (in_size % 3) {
+    case 1:
+        ptr[0] = BASE64_ALPHABET[in[0] >> 2];
+        ptr[1] = BASE64_ALPHABET[(in[0] & 0x03) << 4];
+        ptr[2] = '=';
+        ptr[3] = '=';
+        ptr += 4;
+        break;
+    case 2:
+        ptr[0] = BASE64_ALPHABET[in[0] >> 2];
+        ptr[1] = BASE64_ALPHABET[((in[0] & 0x03) << 4) | (in[1] >> 4)];
+        ptr[2] = BASE64_ALPHABET[(in[1] & 0x0F) << 2];
+        ptr[3] = '=';
+        ptr += 4;
+        break;
+    }
+    return (size_t) (ptr - out);
+}
+
+int _anjay_base64_decode(uint8_t *out, size_t *out_size,
+                         const char *in, size_t in_size) {
+    if (in_size % 4) {
+        return -1;
+    }
+    *out_size = 0;
+    if (!in_size) {
+        return 0;
+    }
+    const uint8_t *ptr = (const uint8_t *) in;
+    const uint8_t *last = ptr + in_size - 4;
+    uint8_t *outptr = out;
+    // all quadruplets except the last one cannot contain padding
+    for (; ptr < last; ptr += 4, outptr += 3) {
+        uint8_t a = BASE64_DECODE_TABLE[ptr[0]];
+        uint8_t b = BASE64_DECODE_TABLE[ptr[1]];
+        uint8_t c = BASE64_DECODE_TABLE[ptr[2]];
+        uint8_t d = BASE64_DECODE_TABLE[ptr[3]];
+        if ((a | b | c | d) & 0x80) {
+            return -1;
+        }
+        uint32_t value = ((uint32_t) a << 18) | ((uint32_t) b << 12)
+                         | ((uint32_t) c << 6) | (uint32_t) d;
+        outptr[0] = (uint8_t) (value >> 16);
+        outptr[1] = (uint8_t) (value >> 8);
+        outptr[2] = (uint8_t) value;
+    }
+
+    size_t padding = (ptr[3] == '=') ? (ptr[2] == '=' ? 2 : 1) : 0;
+    uint8_t a = BASE64_DECODE_TABLE[ptr[0]];
+    uint8_t b = BASE64_DECODE_TABLE[ptr[1]];
+    uint8_t c = padding >= 2 ? 0 : BASE64_DECODE_TABLE[ptr[2]];
+    uint8_t d = padding >= 1 ? 0 : BASE64_DECODE_TABLE[ptr[3]];
+    if ((a | b | c | d) & 0x80) {
+        return -1;
+    }
+    uint32_t value = ((uint32_t) a << 18) | ((uint32_t) b << 12)
+                     | ((uint32_t) c << 6) | (uint32_t) d;
+    outptr[0] = (uint8_t) (value >> 16);
+    if (padding < 2) {
+        outptr[1] = (uint8_t) (value >> 8);
+    }
+    if (padding < 1) {
+        outptr[2] = (uint8_t) value;
+    }
+    *out_size = (size_t) (outptr - out) + 3 - padding;
+    return 0;
+}
+
+#ifdef ANJAY_TEST
+#include "test/base64.c"
+#endif
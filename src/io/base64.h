@@ -0,0 +1,56 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_IO_BASE64_H
+#define ANJAY_IO_BASE64_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+/**
+ * Calculates the number of characters produced by @ref _anjay_base64_encode
+ * for @p size bytes of input (not including any terminator).
+ */
+#define _ANJAY_BASE64_ENCODED_SIZE(size) (4 * (((size) + 2) / 3))
+
+/**
+ * Encodes @p in_size bytes of @p in as standard Base64, with padding.
+ *
+ * @p out must be able to hold at least @ref _ANJAY_BASE64_ENCODED_SIZE
+ * characters. The output is NOT null-terminated.
+ *
+ * @returns Number of characters written to @p out.
+ */
+size_t _anjay_base64_encode(char *out, const uint8_t *in, size_t in_size);
+
+/**
+ * Decodes @p in_size characters of strict Base64 data. @p in_size needs to be
+ * a multiple of 4, and padding characters are only allowed in the last
+ * quadruplet.
+ *
+ * @p out must be able to hold at least <c>3 * (in_size / 4)</c> bytes.
+ *
+ * @returns 0 on success, storing the number of decoded bytes in
+ *          @p out_size, or a negative value if the input is not valid Base64.
+ */
+int _anjay_base64_decode(uint8_t *out, size_t *out_size,
+                         const char *in, size_t in_size);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif /* ANJAY_IO_BASE64_H */
@@ -16,11 +16,11 @@
 
 #include <config.h>
 #include <avsystem/commons/stream.h>
-#include <avsystem/commons/base64.h>
 
 #include <anjay/core.h>
 
 #include "../utils_core.h"
+#include "base64.h"
 #include "base64_out.h"
 #include "vtable.h"
 
@@ -29,7 +29,7 @@ VISIBILITY_SOURCE_BEGIN
 typedef struct base64_ret_bytes_ctx {
     const anjay_ret_bytes_ctx_vtable_t *vtable;
     avs_stream_abstract_t *stream;
-    uint8_t bytes_cached[2];
+    uint8_t bytes_cached[3];
     size_t num_bytes_cached;
     size_t num_bytes_left;
 } base64_ret_bytes_ctx_t;
@@ -39,41 +39,18 @@ AVS_STATIC_ASSERT(TEXT_CHUNK_SIZE % 3 == 0, chunk_must_be_a_multiple_of_3);
 
 static int base64_ret_encode_and_write(base64_ret_bytes_ctx_t *ctx,
                                        const uint8_t *buffer,
-                                       const size_t buffer_size) {
-    if (!buffer_size) {
-        return 0;
-    }
-    size_t encoded_size = avs_base64_encoded_size(buffer_size);
-    assert(encoded_size <= 4 * (TEXT_CHUNK_SIZE / 3) + 1);
-    char encoded[encoded_size];
-    int retval = avs_base64_encode(encoded, sizeof(encoded), buffer, buffer_size);
-    if (retval) {
-        return retval;
-    }
-    return avs_stream_write(ctx->stream, encoded, sizeof(encoded) - 1);
-}
-
-static int base64_ret_bytes_flush(base64_ret_bytes_ctx_t *ctx,
-                                  const uint8_t **dataptr,
-                                  size_t bytes_to_write) {
-    uint8_t chunk[TEXT_CHUNK_SIZE];
-    while (bytes_to_write > 0) {
-        memcpy(chunk, ctx->bytes_cached, ctx->num_bytes_cached);
-        size_t new_bytes_written =
-                AVS_MIN(TEXT_CHUNK_SIZE - ctx->num_bytes_cached,
-                          bytes_to_write);
-        assert(new_bytes_written <= TEXT_CHUNK_SIZE);
-        memcpy(&chunk[ctx->num_bytes_cached], *dataptr, new_bytes_written);
-        *dataptr += new_bytes_written;
-
-        int retval;
-        if ((retval = base64_ret_encode_and_write(
-                     ctx, chunk, new_bytes_written + ctx->num_bytes_cached))) {
+                                       size_t buffer_size) {
+    char encoded[_ANJAY_BASE64_ENCODED_SIZE(TEXT_CHUNK_SIZE)];
+    while (buffer_size > 0) {
+        size_t chunk_size = AVS_MIN(buffer_size, TEXT_CHUNK_SIZE);
+        size_t encoded_size =
+                _anjay_base64_encode(encoded, buffer, chunk_size);
+        int retval = avs_stream_write(ctx->stream, encoded, encoded_size);
+        if (retval) {
             return retval;
         }
-        bytes_to_write -= new_bytes_written;
-        ctx->num_bytes_left -= new_bytes_written;
-        ctx->num_bytes_cached = 0;
+        buffer += chunk_size;
+        buffer_size -= chunk_size;
     }
     return 0;
 }
@@ -85,24 +62,36 @@ static int base64_ret_bytes_append(anjay_ret_bytes_ctx_t *ctx_,
     if (size > ctx->num_bytes_left) {
         return -1;
     }
+    ctx->num_bytes_left -= size;
     const uint8_t *dataptr = (const uint8_t *) data;
-    size_t bytes_to_store;
-    if (size + ctx->num_bytes_cached < 3) {
-        bytes_to_store = size;
-    } else {
-        bytes_to_store = (ctx->num_bytes_cached + size) % 3;
+    int retval;
+    if (ctx->num_bytes_cached) {
+        // complete the triplet left over from the previous call first
+        size_t bytes_to_cache =
+                AVS_MIN(sizeof(ctx->bytes_cached) - ctx->num_bytes_cached,
+                        size);
+        memcpy(&ctx->bytes_cached[ctx->num_bytes_cached], dataptr,
+               bytes_to_cache);
+        ctx->num_bytes_cached += bytes_to_cache;
+        dataptr += bytes_to_cache;
+        size -= bytes_to_cache;
+        if (ctx->num_bytes_cached < sizeof(ctx->bytes_cached)) {
+            return 0;
+        }
+        ctx->num_bytes_cached = 0;
+        if ((retval = base64_ret_encode_and_write(
+                ctx, ctx->bytes_cached, sizeof(ctx->bytes_cached)))) {
+            return retval;
+        }
     }
-    assert(bytes_to_store <= 2);
-
-    int retval = base64_ret_bytes_flush(ctx, &dataptr, size - bytes_to_store);
-    if (retval) {
+    // encode all whole triplets straight from the caller's buffer
+    size_t bytes_to_store = size % 3;
+    if ((retval = base64_ret_encode_and_write(ctx, dataptr,
+                                              size - bytes_to_store))) {
         return retval;
     }
-    assert(ctx->num_bytes_cached + bytes_to_store
-               <= sizeof(ctx->bytes_cached));
-    memcpy(&ctx->bytes_cached[ctx->num_bytes_cached], dataptr, bytes_to_store);
-    ctx->num_bytes_cached += bytes_to_store;
-    ctx->num_bytes_left -= bytes_to_store;
+    memcpy(ctx->bytes_cached, &dataptr[size - bytes_to_store], bytes_to_store);
+    ctx->num_bytes_cached = bytes_to_store;
     return 0;
 }
 
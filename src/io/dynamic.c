@@ -20,8 +20,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <avsystem/commons/coap/block_utils.h>
 #include <avsystem/commons/stream.h>
 
+#include "../anjay_core.h"
 #include "../coap/content_format.h"
 #include "../io_core.h"
 
@@ -80,6 +82,19 @@ static anjay_output_ctx_t *spawn_json(dynamic_out_t *ctx) {
 }
 #endif
 
+#ifdef WITH_SENML_CBOR
+static anjay_output_ctx_t *spawn_senml_cbor(dynamic_out_t *ctx) {
+    anjay_output_ctx_t *result =
+            _anjay_output_senml_cbor_create(ctx->stream, ctx->errno_ptr,
+                                            &ctx->details, &ctx->uri);
+    if (result && ctx->id >= 0
+            && _anjay_output_set_id(result, ctx->id_type, (uint16_t) ctx->id)) {
+        _anjay_output_ctx_destroy(&result);
+    }
+    return result;
+}
+#endif
+
 static anjay_output_ctx_t *spawn_backend(dynamic_out_t *ctx, uint16_t format) {
     switch (_anjay_translate_legacy_content_format(format)) {
     case ANJAY_COAP_FORMAT_OPAQUE:
@@ -91,6 +106,10 @@ static anjay_output_ctx_t *spawn_backend(dynamic_out_t *ctx, uint16_t format) {
 #ifdef WITH_JSON
     case ANJAY_COAP_FORMAT_JSON:
         return spawn_json(ctx);
+#endif
+#ifdef WITH_SENML_CBOR
+    case ANJAY_COAP_FORMAT_SENML_CBOR:
+        return spawn_senml_cbor(ctx);
 #endif
     default:
         anjay_log(ERROR, "Unsupported output format: %" PRIu16, format);
@@ -231,6 +250,18 @@ static anjay_output_ctx_t *dynamic_ret_object_start(anjay_output_ctx_t *ctx_) {
     return NULL;
 }
 
+static anjay_output_ctx_t *
+dynamic_ret_object_start_sized(anjay_output_ctx_t *ctx_, size_t length) {
+    dynamic_out_t *ctx = (dynamic_out_t *) ctx_;
+    if (ensure_backend(ctx, ANJAY_COAP_FORMAT_TLV)) {
+        anjay_output_ctx_t *result =
+                _anjay_output_object_start_sized(ctx->backend, length);
+        adjust_errno(ctx, "ret_object_start_sized");
+        return result;
+    }
+    return NULL;
+}
+
 static int dynamic_set_id(anjay_output_ctx_t *ctx_,
                           anjay_id_type_t type, uint16_t id) {
     dynamic_out_t *ctx = (dynamic_out_t *) ctx_;
@@ -274,14 +305,53 @@ static const anjay_output_ctx_vtable_t DYNAMIC_OUT_VTABLE = {
     .array_start = dynamic_ret_array_start,
     .object_start = dynamic_ret_object_start,
     .set_id = dynamic_set_id,
-    .close = dynamic_close
+    .close = dynamic_close,
+    .object_start_sized = dynamic_ret_object_start_sized
 };
 
+/*
+ * Hierarchical formats implement all public output methods, so once one of
+ * them is known up front, there is nothing left for the dynamic context to
+ * guess. The backend is then handed out directly, so that each value returned
+ * by the data model costs a single indirect call instead of going through
+ * dynamic_out_t first.
+ *
+ * The only method such a backend may lack is object_start_sized (JSON and
+ * SenML CBOR), and _anjay_output_object_start_sized() reports that as
+ * ANJAY_OUTCTXERR_FORMAT_MISMATCH by itself - which is what adjust_errno()
+ * would turn it into - so errors are reported the same on both paths.
+ */
+static bool is_hierarchical_format(uint16_t format) {
+    switch (_anjay_translate_legacy_content_format(format)) {
+    case ANJAY_COAP_FORMAT_TLV:
+#ifdef WITH_JSON
+    case ANJAY_COAP_FORMAT_JSON:
+#endif
+#ifdef WITH_SENML_CBOR
+    case ANJAY_COAP_FORMAT_SENML_CBOR:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
 anjay_output_ctx_t *
 _anjay_output_dynamic_create(avs_stream_abstract_t *stream,
                              int *errno_ptr,
                              anjay_msg_details_t *details_template,
                              const anjay_uri_path_t *uri) {
+    if (is_hierarchical_format(details_template->format)) {
+        dynamic_out_t spawner = {
+            .errno_ptr = errno_ptr,
+            .stream = stream,
+            .details = *details_template,
+            .id = -1,
+            .uri = *uri
+        };
+        return spawn_backend(&spawner, details_template->format);
+    }
+
     dynamic_out_t *ctx = (dynamic_out_t *) calloc(1, sizeof(dynamic_out_t));
     if (!ctx) {
         return NULL;
@@ -302,6 +372,12 @@ _anjay_output_dynamic_create(avs_stream_abstract_t *stream,
 
 /////////////////////////////////////////////////////////////////////// DECODING
 
+static bool has_block1(const avs_coap_msg_t *msg) {
+    avs_coap_block_info_t block1;
+    return avs_coap_get_block_info(msg, AVS_COAP_BLOCK1, &block1)
+            || block1.valid;
+}
+
 int _anjay_input_dynamic_create(anjay_input_ctx_t **out,
                                 avs_stream_abstract_t **stream_ptr,
                                 bool autoclose) {
@@ -316,9 +392,36 @@ int _anjay_input_dynamic_create(anjay_input_ctx_t **out,
     case ANJAY_COAP_FORMAT_PLAINTEXT:
         return _anjay_input_text_create(out, stream_ptr, autoclose);
     case ANJAY_COAP_FORMAT_TLV:
+        if (!autoclose && !has_block1(msg)) {
+            // the whole payload is already in the receive buffer
+            return _anjay_input_tlv_buffer_create(
+                    out, avs_coap_msg_payload(msg),
+                    avs_coap_msg_payload_length(msg));
+        }
         return _anjay_input_tlv_create(out, stream_ptr, autoclose);
     case ANJAY_COAP_FORMAT_OPAQUE:
         return _anjay_input_opaque_create(out, stream_ptr, autoclose);
+#ifdef WITH_JSON
+    case ANJAY_COAP_FORMAT_JSON:
+        {
+            anjay_uri_path_t uri;
+            if (_anjay_parse_dm_uri(msg, &uri)) {
+                return ANJAY_ERR_BAD_REQUEST;
+            }
+            return _anjay_input_json_create(out, stream_ptr, autoclose, &uri);
+        }
+#endif
+#ifdef WITH_SENML_CBOR
+    case ANJAY_COAP_FORMAT_SENML_CBOR:
+        {
+            anjay_uri_path_t uri;
+            if (_anjay_parse_dm_uri(msg, &uri)) {
+                return ANJAY_ERR_BAD_REQUEST;
+            }
+            return _anjay_input_senml_cbor_create(out, stream_ptr, autoclose,
+                                                  &uri);
+        }
+#endif
     default:
         return ANJAY_ERR_BAD_REQUEST;
     }
@@ -0,0 +1,267 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <avsystem/commons/stream.h>
+#include <avsystem/commons/utils.h>
+
+#include "../io_core.h"
+#include "../utils_core.h"
+#include "flat_in.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+/////////////////////////////////////////////////////////////////////// PATHS
+
+static int parse_path(anjay_flat_path_t *out, const char *str, size_t length) {
+    const char *end = str + length;
+    out->length = 0;
+    if (str < end && *str == '/') {
+        ++str;
+    }
+    while (str < end) {
+        if (out->length >= _ANJAY_FLAT_PATH_MAX_LENGTH
+                || *str < '0' || *str > '9') {
+            return -1;
+        }
+        uint32_t id = 0;
+        for (; str < end && *str != '/'; ++str) {
+            if (*str < '0' || *str > '9'
+                    || (id = 10 * id + (uint32_t) (*str - '0')) > UINT16_MAX) {
+                return -1;
+            }
+        }
+        out->ids[out->length++] = (uint16_t) id;
+        if (str < end) {
+            // skip the slash; a trailing one is allowed
+            ++str;
+        }
+    }
+    return 0;
+}
+
+static bool path_has_prefix(const anjay_flat_path_t *path,
+                            const anjay_flat_path_t *prefix) {
+    return path->length >= prefix->length
+            && !memcmp(path->ids, prefix->ids,
+                       prefix->length * sizeof(*prefix->ids));
+}
+
+int _anjay_flat_parser_set_path(anjay_flat_parser_t *p,
+                                const char *base_name,
+                                const char *name) {
+    char full_name[2 * _ANJAY_FLAT_NAME_SIZE];
+    size_t base_name_length = strlen(base_name);
+    size_t name_length = strlen(name);
+    bool valid = (base_name_length + name_length < sizeof(full_name));
+    if (valid) {
+        memcpy(full_name, base_name, base_name_length);
+        memcpy(full_name + base_name_length, name, name_length);
+        valid = !parse_path(&p->path, full_name,
+                            base_name_length + name_length);
+    }
+    if (!valid) {
+        anjay_log(WARNING, "invalid entry name: %s%s", base_name, name);
+        return ANJAY_ERR_BAD_REQUEST;
+    }
+    if (p->path.length <= 2 || !path_has_prefix(&p->path, &p->uri)) {
+        anjay_log(WARNING, "entry path does not match request URI or is not "
+                  "a Resource path");
+        return ANJAY_ERR_BAD_REQUEST;
+    }
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////// PARSER
+
+/*
+ * Makes sure that the parser is positioned at an entry.
+ *
+ * @returns 0 on success, ANJAY_GET_INDEX_END if there are no more entries, or
+ *          an error code.
+ */
+static int ensure_entry(anjay_flat_parser_t *p) {
+    int retval = 0;
+    switch (p->state) {
+    case ANJAY_FLAT_ENTRY_END:
+        return p->error ? p->error : ANJAY_GET_INDEX_END;
+    case ANJAY_FLAT_ENTRY_VALUE:
+    case ANJAY_FLAT_ENTRY_VALUE_PARTIAL:
+        return 0;
+    case ANJAY_FLAT_ENTRY_VALUE_CONSUMED:
+        retval = p->vtable->finish_entry(p);
+        if (!retval) {
+            p->state = ANJAY_FLAT_ENTRY_NONE;
+        }
+        // fall through
+    case ANJAY_FLAT_ENTRY_NONE:
+        if (!retval) {
+            retval = p->vtable->parse_entry_header(p);
+        }
+    }
+    if (retval && retval != ANJAY_GET_INDEX_END) {
+        p->state = ANJAY_FLAT_ENTRY_END;
+        p->error = retval;
+    }
+    return retval;
+}
+
+///////////////////////////////////////////////////////////////////// CONTEXTS
+
+void _anjay_flat_in_init(anjay_flat_in_t *ctx,
+                         const anjay_input_ctx_vtable_t *vtable,
+                         anjay_flat_parser_t *parser,
+                         const anjay_flat_parser_vtable_t *parser_vtable,
+                         avs_stream_abstract_t **stream_ptr,
+                         bool autoclose,
+                         const anjay_uri_path_t *uri) {
+    parser->vtable = parser_vtable;
+    parser->uri.length = 0;
+    const uint16_t *ids[] = {
+        uri->has_oid ? &uri->oid : NULL,
+        uri->has_iid ? &uri->iid : NULL,
+        uri->has_rid ? &uri->rid : NULL
+    };
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(ids) && ids[i]; ++i) {
+        parser->uri.ids[parser->uri.length++] = *ids[i];
+    }
+    parser->state = ANJAY_FLAT_ENTRY_NONE;
+
+    ctx->vtable = vtable;
+    ctx->parser = parser;
+    ctx->owns_parser = true;
+    ctx->child = NULL;
+    // Resource-level requests are handled like Instance-level ones, so that
+    // the top-level context reports Resource IDs, just like TLV does
+    ctx->prefix = parser->uri;
+    ctx->prefix.length = AVS_MIN(ctx->prefix.length, 2);
+    ctx->id = -1;
+
+    parser->stream = *stream_ptr;
+    parser->autoclose = autoclose;
+    if (autoclose) {
+        *stream_ptr = NULL;
+    }
+}
+
+int _anjay_flat_in_begin_value(anjay_flat_in_t *ctx, int value_type) {
+    anjay_flat_parser_t *p = ctx->parser;
+    if (p->state == ANJAY_FLAT_ENTRY_VALUE_CONSUMED) {
+        // do not advance past the value that has already been read
+        return -1;
+    }
+    int retval = ensure_entry(p);
+    if (retval) {
+        return retval == ANJAY_GET_INDEX_END ? -1 : retval;
+    }
+    if (!path_has_prefix(&p->path, &ctx->prefix)
+            || p->path.length != ctx->prefix.length + 1
+            || p->value_type != value_type) {
+        return -1;
+    }
+    return 0;
+}
+
+int _anjay_flat_in_attach_child(anjay_input_ctx_t *ctx_,
+                                anjay_input_ctx_t *child) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    int retval = _anjay_input_ctx_destroy(&ctx->child);
+    if (retval) {
+        return retval;
+    }
+    ctx->child = child;
+    return 0;
+}
+
+int _anjay_flat_in_get_id(anjay_input_ctx_t *ctx_,
+                          anjay_id_type_t *out_type,
+                          uint16_t *out_id) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    *out_type = (anjay_id_type_t) ctx->prefix.length;
+    if (ctx->id >= 0) {
+        *out_id = (uint16_t) ctx->id;
+        return 0;
+    }
+    anjay_flat_parser_t *p = ctx->parser;
+    int retval = ensure_entry(p);
+    if (retval) {
+        return retval;
+    }
+    if (!path_has_prefix(&p->path, &ctx->prefix)) {
+        return ANJAY_GET_INDEX_END;
+    }
+    if (p->path.length <= ctx->prefix.length) {
+        // this entry holds the value of an element this context is nested in
+        return ANJAY_ERR_BAD_REQUEST;
+    }
+    *out_id = p->path.ids[ctx->prefix.length];
+    ctx->id = *out_id;
+    return 0;
+}
+
+int _anjay_flat_in_next_entry(anjay_input_ctx_t *ctx_) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    if (ctx->id < 0) {
+        return 0;
+    }
+    anjay_flat_parser_t *p = ctx->parser;
+    int retval = _anjay_input_ctx_destroy(&ctx->child);
+    // skip all the remaining entries that have the same ID
+    while (!retval && !(retval = ensure_entry(p))
+            && path_has_prefix(&p->path, &ctx->prefix)
+            && p->path.length > ctx->prefix.length
+            && p->path.ids[ctx->prefix.length] == ctx->id) {
+        retval = p->vtable->skip_value(p);
+    }
+    ctx->id = -1;
+    return retval == ANJAY_GET_INDEX_END ? 0 : retval;
+}
+
+int _anjay_flat_in_close(anjay_input_ctx_t *ctx_) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    _anjay_input_ctx_destroy(&ctx->child);
+    if (ctx->owns_parser && ctx->parser->autoclose) {
+        avs_stream_cleanup(&ctx->parser->stream);
+    }
+    return 0;
+}
+
+int _anjay_flat_in_nested_ctx(anjay_input_ctx_t *ctx_,
+                              anjay_input_ctx_t **out) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    anjay_id_type_t type;
+    uint16_t id;
+    int retval = _anjay_flat_in_get_id(ctx_, &type, &id);
+    if (retval) {
+        return retval;
+    }
+    anjay_flat_in_t *child =
+            (anjay_flat_in_t *) calloc(1, sizeof(anjay_flat_in_t));
+    *out = (anjay_input_ctx_t *) child;
+    if (!child) {
+        return -1;
+    }
+    child->vtable = ctx->vtable;
+    child->parser = ctx->parser;
+    child->prefix = ctx->prefix;
+    child->prefix.ids[child->prefix.length++] = id;
+    child->id = -1;
+    return 0;
+}
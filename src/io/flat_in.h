@@ -0,0 +1,172 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_IO_FLAT_IN_H
+#define ANJAY_IO_FLAT_IN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <avsystem/commons/stream.h>
+
+#include "../io_core.h"
+#include "vtable.h"
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+/*
+ * Common part of input contexts for formats that carry a flat list of entries,
+ * each one holding a single Resource (Instance) value along with its full path
+ * (LwM2M JSON and SenML CBOR).
+ *
+ * The payload is parsed on the fly as the data model code asks for it. The
+ * entries are presented to the data model in the same hierarchical way as TLV:
+ * each context handles entries sharing a common path prefix and reports the
+ * path element that directly follows it as the ID; nested contexts narrow the
+ * prefix down by one level.
+ *
+ * Format backends embed @ref anjay_flat_parser_t as the first member of their
+ * parser state, implement @ref anjay_flat_parser_vtable_t , and only need to
+ * provide the value getters of @ref anjay_input_ctx_vtable_t themselves.
+ */
+
+#define _ANJAY_FLAT_PATH_MAX_LENGTH 4
+
+/**
+ * Buffer size sufficient to hold any path accepted by
+ * @ref _anjay_flat_parser_set_path, including the terminating nullbyte.
+ */
+#define _ANJAY_FLAT_NAME_SIZE sizeof("/65535/65535/65535/65535/")
+
+typedef struct {
+    uint16_t ids[_ANJAY_FLAT_PATH_MAX_LENGTH];
+    size_t length;
+} anjay_flat_path_t;
+
+typedef enum {
+    /* the next entry has not been parsed yet */
+    ANJAY_FLAT_ENTRY_NONE,
+    /* entry parsed up to its value */
+    ANJAY_FLAT_ENTRY_VALUE,
+    /* string value partially read, the stream is positioned inside it */
+    ANJAY_FLAT_ENTRY_VALUE_PARTIAL,
+    /* value read, the rest of the entry has not been parsed yet */
+    ANJAY_FLAT_ENTRY_VALUE_CONSUMED,
+    /* end of the entry list reached */
+    ANJAY_FLAT_ENTRY_END
+} anjay_flat_entry_state_t;
+
+typedef struct anjay_flat_parser_struct anjay_flat_parser_t;
+
+typedef struct {
+    /**
+     * Parses the next entry up to its value. On success, sets the state to
+     * ANJAY_FLAT_ENTRY_VALUE and fills in the path and value type. If there
+     * are no more entries, sets the state to ANJAY_FLAT_ENTRY_END and returns
+     * ANJAY_GET_INDEX_END.
+     */
+    int (*parse_entry_header)(anjay_flat_parser_t *p);
+
+    /**
+     * Parses the rest of the current entry, after its value has been consumed.
+     */
+    int (*finish_entry)(anjay_flat_parser_t *p);
+
+    /**
+     * Skips the value of the current entry, if it has not been read, and
+     * sets the state to ANJAY_FLAT_ENTRY_VALUE_CONSUMED.
+     */
+    int (*skip_value)(anjay_flat_parser_t *p);
+} anjay_flat_parser_vtable_t;
+
+struct anjay_flat_parser_struct {
+    const anjay_flat_parser_vtable_t *vtable;
+    avs_stream_abstract_t *stream;
+    bool autoclose;
+    /* parse or stream error; once set, it is reported by all further calls */
+    int error;
+
+    /* all entries need to lie within the request URI */
+    anjay_flat_path_t uri;
+
+    anjay_flat_entry_state_t state;
+    anjay_flat_path_t path;
+    /* format-specific value type of the current entry */
+    int value_type;
+};
+
+typedef struct {
+    const anjay_input_ctx_vtable_t *vtable;
+    anjay_flat_parser_t *parser;
+    bool owns_parser;
+    anjay_input_ctx_t *child;
+    /* entries handled by this context all start with this path */
+    anjay_flat_path_t prefix;
+    /* path element following the prefix in the current entry, or -1 */
+    int32_t id;
+} anjay_flat_in_t;
+
+/**
+ * Initializes the top-level context @p ctx and its parser @p parser , whose
+ * format-specific part is expected to be zero-initialized.
+ */
+void _anjay_flat_in_init(anjay_flat_in_t *ctx,
+                         const anjay_input_ctx_vtable_t *vtable,
+                         anjay_flat_parser_t *parser,
+                         const anjay_flat_parser_vtable_t *parser_vtable,
+                         avs_stream_abstract_t **stream_ptr,
+                         bool autoclose,
+                         const anjay_uri_path_t *uri);
+
+/**
+ * Sets the path of the current entry by parsing the concatenation of
+ * @p base_name and @p name .
+ *
+ * @returns 0 on success, or ANJAY_ERR_BAD_REQUEST if the path is invalid, is
+ *          not a Resource (Instance) path or does not lie within the request
+ *          URI.
+ */
+int _anjay_flat_parser_set_path(anjay_flat_parser_t *p,
+                                const char *base_name,
+                                const char *name);
+
+/**
+ * Makes sure that the current entry holds a value of @p value_type that may be
+ * read from @p ctx - i.e. that it is a direct child of the context's prefix.
+ *
+ * @returns 0 on success, a negative value if there is no such value, or an
+ *          error code.
+ */
+int _anjay_flat_in_begin_value(anjay_flat_in_t *ctx, int value_type);
+
+int _anjay_flat_in_attach_child(anjay_input_ctx_t *ctx,
+                                anjay_input_ctx_t *child);
+
+int _anjay_flat_in_get_id(anjay_input_ctx_t *ctx,
+                          anjay_id_type_t *out_type,
+                          uint16_t *out_id);
+
+int _anjay_flat_in_next_entry(anjay_input_ctx_t *ctx);
+
+int _anjay_flat_in_close(anjay_input_ctx_t *ctx);
+
+int _anjay_flat_in_nested_ctx(anjay_input_ctx_t *ctx,
+                              anjay_input_ctx_t **out);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif /* ANJAY_IO_FLAT_IN_H */
@@ -0,0 +1,816 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avsystem/commons/log.h>
+#include <avsystem/commons/stream.h>
+#include <avsystem/commons/utils.h>
+
+#include "../io_core.h"
+#include "base64.h"
+#include "flat_in.h"
+#include "numbers.h"
+#include "vtable.h"
+
+#define json_log(level, ...) avs_log(json, level, __VA_ARGS__)
+
+VISIBILITY_SOURCE_BEGIN
+
+/*
+ * The LwM2M JSON format is a flat list of entries, each one holding a single
+ * Resource (Instance) value along with its full path:
+ *
+ *     {"bn":"/3/0/","e":[{"n":"0","sv":"Anjay"},{"n":"7/0","v":3800}]}
+ *
+ * The entries are presented to the data model hierarchically, see flat_in.h.
+ * As they are not buffered, this only works if entries of a single Instance or
+ * Multiple Resource are adjacent, and if the "bn" and "n" names precede the
+ * entry values - which is what all known LwM2M Servers do.
+ */
+
+typedef enum {
+    JSON_VALUE_NUMBER,
+    JSON_VALUE_BOOL,
+    JSON_VALUE_OBJLNK,
+    JSON_VALUE_STRING
+} json_value_type_t;
+
+typedef struct {
+    anjay_flat_parser_t base;
+    char buffer[64];
+    size_t buffer_pos;
+    size_t buffer_size;
+    char msg_finished;
+
+    char base_name[_ANJAY_FLAT_NAME_SIZE];
+    char name[_ANJAY_FLAT_NAME_SIZE];
+    bool entries_started;
+
+    /* valid in ANJAY_FLAT_ENTRY_VALUE_PARTIAL state */
+    bool string_finished;
+    /* decoded escape sequence bytes that did not fit in the output buffer */
+    char escape_cached[4];
+    size_t num_escape_cached;
+    /* if bytes_mode == true, the current value is being read as Base64 */
+    bool bytes_mode;
+    uint8_t bytes_cached[3];
+    size_t num_bytes_cached;
+} json_parser_t;
+
+typedef struct {
+    anjay_flat_in_t ctx;
+    json_parser_t parser;
+} json_in_root_t;
+
+//////////////////////////////////////////////////////////////////// TOKENIZER
+
+static int peek_char(json_parser_t *p) {
+    while (p->buffer_pos >= p->buffer_size) {
+        if (p->msg_finished || p->base.error) {
+            return EOF;
+        }
+        p->buffer_pos = 0;
+        p->buffer_size = 0;
+        if ((p->base.error = avs_stream_read(p->base.stream, &p->buffer_size,
+                                        &p->msg_finished, p->buffer,
+                                        sizeof(p->buffer)))) {
+            return EOF;
+        }
+    }
+    return (unsigned char) p->buffer[p->buffer_pos];
+}
+
+static int get_char(json_parser_t *p) {
+    int result = peek_char(p);
+    if (result != EOF) {
+        ++p->buffer_pos;
+    }
+    return result;
+}
+
+static int parse_error(json_parser_t *p) {
+    return p->base.error ? p->base.error : ANJAY_ERR_BAD_REQUEST;
+}
+
+static int skip_whitespace(json_parser_t *p) {
+    int result;
+    while ((result = peek_char(p)) == ' ' || result == '\t'
+            || result == '\n' || result == '\r') {
+        ++p->buffer_pos;
+    }
+    return result;
+}
+
+static int expect_char(json_parser_t *p, char expected) {
+    if (skip_whitespace(p) != expected) {
+        return parse_error(p);
+    }
+    ++p->buffer_pos;
+    return 0;
+}
+
+static int hex_digit_value(int c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int read_hex4(json_parser_t *p, uint32_t *out) {
+    *out = 0;
+    for (int i = 0; i < 4; ++i) {
+        int digit = hex_digit_value(get_char(p));
+        if (digit < 0) {
+            return -1;
+        }
+        *out = (*out << 4) | (uint32_t) digit;
+    }
+    return 0;
+}
+
+static size_t encode_utf8(char *out, uint32_t code_point) {
+    if (code_point < 0x80) {
+        out[0] = (char) code_point;
+        return 1;
+    } else if (code_point < 0x800) {
+        out[0] = (char) (0xC0 | (code_point >> 6));
+        out[1] = (char) (0x80 | (code_point & 0x3F));
+        return 2;
+    } else if (code_point < 0x10000) {
+        out[0] = (char) (0xE0 | (code_point >> 12));
+        out[1] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (code_point & 0x3F));
+        return 3;
+    } else {
+        out[0] = (char) (0xF0 | (code_point >> 18));
+        out[1] = (char) (0x80 | ((code_point >> 12) & 0x3F));
+        out[2] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+        out[3] = (char) (0x80 | (code_point & 0x3F));
+        return 4;
+    }
+}
+
+/* Decodes a single escape sequence; the backslash is already consumed. */
+static int read_escape(json_parser_t *p, char *out, size_t *out_size) {
+    uint32_t code_point;
+    switch (get_char(p)) {
+    case '"':  *out = '"';  break;
+    case '\\': *out = '\\'; break;
+    case '/':  *out = '/';  break;
+    case 'b':  *out = '\b'; break;
+    case 'f':  *out = '\f'; break;
+    case 'n':  *out = '\n'; break;
+    case 'r':  *out = '\r'; break;
+    case 't':  *out = '\t'; break;
+    case 'u':
+        if (read_hex4(p, &code_point)
+                || (code_point >= 0xDC00 && code_point < 0xE000)) {
+            return -1;
+        }
+        if (code_point >= 0xD800 && code_point < 0xDC00) {
+            uint32_t low_surrogate;
+            if (get_char(p) != '\\' || get_char(p) != 'u'
+                    || read_hex4(p, &low_surrogate)
+                    || low_surrogate < 0xDC00 || low_surrogate >= 0xE000) {
+                return -1;
+            }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10)
+                    + (low_surrogate - 0xDC00);
+        }
+        *out_size = encode_utf8(out, code_point);
+        return 0;
+    default:
+        return -1;
+    }
+    *out_size = 1;
+    return 0;
+}
+
+/*
+ * Reads unescaped string contents into @p out, until the closing quote or until
+ * the buffer is full. The opening quote needs to be already consumed.
+ *
+ * Reading stops before the buffer is full rather than split an escape sequence
+ * that might not fit in it. The only exception is an escape sequence at the
+ * very beginning of a buffer shorter than 4 bytes; its decoded bytes that do
+ * not fit are cached in the parser and returned by the next call.
+ */
+static int read_string_chars(json_parser_t *p,
+                             char *out,
+                             size_t size,
+                             size_t *out_length,
+                             bool *out_finished) {
+    *out_length = AVS_MIN(p->num_escape_cached, size);
+    memcpy(out, p->escape_cached, *out_length);
+    memmove(p->escape_cached, p->escape_cached + *out_length,
+            p->num_escape_cached - *out_length);
+    p->num_escape_cached -= *out_length;
+    *out_finished = false;
+    while (*out_length < size) {
+        int c = peek_char(p);
+        if (c == '"') {
+            ++p->buffer_pos;
+            *out_finished = true;
+            return 0;
+        } else if (c == EOF || c < 0x20) {
+            return parse_error(p);
+        } else if (c != '\\') {
+            ++p->buffer_pos;
+            out[(*out_length)++] = (char) c;
+            continue;
+        } else if (*out_length && size - *out_length < 4) {
+            break;
+        }
+        ++p->buffer_pos;
+        char escaped[4];
+        size_t escaped_size;
+        if (read_escape(p, escaped, &escaped_size)) {
+            return parse_error(p);
+        }
+        size_t bytes_to_copy = AVS_MIN(escaped_size, size - *out_length);
+        memcpy(&out[*out_length], escaped, bytes_to_copy);
+        *out_length += bytes_to_copy;
+        p->num_escape_cached = escaped_size - bytes_to_copy;
+        memcpy(p->escape_cached, escaped + bytes_to_copy,
+               p->num_escape_cached);
+    }
+    if (!p->num_escape_cached && peek_char(p) == '"') {
+        ++p->buffer_pos;
+        *out_finished = true;
+    }
+    return 0;
+}
+
+static int skip_string_rest(json_parser_t *p) {
+    p->num_escape_cached = 0;
+    int c;
+    while ((c = get_char(p)) != '"') {
+        if (c == EOF) {
+            return parse_error(p);
+        } else if (c == '\\') {
+            get_char(p);
+        }
+    }
+    return 0;
+}
+
+/* Reads a whole string value into a null-terminated buffer. */
+static int read_short_string(json_parser_t *p, char *out, size_t size) {
+    size_t length;
+    bool finished;
+    int retval;
+    if ((retval = expect_char(p, '"'))
+            || (retval = read_string_chars(p, out, size - 1, &length,
+                                           &finished))) {
+        return retval;
+    }
+    out[length] = '\0';
+    if (!finished) {
+        p->num_escape_cached = 0;
+        return parse_error(p);
+    }
+    return 0;
+}
+
+/* Reads a bare token (number or literal) into a null-terminated buffer. */
+static int read_token(json_parser_t *p, char *out, size_t size) {
+    size_t length = 0;
+    int c;
+    skip_whitespace(p);
+    while ((c = peek_char(p)) != EOF
+            && ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')
+                    || c == '-' || c == '+' || c == '.' || c == 'E')) {
+        if (length >= size - 1) {
+            return -1;
+        }
+        out[length++] = (char) c;
+        ++p->buffer_pos;
+    }
+    out[length] = '\0';
+    return length ? 0 : parse_error(p);
+}
+
+static int skip_value(json_parser_t *p) {
+    unsigned depth = 0;
+    do {
+        int c = skip_whitespace(p);
+        int retval;
+        if (c == '"') {
+            ++p->buffer_pos;
+            if ((retval = skip_string_rest(p))) {
+                return retval;
+            }
+        } else if (c == '{' || c == '[') {
+            ++p->buffer_pos;
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (!depth) {
+                return parse_error(p);
+            }
+            ++p->buffer_pos;
+            --depth;
+        } else if (c == ',' || c == ':') {
+            if (!depth) {
+                return parse_error(p);
+            }
+            ++p->buffer_pos;
+        } else {
+            char token[32];
+            if ((retval = read_token(p, token, sizeof(token)))) {
+                return retval;
+            }
+        }
+    } while (depth);
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////// PARSER
+
+static int read_key(json_parser_t *p, char *out, size_t size) {
+    size_t length;
+    bool finished;
+    int retval;
+    if ((retval = expect_char(p, '"'))
+            || (retval = read_string_chars(p, out, size - 1, &length,
+                                           &finished))) {
+        return retval;
+    }
+    out[length] = '\0';
+    if (!finished) {
+        // not any of the keys we know; make sure it does not match any
+        if ((retval = skip_string_rest(p))) {
+            return retval;
+        }
+        out[0] = '\0';
+    }
+    return expect_char(p, ':');
+}
+
+/* Returns 0 if there are more members in the current object, 1 if not. */
+static int next_member(json_parser_t *p) {
+    switch (skip_whitespace(p)) {
+    case ',':
+        ++p->buffer_pos;
+        return 0;
+    case '}':
+        ++p->buffer_pos;
+        return 1;
+    default:
+        return parse_error(p);
+    }
+}
+
+/*
+ * Parses the top-level object up to the opening bracket of the entry list.
+ */
+static int parse_header(json_parser_t *p) {
+    int retval = expect_char(p, '{');
+    if (retval) {
+        return retval;
+    }
+    while (!retval) {
+        char key[4];
+        if ((retval = read_key(p, key, sizeof(key)))) {
+            return retval;
+        }
+        if (!strcmp(key, "bn")) {
+            retval = read_short_string(p, p->base_name, sizeof(p->base_name));
+        } else if (!strcmp(key, "e")) {
+            if (!(retval = expect_char(p, '['))) {
+                p->entries_started = true;
+                return 0;
+            }
+        } else {
+            retval = skip_value(p);
+        }
+        if (!retval) {
+            retval = next_member(p);
+        }
+    }
+    if (retval > 0) {
+        // object finished without an entry list
+        p->entries_started = true;
+        p->base.state = ANJAY_FLAT_ENTRY_END;
+        return skip_whitespace(p) == EOF ? ANJAY_GET_INDEX_END
+                                         : parse_error(p);
+    }
+    return retval;
+}
+
+/*
+ * Parses whatever follows the entry list, up to the end of the payload.
+ */
+static int parse_trailer(json_parser_t *p) {
+    int retval;
+    while (!(retval = next_member(p))) {
+        char key[4];
+        if ((retval = read_key(p, key, sizeof(key)))
+                || (retval = skip_value(p))) {
+            return retval;
+        }
+    }
+    if (retval < 0) {
+        return retval;
+    }
+    return skip_whitespace(p) == EOF ? ANJAY_GET_INDEX_END : parse_error(p);
+}
+
+/* Returns the value type stored under @p key, or -1 if it is not a value. */
+static int value_type_from_key(const char *key) {
+    if (!strcmp(key, "v")) {
+        return JSON_VALUE_NUMBER;
+    } else if (!strcmp(key, "bv")) {
+        return JSON_VALUE_BOOL;
+    } else if (!strcmp(key, "ov")) {
+        return JSON_VALUE_OBJLNK;
+    } else if (!strcmp(key, "sv")) {
+        return JSON_VALUE_STRING;
+    }
+    return -1;
+}
+
+/*
+ * Parses the next entry up to its value, leaving the stream positioned at the
+ * value itself.
+ */
+static int parse_entry_header(anjay_flat_parser_t *p_) {
+    json_parser_t *p = (json_parser_t *) p_;
+    int retval;
+    if (!p->entries_started) {
+        if ((retval = parse_header(p))) {
+            return retval;
+        }
+        if (skip_whitespace(p) == ']') {
+            ++p->buffer_pos;
+            p->base.state = ANJAY_FLAT_ENTRY_END;
+            return parse_trailer(p);
+        }
+    } else {
+        switch (skip_whitespace(p)) {
+        case ',':
+            ++p->buffer_pos;
+            break;
+        case ']':
+            ++p->buffer_pos;
+            p->base.state = ANJAY_FLAT_ENTRY_END;
+            return parse_trailer(p);
+        default:
+            return parse_error(p);
+        }
+    }
+
+    if ((retval = expect_char(p, '{'))) {
+        return retval;
+    }
+    p->name[0] = '\0';
+    do {
+        char key[4];
+        if ((retval = read_key(p, key, sizeof(key)))) {
+            return retval;
+        }
+        int value_type = value_type_from_key(key);
+        if (value_type >= 0) {
+            if ((retval = _anjay_flat_parser_set_path(&p->base, p->base_name,
+                                                      p->name))) {
+                return retval;
+            }
+            skip_whitespace(p);
+            p->base.value_type = value_type;
+            p->base.state = ANJAY_FLAT_ENTRY_VALUE;
+            return 0;
+        } else if (!strcmp(key, "n")) {
+            retval = read_short_string(p, p->name, sizeof(p->name));
+        } else {
+            retval = skip_value(p);
+        }
+    } while (!retval && !(retval = next_member(p)));
+
+    if (retval > 0) {
+        json_log(WARNING, "JSON entry without a value");
+        retval = ANJAY_ERR_BAD_REQUEST;
+    }
+    return retval;
+}
+
+/*
+ * Finishes processing of the current entry, skipping its value if it has not
+ * been read.
+ */
+static int skip_entry(anjay_flat_parser_t *p_) {
+    json_parser_t *p = (json_parser_t *) p_;
+    int retval = 0;
+    switch (p->base.state) {
+    case ANJAY_FLAT_ENTRY_VALUE:
+        retval = skip_value(p);
+        break;
+    case ANJAY_FLAT_ENTRY_VALUE_PARTIAL:
+        if (!p->string_finished) {
+            retval = skip_string_rest(p);
+        }
+        break;
+    default:
+        break;
+    }
+    p->bytes_mode = false;
+    p->num_bytes_cached = 0;
+    p->num_escape_cached = 0;
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    return retval;
+}
+
+/* Parses the rest of the current entry after its value. */
+static int finish_entry(anjay_flat_parser_t *p_) {
+    json_parser_t *p = (json_parser_t *) p_;
+    int retval;
+    while (!(retval = next_member(p))) {
+        char key[4];
+        if ((retval = read_key(p, key, sizeof(key)))
+                || (retval = skip_value(p))) {
+            return retval;
+        }
+    }
+    return retval < 0 ? retval : 0;
+}
+
+static const anjay_flat_parser_vtable_t JSON_PARSER_VTABLE = {
+    parse_entry_header,
+    finish_entry,
+    skip_entry
+};
+
+///////////////////////////////////////////////////////////////////// CONTEXTS
+
+static int begin_value(anjay_flat_in_t *ctx, json_value_type_t type) {
+    return _anjay_flat_in_begin_value(ctx, (int) type);
+}
+
+static int begin_string(anjay_flat_in_t *ctx, bool bytes_mode) {
+    json_parser_t *p = (json_parser_t *) ctx->parser;
+    if (p->base.state == ANJAY_FLAT_ENTRY_VALUE_PARTIAL) {
+        return p->bytes_mode == bytes_mode ? 0 : -1;
+    }
+    int retval;
+    if ((retval = begin_value(ctx, JSON_VALUE_STRING))
+            || (retval = expect_char(p, '"'))) {
+        return retval;
+    }
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_PARTIAL;
+    p->string_finished = false;
+    p->bytes_mode = bytes_mode;
+    return 0;
+}
+
+static void flush_bytes_cache(json_parser_t *p,
+                              uint8_t **out_buf,
+                              size_t *buf_size) {
+    size_t bytes_to_copy = AVS_MIN(p->num_bytes_cached, *buf_size);
+    memcpy(*out_buf, p->bytes_cached, bytes_to_copy);
+    memmove(p->bytes_cached, p->bytes_cached + bytes_to_copy,
+            p->num_bytes_cached - bytes_to_copy);
+    p->num_bytes_cached -= bytes_to_copy;
+    *buf_size -= bytes_to_copy;
+    *out_buf += bytes_to_copy;
+}
+
+static int json_get_some_bytes(anjay_input_ctx_t *ctx_,
+                               size_t *out_bytes_read,
+                               bool *out_message_finished,
+                               void *out_buf,
+                               size_t buf_size) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    json_parser_t *p = (json_parser_t *) ctx->parser;
+    *out_bytes_read = 0;
+    *out_message_finished = false;
+    int retval = begin_string(ctx, true);
+    if (retval) {
+        return retval;
+    }
+
+    uint8_t *current = (uint8_t *) out_buf;
+    flush_bytes_cache(p, &current, &buf_size);
+    while (buf_size > 0 && !p->string_finished) {
+        // decode as many quadruplets as fit straight into the output buffer;
+        // if not even a single one does, decode it into the cache instead
+        char encoded[4 * 16];
+        size_t quadruplets = AVS_MIN(buf_size / 3, sizeof(encoded) / 4);
+        bool use_cache = (quadruplets == 0);
+        if (use_cache) {
+            quadruplets = 1;
+        }
+        size_t encoded_length = 0;
+        while (encoded_length < 4 * quadruplets && !p->string_finished) {
+            size_t chunk_length;
+            if ((retval = read_string_chars(p, encoded + encoded_length,
+                                            4 * quadruplets - encoded_length,
+                                            &chunk_length,
+                                            &p->string_finished))) {
+                return retval;
+            }
+            encoded_length += chunk_length;
+        }
+        size_t num_decoded;
+        if ((!p->string_finished && encoded[encoded_length - 1] == '=')
+                || _anjay_base64_decode(use_cache ? p->bytes_cached : current,
+                                        &num_decoded, encoded,
+                                        encoded_length)) {
+            return ANJAY_ERR_BAD_REQUEST;
+        }
+        if (use_cache) {
+            p->num_bytes_cached = num_decoded;
+            flush_bytes_cache(p, &current, &buf_size);
+        } else {
+            current += num_decoded;
+            buf_size -= num_decoded;
+        }
+    }
+    if (p->string_finished && !p->num_bytes_cached) {
+        p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+        p->bytes_mode = false;
+        *out_message_finished = true;
+    }
+    *out_bytes_read = (size_t) (current - (uint8_t *) out_buf);
+    return 0;
+}
+
+static int json_get_string(anjay_input_ctx_t *ctx_,
+                           char *out_buf,
+                           size_t buf_size) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    json_parser_t *p = (json_parser_t *) ctx->parser;
+    if (!buf_size) {
+        return -1;
+    }
+    size_t length;
+    int retval;
+    if ((retval = begin_string(ctx, false))
+            || (retval = read_string_chars(p, out_buf, buf_size - 1, &length,
+                                           &p->string_finished))) {
+        return retval;
+    }
+    out_buf[length] = '\0';
+    if (!p->string_finished) {
+        return ANJAY_BUFFER_TOO_SHORT;
+    }
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    return 0;
+}
+
+static int read_number(anjay_flat_in_t *ctx, char *out, size_t size) {
+    json_parser_t *p = (json_parser_t *) ctx->parser;
+    int retval;
+    if ((retval = begin_value(ctx, JSON_VALUE_NUMBER))
+            || (retval = read_token(p, out, size))) {
+        return retval;
+    }
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    // JSON numbers have no leading plus or zeros, and are always decimal
+    const char *digits = (out[0] == '-') ? out + 1 : out;
+    if (digits[0] < '0' || digits[0] > '9'
+            || (digits[0] == '0' && digits[1] >= '0' && digits[1] <= '9')) {
+        return -1;
+    }
+    return 0;
+}
+
+static int json_get_i64(anjay_input_ctx_t *ctx, int64_t *value) {
+    char buf[_ANJAY_I64_STRING_SIZE];
+    int retval = read_number((anjay_flat_in_t *) ctx, buf, sizeof(buf));
+    if (!retval) {
+        retval = _anjay_string_to_i64(buf, strlen(buf), value);
+    }
+    return retval;
+}
+
+static int json_get_i32(anjay_input_ctx_t *ctx, int32_t *value) {
+    int64_t i64_value;
+    int retval = json_get_i64(ctx, &i64_value);
+    if (retval) {
+        return retval;
+    }
+    if (i64_value < INT32_MIN || i64_value > INT32_MAX) {
+        return -1;
+    }
+    *value = (int32_t) i64_value;
+    return 0;
+}
+
+static int json_get_float(anjay_input_ctx_t *ctx, float *value) {
+    char buf[ANJAY_MAX_FLOAT_STRING_SIZE];
+    int retval = read_number((anjay_flat_in_t *) ctx, buf, sizeof(buf));
+    if (!retval) {
+        retval = _anjay_string_to_float(buf, strlen(buf), value);
+    }
+    return retval;
+}
+
+static int json_get_double(anjay_input_ctx_t *ctx, double *value) {
+    char buf[ANJAY_MAX_DOUBLE_STRING_SIZE];
+    int retval = read_number((anjay_flat_in_t *) ctx, buf, sizeof(buf));
+    if (!retval) {
+        retval = _anjay_string_to_double(buf, strlen(buf), value);
+    }
+    return retval;
+}
+
+static int json_get_bool(anjay_input_ctx_t *ctx_, bool *value) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    json_parser_t *p = (json_parser_t *) ctx->parser;
+    char buf[sizeof("false")];
+    int retval;
+    if ((retval = begin_value(ctx, JSON_VALUE_BOOL))
+            || (retval = read_token(p, buf, sizeof(buf)))) {
+        return retval;
+    }
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    if (!strcmp(buf, "true")) {
+        *value = true;
+    } else if (!strcmp(buf, "false")) {
+        *value = false;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static int json_get_objlnk(anjay_input_ctx_t *ctx_,
+                           anjay_oid_t *out_oid, anjay_iid_t *out_iid) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    json_parser_t *p = (json_parser_t *) ctx->parser;
+    char buf[sizeof("65535:65535")];
+    int retval;
+    if ((retval = begin_value(ctx, JSON_VALUE_OBJLNK))
+            || (retval = read_short_string(p, buf, sizeof(buf)))) {
+        return retval;
+    }
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    const char *colon = strchr(buf, ':');
+    int64_t oid, iid;
+    if (!colon
+            || _anjay_string_to_i64(buf, (size_t) (colon - buf), &oid)
+            || _anjay_string_to_i64(colon + 1, strlen(colon + 1), &iid)
+            || oid < 0 || oid > UINT16_MAX
+            || iid < 0 || iid > UINT16_MAX) {
+        return -1;
+    }
+    *out_oid = (anjay_oid_t) oid;
+    *out_iid = (anjay_iid_t) iid;
+    return 0;
+}
+
+static const anjay_input_ctx_vtable_t JSON_IN_VTABLE = {
+    json_get_some_bytes,
+    json_get_string,
+    json_get_i32,
+    json_get_i64,
+    json_get_float,
+    json_get_double,
+    json_get_bool,
+    json_get_objlnk,
+    _anjay_flat_in_attach_child,
+    _anjay_flat_in_get_id,
+    _anjay_flat_in_next_entry,
+    _anjay_flat_in_close,
+    _anjay_flat_in_nested_ctx
+};
+
+int _anjay_input_json_create(anjay_input_ctx_t **out,
+                             avs_stream_abstract_t **stream_ptr,
+                             bool autoclose,
+                             const anjay_uri_path_t *uri) {
+    json_in_root_t *root = (json_in_root_t *) calloc(1, sizeof(json_in_root_t));
+    *out = (anjay_input_ctx_t *) root;
+    if (!root) {
+        return -1;
+    }
+
+    _anjay_flat_in_init(&root->ctx, &JSON_IN_VTABLE, &root->parser.base,
+                        &JSON_PARSER_VTABLE, stream_ptr, autoclose, uri);
+    return 0;
+}
+
+#ifdef ANJAY_TEST
+#include "test/json_in.c"
+#endif
@@ -30,6 +30,7 @@
 
 #include "../io_core.h"
 #include "base64_out.h"
+#include "numbers.h"
 #include "vtable.h"
 
 #define json_log(level, ...) avs_log(json, level, __VA_ARGS__)
@@ -85,6 +86,13 @@ typedef struct {
     anjay_riid_t riid;
 } json_out_array_t;
 
+#define NAME_PREFIX "{\"n\":\""
+#define NAME_SUFFIX "\","
+#define NAME_BUFFER_SIZE                           \
+    (sizeof(NAME_PREFIX) - 1                       \
+     + sizeof("/65535/65535/65535/65535") - 1      \
+     + sizeof(NAME_SUFFIX))
+
 typedef struct json_out_struct {
     const anjay_output_ctx_vtable_t *vtable;
     avs_stream_abstract_t *stream;
@@ -97,6 +105,12 @@ typedef struct json_out_struct {
     size_t num_path_elems;
     /* Number of elements in the node_path which form a basename */
     size_t num_base_path_elems;
+    /* Element name prefix of the current child path, kept rendered between
+       entries, e.g. {"n":"/Z/W for the example above. name_end[i] is the
+       offset just past path[i], so that a path change only re-renders the
+       suffix starting at the first changed element. */
+    char name[NAME_BUFFER_SIZE];
+    size_t name_end[4];
 
     bool needs_separator;
     json_out_array_t array_ctx;
@@ -126,6 +140,19 @@ push_path_elem(json_out_t *ctx, anjay_id_type_t type, uint16_t id) {
     };
 }
 
+static void render_last_path_elem(json_out_t *ctx) {
+    const size_t index = ctx->num_path_elems - 1;
+    if (index < ctx->num_base_path_elems) {
+        return;
+    }
+    size_t offset = (index > ctx->num_base_path_elems)
+            ? ctx->name_end[index - 1]
+            : sizeof(NAME_PREFIX) - 1;
+    ctx->name[offset++] = '/';
+    offset += _anjay_i64_to_string(&ctx->name[offset], ctx->path[index].id);
+    ctx->name_end[index] = offset;
+}
+
 static void
 update_node_path(json_out_t *ctx, anjay_id_type_t type, uint16_t id) {
     AVS_STATIC_ASSERT(ANJAY_ID_OID < ANJAY_ID_IID, bad_ordering_oid_iid);
@@ -159,35 +186,16 @@ update_node_path(json_out_t *ctx, anjay_id_type_t type, uint16_t id) {
         /* But we need to be prepared for that on production. */
         ctx->num_base_path_elems = ctx->num_path_elems;
         json_log(ERROR, "num_path_elems < num_base_path_elems!");
+    } else {
+        render_last_path_elem(ctx);
     }
 }
 
-#define MAX_CHILD_PATH_LEN sizeof("/65535/65535/65535")
-
 static size_t
 count_child_path_elems(json_out_t *ctx) {
     return ctx->num_path_elems - ctx->num_base_path_elems;
 }
 
-static ssize_t child_path_to_string(json_out_t *ctx, char *dest, size_t size) {
-    switch (count_child_path_elems(ctx)) {
-    case 1:
-        return avs_simple_snprintf(dest, size, "/%"PRId32,
-                                   ctx->path[ctx->num_base_path_elems].id);
-    case 2:
-        return avs_simple_snprintf(dest, size, "/%"PRId32"/%"PRId32,
-                                   ctx->path[ctx->num_base_path_elems].id,
-                                   ctx->path[ctx->num_base_path_elems + 1].id);
-    case 3:
-        return avs_simple_snprintf(dest, size, "/%"PRId32"/%"PRId32"/%"PRId32,
-                                   ctx->path[ctx->num_base_path_elems].id,
-                                   ctx->path[ctx->num_base_path_elems + 1].id,
-                                   ctx->path[ctx->num_base_path_elems + 2].id);
-    default:
-        return -1;
-    }
-}
-
 typedef struct {
     anjay_oid_t oid;
     anjay_iid_t iid;
@@ -245,6 +253,9 @@ static int write_quoted_string(avs_stream_abstract_t *stream,
 static int write_variable(avs_stream_abstract_t *stream,
                           json_data_type_t type,
                           const void *value) {
+    AVS_STATIC_ASSERT(_ANJAY_DOUBLE_STRING_SIZE >= _ANJAY_I64_STRING_SIZE,
+                      double_string_fits_i64_string);
+    char buf[_ANJAY_DOUBLE_STRING_SIZE];
     int retval =
             avs_stream_write_f(stream, "\"%s\":", data_type_to_string(type));
     if (retval) {
@@ -253,13 +264,17 @@ static int write_variable(avs_stream_abstract_t *stream,
 
     switch (type) {
     case JSON_DATA_I32:
-        return avs_stream_write_f(stream, "%" PRIi32, *(const int32_t *) value);
+        return avs_stream_write(stream, buf, _anjay_i64_to_string(
+                buf, *(const int32_t *) value));
     case JSON_DATA_I64:
-        return avs_stream_write_f(stream, "%" PRIi64, *(const int64_t *) value);
+        return avs_stream_write(stream, buf, _anjay_i64_to_string(
+                buf, *(const int64_t *) value));
     case JSON_DATA_F32:
-        return avs_stream_write_f(stream, "%f", *(const float *) value);
+        return avs_stream_write(stream, buf, _anjay_float_to_string(
+                buf, *(const float *) value));
     case JSON_DATA_F64:
-        return avs_stream_write_f(stream, "%f", *(const double *) value);
+        return avs_stream_write(stream, buf, _anjay_double_to_string(
+                buf, *(const double *) value));
     case JSON_DATA_BOOL:
         return avs_stream_write_f(stream, "%s",
                                   (*(const bool *) value) ? "true" : "false");
@@ -290,22 +305,13 @@ static int write_uri(avs_stream_abstract_t *stream,
 }
 
 static int write_element_name(json_out_t *ctx) {
-    const char *name = NULL;
-    char buf[MAX_CHILD_PATH_LEN];
-    if (count_child_path_elems(ctx)) {
-        if (child_path_to_string(ctx, buf, sizeof(buf)) < 0) {
-            return -1;
-        }
-        name = buf;
+    if (!count_child_path_elems(ctx)) {
+        return avs_stream_write(ctx->stream, "{", 1);
     }
-
-    int retval;
-    if (name) {
-        retval = avs_stream_write_f(ctx->stream, "{\"n\":\"%s\",", name);
-    } else {
-        retval = avs_stream_write(ctx->stream, "{", 1);
-    }
-    return retval;
+    size_t length = ctx->name_end[ctx->num_path_elems - 1];
+    memcpy(&ctx->name[length], NAME_SUFFIX, sizeof(NAME_SUFFIX) - 1);
+    length += sizeof(NAME_SUFFIX) - 1;
+    return avs_stream_write(ctx->stream, ctx->name, length);
 }
 
 static int write_response_element(json_out_t *ctx,
@@ -550,7 +556,8 @@ static const anjay_output_ctx_vtable_t JSON_OUT_VTABLE = {
     json_ret_object_start,
     json_ret_object_finish,
     json_set_id,
-    json_output_close
+    json_output_close,
+    NULL
 };
 
 static int write_response_preamble(avs_stream_abstract_t *stream,
@@ -572,6 +579,7 @@ _anjay_output_json_create(avs_stream_abstract_t *stream,
         ctx->vtable = &JSON_OUT_VTABLE;
         ctx->errno_ptr = errno_ptr;
         ctx->stream = stream;
+        memcpy(ctx->name, NAME_PREFIX, sizeof(NAME_PREFIX) - 1);
         if (uri->has_oid) {
             update_node_path(ctx, ANJAY_ID_OID, uri->oid);
             ++ctx->num_base_path_elems;
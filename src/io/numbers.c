@@ -0,0 +1,779 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avsystem/commons/defs.h>
+
+#include "numbers.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+static const char DIGIT_PAIRS[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+static size_t u64_to_string(char *out, uint64_t value) {
+    char tmp[_ANJAY_I64_STRING_SIZE];
+    char *ptr = tmp + sizeof(tmp);
+    while (value >= 100) {
+        const char *pair = &DIGIT_PAIRS[2 * (value % 100)];
+        value /= 100;
+        *--ptr = pair[1];
+        *--ptr = pair[0];
+    }
+    if (value >= 10) {
+        *--ptr = DIGIT_PAIRS[2 * value + 1];
+        *--ptr = DIGIT_PAIRS[2 * value];
+    } else {
+        *--ptr = (char) ('0' + value);
+    }
+    size_t length = (size_t) (tmp + sizeof(tmp) - ptr);
+    memcpy(out, ptr, length);
+    out[length] = '\0';
+    return length;
+}
+
+size_t _anjay_i64_to_string(char *out, int64_t value) {
+    if (value < 0) {
+        *out = '-';
+        return 1 + u64_to_string(out + 1, -(uint64_t) value);
+    }
+    return u64_to_string(out, (uint64_t) value);
+}
+
+/*
+ * Floating-point formatting below is an implementation of the Grisu2
+ * algorithm, as described in: Florian Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers", PLDI 2010.
+ */
+
+typedef struct {
+    uint64_t f;
+    int e;
+} diy_fp_t;
+
+// normalized approximations of 10^k for k = -348, -340, ..., 340
+static const diy_fp_t CACHED_POWERS[] = {
+    { UINT64_C(0xFA8FD5A0081C0288), -1220 },
+    { UINT64_C(0xBAAEE17FA23EBF76), -1193 },
+    { UINT64_C(0x8B16FB203055AC76), -1166 },
+    { UINT64_C(0xCF42894A5DCE35EA), -1140 },
+    { UINT64_C(0x9A6BB0AA55653B2D), -1113 },
+    { UINT64_C(0xE61ACF033D1A45DF), -1087 },
+    { UINT64_C(0xAB70FE17C79AC6CA), -1060 },
+    { UINT64_C(0xFF77B1FCBEBCDC4F), -1034 },
+    { UINT64_C(0xBE5691EF416BD60C), -1007 },
+    { UINT64_C(0x8DD01FAD907FFC3C),  -980 },
+    { UINT64_C(0xD3515C2831559A83),  -954 },
+    { UINT64_C(0x9D71AC8FADA6C9B5),  -927 },
+    { UINT64_C(0xEA9C227723EE8BCB),  -901 },
+    { UINT64_C(0xAECC49914078536D),  -874 },
+    { UINT64_C(0x823C12795DB6CE57),  -847 },
+    { UINT64_C(0xC21094364DFB5637),  -821 },
+    { UINT64_C(0x9096EA6F3848984F),  -794 },
+    { UINT64_C(0xD77485CB25823AC7),  -768 },
+    { UINT64_C(0xA086CFCD97BF97F4),  -741 },
+    { UINT64_C(0xEF340A98172AACE5),  -715 },
+    { UINT64_C(0xB23867FB2A35B28E),  -688 },
+    { UINT64_C(0x84C8D4DFD2C63F3B),  -661 },
+    { UINT64_C(0xC5DD44271AD3CDBA),  -635 },
+    { UINT64_C(0x936B9FCEBB25C996),  -608 },
+    { UINT64_C(0xDBAC6C247D62A584),  -582 },
+    { UINT64_C(0xA3AB66580D5FDAF6),  -555 },
+    { UINT64_C(0xF3E2F893DEC3F126),  -529 },
+    { UINT64_C(0xB5B5ADA8AAFF80B8),  -502 },
+    { UINT64_C(0x87625F056C7C4A8B),  -475 },
+    { UINT64_C(0xC9BCFF6034C13053),  -449 },
+    { UINT64_C(0x964E858C91BA2655),  -422 },
+    { UINT64_C(0xDFF9772470297EBD),  -396 },
+    { UINT64_C(0xA6DFBD9FB8E5B88F),  -369 },
+    { UINT64_C(0xF8A95FCF88747D94),  -343 },
+    { UINT64_C(0xB94470938FA89BCF),  -316 },
+    { UINT64_C(0x8A08F0F8BF0F156B),  -289 },
+    { UINT64_C(0xCDB02555653131B6),  -263 },
+    { UINT64_C(0x993FE2C6D07B7FAC),  -236 },
+    { UINT64_C(0xE45C10C42A2B3B06),  -210 },
+    { UINT64_C(0xAA242499697392D3),  -183 },
+    { UINT64_C(0xFD87B5F28300CA0E),  -157 },
+    { UINT64_C(0xBCE5086492111AEB),  -130 },
+    { UINT64_C(0x8CBCCC096F5088CC),  -103 },
+    { UINT64_C(0xD1B71758E219652C),   -77 },
+    { UINT64_C(0x9C40000000000000),   -50 },
+    { UINT64_C(0xE8D4A51000000000),   -24 },
+    { UINT64_C(0xAD78EBC5AC620000),     3 },
+    { UINT64_C(0x813F3978F8940984),    30 },
+    { UINT64_C(0xC097CE7BC90715B3),    56 },
+    { UINT64_C(0x8F7E32CE7BEA5C70),    83 },
+    { UINT64_C(0xD5D238A4ABE98068),   109 },
+    { UINT64_C(0x9F4F2726179A2245),   136 },
+    { UINT64_C(0xED63A231D4C4FB27),   162 },
+    { UINT64_C(0xB0DE65388CC8ADA8),   189 },
+    { UINT64_C(0x83C7088E1AAB65DB),   216 },
+    { UINT64_C(0xC45D1DF942711D9A),   242 },
+    { UINT64_C(0x924D692CA61BE758),   269 },
+    { UINT64_C(0xDA01EE641A708DEA),   295 },
+    { UINT64_C(0xA26DA3999AEF774A),   322 },
+    { UINT64_C(0xF209787BB47D6B85),   348 },
+    { UINT64_C(0xB454E4A179DD1877),   375 },
+    { UINT64_C(0x865B86925B9BC5C2),   402 },
+    { UINT64_C(0xC83553C5C8965D3D),   428 },
+    { UINT64_C(0x952AB45CFA97A0B3),   455 },
+    { UINT64_C(0xDE469FBD99A05FE3),   481 },
+    { UINT64_C(0xA59BC234DB398C25),   508 },
+    { UINT64_C(0xF6C69A72A3989F5C),   534 },
+    { UINT64_C(0xB7DCBF5354E9BECE),   561 },
+    { UINT64_C(0x88FCF317F22241E2),   588 },
+    { UINT64_C(0xCC20CE9BD35C78A5),   614 },
+    { UINT64_C(0x98165AF37B2153DF),   641 },
+    { UINT64_C(0xE2A0B5DC971F303A),   667 },
+    { UINT64_C(0xA8D9D1535CE3B396),   694 },
+    { UINT64_C(0xFB9B7CD9A4A7443C),   720 },
+    { UINT64_C(0xBB764C4CA7A44410),   747 },
+    { UINT64_C(0x8BAB8EEFB6409C1A),   774 },
+    { UINT64_C(0xD01FEF10A657842C),   800 },
+    { UINT64_C(0x9B10A4E5E9913129),   827 },
+    { UINT64_C(0xE7109BFBA19C0C9D),   853 },
+    { UINT64_C(0xAC2820D9623BF429),   880 },
+    { UINT64_C(0x80444B5E7AA7CF85),   907 },
+    { UINT64_C(0xBF21E44003ACDD2D),   933 },
+    { UINT64_C(0x8E679C2F5E44FF8F),   960 },
+    { UINT64_C(0xD433179D9C8CB841),   986 },
+    { UINT64_C(0x9E19DB92B4E31BA9),  1013 },
+    { UINT64_C(0xEB96BF6EBADF77D9),  1039 },
+    { UINT64_C(0xAF87023B9BF0EE6B),  1066 }
+};
+
+#define CACHED_POWERS_MIN_EXP10 (-348)
+#define CACHED_POWERS_EXP10_STEP 8
+
+static const uint64_t POW10[] = {
+    UINT64_C(1),
+    UINT64_C(10),
+    UINT64_C(100),
+    UINT64_C(1000),
+    UINT64_C(10000),
+    UINT64_C(100000),
+    UINT64_C(1000000),
+    UINT64_C(10000000),
+    UINT64_C(100000000),
+    UINT64_C(1000000000),
+    UINT64_C(10000000000),
+    UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+    UINT64_C(10000000000000),
+    UINT64_C(100000000000000),
+    UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000),
+    UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000),
+    UINT64_C(10000000000000000000)
+};
+
+static diy_fp_t diy_fp_normalize(diy_fp_t value) {
+    while (!(value.f & (UINT64_C(1) << 63))) {
+        value.f <<= 1;
+        --value.e;
+    }
+    return value;
+}
+
+static diy_fp_t diy_fp_mul(diy_fp_t a, diy_fp_t b) {
+    const uint64_t mask32 = UINT64_C(0xFFFFFFFF);
+    uint64_t ah = a.f >> 32, al = a.f & mask32;
+    uint64_t bh = b.f >> 32, bl = b.f & mask32;
+    uint64_t hh = ah * bh, hl = ah * bl, lh = al * bh, ll = al * bl;
+    uint64_t mid = (ll >> 32) + (hl & mask32) + (lh & mask32);
+    mid += UINT64_C(1) << 31; // round
+    return (diy_fp_t) {
+        .f = hh + (hl >> 32) + (lh >> 32) + (mid >> 32),
+        .e = a.e + b.e + 64
+    };
+}
+
+/**
+ * Returns a cached power of ten c_mk = 10^(-k), such that the binary exponent
+ * of a number with binary exponent @p e, multiplied by c_mk, falls into
+ * [-60, -32]. k is stored in @p out_k.
+ */
+static diy_fp_t get_cached_power(int e, int *out_k) {
+    // ceil((-61 - e) * log10(2)), offset so that it is always positive
+    double dk = (-61 - e) * 0.30102999566398114 - CACHED_POWERS_MIN_EXP10 - 1;
+    int k = (int) dk;
+    if (dk - k > 0.0) {
+        ++k;
+    }
+    size_t index = (size_t) (k / CACHED_POWERS_EXP10_STEP + 1);
+    *out_k = -(CACHED_POWERS_MIN_EXP10
+               + (int) index * CACHED_POWERS_EXP10_STEP);
+    return CACHED_POWERS[index];
+}
+
+static void grisu_round(char *buffer, size_t length, uint64_t delta,
+                        uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa
+            && (rest + ten_kappa < wp_w
+                    || wp_w - rest > rest + ten_kappa - wp_w)) {
+        --buffer[length - 1];
+        rest += ten_kappa;
+    }
+}
+
+static int count_decimal_digits(uint32_t value) {
+    int digits = 1;
+    while (digits < 10 && value >= POW10[digits]) {
+        ++digits;
+    }
+    return digits;
+}
+
+/**
+ * Generates the shortest digit string that lies between the boundaries, and
+ * as close to @p w as possible. On return, the value is equal to
+ * <c>buffer * 10^(*inout_k)</c>.
+ */
+static size_t digit_gen(diy_fp_t w, diy_fp_t mp, uint64_t delta,
+                        char *buffer, int *inout_k) {
+    const diy_fp_t one = {
+        .f = UINT64_C(1) << -mp.e,
+        .e = mp.e
+    };
+    const uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t) (mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = count_decimal_digits(p1);
+    size_t length = 0;
+
+    while (kappa > 0) {
+        uint32_t divisor = (uint32_t) POW10[kappa - 1];
+        uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+        if (digit || length) {
+            buffer[length++] = (char) ('0' + digit);
+        }
+        --kappa;
+        uint64_t rest = ((uint64_t) p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *inout_k += kappa;
+            grisu_round(buffer, length, delta, rest,
+                        POW10[kappa] << -one.e, wp_w);
+            return length;
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char digit = (char) (p2 >> -one.e);
+        if (digit || length) {
+            buffer[length++] = (char) ('0' + digit);
+        }
+        p2 &= one.f - 1;
+        --kappa;
+        if (p2 < delta) {
+            *inout_k += kappa;
+            size_t index = (size_t) -kappa;
+            grisu_round(buffer, length, delta, p2, one.f,
+                        wp_w * (index < AVS_ARRAY_SIZE(POW10)
+                                        ? POW10[index] : 0));
+            return length;
+        }
+    }
+}
+
+/**
+ * Generates decimal digits of a positive value f * 2^e, where
+ * @p significand_bits is the number of explicitly stored significand bits of
+ * the original floating-point type.
+ */
+static size_t grisu2(uint64_t f, int e, int significand_bits,
+                     char *buffer, int *out_k) {
+    const uint64_t hidden_bit = UINT64_C(1) << significand_bits;
+    diy_fp_t plus = diy_fp_normalize((diy_fp_t) {
+        .f = (f << 1) + 1,
+        .e = e - 1
+    });
+    diy_fp_t minus;
+    if (f == hidden_bit) {
+        // the lower neighbor is closer if the value is a power of two
+        minus = (diy_fp_t) {
+            .f = (f << 2) - 1,
+            .e = e - 2
+        };
+    } else {
+        minus = (diy_fp_t) {
+            .f = (f << 1) - 1,
+            .e = e - 1
+        };
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    const diy_fp_t c_mk = get_cached_power(plus.e, out_k);
+    const diy_fp_t w = diy_fp_mul(diy_fp_normalize((diy_fp_t) {
+                                      .f = f,
+                                      .e = e
+                                  }), c_mk);
+    diy_fp_t wp = diy_fp_mul(plus, c_mk);
+    diy_fp_t wm = diy_fp_mul(minus, c_mk);
+    ++wm.f;
+    --wp.f;
+    return digit_gen(w, wp, wp.f - wm.f, buffer, out_k);
+}
+
+/**
+ * Lays out @p length digits from @p digits, representing
+ * <c>digits * 10^k</c>, in the style of printf's <c>%g</c> with the specified
+ * @p precision, except that trailing zeros are never generated.
+ */
+static size_t format_digits(char *out, const char *digits, size_t length,
+                            int k, int precision) {
+    char *ptr = out;
+    int sci_exp = (int) length + k - 1;
+    if (sci_exp >= -4 && sci_exp < precision) {
+        if (k >= 0) {
+            memcpy(ptr, digits, length);
+            ptr += length;
+            memset(ptr, '0', (size_t) k);
+            ptr += k;
+        } else if (sci_exp >= 0) {
+            size_t integer_digits = (size_t) sci_exp + 1;
+            memcpy(ptr, digits, integer_digits);
+            ptr += integer_digits;
+            *ptr++ = '.';
+            memcpy(ptr, digits + integer_digits, length - integer_digits);
+            ptr += length - integer_digits;
+        } else {
+            *ptr++ = '0';
+            *ptr++ = '.';
+            memset(ptr, '0', (size_t) (-sci_exp - 1));
+            ptr += -sci_exp - 1;
+            memcpy(ptr, digits, length);
+            ptr += length;
+        }
+    } else {
+        *ptr++ = digits[0];
+        if (length > 1) {
+            *ptr++ = '.';
+            memcpy(ptr, digits + 1, length - 1);
+            ptr += length - 1;
+        }
+        *ptr++ = 'e';
+        if (sci_exp < 0) {
+            *ptr++ = '-';
+            sci_exp = -sci_exp;
+        } else {
+            *ptr++ = '+';
+        }
+        if (sci_exp >= 100) {
+            *ptr++ = (char) ('0' + sci_exp / 100);
+            sci_exp %= 100;
+        }
+        *ptr++ = DIGIT_PAIRS[2 * sci_exp];
+        *ptr++ = DIGIT_PAIRS[2 * sci_exp + 1];
+    }
+    *ptr = '\0';
+    return (size_t) (ptr - out);
+}
+
+/**
+ * Formats a finite or non-finite value given by its IEEE 754 fields: sign,
+ * biased exponent and stored significand.
+ */
+static size_t format_floating_point(char *out, bool negative,
+                                    int biased_exponent, uint64_t significand,
+                                    int significand_bits, int exponent_bias,
+                                    int max_biased_exponent, int precision) {
+    char *ptr = out;
+    if (biased_exponent == max_biased_exponent) {
+        if (significand) {
+            strcpy(out, "nan");
+            return 3;
+        }
+        if (negative) {
+            *ptr++ = '-';
+        }
+        strcpy(ptr, "inf");
+        return (size_t) (ptr - out) + 3;
+    }
+    if (negative) {
+        *ptr++ = '-';
+    }
+    if (!biased_exponent && !significand) {
+        *ptr++ = '0';
+        *ptr = '\0';
+        return (size_t) (ptr - out);
+    }
+
+    int e;
+    if (biased_exponent) {
+        significand |= UINT64_C(1) << significand_bits;
+        e = biased_exponent - exponent_bias - significand_bits;
+    } else {
+        e = 1 - exponent_bias - significand_bits;
+    }
+    char digits[20];
+    int k;
+    size_t length = grisu2(significand, e, significand_bits, digits, &k);
+    return (size_t) (ptr - out)
+           + format_digits(ptr, digits, length, k, precision);
+}
+
+size_t _anjay_double_to_string(char *out, double value) {
+    AVS_STATIC_ASSERT(sizeof(double) == sizeof(uint64_t), double_is_64bit);
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return format_floating_point(out, (bits >> 63),
+                                 (int) ((bits >> 52) & 0x7FF),
+                                 bits & ((UINT64_C(1) << 52) - 1),
+                                 52, 1023, 0x7FF, 17);
+}
+
+size_t _anjay_float_to_string(char *out, float value) {
+    AVS_STATIC_ASSERT(sizeof(float) == sizeof(uint32_t), float_is_32bit);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return format_floating_point(out, (bits >> 31),
+                                 (int) ((bits >> 23) & 0xFF),
+                                 bits & ((UINT32_C(1) << 23) - 1),
+                                 23, 127, 0xFF, 9);
+}
+
+static int digit_value(char c, unsigned base) {
+    unsigned value;
+    if (c >= '0' && c <= '9') {
+        value = (unsigned) (c - '0');
+    } else if (c >= 'a' && c <= 'z') {
+        value = (unsigned) (c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'Z') {
+        value = (unsigned) (c - 'A' + 10);
+    } else {
+        return -1;
+    }
+    return value < base ? (int) value : -1;
+}
+
+int _anjay_string_to_i64(const char *str, size_t length, int64_t *out) {
+    const char *ptr = str;
+    const char *end = str + length;
+    bool negative = false;
+    if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+        negative = (*ptr++ == '-');
+    }
+    unsigned base = 10;
+    if (end - ptr > 2 && ptr[0] == '0' && (ptr[1] == 'x' || ptr[1] == 'X')) {
+        base = 16;
+        ptr += 2;
+    } else if (end - ptr > 1 && ptr[0] == '0') {
+        base = 8;
+        ++ptr;
+    }
+    if (ptr == end) {
+        return -1;
+    }
+    const uint64_t limit =
+            negative ? (uint64_t) INT64_MAX + 1 : (uint64_t) INT64_MAX;
+    uint64_t value = 0;
+    for (; ptr < end; ++ptr) {
+        int digit = digit_value(*ptr, base);
+        if (digit < 0 || value > (limit - (unsigned) digit) / base) {
+            return -1;
+        }
+        value = value * base + (unsigned) digit;
+    }
+    if (negative) {
+        *out = value ? -(int64_t) (value - 1) - 1 : 0;
+    } else {
+        *out = (int64_t) value;
+    }
+    return 0;
+}
+
+#define MAX_MANTISSA_DIGITS 19
+
+// decimal exponents beyond that are out of range for any floating-point type
+#define MAX_DECIMAL_EXPONENT 99999
+
+/**
+ * Decomposed decimal number: the value is mantissa * 10^exponent, except that
+ * if truncated is set, some non-zero digits did not fit in the mantissa.
+ */
+typedef struct {
+    bool negative;
+    uint64_t mantissa;
+    int32_t exponent;
+    bool truncated;
+    // the part of the input with digits and the decimal point
+    const char *digits_begin;
+    const char *digits_end;
+    // exponent as written in the input, clamped to MAX_DECIMAL_EXPONENT
+    int32_t explicit_exponent;
+} decimal_t;
+
+typedef enum {
+    DECIMAL_INVALID = -1,
+    DECIMAL_NUMBER,
+    DECIMAL_INF,
+    DECIMAL_NAN
+} decimal_kind_t;
+
+static bool matches_ignore_case(const char *str, const char *end,
+                                const char *pattern) {
+    for (; *pattern; ++str, ++pattern) {
+        if (str >= end || (*str | 0x20) != *pattern) {
+            return false;
+        }
+    }
+    return str == end;
+}
+
+static decimal_kind_t parse_decimal(const char *str, size_t length,
+                                    decimal_t *out) {
+    const char *ptr = str;
+    const char *end = str + length;
+    memset(out, 0, sizeof(*out));
+    if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+        out->negative = (*ptr++ == '-');
+    }
+    if (matches_ignore_case(ptr, end, "inf")
+            || matches_ignore_case(ptr, end, "infinity")) {
+        return DECIMAL_INF;
+    } else if (matches_ignore_case(ptr, end, "nan")) {
+        return DECIMAL_NAN;
+    }
+
+    out->digits_begin = ptr;
+    size_t num_digits = 0;
+    size_t num_mantissa_digits = 0;
+    int64_t exponent = 0;
+    bool seen_point = false;
+    for (; ptr < end; ++ptr) {
+        if (*ptr == '.' && !seen_point) {
+            seen_point = true;
+            continue;
+        } else if (*ptr < '0' || *ptr > '9') {
+            break;
+        }
+        ++num_digits;
+        if (num_mantissa_digits < MAX_MANTISSA_DIGITS) {
+            if (out->mantissa || *ptr != '0') {
+                out->mantissa = 10 * out->mantissa + (uint64_t) (*ptr - '0');
+                ++num_mantissa_digits;
+            }
+            if (seen_point) {
+                --exponent;
+            }
+        } else {
+            out->truncated = out->truncated || *ptr != '0';
+            if (!seen_point) {
+                ++exponent;
+            }
+        }
+    }
+    out->digits_end = ptr;
+    if (!num_digits) {
+        return DECIMAL_INVALID;
+    }
+
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+        ++ptr;
+        bool exponent_negative = false;
+        if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+            exponent_negative = (*ptr++ == '-');
+        }
+        const char *exponent_digits = ptr;
+        int32_t explicit_exponent = 0;
+        for (; ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+            if (explicit_exponent < MAX_DECIMAL_EXPONENT) {
+                explicit_exponent = 10 * explicit_exponent + (*ptr - '0');
+            }
+        }
+        if (ptr == exponent_digits) {
+            return DECIMAL_INVALID;
+        }
+        out->explicit_exponent =
+                exponent_negative ? -explicit_exponent : explicit_exponent;
+        exponent += out->explicit_exponent;
+    }
+    if (ptr != end) {
+        return DECIMAL_INVALID;
+    }
+    out->exponent = (int32_t) AVS_MAX(AVS_MIN(exponent, MAX_DECIMAL_EXPONENT),
+                                      -MAX_DECIMAL_EXPONENT);
+    return DECIMAL_NUMBER;
+}
+
+/**
+ * Number of significant digits that is always enough to round correctly to
+ * any supported floating-point type: a value exactly halfway between two
+ * adjacent doubles has at most 767 of them.
+ */
+#define MAX_RENDERED_DIGITS 768
+
+// sign, digits, sticky digit, 'e' and the exponent
+#define RENDERED_DECIMAL_SIZE \
+        (1 + MAX_RENDERED_DIGITS + 1 + 1 + _ANJAY_I64_STRING_SIZE)
+
+/**
+ * Renders the number in a form that does not contain a decimal point, so that
+ * it can be parsed by the standard library regardless of the locale:
+ * significant digits, followed by an exponent that accounts for the decimal
+ * point.
+ *
+ * Leading zeros are skipped and at most MAX_RENDERED_DIGITS digits are kept;
+ * if any of the dropped ones is non-zero, a single '1' is appended instead, so
+ * that the result rounds the same way as the full input would.
+ *
+ * @p out must be at least RENDERED_DECIMAL_SIZE bytes long.
+ */
+static void render_without_point(char *out, const decimal_t *decimal) {
+    int64_t exponent = decimal->explicit_exponent;
+    if (decimal->negative) {
+        *out++ = '-';
+    }
+    size_t num_digits = 0;
+    bool seen_point = false;
+    bool dropped_nonzero = false;
+    for (const char *ptr = decimal->digits_begin; ptr < decimal->digits_end;
+            ++ptr) {
+        if (*ptr == '.') {
+            seen_point = true;
+        } else if (num_digits < MAX_RENDERED_DIGITS) {
+            if (num_digits || *ptr != '0') {
+                *out++ = *ptr;
+                ++num_digits;
+            }
+            if (seen_point) {
+                --exponent;
+            }
+        } else {
+            dropped_nonzero = dropped_nonzero || *ptr != '0';
+            if (!seen_point) {
+                ++exponent;
+            }
+        }
+    }
+    if (dropped_nonzero) {
+        *out++ = '1';
+        --exponent;
+    }
+    *out++ = 'e';
+    _anjay_i64_to_string(out, exponent);
+}
+
+static const double EXACT_POWERS_OF_10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+/*
+ * Clinger's fast path: if both the mantissa and the power of ten are exactly
+ * representable, a single IEEE 754 multiplication or division yields the
+ * correctly rounded result.
+ */
+#define DEF_FAST_PATH(Type, MaxExactInt, MaxExactPower) \
+static bool fast_path_##Type (const decimal_t *decimal, Type *out) { \
+    if (decimal->truncated || decimal->mantissa > (MaxExactInt)) { \
+        return false; \
+    } \
+    Type value = (Type) decimal->mantissa; \
+    int32_t exponent = decimal->exponent; \
+    if (exponent > (MaxExactPower)) { \
+        /* the mantissa may have enough room for some of the zeros */ \
+        for (; exponent > (MaxExactPower); --exponent) { \
+            if (value * 10 > (Type) (MaxExactInt)) { \
+                return false; \
+            } \
+            value *= 10; \
+        } \
+    } \
+    if (exponent < -(MaxExactPower)) { \
+        return false; \
+    } else if (exponent < 0) { \
+        value /= (Type) EXACT_POWERS_OF_10[-exponent]; \
+    } else { \
+        value *= (Type) EXACT_POWERS_OF_10[exponent]; \
+    } \
+    *out = decimal->negative ? -value : value; \
+    return true; \
+}
+#else // FLT_EVAL_METHOD
+#define DEF_FAST_PATH(Type, MaxExactInt, MaxExactPower) \
+static bool fast_path_##Type (const decimal_t *decimal, Type *out) { \
+    (void) decimal; \
+    (void) out; \
+    return false; \
+}
+#endif // FLT_EVAL_METHOD
+
+DEF_FAST_PATH(double, UINT64_C(1) << 53, 22)
+DEF_FAST_PATH(float, UINT64_C(1) << 24, 10)
+
+#define DEF_STRING_TO(Type, Strtod) \
+int _anjay_string_to_##Type (const char *str, size_t length, Type *out) { \
+    decimal_t decimal; \
+    switch (parse_decimal(str, length, &decimal)) { \
+    case DECIMAL_INF: \
+        *out = decimal.negative ? (Type) -INFINITY : (Type) INFINITY; \
+        return 0; \
+    case DECIMAL_NAN: \
+        *out = (Type) NAN; \
+        return 0; \
+    case DECIMAL_NUMBER: \
+        break; \
+    default: \
+        return -1; \
+    } \
+    if (!decimal.mantissa) { \
+        *out = decimal.negative ? (Type) -0.0 : (Type) 0.0; \
+        return 0; \
+    } \
+    if (fast_path_##Type (&decimal, out)) { \
+        return 0; \
+    } \
+    char rendered[RENDERED_DECIMAL_SIZE]; \
+    render_without_point(rendered, &decimal); \
+    errno = 0; \
+    Type value = Strtod(rendered, NULL); \
+    if (errno) { \
+        return -1; \
+    } \
+    *out = value; \
+    return 0; \
+}
+
+DEF_STRING_TO(double, strtod)
+DEF_STRING_TO(float, strtof)
+
+#ifdef ANJAY_TEST
+#include "test/numbers.c"
+#endif
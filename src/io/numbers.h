@@ -0,0 +1,97 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_IO_NUMBERS_H
+#define ANJAY_IO_NUMBERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+/**
+ * Buffer size sufficient to hold any int64_t value formatted by
+ * @ref _anjay_i64_to_string, including the terminating nullbyte.
+ */
+#define _ANJAY_I64_STRING_SIZE sizeof("-9223372036854775808")
+
+/**
+ * Buffer size sufficient to hold any value formatted by
+ * @ref _anjay_double_to_string or @ref _anjay_float_to_string, including the
+ * terminating nullbyte.
+ */
+#define _ANJAY_DOUBLE_STRING_SIZE sizeof("-0.00001234567890123456789")
+
+/**
+ * Formats @p value as a decimal integer into @p out, which needs to be at
+ * least @ref _ANJAY_I64_STRING_SIZE bytes long. The result is
+ * null-terminated.
+ *
+ * @returns Length of the formatted string.
+ */
+size_t _anjay_i64_to_string(char *out, int64_t value);
+
+/**
+ * Formats @p value into @p out, which needs to be at least
+ * @ref _ANJAY_DOUBLE_STRING_SIZE bytes long. The result is null-terminated.
+ *
+ * The generated string is guaranteed to parse back to exactly the same value,
+ * and is the shortest such string in the vast majority of cases (the Grisu2
+ * algorithm is used). Like with <c>"%.17g"</c>,
+ * exponential notation is only used if the decimal exponent is less than -4 or
+ * greater than 16. Formatting does not depend on the current locale.
+ *
+ * @returns Length of the formatted string.
+ */
+size_t _anjay_double_to_string(char *out, double value);
+
+/**
+ * Works like @ref _anjay_double_to_string, but generates a string that only
+ * needs to parse back to @p value when converted to float. Exponential notation
+ * is used like with <c>"%.9g"</c>.
+ */
+size_t _anjay_float_to_string(char *out, float value);
+
+/**
+ * Parses an integer from the @p length characters starting at @p str, with
+ * syntax compatible with <c>strtoll(str, NULL, 0)</c>: optional sign, then a
+ * decimal, <c>0x</c>-prefixed hexadecimal or <c>0</c>-prefixed octal number.
+ * Neither whitespace nor any trailing characters are allowed.
+ *
+ * @returns 0 on success, or a negative value if the string is not a valid
+ *          number or does not fit in int64_t.
+ */
+int _anjay_string_to_i64(const char *str, size_t length, int64_t *out);
+
+/**
+ * Parses a decimal floating-point number (optionally with an exponent), or one
+ * of "inf", "infinity" or "nan" (case-insensitive, optionally signed), from
+ * the @p length characters starting at @p str. The result is correctly
+ * rounded, and does not depend on the current locale.
+ *
+ * @returns 0 on success, or a negative value if the string is not a valid
+ *          number, or its magnitude is out of range of double.
+ */
+int _anjay_string_to_double(const char *str, size_t length, double *out);
+
+/**
+ * Works like @ref _anjay_string_to_double, but for single-precision values.
+ */
+int _anjay_string_to_float(const char *str, size_t length, float *out);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif /* ANJAY_IO_NUMBERS_H */
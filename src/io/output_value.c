@@ -0,0 +1,231 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <avsystem/commons/utils.h>
+
+#include "../utils_core.h"
+#include "vtable.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+static int *output_value_errno_ptr(anjay_output_ctx_t *ctx) {
+    return &((anjay_output_value_ctx_t *) ctx)->error;
+}
+
+static int emit_value(anjay_output_value_ctx_t *ctx,
+                      anjay_output_value_t *value) {
+    if (ctx->in_array) {
+        if (!ctx->has_riid) {
+            anjay_log(ERROR, "array index not set before returning a value");
+            return -1;
+        }
+        value->is_array_element = true;
+        value->riid = ctx->riid;
+        ctx->has_riid = false;
+    } else if (ctx->value_returned) {
+        anjay_log(ERROR, "multiple values returned for a single Resource");
+        return -1;
+    }
+    ctx->value_returned = true;
+    return ctx->handler(ctx->handler_arg, value);
+}
+
+static int output_value_set_id(anjay_output_ctx_t *ctx_,
+                               anjay_id_type_t type,
+                               uint16_t id) {
+    anjay_output_value_ctx_t *ctx = (anjay_output_value_ctx_t *) ctx_;
+    if (type == ANJAY_ID_RIID) {
+        if (!ctx->in_array) {
+            return -1;
+        }
+        ctx->has_riid = true;
+        ctx->riid = id;
+    }
+    return 0;
+}
+
+static int output_value_ret_string(anjay_output_ctx_t *ctx,
+                                   const char *str) {
+    anjay_output_value_t value = {
+        .type = ANJAY_OUTPUT_VALUE_STRING
+    };
+    value.value.bytes.data = str;
+    value.value.bytes.size = strlen(str);
+    return emit_value((anjay_output_value_ctx_t *) ctx, &value);
+}
+
+static int output_value_ret_i64(anjay_output_ctx_t *ctx, int64_t i) {
+    anjay_output_value_t value = {
+        .type = ANJAY_OUTPUT_VALUE_INT
+    };
+    value.value.i = i;
+    return emit_value((anjay_output_value_ctx_t *) ctx, &value);
+}
+
+static int output_value_ret_i32(anjay_output_ctx_t *ctx, int32_t i) {
+    return output_value_ret_i64(ctx, i);
+}
+
+static int output_value_ret_double(anjay_output_ctx_t *ctx, double f) {
+    anjay_output_value_t value = {
+        .type = ANJAY_OUTPUT_VALUE_DOUBLE
+    };
+    value.value.f = f;
+    return emit_value((anjay_output_value_ctx_t *) ctx, &value);
+}
+
+static int output_value_ret_float(anjay_output_ctx_t *ctx, float f) {
+    return output_value_ret_double(ctx, f);
+}
+
+static int output_value_ret_bool(anjay_output_ctx_t *ctx, bool b) {
+    anjay_output_value_t value = {
+        .type = ANJAY_OUTPUT_VALUE_BOOL
+    };
+    value.value.b = b;
+    return emit_value((anjay_output_value_ctx_t *) ctx, &value);
+}
+
+static int output_value_ret_objlnk(anjay_output_ctx_t *ctx,
+                                   anjay_oid_t oid,
+                                   anjay_iid_t iid) {
+    anjay_output_value_t value = {
+        .type = ANJAY_OUTPUT_VALUE_OBJLNK
+    };
+    value.value.objlnk.oid = oid;
+    value.value.objlnk.iid = iid;
+    return emit_value((anjay_output_value_ctx_t *) ctx, &value);
+}
+
+static anjay_ret_bytes_ctx_t *
+output_value_ret_bytes_begin(anjay_output_ctx_t *ctx_,
+                             size_t length) {
+    anjay_output_value_ctx_t *ctx = (anjay_output_value_ctx_t *) ctx_;
+    if (ctx->bytes_expected != ctx->bytes_written) {
+        anjay_log(ERROR, "anjay_ret_bytes_begin() called before the previous "
+                  "value was finished");
+        return NULL;
+    }
+    if (length > ctx->bytes_buffer_size) {
+        anjay_log(ERROR, "%lu-byte value does not fit in %lu-byte buffer",
+                  (unsigned long) length,
+                  (unsigned long) ctx->bytes_buffer_size);
+        return NULL;
+    }
+    ctx->bytes_expected = length;
+    ctx->bytes_written = 0;
+    if (!length) {
+        anjay_output_value_t value = {
+            .type = ANJAY_OUTPUT_VALUE_BYTES
+        };
+        value.value.bytes.data = ctx->bytes_buffer;
+        if (emit_value(ctx, &value)) {
+            return NULL;
+        }
+    }
+    return (anjay_ret_bytes_ctx_t *) &ctx->ret_bytes_vtable;
+}
+
+static int output_value_ret_bytes_append(anjay_ret_bytes_ctx_t *bytes_ctx,
+                                         const void *data,
+                                         size_t size) {
+    anjay_output_value_ctx_t *ctx =
+            AVS_CONTAINER_OF(bytes_ctx, anjay_output_value_ctx_t,
+                             ret_bytes_vtable);
+    if (size > ctx->bytes_expected - ctx->bytes_written) {
+        anjay_log(ERROR, "anjay_ret_bytes_append() called with more data than "
+                  "declared in anjay_ret_bytes_begin()");
+        return -1;
+    }
+    if (!size) {
+        return 0;
+    }
+    memcpy(ctx->bytes_buffer + ctx->bytes_written, data, size);
+    ctx->bytes_written += size;
+    if (ctx->bytes_written < ctx->bytes_expected) {
+        return 0;
+    }
+    anjay_output_value_t value = {
+        .type = ANJAY_OUTPUT_VALUE_BYTES
+    };
+    value.value.bytes.data = ctx->bytes_buffer;
+    value.value.bytes.size = ctx->bytes_written;
+    return emit_value(ctx, &value);
+}
+
+static anjay_output_ctx_t *output_value_array_start(anjay_output_ctx_t *ctx_) {
+    anjay_output_value_ctx_t *ctx = (anjay_output_value_ctx_t *) ctx_;
+    if (ctx->in_array || ctx->value_returned) {
+        return NULL;
+    }
+    ctx->in_array = true;
+    ctx->has_riid = false;
+    return ctx_;
+}
+
+static int output_value_array_finish(anjay_output_ctx_t *ctx_) {
+    anjay_output_value_ctx_t *ctx = (anjay_output_value_ctx_t *) ctx_;
+    if (!ctx->in_array) {
+        return -1;
+    }
+    ctx->in_array = false;
+    ctx->value_returned = true;
+    return 0;
+}
+
+static const anjay_output_ctx_vtable_t VALUE_OUT_VTABLE = {
+    .errno_ptr = output_value_errno_ptr,
+    .bytes_begin = output_value_ret_bytes_begin,
+    .string = output_value_ret_string,
+    .i32 = output_value_ret_i32,
+    .i64 = output_value_ret_i64,
+    .f32 = output_value_ret_float,
+    .f64 = output_value_ret_double,
+    .boolean = output_value_ret_bool,
+    .objlnk = output_value_ret_objlnk,
+    .array_start = output_value_array_start,
+    .array_finish = output_value_array_finish,
+    .set_id = output_value_set_id
+};
+
+static const anjay_ret_bytes_ctx_vtable_t VALUE_BYTES_VTABLE = {
+    .append = output_value_ret_bytes_append
+};
+
+anjay_output_value_ctx_t
+_anjay_output_value_ctx_init(anjay_output_value_handler_t *handler,
+                             void *handler_arg,
+                             char *bytes_buffer,
+                             size_t bytes_buffer_size) {
+    assert(handler);
+    return (anjay_output_value_ctx_t) {
+        .vtable = &VALUE_OUT_VTABLE,
+        .ret_bytes_vtable = &VALUE_BYTES_VTABLE,
+        .handler = handler,
+        .handler_arg = handler_arg,
+        .bytes_buffer = bytes_buffer,
+        .bytes_buffer_size = bytes_buffer_size
+    };
+}
+
+#ifdef ANJAY_TEST
+#include "test/output_value.c"
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_IO_SENML_CBOR_H
+#define ANJAY_IO_SENML_CBOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+/* RFC 7049, section 2.1 */
+#define CBOR_MAJOR_TYPE_UINT 0
+#define CBOR_MAJOR_TYPE_NEGATIVE_INT 1
+#define CBOR_MAJOR_TYPE_BYTE_STRING 2
+#define CBOR_MAJOR_TYPE_TEXT_STRING 3
+#define CBOR_MAJOR_TYPE_ARRAY 4
+#define CBOR_MAJOR_TYPE_MAP 5
+#define CBOR_MAJOR_TYPE_TAG 6
+#define CBOR_MAJOR_TYPE_FLOAT_OR_SIMPLE 7
+
+#define CBOR_EXT_LENGTH_1BYTE 24
+#define CBOR_EXT_LENGTH_2BYTE 25
+#define CBOR_EXT_LENGTH_4BYTE 26
+#define CBOR_EXT_LENGTH_8BYTE 27
+#define CBOR_EXT_LENGTH_INDEFINITE 31
+
+#define CBOR_VALUE_FALSE 0xF4
+#define CBOR_VALUE_TRUE 0xF5
+#define CBOR_FLOAT_16 0xF9
+#define CBOR_FLOAT_32 0xFA
+#define CBOR_FLOAT_64 0xFB
+#define CBOR_INDEFINITE_ARRAY 0x9F
+#define CBOR_BREAK 0xFF
+
+/* SenML labels, RFC 8428, section 6 */
+#define SENML_LABEL_BASE_NAME (-2)
+#define SENML_LABEL_NAME 0
+#define SENML_LABEL_VALUE 2
+#define SENML_LABEL_STRING_VALUE 3
+#define SENML_LABEL_BOOLEAN_VALUE 4
+#define SENML_LABEL_DATA_VALUE 8
+
+/* Object Link values have no integer label, so they are sent as "vlo";
+ * SENML_LABEL_OBJLNK_VALUE is only used internally to select that label. */
+#define SENML_OBJLNK_LABEL "vlo"
+#define SENML_LABEL_OBJLNK_VALUE (-1000)
+
+/**
+ * Encodes a CBOR data item header of the given @p major_type, with @p value
+ * being the argument (integer value, or length of a string or container).
+ *
+ * @p out must be able to hold at least 9 bytes.
+ *
+ * @returns Number of bytes written to @p out.
+ */
+size_t _anjay_cbor_encode_head(uint8_t *out, uint8_t major_type,
+                               uint64_t value);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif /* ANJAY_IO_SENML_CBOR_H */
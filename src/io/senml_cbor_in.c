@@ -0,0 +1,762 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avsystem/commons/log.h>
+#include <avsystem/commons/stream.h>
+#include <avsystem/commons/utils.h>
+
+#include "../io_core.h"
+#include "flat_in.h"
+#include "numbers.h"
+#include "senml_cbor.h"
+#include "vtable.h"
+
+#define cbor_log(level, ...) avs_log(senml_cbor, level, __VA_ARGS__)
+
+VISIBILITY_SOURCE_BEGIN
+
+/*
+ * SenML CBOR payloads are parsed on the fly, in the same way as LwM2M JSON, see
+ * flat_in.h. The same limitations apply: records of a single Instance or
+ * Multiple Resource need to be adjacent, and the Base Name and Name need to
+ * precede the value in each record. Additionally, only definite-length strings
+ * are supported as values.
+ */
+
+#define MAX_SKIP_DEPTH 8
+
+/* additional information value meaning "indefinite length" */
+#define INDEFINITE_LENGTH (-1)
+
+typedef struct {
+    uint8_t major_type;
+    uint8_t additional_info;
+    /* integer value, string length or container size; raw bits for floats */
+    uint64_t argument;
+} cbor_head_t;
+
+typedef enum {
+    SENML_VALUE_NUMBER,
+    SENML_VALUE_STRING,
+    SENML_VALUE_BOOL,
+    SENML_VALUE_BYTES,
+    SENML_VALUE_OBJLNK
+} senml_value_type_t;
+
+typedef struct {
+    anjay_flat_parser_t base;
+    uint8_t buffer[64];
+    size_t buffer_pos;
+    size_t buffer_size;
+    char msg_finished;
+
+    char base_name[_ANJAY_FLAT_NAME_SIZE];
+    char name[_ANJAY_FLAT_NAME_SIZE];
+
+    bool records_started;
+    /* number of records, or members of the current record, that are left;
+     * INDEFINITE_LENGTH if terminated with a break marker */
+    int64_t records_left;
+    int64_t members_left;
+
+    cbor_head_t value;
+    /* number of unread bytes of a string value */
+    uint64_t string_left;
+} senml_cbor_parser_t;
+
+typedef struct {
+    anjay_flat_in_t ctx;
+    senml_cbor_parser_t parser;
+} senml_cbor_in_root_t;
+
+////////////////////////////////////////////////////////////////////// DECODER
+
+static int peek_byte(senml_cbor_parser_t *p) {
+    while (p->buffer_pos >= p->buffer_size) {
+        if (p->msg_finished || p->base.error) {
+            return EOF;
+        }
+        p->buffer_pos = 0;
+        p->buffer_size = 0;
+        if ((p->base.error = avs_stream_read(p->base.stream,
+                                             &p->buffer_size,
+                                             &p->msg_finished, p->buffer,
+                                             sizeof(p->buffer)))) {
+            return EOF;
+        }
+    }
+    return p->buffer[p->buffer_pos];
+}
+
+static int parse_error(senml_cbor_parser_t *p) {
+    return p->base.error ? p->base.error : ANJAY_ERR_BAD_REQUEST;
+}
+
+/*
+ * Reads exactly @p size bytes. Chunks that are larger than the read-ahead
+ * buffer are read directly into @p out.
+ */
+static int read_raw(senml_cbor_parser_t *p, void *out, size_t size) {
+    uint8_t *current = (uint8_t *) out;
+    while (size) {
+        if (p->buffer_pos >= p->buffer_size && size >= sizeof(p->buffer)) {
+            size_t bytes_read;
+            if (p->msg_finished || p->base.error
+                    || (p->base.error = avs_stream_read(
+                            p->base.stream, &bytes_read, &p->msg_finished,
+                            current, size))) {
+                return parse_error(p);
+            }
+            current += bytes_read;
+            size -= bytes_read;
+            continue;
+        }
+        if (peek_byte(p) == EOF) {
+            return parse_error(p);
+        }
+        size_t chunk = AVS_MIN(size, p->buffer_size - p->buffer_pos);
+        memcpy(current, &p->buffer[p->buffer_pos], chunk);
+        p->buffer_pos += chunk;
+        current += chunk;
+        size -= chunk;
+    }
+    return 0;
+}
+
+static int skip_raw(senml_cbor_parser_t *p, uint64_t size) {
+    while (size) {
+        if (peek_byte(p) == EOF) {
+            return parse_error(p);
+        }
+        size_t chunk = (size_t) AVS_MIN(size, (uint64_t) (p->buffer_size
+                                                          - p->buffer_pos));
+        p->buffer_pos += chunk;
+        size -= chunk;
+    }
+    return 0;
+}
+
+static int read_head(senml_cbor_parser_t *p, cbor_head_t *out) {
+    int initial_byte = peek_byte(p);
+    if (initial_byte == EOF) {
+        return parse_error(p);
+    }
+    ++p->buffer_pos;
+    out->major_type = (uint8_t) (initial_byte >> 5);
+    out->additional_info = (uint8_t) (initial_byte & 0x1F);
+    out->argument = 0;
+    size_t argument_size;
+    switch (out->additional_info) {
+    case CBOR_EXT_LENGTH_1BYTE: argument_size = 1; break;
+    case CBOR_EXT_LENGTH_2BYTE: argument_size = 2; break;
+    case CBOR_EXT_LENGTH_4BYTE: argument_size = 4; break;
+    case CBOR_EXT_LENGTH_8BYTE: argument_size = 8; break;
+    case CBOR_EXT_LENGTH_INDEFINITE:
+        if (out->major_type < CBOR_MAJOR_TYPE_BYTE_STRING
+                || out->major_type == CBOR_MAJOR_TYPE_TAG) {
+            return parse_error(p);
+        }
+        return 0;
+    default:
+        if (out->additional_info > CBOR_EXT_LENGTH_INDEFINITE - 4) {
+            // reserved values
+            return parse_error(p);
+        }
+        out->argument = out->additional_info;
+        return 0;
+    }
+    uint8_t argument[8];
+    int retval = read_raw(p, argument, argument_size);
+    for (size_t i = 0; !retval && i < argument_size; ++i) {
+        out->argument = (out->argument << 8) | argument[i];
+    }
+    return retval;
+}
+
+static bool is_indefinite(const cbor_head_t *head) {
+    return head->additional_info == CBOR_EXT_LENGTH_INDEFINITE;
+}
+
+static bool is_break(const cbor_head_t *head) {
+    return head->major_type == CBOR_MAJOR_TYPE_FLOAT_OR_SIMPLE
+            && is_indefinite(head);
+}
+
+/*
+ * Advances to the next item of a container with @p *items_left items.
+ *
+ * @returns 0 if there is one, 1 if the container is finished, or an error
+ *          code.
+ */
+static int next_item(senml_cbor_parser_t *p, int64_t *items_left) {
+    if (*items_left == INDEFINITE_LENGTH) {
+        int next_byte = peek_byte(p);
+        if (next_byte == EOF) {
+            return parse_error(p);
+        } else if (next_byte == CBOR_BREAK) {
+            ++p->buffer_pos;
+            return 1;
+        }
+        return 0;
+    } else if (!*items_left) {
+        return 1;
+    }
+    --*items_left;
+    return 0;
+}
+
+static int container_size(senml_cbor_parser_t *p, const cbor_head_t *head,
+                          int64_t *out) {
+    if (is_indefinite(head)) {
+        *out = INDEFINITE_LENGTH;
+    } else if (head->argument > INT64_MAX) {
+        return parse_error(p);
+    } else {
+        *out = (int64_t) head->argument;
+    }
+    return 0;
+}
+
+static int skip_item_contents(senml_cbor_parser_t *p, const cbor_head_t *head,
+                              unsigned depth);
+
+static int skip_item(senml_cbor_parser_t *p, unsigned depth) {
+    cbor_head_t head;
+    int retval = read_head(p, &head);
+    if (!retval) {
+        retval = is_break(&head) ? parse_error(p)
+                                 : skip_item_contents(p, &head, depth);
+    }
+    return retval;
+}
+
+static int skip_item_contents(senml_cbor_parser_t *p, const cbor_head_t *head,
+                              unsigned depth) {
+    int64_t items_left;
+    int retval = 0;
+    if (depth >= MAX_SKIP_DEPTH) {
+        cbor_log(WARNING, "CBOR data nested too deeply");
+        return parse_error(p);
+    }
+    switch (head->major_type) {
+    case CBOR_MAJOR_TYPE_BYTE_STRING:
+    case CBOR_MAJOR_TYPE_TEXT_STRING:
+        if (!is_indefinite(head)) {
+            return skip_raw(p, head->argument);
+        }
+        // chunked string: a sequence of definite-length strings
+        items_left = INDEFINITE_LENGTH;
+        while (!(retval = next_item(p, &items_left))) {
+            cbor_head_t chunk;
+            if ((retval = read_head(p, &chunk))) {
+                return retval;
+            }
+            if (chunk.major_type != head->major_type || is_indefinite(&chunk)) {
+                return parse_error(p);
+            }
+            if ((retval = skip_raw(p, chunk.argument))) {
+                return retval;
+            }
+        }
+        return retval < 0 ? retval : 0;
+    case CBOR_MAJOR_TYPE_MAP:
+    case CBOR_MAJOR_TYPE_ARRAY:
+        if ((retval = container_size(p, head, &items_left))) {
+            return retval;
+        }
+        while (!(retval = next_item(p, &items_left))) {
+            if ((retval = skip_item(p, depth + 1))
+                    || (head->major_type == CBOR_MAJOR_TYPE_MAP
+                        && (retval = skip_item(p, depth + 1)))) {
+                return retval;
+            }
+        }
+        return retval < 0 ? retval : 0;
+    case CBOR_MAJOR_TYPE_TAG:
+        return skip_item(p, depth + 1);
+    default:
+        // integers and simple values are contained in the head entirely
+        return 0;
+    }
+}
+
+/* Reads a whole definite-length text string into a null-terminated buffer. */
+static int read_short_text(senml_cbor_parser_t *p, char *out, size_t size) {
+    cbor_head_t head;
+    int retval = read_head(p, &head);
+    if (retval) {
+        return retval;
+    }
+    if (head.major_type != CBOR_MAJOR_TYPE_TEXT_STRING || is_indefinite(&head)
+            || head.argument >= size) {
+        return parse_error(p);
+    }
+    if ((retval = read_raw(p, out, (size_t) head.argument))) {
+        return retval;
+    }
+    out[head.argument] = '\0';
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////// PARSER
+
+/*
+ * Reads a map key. Keys that are not SenML labels known to us are skipped and
+ * reported as INT64_MIN.
+ */
+static int read_label(senml_cbor_parser_t *p, int64_t *out) {
+    cbor_head_t head;
+    int retval = read_head(p, &head);
+    if (retval) {
+        return retval;
+    }
+    *out = INT64_MIN;
+    if (head.major_type == CBOR_MAJOR_TYPE_UINT
+            && head.argument <= INT64_MAX) {
+        *out = (int64_t) head.argument;
+    } else if (head.major_type == CBOR_MAJOR_TYPE_NEGATIVE_INT
+            && head.argument < INT64_MAX) {
+        *out = -1 - (int64_t) head.argument;
+    } else if (head.major_type == CBOR_MAJOR_TYPE_TEXT_STRING
+            && head.argument == sizeof(SENML_OBJLNK_LABEL) - 1) {
+        char label[sizeof(SENML_OBJLNK_LABEL)] = "";
+        if ((retval = read_raw(p, label, sizeof(label) - 1))) {
+            return retval;
+        }
+        if (!strcmp(label, SENML_OBJLNK_LABEL)) {
+            *out = SENML_LABEL_OBJLNK_VALUE;
+        }
+    } else if (is_break(&head)) {
+        return parse_error(p);
+    } else {
+        return skip_item_contents(p, &head, 0);
+    }
+    return 0;
+}
+
+/* Returns the value type stored under @p label, or -1 if it is not a value. */
+static int value_type_from_label(int64_t label) {
+    switch (label) {
+    case SENML_LABEL_VALUE:
+        return SENML_VALUE_NUMBER;
+    case SENML_LABEL_STRING_VALUE:
+        return SENML_VALUE_STRING;
+    case SENML_LABEL_BOOLEAN_VALUE:
+        return SENML_VALUE_BOOL;
+    case SENML_LABEL_DATA_VALUE:
+        return SENML_VALUE_BYTES;
+    case SENML_LABEL_OBJLNK_VALUE:
+        return SENML_VALUE_OBJLNK;
+    default:
+        return -1;
+    }
+}
+
+static bool value_matches_type(const cbor_head_t *value,
+                               senml_value_type_t type) {
+    switch (type) {
+    case SENML_VALUE_NUMBER:
+        return value->major_type == CBOR_MAJOR_TYPE_UINT
+                || value->major_type == CBOR_MAJOR_TYPE_NEGATIVE_INT
+                || (value->major_type == CBOR_MAJOR_TYPE_FLOAT_OR_SIMPLE
+                    && value->additional_info >= CBOR_EXT_LENGTH_2BYTE
+                    && value->additional_info <= CBOR_EXT_LENGTH_8BYTE);
+    case SENML_VALUE_BOOL:
+        return value->major_type == CBOR_MAJOR_TYPE_FLOAT_OR_SIMPLE
+                && (value->additional_info == (CBOR_VALUE_FALSE & 0x1F)
+                    || value->additional_info == (CBOR_VALUE_TRUE & 0x1F));
+    case SENML_VALUE_BYTES:
+        return value->major_type == CBOR_MAJOR_TYPE_BYTE_STRING
+                && !is_indefinite(value);
+    case SENML_VALUE_STRING:
+    case SENML_VALUE_OBJLNK:
+        return value->major_type == CBOR_MAJOR_TYPE_TEXT_STRING
+                && !is_indefinite(value);
+    }
+    return false;
+}
+
+static int parse_header(senml_cbor_parser_t *p) {
+    cbor_head_t head;
+    int retval = read_head(p, &head);
+    if (retval) {
+        return retval;
+    }
+    if (head.major_type != CBOR_MAJOR_TYPE_ARRAY) {
+        return parse_error(p);
+    }
+    p->records_started = true;
+    return container_size(p, &head, &p->records_left);
+}
+
+/*
+ * Parses the next record up to the head of its value.
+ */
+static int parse_entry_header(anjay_flat_parser_t *p_) {
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) p_;
+    int retval;
+    if (!p->records_started && (retval = parse_header(p))) {
+        return retval;
+    }
+    if ((retval = next_item(p, &p->records_left))) {
+        if (retval < 0) {
+            return retval;
+        }
+        p->base.state = ANJAY_FLAT_ENTRY_END;
+        if (peek_byte(p) != EOF) {
+            cbor_log(WARNING, "trailing data after SenML records");
+            return ANJAY_ERR_BAD_REQUEST;
+        }
+        return p->base.error ? p->base.error : ANJAY_GET_INDEX_END;
+    }
+
+    cbor_head_t head;
+    if ((retval = read_head(p, &head))) {
+        return retval;
+    }
+    if (head.major_type != CBOR_MAJOR_TYPE_MAP
+            || (retval = container_size(p, &head, &p->members_left))) {
+        return parse_error(p);
+    }
+    p->name[0] = '\0';
+    while (!(retval = next_item(p, &p->members_left))) {
+        int64_t label;
+        if ((retval = read_label(p, &label))) {
+            return retval;
+        }
+        int value_type = value_type_from_label(label);
+        if (value_type >= 0) {
+            if ((retval = _anjay_flat_parser_set_path(&p->base, p->base_name,
+                                                      p->name))
+                    || (retval = read_head(p, &p->value))) {
+                return retval;
+            }
+            if (!value_matches_type(&p->value,
+                                    (senml_value_type_t) value_type)) {
+                cbor_log(WARNING, "invalid SenML value");
+                return ANJAY_ERR_BAD_REQUEST;
+            }
+            p->base.value_type = value_type;
+            p->string_left = p->value.argument;
+            p->base.state = ANJAY_FLAT_ENTRY_VALUE;
+            return 0;
+        } else if (label == SENML_LABEL_BASE_NAME) {
+            retval = read_short_text(p, p->base_name, sizeof(p->base_name));
+        } else if (label == SENML_LABEL_NAME) {
+            retval = read_short_text(p, p->name, sizeof(p->name));
+        } else {
+            retval = skip_item(p, 0);
+        }
+        if (retval) {
+            return retval;
+        }
+    }
+    if (retval > 0) {
+        cbor_log(WARNING, "SenML record without a value");
+        retval = ANJAY_ERR_BAD_REQUEST;
+    }
+    return retval;
+}
+
+/*
+ * Finishes processing of the current record, skipping its value if it has not
+ * been read.
+ */
+static int skip_entry(anjay_flat_parser_t *p_) {
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) p_;
+    int retval = 0;
+    if ((p->base.state == ANJAY_FLAT_ENTRY_VALUE
+                || p->base.state == ANJAY_FLAT_ENTRY_VALUE_PARTIAL)
+            && (p->base.value_type == SENML_VALUE_STRING
+                || p->base.value_type == SENML_VALUE_BYTES
+                || p->base.value_type == SENML_VALUE_OBJLNK)) {
+        retval = skip_raw(p, p->string_left);
+    }
+    p->string_left = 0;
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    return retval;
+}
+
+/* Parses the rest of the current record after its value. */
+static int finish_entry(anjay_flat_parser_t *p_) {
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) p_;
+    int retval;
+    while (!(retval = next_item(p, &p->members_left))) {
+        if ((retval = skip_item(p, 0)) || (retval = skip_item(p, 0))) {
+            return retval;
+        }
+    }
+    return retval < 0 ? retval : 0;
+}
+
+static const anjay_flat_parser_vtable_t SENML_CBOR_PARSER_VTABLE = {
+    parse_entry_header,
+    finish_entry,
+    skip_entry
+};
+
+///////////////////////////////////////////////////////////////////// CONTEXTS
+
+static int begin_value(anjay_flat_in_t *ctx, senml_value_type_t type) {
+    return _anjay_flat_in_begin_value(ctx, (int) type);
+}
+
+static int cbor_get_some_bytes(anjay_input_ctx_t *ctx_,
+                               size_t *out_bytes_read,
+                               bool *out_message_finished,
+                               void *out_buf,
+                               size_t buf_size) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) ctx->parser;
+    *out_bytes_read = 0;
+    *out_message_finished = false;
+    int retval;
+    if (p->base.state != ANJAY_FLAT_ENTRY_VALUE_PARTIAL
+            && (retval = begin_value(ctx, SENML_VALUE_BYTES))) {
+        return retval;
+    } else if (p->base.value_type != SENML_VALUE_BYTES) {
+        return -1;
+    }
+    size_t chunk = (size_t) AVS_MIN((uint64_t) buf_size, p->string_left);
+    if ((retval = read_raw(p, out_buf, chunk))) {
+        return retval;
+    }
+    p->string_left -= chunk;
+    *out_bytes_read = chunk;
+    if (p->string_left) {
+        p->base.state = ANJAY_FLAT_ENTRY_VALUE_PARTIAL;
+    } else {
+        p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+        *out_message_finished = true;
+    }
+    return 0;
+}
+
+static int cbor_get_string(anjay_input_ctx_t *ctx_,
+                           char *out_buf,
+                           size_t buf_size) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) ctx->parser;
+    if (!buf_size) {
+        return -1;
+    }
+    int retval;
+    if (p->base.state != ANJAY_FLAT_ENTRY_VALUE_PARTIAL
+            && (retval = begin_value(ctx, SENML_VALUE_STRING))) {
+        return retval;
+    } else if (p->base.value_type != SENML_VALUE_STRING) {
+        return -1;
+    }
+    size_t chunk = (size_t) AVS_MIN((uint64_t) (buf_size - 1), p->string_left);
+    if ((retval = read_raw(p, out_buf, chunk))) {
+        return retval;
+    }
+    out_buf[chunk] = '\0';
+    p->string_left -= chunk;
+    if (p->string_left) {
+        p->base.state = ANJAY_FLAT_ENTRY_VALUE_PARTIAL;
+        return ANJAY_BUFFER_TOO_SHORT;
+    }
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    return 0;
+}
+
+static double decode_half(uint16_t half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    double value;
+    if (exponent == 0) {
+        value = ldexp(mantissa, -24);
+    } else if (exponent != 0x1F) {
+        value = ldexp(mantissa + 0x400, exponent - 25);
+    } else {
+        value = mantissa ? NAN : INFINITY;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+/*
+ * Reads a numeric value. Integers are returned through @p out_int if they fit
+ * in int64_t, in which case @p out_is_int is set; @p out_double is always set.
+ */
+static int read_number(anjay_flat_in_t *ctx, bool *out_is_int,
+                       int64_t *out_int, double *out_double) {
+    int retval = begin_value(ctx, SENML_VALUE_NUMBER);
+    if (retval) {
+        return retval;
+    }
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) ctx->parser;
+    const cbor_head_t *value = &p->value;
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    *out_is_int = false;
+    switch (value->major_type) {
+    case CBOR_MAJOR_TYPE_UINT:
+        *out_is_int = (value->argument <= INT64_MAX);
+        *out_int = (int64_t) value->argument;
+        *out_double = (double) value->argument;
+        break;
+    case CBOR_MAJOR_TYPE_NEGATIVE_INT:
+        *out_is_int = (value->argument <= INT64_MAX);
+        *out_int = -1 - (int64_t) value->argument;
+        *out_double = -1.0 - (double) value->argument;
+        break;
+    default:
+        if (value->additional_info == CBOR_EXT_LENGTH_2BYTE) {
+            *out_double = decode_half((uint16_t) value->argument);
+        } else if (value->additional_info == CBOR_EXT_LENGTH_4BYTE) {
+            *out_double = _anjay_ntohf(
+                    avs_convert_be32((uint32_t) value->argument));
+        } else {
+            *out_double = _anjay_ntohd(avs_convert_be64(value->argument));
+        }
+    }
+    return 0;
+}
+
+static int cbor_get_i64(anjay_input_ctx_t *ctx, int64_t *value) {
+    bool is_int;
+    double double_value;
+    int retval = read_number((anjay_flat_in_t *) ctx, &is_int, value,
+                             &double_value);
+    if (retval || is_int) {
+        return retval;
+    }
+    // integral floating-point values are accepted as well; the range is
+    // checked before casting, as the cast is undefined behavior otherwise
+    if (!isfinite(double_value) || double_value < -0x1p63
+            || double_value >= 0x1p63
+            || double_value != (double) (int64_t) double_value) {
+        return -1;
+    }
+    *value = (int64_t) double_value;
+    return 0;
+}
+
+static int cbor_get_i32(anjay_input_ctx_t *ctx, int32_t *value) {
+    int64_t i64_value;
+    int retval = cbor_get_i64(ctx, &i64_value);
+    if (retval) {
+        return retval;
+    }
+    if (i64_value < INT32_MIN || i64_value > INT32_MAX) {
+        return -1;
+    }
+    *value = (int32_t) i64_value;
+    return 0;
+}
+
+static int cbor_get_double(anjay_input_ctx_t *ctx, double *value) {
+    bool is_int;
+    int64_t int_value;
+    return read_number((anjay_flat_in_t *) ctx, &is_int, &int_value, value);
+}
+
+static int cbor_get_float(anjay_input_ctx_t *ctx, float *value) {
+    double double_value;
+    int retval = cbor_get_double(ctx, &double_value);
+    if (!retval) {
+        *value = (float) double_value;
+    }
+    return retval;
+}
+
+static int cbor_get_bool(anjay_input_ctx_t *ctx_, bool *value) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    int retval = begin_value(ctx, SENML_VALUE_BOOL);
+    if (retval) {
+        return retval;
+    }
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) ctx->parser;
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    *value = (p->value.additional_info == (CBOR_VALUE_TRUE & 0x1F));
+    return 0;
+}
+
+static int cbor_get_objlnk(anjay_input_ctx_t *ctx_,
+                           anjay_oid_t *out_oid, anjay_iid_t *out_iid) {
+    anjay_flat_in_t *ctx = (anjay_flat_in_t *) ctx_;
+    senml_cbor_parser_t *p = (senml_cbor_parser_t *) ctx->parser;
+    char buf[sizeof("65535:65535")];
+    int retval = begin_value(ctx, SENML_VALUE_OBJLNK);
+    if (retval) {
+        return retval;
+    }
+    if (p->string_left >= sizeof(buf)) {
+        return -1;
+    }
+    if ((retval = read_raw(p, buf, (size_t) p->string_left))) {
+        return retval;
+    }
+    buf[p->string_left] = '\0';
+    p->string_left = 0;
+    p->base.state = ANJAY_FLAT_ENTRY_VALUE_CONSUMED;
+    const char *colon = strchr(buf, ':');
+    int64_t oid, iid;
+    if (!colon
+            || _anjay_string_to_i64(buf, (size_t) (colon - buf), &oid)
+            || _anjay_string_to_i64(colon + 1, strlen(colon + 1), &iid)
+            || oid < 0 || oid > UINT16_MAX
+            || iid < 0 || iid > UINT16_MAX) {
+        return -1;
+    }
+    *out_oid = (anjay_oid_t) oid;
+    *out_iid = (anjay_iid_t) iid;
+    return 0;
+}
+
+static const anjay_input_ctx_vtable_t SENML_CBOR_IN_VTABLE = {
+    cbor_get_some_bytes,
+    cbor_get_string,
+    cbor_get_i32,
+    cbor_get_i64,
+    cbor_get_float,
+    cbor_get_double,
+    cbor_get_bool,
+    cbor_get_objlnk,
+    _anjay_flat_in_attach_child,
+    _anjay_flat_in_get_id,
+    _anjay_flat_in_next_entry,
+    _anjay_flat_in_close,
+    _anjay_flat_in_nested_ctx
+};
+
+int _anjay_input_senml_cbor_create(anjay_input_ctx_t **out,
+                                   avs_stream_abstract_t **stream_ptr,
+                                   bool autoclose,
+                                   const anjay_uri_path_t *uri) {
+    senml_cbor_in_root_t *root =
+            (senml_cbor_in_root_t *) calloc(1, sizeof(senml_cbor_in_root_t));
+    *out = (anjay_input_ctx_t *) root;
+    if (!root) {
+        return -1;
+    }
+
+    _anjay_flat_in_init(&root->ctx, &SENML_CBOR_IN_VTABLE, &root->parser.base,
+                        &SENML_CBOR_PARSER_VTABLE, stream_ptr, autoclose, uri);
+    return 0;
+}
+
+#ifdef ANJAY_TEST
+#include "test/senml_cbor_in.c"
+#endif
@@ -0,0 +1,417 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+#include <avsystem/commons/log.h>
+#include <avsystem/commons/stream.h>
+#include <avsystem/commons/utils.h>
+
+#include "../coap/content_format.h"
+
+#include "../io_core.h"
+#include "numbers.h"
+#include "senml_cbor.h"
+#include "vtable.h"
+
+#define cbor_log(level, ...) avs_log(senml_cbor, level, __VA_ARGS__)
+
+VISIBILITY_SOURCE_BEGIN
+
+/*
+ * The payload is an indefinite-length array of SenML records, each of them
+ * being a map with an optional Base Name, an optional Name and a single value:
+ *
+ *     [_ {-2: "/3/0", 0: "/1", 2: 42}, {0: "/7/0", 2: 3800}, ...]
+ *
+ * Each record is assembled in a small local buffer and written to the stream
+ * with a single call; only string and opaque contents are written separately.
+ */
+
+/* map header + Base Name + Name + value label + value header */
+#define MAX_RECORD_HEADER_SIZE \
+        (1 + 2 * (2 + sizeof("/65535/65535/65535/65535")) + 4 + 9)
+
+typedef struct senml_cbor_out_struct senml_cbor_out_t;
+
+typedef struct {
+    const anjay_ret_bytes_ctx_vtable_t *vtable;
+    senml_cbor_out_t *owner;
+    size_t bytes_left;
+} senml_cbor_bytes_t;
+
+struct senml_cbor_out_struct {
+    const anjay_output_ctx_vtable_t *vtable;
+    avs_stream_abstract_t *stream;
+    int *errno_ptr;
+
+    /* Full path of the next record. The first base_path_length elements are
+       the request URI, which is sent only once as the Base Name. */
+    uint16_t path[4];
+    size_t path_length;
+    size_t base_path_length;
+    bool base_name_written;
+
+    senml_cbor_bytes_t bytes;
+};
+
+size_t _anjay_cbor_encode_head(uint8_t *out, uint8_t major_type,
+                               uint64_t value) {
+    size_t value_size;
+    if (value < 24) {
+        out[0] = (uint8_t) ((major_type << 5) | value);
+        return 1;
+    } else if (value <= UINT8_MAX) {
+        out[0] = (uint8_t) ((major_type << 5) | CBOR_EXT_LENGTH_1BYTE);
+        value_size = 1;
+    } else if (value <= UINT16_MAX) {
+        out[0] = (uint8_t) ((major_type << 5) | CBOR_EXT_LENGTH_2BYTE);
+        value_size = 2;
+    } else if (value <= UINT32_MAX) {
+        out[0] = (uint8_t) ((major_type << 5) | CBOR_EXT_LENGTH_4BYTE);
+        value_size = 4;
+    } else {
+        out[0] = (uint8_t) ((major_type << 5) | CBOR_EXT_LENGTH_8BYTE);
+        value_size = 8;
+    }
+    for (size_t i = 0; i < value_size; ++i) {
+        out[1 + i] = (uint8_t) (value >> (8 * (value_size - 1 - i)));
+    }
+    return 1 + value_size;
+}
+
+static size_t encode_int(uint8_t *out, int64_t value) {
+    if (value >= 0) {
+        return _anjay_cbor_encode_head(out, CBOR_MAJOR_TYPE_UINT,
+                                       (uint64_t) value);
+    }
+    return _anjay_cbor_encode_head(out, CBOR_MAJOR_TYPE_NEGATIVE_INT,
+                                   (uint64_t) -(value + 1));
+}
+
+/*
+ * Numbers are encoded in the shortest form that represents them exactly:
+ * integral values as integers, and others as single precision if possible.
+ */
+static size_t encode_double(uint8_t *out, double value) {
+    // the range is checked first, as casting values out of int64_t range
+    // (including infinities and NaN) is undefined behavior
+    if (isfinite(value) && value >= -0x1p53 && value <= 0x1p53
+            && value == (double) (int64_t) value
+            && (value != 0.0 || !signbit(value))) {
+        return encode_int(out, (int64_t) value);
+    } else if ((double) (float) value == value || value != value) {
+        uint32_t encoded = _anjay_htonf((float) value);
+        out[0] = CBOR_FLOAT_32;
+        memcpy(&out[1], &encoded, sizeof(encoded));
+        return 1 + sizeof(encoded);
+    } else {
+        uint64_t encoded = _anjay_htond(value);
+        out[0] = CBOR_FLOAT_64;
+        memcpy(&out[1], &encoded, sizeof(encoded));
+        return 1 + sizeof(encoded);
+    }
+}
+
+static size_t encode_path(uint8_t *out, const uint16_t *ids, size_t count) {
+    char buf[sizeof("/65535/65535/65535/65535")];
+    size_t length = 0;
+    for (size_t i = 0; i < count; ++i) {
+        buf[length++] = '/';
+        length += _anjay_i64_to_string(&buf[length], ids[i]);
+    }
+    size_t head_size = _anjay_cbor_encode_head(out, CBOR_MAJOR_TYPE_TEXT_STRING,
+                                               length);
+    memcpy(out + head_size, buf, length);
+    return head_size + length;
+}
+
+/*
+ * Encodes everything in the record up to and including the value label.
+ */
+static size_t encode_record_start(senml_cbor_out_t *ctx,
+                                  uint8_t *out,
+                                  int value_label) {
+    bool has_base_name = !ctx->base_name_written && ctx->base_path_length;
+    bool has_name = (ctx->path_length > ctx->base_path_length);
+    size_t size = _anjay_cbor_encode_head(
+            out, CBOR_MAJOR_TYPE_MAP,
+            (uint64_t) (1 + has_base_name + has_name));
+    if (has_base_name) {
+        size += encode_int(&out[size], SENML_LABEL_BASE_NAME);
+        size += encode_path(&out[size], ctx->path, ctx->base_path_length);
+    }
+    if (has_name) {
+        size += encode_int(&out[size], SENML_LABEL_NAME);
+        size += encode_path(&out[size], &ctx->path[ctx->base_path_length],
+                            ctx->path_length - ctx->base_path_length);
+    }
+    if (value_label == SENML_LABEL_OBJLNK_VALUE) {
+        size += _anjay_cbor_encode_head(&out[size], CBOR_MAJOR_TYPE_TEXT_STRING,
+                                        sizeof(SENML_OBJLNK_LABEL) - 1);
+        memcpy(&out[size], SENML_OBJLNK_LABEL, sizeof(SENML_OBJLNK_LABEL) - 1);
+        size += sizeof(SENML_OBJLNK_LABEL) - 1;
+    } else {
+        size += encode_int(&out[size], value_label);
+    }
+    return size;
+}
+
+static int finish_record(senml_cbor_out_t *ctx) {
+    if (ctx->bytes.bytes_left) {
+        cbor_log(ERROR, "not all declared bytes have been returned");
+        return -1;
+    }
+    ctx->bytes.vtable = NULL;
+    ctx->base_name_written = true;
+    return 0;
+}
+
+static int write_scalar(senml_cbor_out_t *ctx,
+                        uint8_t *buf,
+                        size_t size) {
+    int retval;
+    (void) ((retval = finish_record(ctx))
+            || (retval = avs_stream_write(ctx->stream, buf, size)));
+    return retval;
+}
+
+static int *senml_cbor_errno_ptr(anjay_output_ctx_t *ctx) {
+    return ((senml_cbor_out_t *) ctx)->errno_ptr;
+}
+
+static int bytes_append(anjay_ret_bytes_ctx_t *ctx_,
+                        const void *data,
+                        size_t length) {
+    senml_cbor_bytes_t *ctx = (senml_cbor_bytes_t *) ctx_;
+    if (length > ctx->bytes_left) {
+        return -1;
+    }
+    int retval = avs_stream_write(ctx->owner->stream, data, length);
+    if (!retval) {
+        ctx->bytes_left -= length;
+    }
+    return retval;
+}
+
+static const anjay_ret_bytes_ctx_vtable_t BYTES_VTABLE = {
+    .append = bytes_append
+};
+
+static anjay_ret_bytes_ctx_t *senml_cbor_ret_bytes(anjay_output_ctx_t *ctx_,
+                                                   size_t length) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    uint8_t buf[MAX_RECORD_HEADER_SIZE];
+    size_t size = encode_record_start(ctx, buf, SENML_LABEL_DATA_VALUE);
+    size += _anjay_cbor_encode_head(&buf[size], CBOR_MAJOR_TYPE_BYTE_STRING,
+                                    length);
+    if (write_scalar(ctx, buf, size)) {
+        return NULL;
+    }
+    ctx->bytes.vtable = &BYTES_VTABLE;
+    ctx->bytes.owner = ctx;
+    ctx->bytes.bytes_left = length;
+    return (anjay_ret_bytes_ctx_t *) &ctx->bytes;
+}
+
+static int senml_cbor_ret_string(anjay_output_ctx_t *ctx_,
+                                 const char *value) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    uint8_t buf[MAX_RECORD_HEADER_SIZE];
+    size_t length = strlen(value);
+    size_t size = encode_record_start(ctx, buf, SENML_LABEL_STRING_VALUE);
+    size += _anjay_cbor_encode_head(&buf[size], CBOR_MAJOR_TYPE_TEXT_STRING,
+                                    length);
+    int retval;
+    (void) ((retval = write_scalar(ctx, buf, size))
+            || (retval = avs_stream_write(ctx->stream, value, length)));
+    return retval;
+}
+
+static int senml_cbor_ret_i64(anjay_output_ctx_t *ctx_, int64_t value) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    uint8_t buf[MAX_RECORD_HEADER_SIZE];
+    size_t size = encode_record_start(ctx, buf, SENML_LABEL_VALUE);
+    size += encode_int(&buf[size], value);
+    return write_scalar(ctx, buf, size);
+}
+
+static int senml_cbor_ret_i32(anjay_output_ctx_t *ctx, int32_t value) {
+    return senml_cbor_ret_i64(ctx, value);
+}
+
+static int senml_cbor_ret_double(anjay_output_ctx_t *ctx_, double value) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    uint8_t buf[MAX_RECORD_HEADER_SIZE];
+    size_t size = encode_record_start(ctx, buf, SENML_LABEL_VALUE);
+    size += encode_double(&buf[size], value);
+    return write_scalar(ctx, buf, size);
+}
+
+static int senml_cbor_ret_float(anjay_output_ctx_t *ctx, float value) {
+    return senml_cbor_ret_double(ctx, value);
+}
+
+static int senml_cbor_ret_bool(anjay_output_ctx_t *ctx_, bool value) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    uint8_t buf[MAX_RECORD_HEADER_SIZE];
+    size_t size = encode_record_start(ctx, buf, SENML_LABEL_BOOLEAN_VALUE);
+    buf[size++] = value ? CBOR_VALUE_TRUE : CBOR_VALUE_FALSE;
+    return write_scalar(ctx, buf, size);
+}
+
+static int senml_cbor_ret_objlnk(anjay_output_ctx_t *ctx_,
+                                 anjay_oid_t oid, anjay_iid_t iid) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    uint8_t buf[MAX_RECORD_HEADER_SIZE + sizeof("65535:65535")];
+    char objlnk[sizeof("65535:65535")];
+    size_t length = _anjay_i64_to_string(objlnk, oid);
+    objlnk[length++] = ':';
+    length += _anjay_i64_to_string(&objlnk[length], iid);
+    size_t size = encode_record_start(ctx, buf, SENML_LABEL_OBJLNK_VALUE);
+    size += _anjay_cbor_encode_head(&buf[size], CBOR_MAJOR_TYPE_TEXT_STRING,
+                                    length);
+    memcpy(&buf[size], objlnk, length);
+    return write_scalar(ctx, buf, size + length);
+}
+
+static anjay_output_ctx_t *
+senml_cbor_ret_array_start(anjay_output_ctx_t *ctx_) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    if (ctx->path_length < 3) {
+        cbor_log(ERROR, "attempted to start array outside of a Resource");
+        return NULL;
+    }
+    return ctx_;
+}
+
+static int senml_cbor_ret_array_finish(anjay_output_ctx_t *ctx_) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    if (ctx->path_length > 3) {
+        ctx->path_length = 3;
+    }
+    return 0;
+}
+
+static anjay_output_ctx_t *senml_cbor_ret_object_start(anjay_output_ctx_t *ctx) {
+    return ctx;
+}
+
+static int senml_cbor_ret_object_finish(anjay_output_ctx_t *ctx) {
+    (void) ctx;
+    return 0;
+}
+
+static int senml_cbor_set_id(anjay_output_ctx_t *ctx_,
+                             anjay_id_type_t type,
+                             uint16_t id) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    size_t level = (size_t) type;
+    if (level < ctx->base_path_length) {
+        /* dm_read() announces the Resource or Instance being read even if it
+         * is already a part of the request URI */
+        if (level + 1 == ctx->base_path_length && ctx->path[level] == id) {
+            ctx->path_length = ctx->base_path_length;
+            return 0;
+        }
+    } else if (level <= ctx->path_length) {
+        ctx->path[level] = id;
+        ctx->path_length = level + 1;
+        return 0;
+    }
+    cbor_log(ERROR, "set_id(type=%d, id=%" PRIu16 ") out of order",
+             (int) type, id);
+    return -1;
+}
+
+static int senml_cbor_output_close(anjay_output_ctx_t *ctx_) {
+    senml_cbor_out_t *ctx = (senml_cbor_out_t *) ctx_;
+    const uint8_t brk = CBOR_BREAK;
+    int retval;
+    (void) ((retval = finish_record(ctx))
+            || (retval = avs_stream_write(ctx->stream, &brk, 1)));
+    return retval;
+}
+
+static const anjay_output_ctx_vtable_t SENML_CBOR_OUT_VTABLE = {
+    senml_cbor_errno_ptr,
+    senml_cbor_ret_bytes,
+    senml_cbor_ret_string,
+    senml_cbor_ret_i32,
+    senml_cbor_ret_i64,
+    senml_cbor_ret_float,
+    senml_cbor_ret_double,
+    senml_cbor_ret_bool,
+    senml_cbor_ret_objlnk,
+    senml_cbor_ret_array_start,
+    senml_cbor_ret_array_finish,
+    senml_cbor_ret_object_start,
+    senml_cbor_ret_object_finish,
+    senml_cbor_set_id,
+    senml_cbor_output_close,
+    NULL
+};
+
+static anjay_output_ctx_t *senml_cbor_out_new(avs_stream_abstract_t *stream,
+                                              int *errno_ptr,
+                                              const anjay_uri_path_t *uri) {
+    senml_cbor_out_t *ctx =
+            (senml_cbor_out_t *) calloc(1, sizeof(senml_cbor_out_t));
+    if (!ctx) {
+        return NULL;
+    }
+    ctx->vtable = &SENML_CBOR_OUT_VTABLE;
+    ctx->errno_ptr = errno_ptr;
+    ctx->stream = stream;
+    const uint16_t *ids[] = {
+        uri->has_oid ? &uri->oid : NULL,
+        uri->has_iid ? &uri->iid : NULL,
+        uri->has_rid ? &uri->rid : NULL
+    };
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(ids) && ids[i]; ++i) {
+        ctx->path[ctx->path_length++] = *ids[i];
+    }
+    ctx->base_path_length = ctx->path_length;
+
+    const uint8_t preamble = CBOR_INDEFINITE_ARRAY;
+    if (avs_stream_write(stream, &preamble, 1)) {
+        free(ctx);
+        return NULL;
+    }
+    return (anjay_output_ctx_t *) ctx;
+}
+
+anjay_output_ctx_t *
+_anjay_output_senml_cbor_create(avs_stream_abstract_t *stream,
+                                int *errno_ptr,
+                                anjay_msg_details_t *inout_details,
+                                const anjay_uri_path_t *uri) {
+    if ((*errno_ptr = _anjay_handle_requested_format(
+                 &inout_details->format, ANJAY_COAP_FORMAT_SENML_CBOR))
+            || _anjay_coap_stream_setup_response(stream, inout_details)) {
+        return NULL;
+    }
+    return senml_cbor_out_new(stream, errno_ptr, uri);
+}
+
+#ifdef ANJAY_TEST
+#include "test/senml_cbor_out.c"
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <config.h>
+
+#include <string.h>
+
+#include <avsystem/commons/unit/test.h>
+
+#define TEST_ROUNDTRIP(Decoded, Encoded) do { \
+    char encoded[_ANJAY_BASE64_ENCODED_SIZE(sizeof(Decoded) - 1)]; \
+    AVS_UNIT_ASSERT_EQUAL(_anjay_base64_encode(encoded, \
+                                               (const uint8_t *) Decoded, \
+                                               sizeof(Decoded) - 1), \
+                          sizeof(Encoded) - 1); \
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(encoded, Encoded, sizeof(Encoded) - 1); \
+    uint8_t decoded[sizeof(Decoded)]; \
+    size_t decoded_size; \
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_base64_decode(decoded, &decoded_size, \
+                                                 Encoded, \
+                                                 sizeof(Encoded) - 1)); \
+    AVS_UNIT_ASSERT_EQUAL(decoded_size, sizeof(Decoded) - 1); \
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(decoded, Decoded, decoded_size); \
+} while (0)
+
+AVS_UNIT_TEST(base64, roundtrip) {
+    TEST_ROUNDTRIP("", "");
+    TEST_ROUNDTRIP("f", "Zg==");
+    TEST_ROUNDTRIP("fo", "Zm8=");
+    TEST_ROUNDTRIP("foo", "Zm9v");
+    TEST_ROUNDTRIP("foob", "Zm9vYg==");
+    TEST_ROUNDTRIP("fooba", "Zm9vYmE=");
+    TEST_ROUNDTRIP("foobar", "Zm9vYmFy");
+    TEST_ROUNDTRIP("\x00\xFB\xFF\x3E", "APv/Pg==");
+}
+
+#undef TEST_ROUNDTRIP
+
+AVS_UNIT_TEST(base64, decode_invalid) {
+    static const char *const INVALID[] = {
+        "Zm9", "Zm9vY", "Zm9v=", "Zg==Zm9v", "Zm=v", "Z===", "====",
+        "Zm9v Zm9v", "Zm9\x80", "Zm9-"
+    };
+    uint8_t decoded[16];
+    size_t decoded_size;
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(INVALID); ++i) {
+        AVS_UNIT_ASSERT_FAILED(_anjay_base64_decode(decoded, &decoded_size,
+                                                    INVALID[i],
+                                                    strlen(INVALID[i])));
+    }
+}
+
+AVS_UNIT_TEST(base64, all_byte_values) {
+    uint8_t data[256];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t) i;
+    }
+    char encoded[_ANJAY_BASE64_ENCODED_SIZE(sizeof(data))];
+    size_t encoded_size = _anjay_base64_encode(encoded, data, sizeof(data));
+    AVS_UNIT_ASSERT_EQUAL(encoded_size, sizeof(encoded));
+
+    uint8_t decoded[sizeof(data) + 2];
+    size_t decoded_size;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_base64_decode(decoded, &decoded_size,
+                                                 encoded, encoded_size));
+    AVS_UNIT_ASSERT_EQUAL(decoded_size, sizeof(data));
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(decoded, data, sizeof(data));
+}
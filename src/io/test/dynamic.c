@@ -222,6 +222,34 @@ AVS_UNIT_TEST(dynamic_out, object) {
     AVS_UNIT_ASSERT_EQUAL(COAP_FORMAT, ANJAY_COAP_FORMAT_TLV);
 }
 
+AVS_UNIT_TEST(dynamic_out, hierarchical_format_requested) {
+    TEST_ENV_WITH_FORMAT(512, ANJAY_COAP_FORMAT_TLV);
+
+    // the backend is used directly, without the dynamic wrapper
+    AVS_UNIT_ASSERT_NOT_NULL(out);
+    AVS_UNIT_ASSERT_TRUE(((dynamic_out_t *) out)->vtable
+                         != &DYNAMIC_OUT_VTABLE);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 69));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(out, 514));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+
+    VERIFY_BYTES("\xC2\x45\x02\x02");
+    AVS_UNIT_ASSERT_EQUAL(COAP_FORMAT, ANJAY_COAP_FORMAT_TLV);
+}
+
+#ifdef WITH_JSON
+AVS_UNIT_TEST(dynamic_out, hierarchical_format_mismatch) {
+    TEST_ENV_WITH_FORMAT(512, ANJAY_COAP_FORMAT_JSON);
+
+    AVS_UNIT_ASSERT_NOT_NULL(out);
+    AVS_UNIT_ASSERT_TRUE(((dynamic_out_t *) out)->vtable
+                         != &DYNAMIC_OUT_VTABLE);
+    AVS_UNIT_ASSERT_NULL(_anjay_output_object_start_sized(out, 4));
+    AVS_UNIT_ASSERT_EQUAL(outctx_errno, ANJAY_OUTCTXERR_FORMAT_MISMATCH);
+    _anjay_output_ctx_destroy(&out);
+}
+#endif // WITH_JSON
+
 AVS_UNIT_TEST(dynamic_out, method_not_implemented) {
     TEST_ENV(512);
 
@@ -0,0 +1,436 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <avsystem/commons/unit/memstream.h>
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay/core.h>
+
+#define TEST_ENV(Uri, Data) \
+    avs_stream_abstract_t *stream = NULL; \
+    AVS_UNIT_ASSERT_SUCCESS(avs_unit_memstream_alloc(&stream, sizeof(Data))); \
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(stream, Data, \
+                                             sizeof(Data) - 1)); \
+    anjay_input_ctx_t *in; \
+    AVS_UNIT_ASSERT_SUCCESS( \
+            _anjay_input_json_create(&in, &stream, false, &(Uri)));
+
+#define TEST_TEARDOWN do { \
+    _anjay_input_ctx_destroy(&in); \
+    avs_stream_cleanup(&stream); \
+} while (0)
+
+#define INSTANCE_URI \
+    ((anjay_uri_path_t) { \
+        .oid = 3, \
+        .iid = 0, \
+        .has_oid = true, \
+        .has_iid = true \
+    })
+
+#define ASSERT_ID(Ctx, IdType, Id) do { \
+    anjay_id_type_t type; \
+    uint16_t id; \
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_get_id((Ctx), &type, &id)); \
+    AVS_UNIT_ASSERT_EQUAL(type, (IdType)); \
+    AVS_UNIT_ASSERT_EQUAL(id, (Id)); \
+} while (0)
+
+#define ASSERT_ID_END(Ctx) do { \
+    anjay_id_type_t type; \
+    uint16_t id; \
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id((Ctx), &type, &id), \
+                          ANJAY_GET_INDEX_END); \
+} while (0)
+
+AVS_UNIT_TEST(json_in, instance) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":["
+             "{\"n\":\"0\",\"sv\":\"Anjay\"},"
+             "{\"n\":\"1\",\"v\":-42},"
+             "{\"n\":\"2\",\"bv\":true},"
+             "{\"n\":\"3\",\"ov\":\"1:65535\"},"
+             "{\"n\":\"4\",\"v\":1.5e3},"
+             "{\"n\":\"5\",\"v\":0.25}"
+             "]}");
+
+    char str[16];
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "Anjay");
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, -42);
+    // the value can only be read once
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    bool b;
+    ASSERT_ID(in, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bool(in, &b));
+    AVS_UNIT_ASSERT_TRUE(b);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    anjay_oid_t oid;
+    anjay_iid_t iid;
+    ASSERT_ID(in, ANJAY_ID_RID, 3);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_objlnk(in, &oid, &iid));
+    AVS_UNIT_ASSERT_EQUAL(oid, 1);
+    AVS_UNIT_ASSERT_EQUAL(iid, 65535);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    double d;
+    ASSERT_ID(in, ANJAY_ID_RID, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_double(in, &d));
+    AVS_UNIT_ASSERT_EQUAL(d, 1500.0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    float f;
+    ASSERT_ID(in, ANJAY_ID_RID, 5);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_float(in, &f));
+    AVS_UNIT_ASSERT_EQUAL(f, 0.25f);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, type_mismatch) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1\",\"sv\":\"42\"}]}");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, invalid_numbers) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":["
+             "{\"n\":\"1\",\"v\":012},"
+             "{\"n\":\"2\",\"v\":+12},"
+             "{\"n\":\"3\",\"v\":4294967296}"
+             "]}");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 3);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, skip_unread_and_unknown) {
+    TEST_ENV(INSTANCE_URI,
+             "{ \"bn\" : \"/3/0/\" , \"bt\" : 25 ,\n"
+             "  \"e\" : [\n"
+             "    { \"n\" : \"0\" , \"t\" : -5 , \"sv\" : \"x\\\"y\" } ,\n"
+             "    { \"n\" : \"1\" , \"v\" : 5 , \"x\" : [ {\"a\":\"]\"} ] } ,\n"
+             "    { \"v\" : 6 , \"n\" : \"2\" }\n"
+             "  ]\n"
+             "}\n");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 5);
+    // name following the value is not supported; the error is reported as
+    // soon as the entry is parsed, and by all subsequent calls
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_next_entry(in), ANJAY_ERR_BAD_REQUEST);
+    anjay_id_type_t type;
+    uint16_t id;
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                          ANJAY_ERR_BAD_REQUEST);
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                          ANJAY_ERR_BAD_REQUEST);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, array) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":["
+             "{\"n\":\"6/0\",\"v\":1},"
+             "{\"n\":\"6/5\",\"v\":5},"
+             "{\"n\":\"7/0\",\"v\":3800},"
+             "{\"n\":\"7/1\",\"v\":5000},"
+             "{\"n\":\"9\",\"v\":100}"
+             "]}");
+
+    int32_t i32;
+    anjay_riid_t riid;
+    ASSERT_ID(in, ANJAY_ID_RID, 6);
+    // Multiple Resource cannot be read as a single value
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    // skipping a whole Multiple Resource
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 7);
+    anjay_input_ctx_t *array = anjay_get_array(in);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(array, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 3800);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(array, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 5000);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_array_index(array, &riid),
+                          ANJAY_GET_INDEX_END);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 9);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 100);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, array_partially_read) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":["
+             "{\"n\":\"7/0\",\"v\":3800},"
+             "{\"n\":\"7/1\",\"v\":5000},"
+             "{\"n\":\"9\",\"v\":100}"
+             "]}");
+    anjay_riid_t riid;
+    ASSERT_ID(in, ANJAY_ID_RID, 7);
+    anjay_input_ctx_t *array = anjay_get_array(in);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 9);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, resource) {
+    TEST_ENV(MAKE_RESOURCE_PATH(3, 0, 1),
+             "{\"bn\":\"/3/0/1\",\"e\":[{\"sv\":\"\\u017c\\u00F3\\u0142w\"}]}");
+    char str[16];
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "\xC5\xBC\xC3\xB3\xC5\x82w");
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, resource_array) {
+    TEST_ENV(MAKE_RESOURCE_PATH(3, 0, 7),
+             "{\"e\":[{\"n\":\"/3/0/7/1\",\"v\":1},"
+             "{\"n\":\"/3/0/7/2\",\"v\":2}]}");
+    int32_t i32;
+    anjay_riid_t riid;
+    anjay_input_ctx_t *array = anjay_get_array(in);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(array, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(array, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 2);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_array_index(array, &riid),
+                          ANJAY_GET_INDEX_END);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, object) {
+    TEST_ENV(((anjay_uri_path_t) { .oid = 3, .has_oid = true }),
+             "{\"bn\":\"/3/\",\"e\":["
+             "{\"n\":\"0/1\",\"v\":1},"
+             "{\"n\":\"0/2\",\"v\":2},"
+             "{\"n\":\"4/1\",\"v\":3}"
+             "]}");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_IID, 0);
+    anjay_input_ctx_t *instance = _anjay_input_nested_ctx(in);
+    AVS_UNIT_ASSERT_NOT_NULL(instance);
+    ASSERT_ID(instance, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(instance, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 1);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(instance));
+    ASSERT_ID(instance, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(instance, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 2);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(instance));
+    ASSERT_ID_END(instance);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_IID, 4);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, string_in_chunks) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"0\","
+             "\"sv\":\"0123456789\\n\\u20ac0123456789\"}]}");
+    char str[8];
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, str, sizeof(str)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "0123456");
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, str, sizeof(str)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    // the multi-byte character is not split between the calls
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "789\n");
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, str, sizeof(str)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "\xE2\x82\xAC" "0123");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "456789");
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, string_escape_in_short_buffer) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"0\","
+             "\"sv\":\"\\u20ac!\"}]}");
+    char str[3];
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    // the character does not fit, so it is returned in parts
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, str, sizeof(str)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "\xE2\x82");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "\xAC!");
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, bytes) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/0/\",\"e\":["
+             "{\"n\":\"0\",\"sv\":\"AAEC\\/\\/79\"},"
+             "{\"n\":\"1\",\"sv\":\"SGVsbG8sIHdvcmxkIQ==\"},"
+             "{\"n\":\"2\",\"sv\":\"\"}"
+             "]}");
+    char buf[32];
+    size_t bytes_read;
+    bool message_finished;
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 6);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, "\x00\x01\x02\xff\xfe\xfd", 6);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    for (size_t i = 0; i < sizeof("Hello, world!") - 1; ++i) {
+        AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read,
+                                                &message_finished, &buf[i], 1));
+        AVS_UNIT_ASSERT_EQUAL(bytes_read, 1);
+    }
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, "Hello, world!", 13);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, path_outside_uri) {
+    TEST_ENV(INSTANCE_URI,
+             "{\"bn\":\"/3/1/\",\"e\":[{\"n\":\"0\",\"v\":1}]}");
+    anjay_id_type_t type;
+    uint16_t id;
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                          ANJAY_ERR_BAD_REQUEST);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(json_in, invalid_paths) {
+    static const char *const PAYLOADS[] = {
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"65536\",\"v\":1}]}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1//2\",\"v\":1}]}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1/2/3\",\"v\":1}]}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"-1\",\"v\":1}]}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"v\":1}]}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1\"}]}"
+    };
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(PAYLOADS); ++i) {
+        avs_stream_abstract_t *stream = NULL;
+        AVS_UNIT_ASSERT_SUCCESS(avs_unit_memstream_alloc(&stream, 64));
+        AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(stream, PAYLOADS[i],
+                                                 strlen(PAYLOADS[i])));
+        anjay_input_ctx_t *in;
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_input_json_create(&in, &stream, false,
+                                                         &INSTANCE_URI));
+        anjay_id_type_t type;
+        uint16_t id;
+        AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                              ANJAY_ERR_BAD_REQUEST);
+        TEST_TEARDOWN;
+    }
+}
+
+AVS_UNIT_TEST(json_in, malformed) {
+    static const char *const PAYLOADS[] = {
+        "",
+        "[]",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1\",\"v\":1}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1\",\"v\":1},]}",
+        "{\"bn\":\"/3/0/\",\"e\":[{\"n\":\"1\",\"v\":1}]} x",
+        "{\"bn\":\"/3/0/\" \"e\":[{\"n\":\"1\",\"v\":1}]}"
+    };
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(PAYLOADS); ++i) {
+        avs_stream_abstract_t *stream = NULL;
+        AVS_UNIT_ASSERT_SUCCESS(avs_unit_memstream_alloc(&stream, 64));
+        AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(stream, PAYLOADS[i],
+                                                 strlen(PAYLOADS[i])));
+        anjay_input_ctx_t *in;
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_input_json_create(&in, &stream, false,
+                                                         &INSTANCE_URI));
+        anjay_id_type_t type;
+        uint16_t id;
+        int result;
+        while (!(result = _anjay_input_get_id(in, &type, &id))
+                && !(result = _anjay_input_next_entry(in)));
+        AVS_UNIT_ASSERT_EQUAL(result, ANJAY_ERR_BAD_REQUEST);
+        TEST_TEARDOWN;
+    }
+}
+
+AVS_UNIT_TEST(json_in, empty) {
+    TEST_ENV(INSTANCE_URI, "{\"bn\":\"/3/0/\",\"e\":[]}");
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
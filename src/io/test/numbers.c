@@ -0,0 +1,222 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <config.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <avsystem/commons/unit/test.h>
+
+#define TEST_I64(Value, Expected) do { \
+    char buf[_ANJAY_I64_STRING_SIZE]; \
+    AVS_UNIT_ASSERT_EQUAL(_anjay_i64_to_string(buf, (Value)), \
+                          sizeof(Expected) - 1); \
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf, Expected); \
+} while (0)
+
+AVS_UNIT_TEST(numbers, i64_to_string) {
+    TEST_I64(0, "0");
+    TEST_I64(7, "7");
+    TEST_I64(10, "10");
+    TEST_I64(100, "100");
+    TEST_I64(-42, "-42");
+    TEST_I64(1234567890, "1234567890");
+    TEST_I64(INT64_MAX, "9223372036854775807");
+    TEST_I64(INT64_MIN, "-9223372036854775808");
+}
+
+#undef TEST_I64
+
+#define TEST_DOUBLE(Value, Expected) do { \
+    char buf[_ANJAY_DOUBLE_STRING_SIZE]; \
+    AVS_UNIT_ASSERT_EQUAL(_anjay_double_to_string(buf, (Value)), \
+                          sizeof(Expected) - 1); \
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf, Expected); \
+} while (0)
+
+AVS_UNIT_TEST(numbers, double_to_string) {
+    TEST_DOUBLE(0.0, "0");
+    TEST_DOUBLE(-0.0, "-0");
+    TEST_DOUBLE(1.0, "1");
+    TEST_DOUBLE(-1.5, "-1.5");
+    TEST_DOUBLE(0.1, "0.1");
+    TEST_DOUBLE(100.0, "100");
+    TEST_DOUBLE(0.0001, "0.0001");
+    TEST_DOUBLE(0.00001, "1e-05");
+    TEST_DOUBLE(10000000000000.5, "10000000000000.5");
+    TEST_DOUBLE(1e16, "10000000000000000");
+    TEST_DOUBLE(1e17, "1e+17");
+    TEST_DOUBLE(3.26e+218, "3.26e+218");
+    TEST_DOUBLE(5e-324, "5e-324");
+    TEST_DOUBLE(1.7976931348623157e+308, "1.7976931348623157e+308");
+    TEST_DOUBLE(INFINITY, "inf");
+    TEST_DOUBLE(-INFINITY, "-inf");
+    TEST_DOUBLE(NAN, "nan");
+}
+
+#undef TEST_DOUBLE
+
+#define TEST_FLOAT(Value, Expected) do { \
+    char buf[_ANJAY_DOUBLE_STRING_SIZE]; \
+    AVS_UNIT_ASSERT_EQUAL(_anjay_float_to_string(buf, (Value)), \
+                          sizeof(Expected) - 1); \
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf, Expected); \
+} while (0)
+
+AVS_UNIT_TEST(numbers, float_to_string) {
+    TEST_FLOAT(0.0f, "0");
+    TEST_FLOAT(1.3f, "1.3");
+    TEST_FLOAT(0.1f, "0.1");
+    TEST_FLOAT(10000.5f, "10000.5");
+    TEST_FLOAT(16777216.0f, "16777216");
+    TEST_FLOAT(1e9f, "1e+09");
+    TEST_FLOAT(4.223e+37f, "4.223e+37");
+    TEST_FLOAT(1e-45f, "1e-45");
+}
+
+#undef TEST_FLOAT
+
+AVS_UNIT_TEST(numbers, round_trip) {
+    uint64_t state = UINT64_C(88172645463325252);
+    for (int i = 0; i < 100000; ++i) {
+        // xorshift64
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        if (isfinite(d)) {
+            char buf[_ANJAY_DOUBLE_STRING_SIZE];
+            _anjay_double_to_string(buf, d);
+            AVS_UNIT_ASSERT_TRUE(strtod(buf, NULL) == d);
+        }
+
+        uint32_t fbits = (uint32_t) state;
+        float f;
+        memcpy(&f, &fbits, sizeof(f));
+        if (isfinite(f)) {
+            char buf[_ANJAY_DOUBLE_STRING_SIZE];
+            _anjay_float_to_string(buf, f);
+            AVS_UNIT_ASSERT_TRUE(strtof(buf, NULL) == f);
+        }
+    }
+}
+
+#define TEST_PARSE(Type, Suffix, Str, Expected) do { \
+    Type value; \
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_string_to_##Suffix (Str, sizeof(Str) - 1, \
+                                                       &value)); \
+    AVS_UNIT_ASSERT_EQUAL(value, (Expected)); \
+} while (0)
+
+#define TEST_PARSE_FAIL(Type, Suffix, Str) do { \
+    Type value; \
+    AVS_UNIT_ASSERT_FAILED(_anjay_string_to_##Suffix (Str, sizeof(Str) - 1, \
+                                                      &value)); \
+} while (0)
+
+AVS_UNIT_TEST(numbers, string_to_i64) {
+    TEST_PARSE(int64_t, i64, "0", 0);
+    TEST_PARSE(int64_t, i64, "+42", 42);
+    TEST_PARSE(int64_t, i64, "-42", -42);
+    TEST_PARSE(int64_t, i64, "0x1F", 31);
+    TEST_PARSE(int64_t, i64, "-010", -8);
+    TEST_PARSE(int64_t, i64, "9223372036854775807", INT64_MAX);
+    TEST_PARSE(int64_t, i64, "-9223372036854775808", INT64_MIN);
+    TEST_PARSE_FAIL(int64_t, i64, "");
+    TEST_PARSE_FAIL(int64_t, i64, "-");
+    TEST_PARSE_FAIL(int64_t, i64, " 1");
+    TEST_PARSE_FAIL(int64_t, i64, "1 ");
+    TEST_PARSE_FAIL(int64_t, i64, "08");
+    TEST_PARSE_FAIL(int64_t, i64, "0x");
+    TEST_PARSE_FAIL(int64_t, i64, "1.0");
+    TEST_PARSE_FAIL(int64_t, i64, "9223372036854775808");
+    TEST_PARSE_FAIL(int64_t, i64, "-9223372036854775809");
+}
+
+AVS_UNIT_TEST(numbers, string_to_double) {
+    TEST_PARSE(double, double, "0", 0.0);
+    TEST_PARSE(double, double, "1.", 1.0);
+    TEST_PARSE(double, double, ".5", 0.5);
+    TEST_PARSE(double, double, "-10000.5", -10000.5);
+    TEST_PARSE(double, double, "1.3125000", 1.3125);
+    TEST_PARSE(double, double, "4.223e+37", 4.223e+37);
+    TEST_PARSE(double, double, "3.26E218", 3.26e+218);
+    TEST_PARSE(double, double, "0.1", 0.1);
+    TEST_PARSE(double, double, "9007199254740993", 9007199254740992.0);
+    TEST_PARSE(double, double, "123456789012345678901234567890",
+               123456789012345678901234567890.0);
+    TEST_PARSE(double, double, "2.2250738585072014e-308", 2.2250738585072014e-308);
+    TEST_PARSE(double, double, "0e999", 0.0);
+    TEST_PARSE(double, double, "-inf", -INFINITY);
+    TEST_PARSE(double, double, "Infinity", INFINITY);
+
+    double value;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_string_to_double("NaN", 3, &value));
+    AVS_UNIT_ASSERT_TRUE(isnan(value));
+
+    TEST_PARSE_FAIL(double, double, "");
+    TEST_PARSE_FAIL(double, double, ".");
+    TEST_PARSE_FAIL(double, double, "1e");
+    TEST_PARSE_FAIL(double, double, "1e+");
+    TEST_PARSE_FAIL(double, double, "1..2");
+    TEST_PARSE_FAIL(double, double, "1,5");
+    TEST_PARSE_FAIL(double, double, " 1");
+    TEST_PARSE_FAIL(double, double, "wat");
+    TEST_PARSE_FAIL(double, double, "1e400");
+}
+
+AVS_UNIT_TEST(numbers, string_to_double_long_input) {
+    // 2^53 + 1 is exactly halfway between two doubles; digits that do not
+    // fit in the rendered buffer still decide how it is rounded
+    char str[2048] = "9007199254740993.";
+    size_t length = strlen(str);
+    memset(&str[length], '0', 1500);
+    length += 1500;
+    double value;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_string_to_double(str, length, &value));
+    AVS_UNIT_ASSERT_EQUAL(value, 9007199254740992.0);
+
+    str[length++] = '1';
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_string_to_double(str, length, &value));
+    AVS_UNIT_ASSERT_EQUAL(value, 9007199254740994.0);
+
+    // leading zeros are not significant
+    memset(str, '0', 1500);
+    memcpy(&str[1500], "9007199254740995", 16);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_string_to_double(str, 1516, &value));
+    AVS_UNIT_ASSERT_EQUAL(value, 9007199254740996.0);
+
+    // dropped digits of the integer part still count towards the magnitude
+    str[0] = '1';
+    memset(&str[1], '0', 1000);
+    memcpy(&str[1001], "e-700", 5);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_string_to_double(str, 1006, &value));
+    AVS_UNIT_ASSERT_EQUAL(value, 1e300);
+}
+
+AVS_UNIT_TEST(numbers, string_to_float) {
+    TEST_PARSE(float, float, "1.3", 1.3f);
+    TEST_PARSE(float, float, "-10000.5", -10000.5f);
+    TEST_PARSE(float, float, "4.223e+37", 4.223e+37f);
+    TEST_PARSE(float, float, "16777217", 16777216.0f);
+    TEST_PARSE_FAIL(float, float, "1e39");
+    TEST_PARSE_FAIL(float, float, "wat");
+}
+
+#undef TEST_PARSE_FAIL
+#undef TEST_PARSE
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <avsystem/commons/unit/test.h>
+
+typedef struct {
+    anjay_output_value_t values[4];
+    char bytes[4][16];
+    size_t count;
+} captured_values_t;
+
+static int capture_value(void *captured_, const anjay_output_value_t *value) {
+    captured_values_t *captured = (captured_values_t *) captured_;
+    AVS_UNIT_ASSERT_TRUE(captured->count < AVS_ARRAY_SIZE(captured->values));
+    captured->values[captured->count] = *value;
+    if (value->type == ANJAY_OUTPUT_VALUE_BYTES
+            || value->type == ANJAY_OUTPUT_VALUE_STRING) {
+        AVS_UNIT_ASSERT_TRUE(value->value.bytes.size
+                             <= sizeof(captured->bytes[0]));
+        memcpy(captured->bytes[captured->count], value->value.bytes.data,
+               value->value.bytes.size);
+    }
+    ++captured->count;
+    return 0;
+}
+
+#define TEST_ENV(BufSize) \
+    captured_values_t captured = { .count = 0 }; \
+    char buf[BufSize]; \
+    anjay_output_value_ctx_t value_ctx = \
+            _anjay_output_value_ctx_init(capture_value, &captured, \
+                                         buf, sizeof(buf)); \
+    anjay_output_ctx_t *out = (anjay_output_ctx_t *) &value_ctx
+
+AVS_UNIT_TEST(output_value, i32) {
+    TEST_ENV(1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(out, -42));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 1);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].type, ANJAY_OUTPUT_VALUE_INT);
+    AVS_UNIT_ASSERT_FALSE(captured.values[0].is_array_element);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].value.i, -42);
+}
+
+AVS_UNIT_TEST(output_value, string) {
+    TEST_ENV(1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_string(out, "coap://"));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 1);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].type, ANJAY_OUTPUT_VALUE_STRING);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].value.bytes.size, 7);
+    AVS_UNIT_ASSERT_EQUAL_BYTES(captured.bytes[0], "coap://");
+}
+
+AVS_UNIT_TEST(output_value, only_one_value_allowed) {
+    TEST_ENV(1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bool(out, true));
+    AVS_UNIT_ASSERT_FAILED(anjay_ret_bool(out, false));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 1);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].type, ANJAY_OUTPUT_VALUE_BOOL);
+    AVS_UNIT_ASSERT_TRUE(captured.values[0].value.b);
+}
+
+AVS_UNIT_TEST(output_value, bytes_chunked) {
+    TEST_ENV(8);
+    anjay_ret_bytes_ctx_t *bytes = anjay_ret_bytes_begin(out, 6);
+    AVS_UNIT_ASSERT_NOT_NULL(bytes);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, "abc", 3));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, "def", 3));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 1);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].type, ANJAY_OUTPUT_VALUE_BYTES);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].value.bytes.size, 6);
+    AVS_UNIT_ASSERT_EQUAL_BYTES(captured.bytes[0], "abcdef");
+}
+
+AVS_UNIT_TEST(output_value, bytes_too_long) {
+    TEST_ENV(4);
+    AVS_UNIT_ASSERT_NULL(anjay_ret_bytes_begin(out, 5));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 0);
+}
+
+AVS_UNIT_TEST(output_value, array) {
+    TEST_ENV(1);
+    anjay_output_ctx_t *array = anjay_ret_array_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(array, 15));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 0));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i64(array, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_finish(array));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 2);
+    AVS_UNIT_ASSERT_TRUE(captured.values[0].is_array_element);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].riid, 1);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[0].value.i, 15);
+    AVS_UNIT_ASSERT_TRUE(captured.values[1].is_array_element);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[1].riid, 0);
+    AVS_UNIT_ASSERT_EQUAL(captured.values[1].value.i, 1);
+}
+
+AVS_UNIT_TEST(output_value, array_index_required) {
+    TEST_ENV(1);
+    anjay_output_ctx_t *array = anjay_ret_array_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_FAILED(anjay_ret_i32(array, 15));
+    AVS_UNIT_ASSERT_EQUAL(captured.count, 0);
+}
@@ -0,0 +1,426 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <avsystem/commons/unit/memstream.h>
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay/core.h>
+
+#define TEST_ENV_SIZED(Uri, Data, Size) \
+    avs_stream_abstract_t *stream = NULL; \
+    AVS_UNIT_ASSERT_SUCCESS(avs_unit_memstream_alloc(&stream, (Size) + 1)); \
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(stream, (Data), (Size))); \
+    anjay_input_ctx_t *in; \
+    AVS_UNIT_ASSERT_SUCCESS( \
+            _anjay_input_senml_cbor_create(&in, &stream, false, &(Uri)));
+
+#define TEST_ENV(Uri, Data) TEST_ENV_SIZED((Uri), Data, sizeof(Data) - 1)
+
+#define TEST_TEARDOWN do { \
+    _anjay_input_ctx_destroy(&in); \
+    avs_stream_cleanup(&stream); \
+} while (0)
+
+#define INSTANCE_URI \
+    ((anjay_uri_path_t) { \
+        .oid = 3, \
+        .iid = 0, \
+        .has_oid = true, \
+        .has_iid = true \
+    })
+
+#define ASSERT_ID(Ctx, IdType, Id) do { \
+    anjay_id_type_t type; \
+    uint16_t id; \
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_get_id((Ctx), &type, &id)); \
+    AVS_UNIT_ASSERT_EQUAL(type, (IdType)); \
+    AVS_UNIT_ASSERT_EQUAL(id, (Id)); \
+} while (0)
+
+#define ASSERT_ID_END(Ctx) do { \
+    anjay_id_type_t type; \
+    uint16_t id; \
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id((Ctx), &type, &id), \
+                          ANJAY_GET_INDEX_END); \
+} while (0)
+
+/* Base Name "/3/0/" and a single-character Name */
+#define BN_3_0 "\x21\x65/3/0/"
+#define NAME(Str) "\x00\x61" Str
+
+AVS_UNIT_TEST(senml_cbor_in, instance) {
+    TEST_ENV(INSTANCE_URI,
+             "\x9F"
+             "\xA3" BN_3_0 NAME("0") "\x03\x65" "Anjay"
+             "\xA2" NAME("1") "\x02\x38\x29"
+             "\xA2" NAME("2") "\x04\xF5"
+             "\xA2" NAME("3") "\x63vlo\x67" "1:65535"
+             "\xA2" NAME("4") "\x02\xFA\x44\xBB\x80\x00"
+             "\xA2" NAME("5") "\x02\xF9\x34\x00"
+             "\xA2" NAME("6") "\x02\xFB\x3F\xF8\x00\x00\x00\x00\x00\x00"
+             "\xFF");
+
+    char str[16];
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "Anjay");
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, -42);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    bool boolean;
+    ASSERT_ID(in, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bool(in, &boolean));
+    AVS_UNIT_ASSERT_TRUE(boolean);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    anjay_oid_t oid;
+    anjay_iid_t iid;
+    ASSERT_ID(in, ANJAY_ID_RID, 3);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_objlnk(in, &oid, &iid));
+    AVS_UNIT_ASSERT_EQUAL(oid, 1);
+    AVS_UNIT_ASSERT_EQUAL(iid, 65535);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    // integral floating-point values may be read as integers
+    ASSERT_ID(in, ANJAY_ID_RID, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 1500);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    float f32;
+    ASSERT_ID(in, ANJAY_ID_RID, 5);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_float(in, &f32));
+    AVS_UNIT_ASSERT_EQUAL(f32, 0.25f);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    double f64;
+    ASSERT_ID(in, ANJAY_ID_RID, 6);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_double(in, &f64));
+    AVS_UNIT_ASSERT_EQUAL(f64, 1.5);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, type_mismatch) {
+    TEST_ENV(INSTANCE_URI,
+             "\x81\xA3" BN_3_0 NAME("1") "\x03\x62" "42");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, invalid_numbers) {
+    TEST_ENV(INSTANCE_URI,
+             "\x86"
+             "\xA3" BN_3_0 NAME("1") "\x02\xF9\x3E\x00"
+             "\xA2" NAME("2") "\x02\x1B\x00\x00\x00\x01\x00\x00\x00\x00"
+             "\xA2" NAME("3") "\x02\x1B\x80\x00\x00\x00\x00\x00\x00\x00"
+             // infinity, NaN and 1e300
+             "\xA2" NAME("4") "\x02\xF9\x7C\x00"
+             "\xA2" NAME("5") "\x02\xF9\x7E\x00"
+             "\xA2" NAME("6") "\x02\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C");
+    int32_t i32;
+    int64_t i64;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 3);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i64(in, &i64));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 4);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i64(in, &i64));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 5);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i64(in, &i64));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 6);
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i64(in, &i64));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, large_integer_as_double) {
+    // out-of-range integers may still be read as floating-point values
+    TEST_ENV(INSTANCE_URI,
+             "\x81\xA3" BN_3_0 NAME("1")
+             "\x02\x3B\x80\x00\x00\x00\x00\x00\x00\x00");
+    double f64;
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_double(in, &f64));
+    AVS_UNIT_ASSERT_EQUAL(f64, -9223372036854775809.0);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, skip_unread_and_unknown) {
+    TEST_ENV(INSTANCE_URI,
+             "\x9F"
+             // {-3: 25, -2: "/3/0/", 0: "0", 6: -5, 3: "xy"}
+             "\xBF\x22\x18\x19" BN_3_0 NAME("0") "\x06\x24\x03\x62xy\xFF"
+             // {0: "1", 2: 5, "x": [_ {"a": h'ff'}, 1(0)], 7: "z"}
+             "\xA4" NAME("1") "\x02\x05"
+             "\x61x\x9F\xA1\x61\x61\x41\xFF\xC1\x00\xFF" "\x07\x61z"
+             // {2: 6, 0: "2"}
+             "\xA2\x02\x06" NAME("2")
+             "\xFF");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 5);
+    // name following the value is not supported; the error is reported as
+    // soon as the record is parsed, and by all subsequent calls
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_next_entry(in), ANJAY_ERR_BAD_REQUEST);
+    anjay_id_type_t type;
+    uint16_t id;
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                          ANJAY_ERR_BAD_REQUEST);
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                          ANJAY_ERR_BAD_REQUEST);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, array) {
+    TEST_ENV(INSTANCE_URI,
+             "\x85"
+             "\xA3" BN_3_0 "\x00\x63" "6/0\x02\x01"
+             "\xA2\x00\x63" "6/5\x02\x05"
+             "\xA2\x00\x63" "7/0\x02\x19\x0E\xD8"
+             "\xA2\x00\x63" "7/1\x02\x19\x13\x88"
+             "\xA2" NAME("9") "\x02\x18\x64");
+
+    int32_t i32;
+    anjay_riid_t riid;
+    ASSERT_ID(in, ANJAY_ID_RID, 6);
+    // Multiple Resource cannot be read as a single value
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    // skipping a whole Multiple Resource
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 7);
+    anjay_input_ctx_t *array = anjay_get_array(in);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(array, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 3800);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_array_index(array, &riid));
+    AVS_UNIT_ASSERT_EQUAL(riid, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(array, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 5000);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_array_index(array, &riid),
+                          ANJAY_GET_INDEX_END);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 9);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 100);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, resource) {
+    TEST_ENV(MAKE_RESOURCE_PATH(3, 0, 1),
+             "\x81\xA2\x21\x66/3/0/1\x03\x66\xC5\xBC\xC3\xB3\xC5\x82");
+    char str[16];
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "\xC5\xBC\xC3\xB3\xC5\x82");
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, object) {
+    TEST_ENV(((anjay_uri_path_t) { .oid = 3, .has_oid = true }),
+             "\x9F"
+             "\xA3\x21\x62/3\x00\x64/0/1\x02\x01"
+             "\xA2\x00\x64/0/2\x02\x02"
+             "\xA2\x00\x64/1/1\x02\x03"
+             "\xFF");
+    int32_t i32;
+    ASSERT_ID(in, ANJAY_ID_IID, 0);
+    anjay_input_ctx_t *instance = _anjay_input_nested_ctx(in);
+    AVS_UNIT_ASSERT_NOT_NULL(instance);
+    ASSERT_ID(instance, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(instance, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 1);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(instance));
+    ASSERT_ID(instance, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(instance, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 2);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(instance));
+    ASSERT_ID_END(instance);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_IID, 1);
+    instance = _anjay_input_nested_ctx(in);
+    AVS_UNIT_ASSERT_NOT_NULL(instance);
+    ASSERT_ID(instance, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(instance, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 3);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, string_in_chunks) {
+    TEST_ENV(INSTANCE_URI,
+             "\x81\xA3" BN_3_0 NAME("0") "\x03\x74" "0123456789abcdefghij");
+    char str[8];
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, str, sizeof(str)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "0123456");
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, str, sizeof(str)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "789abcd");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, str, sizeof(str)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(str, "efghij");
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, bytes) {
+    static const char HEADER[] =
+            "\x83"
+            "\xA3" BN_3_0 NAME("0") "\x08\x46\x00\x01\x02\xFF\xFE\xFD"
+            "\xA2" NAME("1") "\x08\x40"
+            "\xA2" NAME("2") "\x08\x59\x01\x00";
+    char payload[sizeof(HEADER) - 1 + 256];
+    memcpy(payload, HEADER, sizeof(HEADER) - 1);
+    for (size_t i = 0; i < 256; ++i) {
+        payload[sizeof(HEADER) - 1 + i] = (char) i;
+    }
+    TEST_ENV_SIZED(INSTANCE_URI, payload, sizeof(payload));
+
+    char buf[256];
+    size_t bytes_read;
+    bool message_finished;
+    ASSERT_ID(in, ANJAY_ID_RID, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 6);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, "\x00\x01\x02\xFF\xFE\xFD", 6);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    ASSERT_ID(in, ANJAY_ID_RID, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    // chunks larger than the internal buffer are read directly
+    ASSERT_ID(in, ANJAY_ID_RID, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, 3));
+    AVS_UNIT_ASSERT_FALSE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 3);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            &buf[3], sizeof(buf)));
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 253);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, &payload[sizeof(HEADER) - 1], 256);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(senml_cbor_in, path_outside_uri) {
+    TEST_ENV(INSTANCE_URI, "\x81\xA3\x21\x65/3/1/" NAME("0") "\x02\x01");
+    anjay_id_type_t type;
+    uint16_t id;
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, &type, &id),
+                          ANJAY_ERR_BAD_REQUEST);
+    TEST_TEARDOWN;
+}
+
+typedef struct {
+    const char *data;
+    size_t size;
+} test_payload_t;
+
+#define PAYLOAD(Data) { Data, sizeof(Data) - 1 }
+
+static void assert_bad_request(const test_payload_t *payloads, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        TEST_ENV_SIZED(INSTANCE_URI, payloads[i].data, payloads[i].size);
+        anjay_id_type_t type;
+        uint16_t id;
+        int result;
+        while (!(result = _anjay_input_get_id(in, &type, &id))
+                && !(result = _anjay_input_next_entry(in)));
+        AVS_UNIT_ASSERT_EQUAL(result, ANJAY_ERR_BAD_REQUEST);
+        TEST_TEARDOWN;
+    }
+}
+
+AVS_UNIT_TEST(senml_cbor_in, invalid_paths) {
+    static const test_payload_t PAYLOADS[] = {
+        PAYLOAD("\x81\xA3" BN_3_0 "\x00\x65" "65536\x02\x01"),
+        PAYLOAD("\x81\xA3" BN_3_0 "\x00\x64" "1//2\x02\x01"),
+        PAYLOAD("\x81\xA3" BN_3_0 "\x00\x65" "1/2/3\x02\x01"),
+        PAYLOAD("\x81\xA2" BN_3_0 "\x02\x01"),
+        PAYLOAD("\x81\xA2" BN_3_0 NAME("1")),
+        PAYLOAD("\x81\xA3" BN_3_0 "\x00\x01\x02\x01")
+    };
+    assert_bad_request(PAYLOADS, AVS_ARRAY_SIZE(PAYLOADS));
+}
+
+AVS_UNIT_TEST(senml_cbor_in, malformed) {
+    static const test_payload_t PAYLOADS[] = {
+        PAYLOAD(""),
+        PAYLOAD("\xA0"),
+        // truncated
+        PAYLOAD("\x9F\xA3" BN_3_0 NAME("1") "\x02\x01"),
+        PAYLOAD("\x82\xA3" BN_3_0 NAME("1") "\x02\x01"),
+        PAYLOAD("\x81\xA3" BN_3_0 NAME("1") "\x03\x65" "ab"),
+        // trailing data
+        PAYLOAD("\x81\xA3" BN_3_0 NAME("1") "\x02\x01\x00"),
+        // reserved additional information value
+        PAYLOAD("\x81\xA3" BN_3_0 NAME("1") "\x02\x1C"),
+        // value of a type not matching the label
+        PAYLOAD("\x81\xA3" BN_3_0 NAME("1") "\x04\x01"),
+        // indefinite-length string value
+        PAYLOAD("\x81\xA3" BN_3_0 NAME("1") "\x03\x7F\x61" "a\xFF"),
+        // nested too deeply
+        PAYLOAD("\x81\xA4" BN_3_0 NAME("1") "\x01"
+                "\x81\x81\x81\x81\x81\x81\x81\x81\x81\x00" "\x02\x01")
+    };
+    assert_bad_request(PAYLOADS, AVS_ARRAY_SIZE(PAYLOADS));
+}
+
+AVS_UNIT_TEST(senml_cbor_in, empty) {
+    TEST_ENV(INSTANCE_URI, "\x9F\xFF");
+    ASSERT_ID_END(in);
+    TEST_TEARDOWN;
+}
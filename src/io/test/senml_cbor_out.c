@@ -0,0 +1,196 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <avsystem/commons/unit/test.h>
+
+#define TEST_ENV(Size, Uri) \
+    char buf[Size]; \
+    avs_stream_outbuf_t outbuf = AVS_STREAM_OUTBUF_STATIC_INITIALIZER; \
+    avs_stream_outbuf_set_buffer(&outbuf, buf, sizeof(buf)); \
+    int errno_value = 0; \
+    anjay_output_ctx_t *out = \
+            senml_cbor_out_new((avs_stream_abstract_t *) &outbuf, \
+                               &errno_value, &(Uri)); \
+    AVS_UNIT_ASSERT_NOT_NULL(out)
+
+#define VERIFY_BYTES(Data) do { \
+    AVS_UNIT_ASSERT_EQUAL(avs_stream_outbuf_offset(&outbuf), sizeof(Data) - 1);\
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, Data, sizeof(Data) - 1); \
+} while (0)
+
+#define INSTANCE_URI \
+    ((anjay_uri_path_t) { \
+        .oid = 3, \
+        .iid = 0, \
+        .has_oid = true, \
+        .has_iid = true \
+    })
+
+AVS_UNIT_TEST(senml_cbor_out, instance) {
+    TEST_ENV(256, INSTANCE_URI);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 0));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_string(out, "Anjay"));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(out, -42));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 2));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bool(out, true));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 3));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_objlnk(out, 1, 65535));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_double(out, 1500.0));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 5));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_float(out, 0.25f));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 6));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_double(out, 0.1));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F"
+                 "\xA3\x21\x64/3/0\x00\x62/0\x03\x65" "Anjay"
+                 "\xA2\x00\x62/1\x02\x38\x29"
+                 "\xA2\x00\x62/2\x04\xF5"
+                 "\xA2\x00\x62/3\x63vlo\x67" "1:65535"
+                 "\xA2\x00\x62/4\x02\x19\x05\xDC"
+                 "\xA2\x00\x62/5\x02\xFA\x3E\x80\x00\x00"
+                 "\xA2\x00\x62/6\x02\xFB\x3F\xB9\x99\x99\x99\x99\x99\x9A"
+                 "\xFF");
+}
+
+AVS_UNIT_TEST(senml_cbor_out, numbers) {
+    TEST_ENV(256, INSTANCE_URI);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 0));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i64(out, INT64_MIN));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i64(out, 4294967296));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 2));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_double(out, -0.0));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 3));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_double(out, 1e300));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_double(out, 18014398509481984.0));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F"
+                 "\xA3\x21\x64/3/0\x00\x62/0"
+                 "\x02\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF"
+                 "\xA2\x00\x62/1\x02\x1B\x00\x00\x00\x01\x00\x00\x00\x00"
+                 "\xA2\x00\x62/2\x02\xFA\x80\x00\x00\x00"
+                 "\xA2\x00\x62/3\x02\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C"
+                 // integral, but too large to be exactly representable as
+                 // an integer by receivers that use doubles internally
+                 "\xA2\x00\x62/4\x02\xFA\x5A\x80\x00\x00"
+                 "\xFF");
+}
+
+AVS_UNIT_TEST(senml_cbor_out, resource) {
+    TEST_ENV(64, MAKE_RESOURCE_PATH(3, 0, 1));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(out, 5));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F\xA2\x21\x66/3/0/1\x02\x05\xFF");
+}
+
+AVS_UNIT_TEST(senml_cbor_out, resource_array) {
+    TEST_ENV(64, MAKE_RESOURCE_PATH(3, 0, 7));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 7));
+    anjay_output_ctx_t *array = anjay_ret_array_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 0));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(array, 3800));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(array, 5000));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_finish(array));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F"
+                 "\xA3\x21\x66/3/0/7\x00\x62/0\x02\x19\x0E\xD8"
+                 "\xA2\x00\x62/1\x02\x19\x13\x88"
+                 "\xFF");
+}
+
+AVS_UNIT_TEST(senml_cbor_out, object) {
+    TEST_ENV(128, ((anjay_uri_path_t) { .oid = 3, .has_oid = true }));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 0));
+    anjay_output_ctx_t *instance = _anjay_output_object_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(instance);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(instance, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(instance, 1));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(instance, ANJAY_ID_RID, 7));
+    anjay_output_ctx_t *array = anjay_ret_array_start(instance);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 2));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(array, 2));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_finish(array));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_object_finish(instance));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    instance = _anjay_output_object_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(instance);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(instance, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(instance, 3));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_object_finish(instance));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F"
+                 "\xA3\x21\x62/3\x00\x64/0/1\x02\x01"
+                 "\xA2\x00\x66/0/7/2\x02\x02"
+                 "\xA2\x00\x64/1/1\x02\x03"
+                 "\xFF");
+}
+
+AVS_UNIT_TEST(senml_cbor_out, bytes) {
+    TEST_ENV(64, INSTANCE_URI);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 0));
+    anjay_ret_bytes_ctx_t *bytes = anjay_ret_bytes_begin(out, 5);
+    AVS_UNIT_ASSERT_NOT_NULL(bytes);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, "\x00\x01", 2));
+    AVS_UNIT_ASSERT_FAILED(anjay_ret_bytes_append(bytes, "\x02\x03\x04\x05",
+                                                  4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, "\x02\x03\x04", 3));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_NOT_NULL(anjay_ret_bytes_begin(out, 0));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F"
+                 "\xA3\x21\x64/3/0\x00\x62/0\x08\x45\x00\x01\x02\x03\x04"
+                 "\xA2\x00\x62/1\x08\x40"
+                 "\xFF");
+}
+
+AVS_UNIT_TEST(senml_cbor_out, bytes_incomplete) {
+    TEST_ENV(64, INSTANCE_URI);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 0));
+    anjay_ret_bytes_ctx_t *bytes = anjay_ret_bytes_begin(out, 5);
+    AVS_UNIT_ASSERT_NOT_NULL(bytes);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, "\x00\x01", 2));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_RID, 1));
+    AVS_UNIT_ASSERT_FAILED(anjay_ret_i32(out, 1));
+    AVS_UNIT_ASSERT_FAILED(_anjay_output_ctx_destroy(&out));
+}
+
+AVS_UNIT_TEST(senml_cbor_out, invalid_ids) {
+    TEST_ENV(64, INSTANCE_URI);
+
+    // Object Instance from the request URI may be announced again
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 0));
+    AVS_UNIT_ASSERT_FAILED(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    AVS_UNIT_ASSERT_FAILED(_anjay_output_set_id(out, ANJAY_ID_OID, 3));
+    AVS_UNIT_ASSERT_FAILED(_anjay_output_set_id(out, ANJAY_ID_RIID, 1));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+    VERIFY_BYTES("\x9F\xFF");
+}
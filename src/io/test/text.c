@@ -172,6 +172,24 @@ AVS_UNIT_TEST(text_out, objlnk) {
 
 #undef TEST_OBJLNK
 
+AVS_UNIT_TEST(text_out, bytes) {
+    TEST_ENV(512);
+    static const char DATA[] = "Hello, world! How are you?";
+    anjay_ret_bytes_ctx_t *bytes =
+            anjay_ret_bytes_begin((anjay_output_ctx_t *) &out,
+                                  sizeof(DATA) - 1);
+    AVS_UNIT_ASSERT_NOT_NULL(bytes);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, DATA, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, &DATA[1], 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, &DATA[2], 20));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_append(bytes, &DATA[22], 4));
+    AVS_UNIT_ASSERT_FAILED(anjay_ret_bytes_append(bytes, "!", 1));
+    AVS_UNIT_ASSERT_SUCCESS(text_ret_close((anjay_output_ctx_t *) &out));
+    stringify_buf(&outbuf);
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf,
+                                 "SGVsbG8sIHdvcmxkISBIb3cgYXJlIHlvdT8=");
+}
+
 AVS_UNIT_TEST(text_out, unimplemented) {
     TEST_ENV(512);
     AVS_UNIT_ASSERT_NOT_NULL(anjay_ret_bytes_begin((anjay_output_ctx_t *) &out, 3));
@@ -224,6 +242,49 @@ AVS_UNIT_TEST(text_in, string_too_long) {
     TEST_TEARDOWN;
 }
 
+AVS_UNIT_TEST(text_in, bytes) {
+    TEST_ENV(64);
+
+    static const char ENCODED[] = "SGVsbG8sIHdvcmxkISBIb3cgYXJlIHlvdT8=";
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(stream,
+                                             ENCODED, strlen(ENCODED)));
+
+    char buf[32];
+    size_t bytes_read;
+    bool message_finished;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, 2));
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 2);
+    AVS_UNIT_ASSERT_FALSE(message_finished);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            &buf[2], 7));
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 7);
+    AVS_UNIT_ASSERT_FALSE(message_finished);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            &buf[9], sizeof(buf) - 9));
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 17);
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, "Hello, world! How are you?", 26);
+
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(text_in, bytes_invalid_padding) {
+    TEST_ENV(64);
+
+    static const char ENCODED[] = "Zg==Zm9v";
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(stream,
+                                             ENCODED, strlen(ENCODED)));
+
+    char buf[32];
+    size_t bytes_read;
+    bool message_finished;
+    AVS_UNIT_ASSERT_FAILED(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                           buf, sizeof(buf)));
+
+    TEST_TEARDOWN;
+}
+
 #define TEST_NUM_COMMON(Val, ...) do { \
     TEST_ENV(32); \
     \
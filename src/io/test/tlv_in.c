@@ -423,3 +423,148 @@ AVS_UNIT_TEST(tlv_in_types, invalid_read) {
 
     TEST_TEARDOWN;
 }
+
+#undef TEST_TEARDOWN
+#undef TEST_ENV
+
+#define TEST_ENV(Data) \
+    anjay_input_ctx_t *in; \
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_tlv_buffer_create(&in, Data, \
+                                                           sizeof(Data) - 1));
+
+#define TEST_TEARDOWN _anjay_input_ctx_destroy(&in)
+
+#define TLV_BYTES_TEST_ID(IdType, Id) do { \
+    anjay_id_type_t type; \
+    uint16_t id; \
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_get_id(in, &type, &id)); \
+    AVS_UNIT_ASSERT_EQUAL(type, IdType); \
+    AVS_UNIT_ASSERT_EQUAL(id, Id); \
+} while (0)
+
+AVS_UNIT_TEST(tlv_in_buffer, bytes) {
+    TEST_ENV("\xC4\x2A" "0123" "\xE8\xFF\xFE\x07" "0123456" "\xC5\x16" "01234");
+
+    TLV_BYTES_TEST_ID(ANJAY_ID_RID, 42);
+    // skip reading altogether
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    TLV_BYTES_TEST_ID(ANJAY_ID_RID, 65534);
+    char buf[4];
+    size_t bytes_read;
+    bool message_finished;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 4);
+    AVS_UNIT_ASSERT_FALSE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, "0123", 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 3);
+    AVS_UNIT_ASSERT_TRUE(message_finished);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, "456", 3);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_string(in, buf, sizeof(buf)),
+                          ANJAY_BUFFER_TOO_SHORT);
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf, "012");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(in, buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf, "34");
+    TLV_BYTES_TEST_ID(ANJAY_ID_RID, 22);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, NULL, NULL),
+                          ANJAY_GET_INDEX_END);
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(tlv_in_buffer, types) {
+    TEST_ENV("\xC2\x00\x10\x92"
+             "\xC4\x01\x3F\x80\x00\x00"
+             "\xC1\x02\x01"
+             "\xC4\x03\x00\x01\xFF\xFF"
+             "\xC3\x04\x06\x79\x32");
+
+    int32_t i32;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_EQUAL(i32, 4242);
+    // whole-value getters cannot be called twice
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i32(in, &i32));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    double value;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_double(in, &value));
+    AVS_UNIT_ASSERT_EQUAL(value, 1.0);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    bool boolean;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bool(in, &boolean));
+    AVS_UNIT_ASSERT_TRUE(boolean);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    anjay_oid_t oid;
+    anjay_iid_t iid;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_objlnk(in, &oid, &iid));
+    AVS_UNIT_ASSERT_EQUAL(oid, 1);
+    AVS_UNIT_ASSERT_EQUAL(iid, 65535);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    int64_t i64;
+    AVS_UNIT_ASSERT_FAILED(anjay_get_i64(in, &i64));
+
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(tlv_in_buffer, nested) {
+    TEST_ENV("\x07\x01" "\xC1\x02\x2A" "\xC2\x03" "ab"
+             "\x03\x05" "\xC1\x02\x2B");
+
+    TLV_BYTES_TEST_ID(ANJAY_ID_IID, 1);
+    anjay_input_ctx_t *nested = _anjay_input_nested_ctx(in);
+    AVS_UNIT_ASSERT_NOT_NULL(nested);
+    anjay_id_type_t type;
+    uint16_t id;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_get_id(nested, &type, &id));
+    AVS_UNIT_ASSERT_EQUAL(type, ANJAY_ID_RID);
+    AVS_UNIT_ASSERT_EQUAL(id, 2);
+    int32_t value;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_i32(nested, &value));
+    AVS_UNIT_ASSERT_EQUAL(value, 42);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(nested));
+    char buf[8];
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_string(nested, buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(buf, "ab");
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(nested));
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(nested, NULL, NULL),
+                          ANJAY_GET_INDEX_END);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+
+    TLV_BYTES_TEST_ID(ANJAY_ID_IID, 5);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    AVS_UNIT_ASSERT_EQUAL(_anjay_input_get_id(in, NULL, NULL),
+                          ANJAY_GET_INDEX_END);
+
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(tlv_in_buffer, truncated) {
+    TEST_ENV("\xC4\x2A" "0123" "\xC7\x2B" "012");
+
+    TLV_BYTES_TEST_ID(ANJAY_ID_RID, 42);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    char buf[16];
+    size_t bytes_read;
+    bool message_finished;
+    AVS_UNIT_ASSERT_FAILED(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                           buf, sizeof(buf)));
+
+    TEST_TEARDOWN;
+}
+
+AVS_UNIT_TEST(tlv_in_buffer, header_truncated) {
+    TEST_ENV("\xF8\x01\x02\x01\x86");
+
+    AVS_UNIT_ASSERT_FAILED(_anjay_input_get_id(in, NULL, NULL));
+
+    TEST_TEARDOWN;
+}
@@ -23,13 +23,9 @@
 ///////////////////////////////////////////////////////////// ENCODING // SIMPLE
 
 static anjay_output_ctx_t *new_tlv_out(avs_stream_abstract_t *stream) {
-    tlv_out_t *out = (tlv_out_t *) calloc(1, sizeof(tlv_out_t));
+    anjay_output_ctx_t *out = _anjay_output_raw_tlv_create(stream);
     AVS_UNIT_ASSERT_NOT_NULL(out);
-    out->vtable = &TLV_OUT_VTABLE;
-    out->next_entry_ptr = &out->entries;
-    out->stream = stream;
-    out->next_id.id = -1;
-    return (anjay_output_ctx_t *) out;
+    return out;
 }
 
 #define TEST_ENV_COMMON(Size) \
@@ -314,6 +310,139 @@ AVS_UNIT_TEST(tlv_out_array, array_index) {
     AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
 }
 
+AVS_UNIT_TEST(tlv_out, object_with_array) {
+    TEST_ENV(512);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    anjay_output_ctx_t *obj = _anjay_output_object_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(obj, ANJAY_ID_RID, 2));
+    anjay_output_ctx_t *array = anjay_ret_array_start(obj);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 0));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(array, 5));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_string(array, "abcdefgh"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_finish(array));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_object_finish(obj));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 2));
+    obj = _anjay_output_object_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(obj, ANJAY_ID_RID, 3));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bool(obj, true));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_object_finish(obj));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+
+    VERIFY_BYTES(
+            "\x08\x01\x11" // Object Instance 1
+            "\x88\x02\x0E" // Resource 2 - array
+            "\x41\x00\x05" // [0] -> 5
+            "\x48\x01\x08" "abcdefgh" // [1] -> "abcdefgh"
+            "\x03\x02" // Object Instance 2
+            "\xC1\x03\x01" // Resource 3 - true
+            );
+}
+
+AVS_UNIT_TEST(tlv_out, unfinished_object_discarded) {
+    TEST_ENV(512);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    anjay_output_ctx_t *obj = _anjay_output_object_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(obj, ANJAY_ID_RID, 2));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(obj, 42));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+
+    AVS_UNIT_ASSERT_EQUAL(avs_stream_outbuf_offset(&outbuf), 0);
+}
+
+static void write_instance_contents(anjay_output_ctx_t *ctx) {
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(ctx, ANJAY_ID_RID, 2));
+    anjay_output_ctx_t *array = anjay_ret_array_start(ctx);
+    AVS_UNIT_ASSERT_NOT_NULL(array);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 0));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_i32(array, 5));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_index(array, 1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_string(array, "abcdefgh"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_array_finish(array));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(ctx, ANJAY_ID_RID, 3));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bool(ctx, true));
+}
+
+AVS_UNIT_TEST(tlv_out, size_ctx) {
+    int errno_value = 0;
+    anjay_output_ctx_t *size_ctx =
+            _anjay_output_tlv_size_ctx_create(&errno_value);
+    AVS_UNIT_ASSERT_NOT_NULL(size_ctx);
+    write_instance_contents(size_ctx);
+    AVS_UNIT_ASSERT_EQUAL(_anjay_output_tlv_size(size_ctx), 20);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&size_ctx));
+}
+
+AVS_UNIT_TEST(tlv_out, object_start_sized) {
+    TEST_ENV(512);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    anjay_output_ctx_t *obj = _anjay_output_object_start_sized(out, 20);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    write_instance_contents(obj);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_object_finish(obj));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+
+    VERIFY_BYTES(
+            "\x08\x01\x14" // Object Instance 1
+            "\x88\x02\x0E" // Resource 2 - array
+            "\x41\x00\x05" // [0] -> 5
+            "\x48\x01\x08" "abcdefgh" // [1] -> "abcdefgh"
+            "\xC1\x03\x01" // Resource 3 - true
+            );
+}
+
+AVS_UNIT_TEST(tlv_out, object_start_sized_length_mismatch) {
+    TEST_ENV(512);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    anjay_output_ctx_t *obj = _anjay_output_object_start_sized(out, 21);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    write_instance_contents(obj);
+    AVS_UNIT_ASSERT_FAILED(_anjay_output_object_finish(obj));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+}
+
+AVS_UNIT_TEST(tlv_out, object_start_sized_overflow) {
+    TEST_ENV(512);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    anjay_output_ctx_t *obj = _anjay_output_object_start_sized(out, 6);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(obj, ANJAY_ID_RID, 3));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bool(obj, true));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(obj, ANJAY_ID_RID, 4));
+    AVS_UNIT_ASSERT_FAILED(anjay_ret_string(obj, "abcdefgh"));
+    AVS_UNIT_ASSERT_FAILED(_anjay_output_object_finish(obj));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+
+    // nothing past the declared length reached the stream
+    VERIFY_BYTES(
+            "\x08\x01\x06" // Object Instance 1
+            "\xC1\x03\x01" // Resource 3 - true
+            "\xC8\x04\x08" // Resource 4 - header only
+            );
+}
+
+AVS_UNIT_TEST(tlv_out, object_start_sized_nested) {
+    TEST_ENV(512);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(out, ANJAY_ID_IID, 1));
+    anjay_output_ctx_t *obj = _anjay_output_object_start(out);
+    AVS_UNIT_ASSERT_NOT_NULL(obj);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_set_id(obj, ANJAY_ID_RID, 2));
+    AVS_UNIT_ASSERT_NULL(_anjay_output_object_start_sized(obj, 3));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_output_ctx_destroy(&out));
+}
+
 AVS_UNIT_TEST(tlv_out, object_with_empty_bytes) {
     TEST_ENV(512);
 
@@ -16,21 +16,19 @@
 
 #include <config.h>
 
-#include <ctype.h>
-#include <errno.h>
 #include <inttypes.h>
-#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include <avsystem/commons/base64.h>
 #include <avsystem/commons/stream.h>
 
 #include <anjay/core.h>
 
 #include "../coap/content_format.h"
 #include "../utils_core.h"
+#include "base64.h"
 #include "base64_out.h"
+#include "numbers.h"
 #include "vtable.h"
 
 VISIBILITY_SOURCE_BEGIN
@@ -59,72 +57,46 @@ static anjay_ret_bytes_ctx_t *text_ret_bytes_begin(anjay_output_ctx_t *ctx_,
     return ctx->bytes;
 }
 
-static int text_ret_string(anjay_output_ctx_t *ctx_, const char *value) {
-    text_out_t *ctx = (text_out_t *) ctx_;
+static int text_ret_chars(text_out_t *ctx, const char *str, size_t length) {
     if (ctx->bytes) {
         return -1;
     }
-
     int retval = -1;
     if (!ctx->finished
-            && !(retval = avs_stream_write(ctx->stream, value, strlen(value)))) {
+            && !(retval = avs_stream_write(ctx->stream, str, length))) {
         ctx->finished = true;
     }
     return retval;
 }
 
-static int text_ret_i32(anjay_output_ctx_t *ctx_, int32_t value) {
-    text_out_t *ctx = (text_out_t *) ctx_;
-    if (ctx->bytes) {
-        return -1;
-    }
-
-    int retval = -1;
-    if (!ctx->finished
-            && !(retval = avs_stream_write_f(ctx->stream, "%" PRId32, value))) {
-        ctx->finished = true;
-    }
-    return retval;
+static int text_ret_string(anjay_output_ctx_t *ctx, const char *value) {
+    return text_ret_chars((text_out_t *) ctx, value, strlen(value));
 }
 
-static int text_ret_i64(anjay_output_ctx_t *ctx_, int64_t value) {
-    text_out_t *ctx = (text_out_t *) ctx_;
-    if (ctx->bytes) {
-        return -1;
-    }
-
-    int retval = -1;
-    if (!ctx->finished
-            && !(retval = avs_stream_write_f(ctx->stream, "%" PRId64, value))) {
-        ctx->finished = true;
-    }
-    return retval;
+static int text_ret_i64(anjay_output_ctx_t *ctx, int64_t value) {
+    char buf[_ANJAY_I64_STRING_SIZE];
+    return text_ret_chars((text_out_t *) ctx, buf,
+                          _anjay_i64_to_string(buf, value));
 }
 
-static inline int text_ret_floating_point(text_out_t *ctx, double value,
-                                          int precision) {
-    if (ctx->bytes) {
-        return -1;
-    }
-    int retval = -1;
-    // FIXME: The spec calls for a "decimal" representation, which, in my
-    // understanding, excludes exponential representation.
-    // As printing floating-point numbers in C as pure decimal with sane
-    // precision is tricky, let's take the spec a bit loosely for now.
-    if (!ctx->finished
-            && !(retval = avs_stream_write_f(ctx->stream, "%.*g",
-                                             precision, value))) {
-        ctx->finished = true;
-    }
-    return retval;
+static int text_ret_i32(anjay_output_ctx_t *ctx, int32_t value) {
+    return text_ret_i64(ctx, value);
 }
 
+// FIXME: The spec calls for a "decimal" representation, which, in my
+// understanding, excludes exponential representation.
+// As printing floating-point numbers in C as pure decimal with sane
+// precision is tricky, let's take the spec a bit loosely for now.
 static int text_ret_float(anjay_output_ctx_t *ctx, float value) {
-    return text_ret_floating_point((text_out_t *) ctx, value, 9);
+    char buf[_ANJAY_DOUBLE_STRING_SIZE];
+    return text_ret_chars((text_out_t *) ctx, buf,
+                          _anjay_float_to_string(buf, value));
 }
 
 static int text_ret_double(anjay_output_ctx_t *ctx, double value) {
-    return text_ret_floating_point((text_out_t *) ctx, value, 17);
+    char buf[_ANJAY_DOUBLE_STRING_SIZE];
+    return text_ret_chars((text_out_t *) ctx, buf,
+                          _anjay_double_to_string(buf, value));
 }
 
 static int text_ret_bool(anjay_output_ctx_t *ctx, bool value) {
@@ -206,10 +178,7 @@ typedef struct {
 static int has_valid_padding(const char *buffer,
                              size_t size,
                              bool msg_finished) {
-    const char *last = buffer + size;
-    /* Note: buffer is size+1 in length. Last byte is a NULL terminator though. */
-    assert(!*last);
-    return last - 1 >= buffer && *(last - 1) == '=' && !msg_finished ? -1 : 0;
+    return size > 0 && buffer[size - 1] == '=' && !msg_finished ? -1 : 0;
 }
 
 static void text_get_some_bytes_cache_flush(text_in_t *ctx,
@@ -236,18 +205,20 @@ static int text_get_some_bytes(anjay_input_ctx_t *ctx_,
     *out_bytes_read = 0;
 
     text_get_some_bytes_cache_flush(ctx, &current, &buf_size);
-    // 4bytes + null terminator
-    char encoded[5];
+    char encoded[4 * 64];
     size_t stream_bytes_read;
     char stream_msg_finished = 0;
 
     while (buf_size > 0) {
-        if (avs_stream_read(ctx->stream, &stream_bytes_read, &stream_msg_finished,
-                            encoded, sizeof(encoded) - 1)) {
-            return -1;
+        // decode as many quadruplets as fit straight into the output buffer;
+        // if not even a single one does, decode it into the cache instead
+        size_t quadruplets = AVS_MIN(buf_size / 3, sizeof(encoded) / 4);
+        bool use_cache = (quadruplets == 0);
+        if (use_cache) {
+            quadruplets = 1;
         }
-        encoded[stream_bytes_read] = '\0';
-        if (stream_bytes_read % 4) {
+        if (avs_stream_read(ctx->stream, &stream_bytes_read,
+                            &stream_msg_finished, encoded, 4 * quadruplets)) {
             return -1;
         }
         if (has_valid_padding(encoded, stream_bytes_read,
@@ -255,14 +226,18 @@ static int text_get_some_bytes(anjay_input_ctx_t *ctx_,
             return -1;
         }
         assert(ctx->num_bytes_cached == 0);
-        ssize_t num_decoded =
-                avs_base64_decode_strict((uint8_t *) ctx->bytes_cached,
-                                         sizeof(ctx->bytes_cached), encoded);
-        if (num_decoded < 0) {
-            return (int) num_decoded;
+        size_t num_decoded;
+        if (_anjay_base64_decode(use_cache ? ctx->bytes_cached : current,
+                                 &num_decoded, encoded, stream_bytes_read)) {
+            return -1;
+        }
+        if (use_cache) {
+            ctx->num_bytes_cached = num_decoded;
+            text_get_some_bytes_cache_flush(ctx, &current, &buf_size);
+        } else {
+            current += num_decoded;
+            buf_size -= num_decoded;
         }
-        ctx->num_bytes_cached = (size_t) num_decoded;
-        text_get_some_bytes_cache_flush(ctx, &current, &buf_size);
         if (stream_msg_finished) {
             break;
         }
@@ -296,85 +271,66 @@ static int text_get_string(anjay_input_ctx_t *ctx,
     return message_finished ? 0 : ANJAY_BUFFER_TOO_SHORT;
 }
 
-#define DEF_GETNUM(Type, Bufsize, ...) \
-static int safe_strto##Type (const char *in, TYPE##Type *value) { \
-    char *endptr = NULL; \
-    if (!*in || isspace((unsigned char)*in)) { \
-        return -1; \
-    } \
-    errno = 0; \
-    TYPE##Type tmp = strto##Type (in, &endptr __VA_ARGS__); \
-    if (errno || !endptr || *endptr) { \
-        return -1; \
-    } \
-    *value = tmp; \
-    return 0; \
-} \
-\
-static int text_get_##Type (anjay_input_ctx_t *ctx, TYPE##Type *value) { \
-    char buf[Bufsize]; \
-    int retval = anjay_get_string(ctx, buf, sizeof(buf)); \
-    if (retval) { \
-        return retval; \
-    } \
-    return safe_strto##Type (buf, value); \
+static int text_get_i64(anjay_input_ctx_t *ctx, int64_t *value) {
+    char buf[32];
+    int retval = anjay_get_string(ctx, buf, sizeof(buf));
+    if (retval) {
+        return retval;
+    }
+    return _anjay_string_to_i64(buf, strlen(buf), value);
 }
 
-#if LLONG_MAX == INT64_MAX
-#define TYPEll int64_t
-#else
-#define TYPEll long long
-#endif
+static int text_get_i32(anjay_input_ctx_t *ctx, int32_t *value) {
+    int64_t i64_value;
+    int retval = text_get_i64(ctx, &i64_value);
+    if (retval) {
+        return retval;
+    }
+    if (i64_value < INT32_MIN || i64_value > INT32_MAX) {
+        return -1;
+    }
+    *value = (int32_t) i64_value;
+    return 0;
+}
 
-#define TYPEf float
-#define TYPEd double
+static int text_get_float(anjay_input_ctx_t *ctx, float *value) {
+    char buf[ANJAY_MAX_FLOAT_STRING_SIZE];
+    int retval = anjay_get_string(ctx, buf, sizeof(buf));
+    if (retval) {
+        return retval;
+    }
+    return _anjay_string_to_float(buf, strlen(buf), value);
+}
 
-DEF_GETNUM(ll, 32,, 0)
-DEF_GETNUM(f, ANJAY_MAX_FLOAT_STRING_SIZE, )
-DEF_GETNUM(d, ANJAY_MAX_DOUBLE_STRING_SIZE, )
+static int text_get_double(anjay_input_ctx_t *ctx, double *value) {
+    char buf[ANJAY_MAX_DOUBLE_STRING_SIZE];
+    int retval = anjay_get_string(ctx, buf, sizeof(buf));
+    if (retval) {
+        return retval;
+    }
+    return _anjay_string_to_double(buf, strlen(buf), value);
+}
 
 int _anjay_safe_strtoll(const char *in, long long *value) {
-    TYPEll out;
-    if (safe_strtoll(in, &out)) {
+    int64_t out;
+    if (_anjay_string_to_i64(in, strlen(in), &out)) {
         return -1;
     }
-    *value = (long long)out;
+    *value = (long long) out;
     return 0;
 }
 
 int _anjay_safe_strtod(const char *in, double *value) {
-    return safe_strtod(in, value);
-}
-
-#define DEF_GETI(Bits) \
-static int text_get_i##Bits (anjay_input_ctx_t *ctx, int##Bits##_t *value) { \
-    TYPEll ll_value; \
-    int retval = text_get_ll(ctx, &ll_value); \
-    if (retval) { \
-        return retval; \
-    } \
-    if (ll_value < INT##Bits##_MIN || ll_value > INT##Bits##_MAX) { \
-        return -1; \
-    } \
-    *value = (int##Bits##_t) ll_value; \
-    return 0; \
+    return _anjay_string_to_double(in, strlen(in), value);
 }
 
-#if LLONG_MAX == INT64_MAX
-#define text_get_i64 text_get_ll
-#else
-DEF_GETI(64)
-#endif
-
-DEF_GETI(32)
-
 static int text_get_bool(anjay_input_ctx_t *ctx, bool *value) {
-    TYPEll ll_value;
-    int retval = text_get_ll(ctx, &ll_value);
+    int64_t i64_value;
+    int retval = text_get_i64(ctx, &i64_value);
     if (retval) {
         return retval;
     }
-    switch (ll_value) {
+    switch (i64_value) {
     case 0:
         *value = false;
         return 0;
@@ -393,23 +349,20 @@ static int text_get_objlnk(anjay_input_ctx_t *ctx,
     if (retval) {
         return retval;
     }
-    char *colon = strchr(buf, ':');
+    const char *colon = strchr(buf, ':');
     if (!colon) {
         return -1;
     }
-    *colon = '\0';
-    TYPEll oid, iid;
-    if (!(retval = (safe_strtoll(buf, &oid)
-            || safe_strtoll(colon + 1, &iid)) ? -1 : 0)) {
-        if (oid >= 0 && oid <= UINT16_MAX
-                && iid >= 0 && iid <= UINT16_MAX) {
-            *out_oid = (anjay_oid_t) oid;
-            *out_iid = (anjay_iid_t) iid;
-        } else {
-            retval = -1;
-        }
+    int64_t oid, iid;
+    if (_anjay_string_to_i64(buf, (size_t) (colon - buf), &oid)
+            || _anjay_string_to_i64(colon + 1, strlen(colon + 1), &iid)
+            || oid < 0 || oid > UINT16_MAX
+            || iid < 0 || iid > UINT16_MAX) {
+        return -1;
     }
-    return retval;
+    *out_oid = (anjay_oid_t) oid;
+    *out_iid = (anjay_iid_t) iid;
+    return 0;
 }
 
 static int text_in_close(anjay_input_ctx_t *ctx_) {
@@ -425,8 +378,8 @@ static const anjay_input_ctx_vtable_t TEXT_IN_VTABLE = {
     .string = text_get_string,
     .i32 = text_get_i32,
     .i64 = text_get_i64,
-    .f32 = text_get_f,
-    .f64 = text_get_d,
+    .f32 = text_get_float,
+    .f64 = text_get_double,
     .boolean = text_get_bool,
     .objlnk = text_get_objlnk,
     .close = text_in_close
@@ -16,6 +16,8 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include <avsystem/commons/stream_v_table.h>
 #include <avsystem/commons/utils.h>
 
@@ -117,57 +119,51 @@ static int tlv_get_string(anjay_input_ctx_t *ctx,
     return retval;
 }
 
-#define DEF_GETI(Bits) \
-static int tlv_get_i##Bits (anjay_input_ctx_t *ctx, int##Bits##_t *value) { \
-    uint8_t bytes[Bits / 8]; \
-    size_t bytes_read = 0; \
-    if (tlv_read_whole_entry(ctx, &bytes_read, bytes, sizeof(bytes)) \
-            || !avs_is_power_of_2(bytes_read)) { \
+#define DEF_DECODE_I(Bits) \
+static int decode_i##Bits (int##Bits##_t *value, \
+                           const uint8_t *bytes, size_t size) { \
+    if (size > Bits / 8 || !avs_is_power_of_2(size)) { \
         return -1; \
     } \
-    *value = (bytes_read > 0 && ((int8_t) bytes[0]) < 0) ? -1 : 0; \
-    for (size_t i = 0; i < bytes_read; ++i) { \
+    *value = (size > 0 && ((int8_t) bytes[0]) < 0) ? -1 : 0; \
+    for (size_t i = 0; i < size; ++i) { \
         *(uint##Bits##_t *) value <<= 8; \
         *value += bytes[i]; \
     } \
     return 0; \
 }
 
-DEF_GETI(32)
-DEF_GETI(64)
+DEF_DECODE_I(32)
+DEF_DECODE_I(64)
 
-#define DEF_GETF(Type) \
-static int tlv_get_##Type (anjay_input_ctx_t *ctx, Type *value) { \
-    union { \
-        uint32_t f32; \
-        uint64_t f64; \
-    } data; \
-    size_t bytes_read = 0; \
-    if (tlv_read_whole_entry(ctx, &bytes_read, &data, 8)) { \
-        return -1; \
-    } \
-    switch (bytes_read) { \
-    case 4: \
-        *value = (Type) _anjay_ntohf(data.f32); \
+#define DEF_DECODE_F(Type) \
+static int decode_##Type (Type *value, const uint8_t *bytes, size_t size) { \
+    switch (size) { \
+    case 4: { \
+        uint32_t data; \
+        memcpy(&data, bytes, sizeof(data)); \
+        *value = (Type) _anjay_ntohf(data); \
         return 0; \
-    case 8: \
-        *value = (Type) _anjay_ntohd(data.f64); \
+    } \
+    case 8: { \
+        uint64_t data; \
+        memcpy(&data, bytes, sizeof(data)); \
+        *value = (Type) _anjay_ntohd(data); \
         return 0; \
+    } \
     default: \
         return -1; \
     } \
 }
 
-DEF_GETF(float)
-DEF_GETF(double)
+DEF_DECODE_F(float)
+DEF_DECODE_F(double)
 
-static int tlv_get_bool(anjay_input_ctx_t *ctx, bool *value) {
-    char raw;
-    size_t bytes_read = 0;
-    if (tlv_read_whole_entry(ctx, &bytes_read, &raw, 1) || bytes_read != 1) {
+static int decode_bool(bool *value, const uint8_t *bytes, size_t size) {
+    if (size != 1) {
         return -1;
     }
-    switch (raw) {
+    switch (bytes[0]) {
     case 0:
         *value = false;
         return 0;
@@ -179,19 +175,42 @@ static int tlv_get_bool(anjay_input_ctx_t *ctx, bool *value) {
     }
 }
 
+static int decode_objlnk(anjay_oid_t *out_oid, anjay_iid_t *out_iid,
+                         const uint8_t *bytes, size_t size) {
+    if (size > 4) {
+        return -1;
+    } else if (size != 4) {
+        return ANJAY_ERR_BAD_REQUEST;
+    }
+    *out_oid = (anjay_oid_t) ((bytes[0] << 8) | bytes[1]);
+    *out_iid = (anjay_iid_t) ((bytes[2] << 8) | bytes[3]);
+    return 0;
+}
+
+#define DEF_GET(Name, Type, MaxSize) \
+static int tlv_get_##Name (anjay_input_ctx_t *ctx, Type *value) { \
+    uint8_t bytes[MaxSize]; \
+    size_t bytes_read = 0; \
+    if (tlv_read_whole_entry(ctx, &bytes_read, bytes, sizeof(bytes))) { \
+        return -1; \
+    } \
+    return decode_##Name(value, bytes, bytes_read); \
+}
+
+DEF_GET(i32, int32_t, 4)
+DEF_GET(i64, int64_t, 8)
+DEF_GET(float, float, 8)
+DEF_GET(double, double, 8)
+DEF_GET(bool, bool, 1)
+
 static int tlv_get_objlnk(anjay_input_ctx_t *ctx,
                           anjay_oid_t *out_oid, anjay_iid_t *out_iid) {
-    AVS_STATIC_ASSERT(sizeof(uint16_t[2]) == 4, uint16_t_array_size);
-    uint16_t raw[2];
+    uint8_t bytes[4];
     size_t bytes_read = 0;
-    if (tlv_read_whole_entry(ctx, &bytes_read, raw, 4)) {
+    if (tlv_read_whole_entry(ctx, &bytes_read, bytes, sizeof(bytes))) {
         return -1;
-    } else if (bytes_read != 4) {
-        return ANJAY_ERR_BAD_REQUEST;
     }
-    *out_oid = avs_convert_be16(raw[0]);
-    *out_iid = avs_convert_be16(raw[1]);
-    return 0;
+    return decode_objlnk(out_oid, out_iid, bytes, bytes_read);
 }
 
 #define DEF_READ_SHORTENED(Type) \
@@ -324,7 +343,8 @@ static const anjay_input_ctx_vtable_t TLV_IN_VTABLE = {
     tlv_in_attach_child,
     tlv_get_id,
     tlv_next_entry,
-    tlv_in_close
+    tlv_in_close,
+    NULL
 };
 
 static int tlv_safe_read(avs_stream_abstract_t *stream_,
@@ -369,6 +389,208 @@ int _anjay_input_tlv_create(anjay_input_ctx_t **out,
     return 0;
 }
 
+/////////////////////////////////////////////////////////// IN-PLACE PARSING
+
+typedef struct {
+    const anjay_input_ctx_vtable_t *vtable;
+    anjay_input_ctx_t *child;
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+    anjay_id_type_t id_type;
+    int32_t id;
+    const uint8_t *value;
+    size_t length;
+    size_t bytes_read;
+} tlv_buf_in_t;
+
+static int tlv_buf_get_id(anjay_input_ctx_t *ctx_,
+                          anjay_id_type_t *out_type, uint16_t *out_id) {
+    tlv_buf_in_t *ctx = (tlv_buf_in_t *) ctx_;
+    if (ctx->id < 0) {
+        if (ctx->offset >= ctx->size) {
+            return ANJAY_GET_INDEX_END;
+        }
+        const uint8_t *ptr = ctx->data + ctx->offset;
+        const uint8_t *end = ctx->data + ctx->size;
+        uint8_t typefield = *ptr++;
+        size_t id_length = (typefield & 0x20) ? 2 : 1;
+        size_t length_length = ((typefield >> 3) & 3);
+        if ((size_t) (end - ptr) < id_length + length_length) {
+            return ANJAY_ERR_BAD_REQUEST;
+        }
+        uint16_t id = 0;
+        for (size_t i = 0; i < id_length; ++i) {
+            id = (uint16_t) ((id << 8) + *ptr++);
+        }
+        size_t length = (typefield & 7);
+        if (length_length) {
+            length = 0;
+            for (size_t i = 0; i < length_length; ++i) {
+                length = (length << 8) + *ptr++;
+            }
+        }
+        if ((size_t) (end - ptr) < length) {
+            return ANJAY_ERR_BAD_REQUEST;
+        }
+        ctx->id_type = convert_id_type(typefield);
+        ctx->id = id;
+        ctx->value = ptr;
+        ctx->length = length;
+        ctx->bytes_read = 0;
+        ctx->offset = (size_t) (ptr + length - ctx->data);
+    }
+    if (out_type) {
+        *out_type = ctx->id_type;
+    }
+    if (out_id) {
+        *out_id = (uint16_t) ctx->id;
+    }
+    return 0;
+}
+
+static int tlv_buf_get_some_bytes(anjay_input_ctx_t *ctx_,
+                                  size_t *out_bytes_read,
+                                  bool *out_message_finished,
+                                  void *out_buf,
+                                  size_t buf_size) {
+    tlv_buf_in_t *ctx = (tlv_buf_in_t *) ctx_;
+    int retval = tlv_buf_get_id(ctx_, NULL, NULL);
+    if (retval) {
+        return retval;
+    }
+    *out_bytes_read = AVS_MIN(buf_size, ctx->length - ctx->bytes_read);
+    memcpy(out_buf, ctx->value + ctx->bytes_read, *out_bytes_read);
+    ctx->bytes_read += *out_bytes_read;
+    *out_message_finished = (ctx->bytes_read == ctx->length);
+    return 0;
+}
+
+static int tlv_buf_get_string(anjay_input_ctx_t *ctx,
+                              char *out_buf,
+                              size_t buf_size) {
+    if (!buf_size) {
+        return -1;
+    }
+    size_t bytes_read;
+    bool message_finished;
+    int retval = tlv_buf_get_some_bytes(ctx, &bytes_read, &message_finished,
+                                        out_buf, buf_size - 1);
+    if (retval) {
+        return retval;
+    }
+    out_buf[bytes_read] = '\0';
+    return message_finished ? 0 : ANJAY_BUFFER_TOO_SHORT;
+}
+
+/**
+ * Returns a view of the whole value of the current entry, straight from the
+ * underlying buffer. Fails if any part of the value has already been read.
+ */
+static int tlv_buf_whole_value(tlv_buf_in_t *ctx,
+                               const uint8_t **out_value,
+                               size_t *out_length) {
+    if ((ctx->id >= 0 && ctx->bytes_read)
+            || tlv_buf_get_id((anjay_input_ctx_t *) ctx, NULL, NULL)) {
+        return -1;
+    }
+    *out_value = ctx->value;
+    *out_length = ctx->length;
+    ctx->bytes_read = ctx->length;
+    return 0;
+}
+
+#define DEF_BUF_GET(Name, Type) \
+static int tlv_buf_get_##Name (anjay_input_ctx_t *ctx, Type *value) { \
+    const uint8_t *bytes; \
+    size_t length; \
+    if (tlv_buf_whole_value((tlv_buf_in_t *) ctx, &bytes, &length)) { \
+        return -1; \
+    } \
+    return decode_##Name(value, bytes, length); \
+}
+
+DEF_BUF_GET(i32, int32_t)
+DEF_BUF_GET(i64, int64_t)
+DEF_BUF_GET(float, float)
+DEF_BUF_GET(double, double)
+DEF_BUF_GET(bool, bool)
+
+static int tlv_buf_get_objlnk(anjay_input_ctx_t *ctx,
+                              anjay_oid_t *out_oid, anjay_iid_t *out_iid) {
+    const uint8_t *bytes;
+    size_t length;
+    if (tlv_buf_whole_value((tlv_buf_in_t *) ctx, &bytes, &length)) {
+        return -1;
+    }
+    return decode_objlnk(out_oid, out_iid, bytes, length);
+}
+
+static int tlv_buf_attach_child(anjay_input_ctx_t *ctx_,
+                                anjay_input_ctx_t *child) {
+    tlv_buf_in_t *ctx = (tlv_buf_in_t *) ctx_;
+    int retval = _anjay_input_ctx_destroy(&ctx->child);
+    if (retval) {
+        return retval;
+    }
+    ctx->child = child;
+    return 0;
+}
+
+static int tlv_buf_next_entry(anjay_input_ctx_t *ctx_) {
+    tlv_buf_in_t *ctx = (tlv_buf_in_t *) ctx_;
+    ctx->id = -1;
+    return 0;
+}
+
+static int tlv_buf_nested_ctx(anjay_input_ctx_t *ctx,
+                              anjay_input_ctx_t **out_nested) {
+    const uint8_t *value;
+    size_t length;
+    if (tlv_buf_whole_value((tlv_buf_in_t *) ctx, &value, &length)) {
+        return -1;
+    }
+    return _anjay_input_tlv_buffer_create(out_nested, value, length);
+}
+
+static int tlv_buf_in_close(anjay_input_ctx_t *ctx_) {
+    tlv_buf_in_t *ctx = (tlv_buf_in_t *) ctx_;
+    _anjay_input_ctx_destroy(&ctx->child);
+    return 0;
+}
+
+static const anjay_input_ctx_vtable_t TLV_BUF_IN_VTABLE = {
+    tlv_buf_get_some_bytes,
+    tlv_buf_get_string,
+    tlv_buf_get_i32,
+    tlv_buf_get_i64,
+    tlv_buf_get_float,
+    tlv_buf_get_double,
+    tlv_buf_get_bool,
+    tlv_buf_get_objlnk,
+    tlv_buf_attach_child,
+    tlv_buf_get_id,
+    tlv_buf_next_entry,
+    tlv_buf_in_close,
+    tlv_buf_nested_ctx
+};
+
+int _anjay_input_tlv_buffer_create(anjay_input_ctx_t **out,
+                                   const void *data,
+                                   size_t size) {
+    tlv_buf_in_t *ctx = (tlv_buf_in_t *) calloc(1, sizeof(tlv_buf_in_t));
+    *out = (anjay_input_ctx_t *) ctx;
+    if (!ctx) {
+        return -1;
+    }
+
+    ctx->vtable = &TLV_BUF_IN_VTABLE;
+    ctx->data = (const uint8_t *) data;
+    ctx->size = size;
+    ctx->id = -1;
+    return 0;
+}
+
 #ifdef ANJAY_TEST
 #include "test/tlv_in.c"
 #endif
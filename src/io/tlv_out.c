@@ -19,7 +19,6 @@
 #include <assert.h>
 #include <string.h>
 
-#include <avsystem/commons/list.h>
 #include <avsystem/commons/stream.h>
 #include <avsystem/commons/utils.h>
 
@@ -35,21 +34,33 @@ typedef struct {
     int32_t id;
 } tlv_id_t;
 
+/* Type field, 16-bit identifier and 24-bit length */
+#define TLV_MAX_HEADER_SIZE 6
+
+/**
+ * Growable buffer shared by all nested contexts of a single TLV output
+ * context. Each nested level (Object Instance or Multiple Resource) occupies a
+ * contiguous region at the end of the arena: a header placeholder of
+ * TLV_MAX_HEADER_SIZE bytes, followed by its already encoded children. When
+ * the level is finished, the actual header is back-patched in place and the
+ * payload is moved to close the gap.
+ */
 typedef struct {
-    size_t data_length;
-    tlv_id_t id;
-    char data[];
-} tlv_entry_t;
+    char *data;
+    size_t size;
+    size_t capacity;
+} tlv_arena_t;
 
 typedef struct {
     const anjay_ret_bytes_ctx_vtable_t *vtable;
-    char *out_ptr;
+    tlv_arena_t *arena;
+    size_t offset;
     size_t bytes_left;
 } tlv_buffered_bytes_t;
 
 typedef struct {
     const anjay_ret_bytes_ctx_vtable_t *vtable;
-    avs_stream_abstract_t *stream;
+    struct tlv_out_struct *owner;
     size_t bytes_left;
 } tlv_streamed_bytes_t;
 
@@ -68,9 +79,17 @@ typedef struct tlv_out_struct {
     int *errno_ptr;
     struct tlv_out_struct *parent;
     anjay_output_ctx_t *slave;
-    AVS_LIST(tlv_entry_t) entries;
-    AVS_LIST(tlv_entry_t) *next_entry_ptr;
+    /* true if entries are written through tlv_write() instead of the arena;
+     * that is the case for root contexts and levels of known length */
+    bool direct;
+    /* may be NULL for direct contexts that only measure the encoded size */
     avs_stream_abstract_t *stream;
+    size_t bytes_written;
+    size_t declared_length;
+    tlv_arena_t *arena;
+    tlv_arena_t root_arena;
+    size_t header_offset;
+    bool finished;
     tlv_id_t next_id;
     tlv_bytes_t bytes_ctx;
 } tlv_out_t;
@@ -95,39 +114,62 @@ static inline uint8_t typefield_length(uint32_t length) {
     }
 }
 
-static int write_shortened_u32(avs_stream_abstract_t *stream, uint32_t value) {
+static size_t encode_shortened_u32(uint8_t *out, uint32_t value) {
     uint8_t length = u32_length(value);
     assert(length <= 4);
-    union {
-        uint32_t uval;
-        char tab[4];
-    } value32;
-    value32.uval = avs_convert_be32(value);
-    return avs_stream_write(stream, value32.tab + (4 - length), length);
-}
-
-static size_t header_size(uint16_t id, size_t length) {
-    assert(length == (uint32_t) length);
-    return 1 + (size_t) u32_length(id) +
-            ((length > 7) ? (size_t) u32_length((uint32_t) length) : 0);
+    for (uint8_t i = length; i > 0; --i) {
+        out[i - 1] = (uint8_t) value;
+        value >>= 8;
+    }
+    return length;
 }
 
-static int write_header(avs_stream_abstract_t *stream,
-                        const tlv_id_t *id,
-                        size_t length) {
+static int encode_header(uint8_t *out,
+                         const tlv_id_t *id,
+                         size_t length,
+                         size_t *out_header_size) {
     if (id->id != (uint16_t) id->id || length >> 24) {
         return -1;
     }
-    uint8_t typefield = (uint8_t) (
+    out[0] = (uint8_t) (
             ((id->type & 3) << 6) |
             ((id->id > UINT8_MAX) ? 0x20 : 0) |
             typefield_length((uint32_t) length));
-    int retval = avs_stream_write(stream, &typefield, 1);
+    size_t header_size = 1;
+    header_size += encode_shortened_u32(&out[header_size], (uint16_t) id->id);
+    if (length > 7) {
+        header_size += encode_shortened_u32(&out[header_size],
+                                            (uint32_t) length);
+    }
+    assert(header_size <= TLV_MAX_HEADER_SIZE);
+    *out_header_size = header_size;
+    return 0;
+}
+
+static int tlv_write(tlv_out_t *ctx, const void *data, size_t length) {
+    assert(ctx->direct);
+    // levels of known length (i.e. non-root ones) may not exceed it
+    if (ctx->parent && length > ctx->declared_length - ctx->bytes_written) {
+        anjay_log(ERROR, "declared TLV entry length %lu exceeded",
+                  (unsigned long) ctx->declared_length);
+        return -1;
+    }
+    int retval = 0;
+    if (ctx->stream) {
+        retval = avs_stream_write(ctx->stream, data, length);
+    }
     if (!retval) {
-        retval = write_shortened_u32(stream, (uint16_t) id->id);
+        ctx->bytes_written += length;
     }
-    if (!retval && length > 7) {
-        retval = write_shortened_u32(stream, (uint32_t) length);
+    return retval;
+}
+
+static int write_header(tlv_out_t *ctx, const tlv_id_t *id, size_t length) {
+    uint8_t header[TLV_MAX_HEADER_SIZE];
+    size_t header_size;
+    int retval = encode_header(header, id, length, &header_size);
+    if (!retval) {
+        retval = tlv_write(ctx, header, header_size);
     }
     return retval;
 }
@@ -139,29 +181,20 @@ static inline int ensure_valid_for_value(tlv_out_t *ctx) {
             || ctx->next_id.id < 0) ? -1 : 0;
 }
 
-static int write_entry(avs_stream_abstract_t *stream,
-                       const tlv_id_t *id,
-                       const void *buf,
-                       size_t length) {
-    int retval = write_header(stream, id, length);
-    if (!retval) {
-        retval = avs_stream_write(stream, buf, length);
-    }
-    return retval;
-}
-
-static char *add_buffered_entry(tlv_out_t *ctx, size_t length) {
-    tlv_entry_t *new_entry = (tlv_entry_t *)
-            AVS_LIST_NEW_BUFFER(sizeof(tlv_entry_t) + length);
-    if (!new_entry) {
-        return NULL;
+static char *arena_alloc(tlv_arena_t *arena, size_t length) {
+    if (arena->capacity - arena->size < length) {
+        size_t new_capacity = AVS_MAX(2 * arena->capacity,
+                                      arena->size + length);
+        char *new_data = (char *) realloc(arena->data, new_capacity);
+        if (!new_data) {
+            return NULL;
+        }
+        arena->data = new_data;
+        arena->capacity = new_capacity;
     }
-    new_entry->data_length = length;
-    new_entry->id = ctx->next_id;
-    ctx->next_id.id = -1;
-    *ctx->next_entry_ptr = new_entry;
-    ctx->next_entry_ptr = AVS_LIST_NEXT_PTR(ctx->next_entry_ptr);
-    return new_entry->data;
+    char *result = arena->data + arena->size;
+    arena->size += length;
+    return result;
 }
 
 static int streamed_bytes_append(anjay_ret_bytes_ctx_t *ctx_,
@@ -173,7 +206,7 @@ static int streamed_bytes_append(anjay_ret_bytes_ctx_t *ctx_,
         if (length > ctx->bytes_left) {
             retval = -1;
         } else {
-            retval = avs_stream_write(ctx->stream, data, length);
+            retval = tlv_write(ctx->owner, data, length);
         }
     }
     if (!retval && !(ctx->bytes_left -= length)) {
@@ -195,8 +228,9 @@ static int buffered_bytes_append(anjay_ret_bytes_ctx_t *ctx_,
         if (length > ctx->bytes_left) {
             retval = -1;
         } else {
-            memcpy(ctx->out_ptr, data, length);
-            ctx->out_ptr += length;
+            assert(ctx->offset + ctx->bytes_left <= ctx->arena->size);
+            memcpy(ctx->arena->data + ctx->offset, data, length);
+            ctx->offset += length;
         }
     }
     if (!retval && !(ctx->bytes_left -= length)) {
@@ -213,19 +247,27 @@ static anjay_ret_bytes_ctx_t *add_entry(tlv_out_t *ctx, size_t length) {
     if (length >> 24 || ctx->bytes_ctx.null.vtable) {
         return NULL;
     }
-    if (ctx->stream) {
-        int retval = write_header(ctx->stream, &ctx->next_id, length);
+    if (ctx->direct) {
+        int retval = write_header(ctx, &ctx->next_id, length);
         ctx->next_id.id = -1;
         if (!retval) {
             ctx->bytes_ctx.streamed.vtable = &STREAMED_BYTES_VTABLE;
-            ctx->bytes_ctx.streamed.stream = ctx->stream;
+            ctx->bytes_ctx.streamed.owner = ctx;
             ctx->bytes_ctx.streamed.bytes_left = length;
             return (anjay_ret_bytes_ctx_t *) &ctx->bytes_ctx.streamed;
         }
     } else if (ctx->parent) {
-        if ((ctx->bytes_ctx.buffered.out_ptr =
-                add_buffered_entry(ctx, length))) {
+        uint8_t header[TLV_MAX_HEADER_SIZE];
+        size_t header_size;
+        char *entry = NULL;
+        int retval = encode_header(header, &ctx->next_id, length, &header_size);
+        ctx->next_id.id = -1;
+        if (!retval
+                && (entry = arena_alloc(ctx->arena, header_size + length))) {
+            memcpy(entry, header, header_size);
             ctx->bytes_ctx.buffered.vtable = &BUFFERED_BYTES_VTABLE;
+            ctx->bytes_ctx.buffered.arena = ctx->arena;
+            ctx->bytes_ctx.buffered.offset = ctx->arena->size - length;
             ctx->bytes_ctx.buffered.bytes_left = length;
             return (anjay_ret_bytes_ctx_t *) &ctx->bytes_ctx.buffered;
         }
@@ -293,37 +335,53 @@ static anjay_output_ctx_t *tlv_slave_start(tlv_out_t *ctx,
                                            tlv_id_type_t new_type,
                                            tlv_id_type_t inner_type);
 
+static anjay_output_ctx_t *tlv_ret_object_start_sized(anjay_output_ctx_t *ctx,
+                                                      size_t length);
+
+static int tlv_sized_slave_finish(tlv_out_t *ctx,
+                                  tlv_id_type_t next_id_type) {
+    int retval = 0;
+    if (ctx->bytes_written != ctx->declared_length) {
+        anjay_log(ERROR, "declared TLV entry length %lu, but %lu bytes written",
+                  (unsigned long) ctx->declared_length,
+                  (unsigned long) ctx->bytes_written);
+        retval = -1;
+    }
+    ctx->finished = true;
+    ctx->parent->next_id.id = -1;
+    ctx->parent->next_id.type = next_id_type;
+    _anjay_output_ctx_destroy((anjay_output_ctx_t **) &ctx);
+    return retval;
+}
+
 static int tlv_slave_finish(tlv_out_t *ctx, tlv_id_type_t next_id_type) {
     if (!ctx->parent) {
         return -1;
     }
-    size_t data_size = 0;
-    {
-        tlv_entry_t *entry = NULL;
-        AVS_LIST_FOREACH(entry, ctx->entries) {
-            data_size += header_size((uint16_t) entry->id.id,
-                                     entry->data_length) +
-                    entry->data_length;
-        }
-    }
-    char *buffer = (char *) (data_size ? malloc(data_size) : NULL);
-    int retval = ((!data_size || buffer) ? 0 : -1);
-    avs_stream_outbuf_t outbuf = AVS_STREAM_OUTBUF_STATIC_INITIALIZER;
-    avs_stream_outbuf_set_buffer(&outbuf, buffer, data_size);
-    AVS_LIST_CLEAR(&ctx->entries) {
-        if (!retval) {
-            retval = write_entry((avs_stream_abstract_t *) &outbuf,
-                                 &ctx->entries->id,
-                                 ctx->entries->data,
-                                 ctx->entries->data_length);
-        }
+    if (ctx->direct) {
+        return tlv_sized_slave_finish(ctx, next_id_type);
     }
+    tlv_arena_t *arena = ctx->arena;
+    size_t payload_offset = ctx->header_offset + TLV_MAX_HEADER_SIZE;
+    assert(arena->size >= payload_offset);
+    size_t length = arena->size - payload_offset;
+
+    uint8_t header[TLV_MAX_HEADER_SIZE];
+    size_t header_size;
+    int retval = encode_header(header, &ctx->parent->next_id, length,
+                               &header_size);
+    ctx->parent->next_id.id = -1;
     if (!retval) {
-        size_t length = avs_stream_outbuf_offset(&outbuf);
-        anjay_ret_bytes_ctx_t *bytes = add_entry(ctx->parent, length);
-        retval = !bytes ? -1 : anjay_ret_bytes_append(bytes, buffer, length);
+        char *entry = arena->data + ctx->header_offset;
+        memcpy(entry, header, header_size);
+        memmove(entry + header_size, arena->data + payload_offset, length);
+        arena->size = ctx->header_offset + header_size + length;
+        if (ctx->parent->direct) {
+            retval = tlv_write(ctx->parent, entry, header_size + length);
+            arena->size = ctx->header_offset;
+        }
+        ctx->finished = true;
     }
-    free(buffer);
     ctx->parent->next_id.type = next_id_type;
     _anjay_output_ctx_destroy((anjay_output_ctx_t **) &ctx);
     return retval;
@@ -382,11 +440,16 @@ static int tlv_set_id(anjay_output_ctx_t *ctx_,
 
 static int tlv_output_close(anjay_output_ctx_t *ctx_) {
     tlv_out_t *ctx = (tlv_out_t *) ctx_;
-    AVS_LIST_CLEAR(&ctx->entries);
     int retval = _anjay_output_ctx_destroy(&ctx->slave);
     if (ctx->parent) {
+        if (!ctx->finished) {
+            /* discard everything encoded within the unfinished level */
+            ctx->arena->size = ctx->header_offset;
+        }
         ctx->parent->next_id.id = -1;
         ctx->parent->slave = NULL;
+    } else {
+        free(ctx->root_arena.data);
     }
     return retval;
 }
@@ -406,13 +469,13 @@ static const anjay_output_ctx_vtable_t TLV_OUT_VTABLE = {
     tlv_ret_object_start,
     tlv_ret_object_finish,
     tlv_set_id,
-    tlv_output_close
+    tlv_output_close,
+    tlv_ret_object_start_sized
 };
 
-static anjay_output_ctx_t *tlv_slave_start(tlv_out_t *ctx,
-                                           tlv_id_type_t expected_type,
-                                           tlv_id_type_t new_type,
-                                           tlv_id_type_t inner_type) {
+static tlv_out_t *tlv_slave_new(tlv_out_t *ctx,
+                                tlv_id_type_t expected_type,
+                                tlv_id_type_t inner_type) {
     tlv_out_t *object = NULL;
     if (ctx->slave
             || ctx->next_id.type != expected_type
@@ -423,13 +486,49 @@ static anjay_output_ctx_t *tlv_slave_start(tlv_out_t *ctx,
     object->vtable = &TLV_OUT_VTABLE;
     object->errno_ptr = ctx->errno_ptr;
     object->parent = ctx;
-    object->next_entry_ptr = &object->entries;
+    object->arena = ctx->arena;
+    object->header_offset = ctx->arena->size;
     object->next_id.type = inner_type;
     object->next_id.id = -1;
+    return object;
+}
+
+static anjay_output_ctx_t *tlv_slave_start(tlv_out_t *ctx,
+                                           tlv_id_type_t expected_type,
+                                           tlv_id_type_t new_type,
+                                           tlv_id_type_t inner_type) {
+    tlv_out_t *object = tlv_slave_new(ctx, expected_type, inner_type);
+    if (!object) {
+        return NULL;
+    }
+    if (!arena_alloc(ctx->arena, TLV_MAX_HEADER_SIZE)) {
+        free(object);
+        return NULL;
+    }
     ctx->next_id.type = new_type;
     return (ctx->slave = (anjay_output_ctx_t *) object);
 }
 
+static anjay_output_ctx_t *tlv_ret_object_start_sized(anjay_output_ctx_t *ctx_,
+                                                      size_t length) {
+    tlv_out_t *ctx = (tlv_out_t *) ctx_;
+    if (!ctx->direct) {
+        return NULL;
+    }
+    tlv_out_t *object = tlv_slave_new(ctx, TLV_ID_IID, TLV_ID_RID);
+    if (!object) {
+        return NULL;
+    }
+    if (write_header(ctx, &ctx->next_id, length)) {
+        free(object);
+        return NULL;
+    }
+    object->direct = true;
+    object->stream = ctx->stream;
+    object->declared_length = length;
+    return (ctx->slave = (anjay_output_ctx_t *) object);
+}
+
 anjay_output_ctx_t *
 _anjay_output_raw_tlv_create(avs_stream_abstract_t *stream) {
     tlv_out_t *ctx = (tlv_out_t *) calloc(1, sizeof(tlv_out_t));
@@ -437,13 +536,27 @@ _anjay_output_raw_tlv_create(avs_stream_abstract_t *stream) {
     if (ctx) {
         ctx->vtable = &TLV_OUT_VTABLE;
         ctx->errno_ptr = NULL;
-        ctx->next_entry_ptr = &ctx->entries;
+        ctx->direct = true;
         ctx->stream = stream;
+        ctx->arena = &ctx->root_arena;
         ctx->next_id.id = -1;
     }
     return (anjay_output_ctx_t *) ctx;
 }
 
+anjay_output_ctx_t *_anjay_output_tlv_size_ctx_create(int *errno_ptr) {
+    tlv_out_t *ctx = (tlv_out_t *) _anjay_output_raw_tlv_create(NULL);
+    if (ctx) {
+        ctx->errno_ptr = errno_ptr;
+    }
+    return (anjay_output_ctx_t *) ctx;
+}
+
+size_t _anjay_output_tlv_size(anjay_output_ctx_t *ctx) {
+    assert(((tlv_out_t *) ctx)->vtable == &TLV_OUT_VTABLE);
+    return ((tlv_out_t *) ctx)->bytes_written;
+}
+
 anjay_output_ctx_t *
 _anjay_output_tlv_create(avs_stream_abstract_t *stream,
                          int *errno_ptr,
@@ -44,6 +44,8 @@ typedef int (*anjay_output_ctx_object_finish_t)(anjay_output_ctx_t *);
 typedef int (*anjay_output_ctx_set_id_t)(anjay_output_ctx_t *,
                                          anjay_id_type_t, uint16_t);
 typedef int (*anjay_output_ctx_close_t)(anjay_output_ctx_t *);
+typedef anjay_output_ctx_t *
+(*anjay_output_ctx_object_start_sized_t)(anjay_output_ctx_t *, size_t);
 
 typedef struct {
     anjay_output_ctx_errno_ptr_t errno_ptr;
@@ -61,6 +63,7 @@ typedef struct {
     anjay_output_ctx_object_finish_t object_finish;
     anjay_output_ctx_set_id_t set_id;
     anjay_output_ctx_close_t close;
+    anjay_output_ctx_object_start_sized_t object_start_sized;
 } anjay_output_ctx_vtable_t;
 
 typedef int (*anjay_ret_bytes_ctx_append_t)(anjay_ret_bytes_ctx_t *,
@@ -87,6 +90,8 @@ typedef int (*anjay_input_ctx_get_id_t)(anjay_input_ctx_t *,
                                         anjay_id_type_t *, uint16_t *);
 typedef int (*anjay_input_ctx_next_entry_t)(anjay_input_ctx_t *);
 typedef int (*anjay_input_ctx_close_t)(anjay_input_ctx_t *);
+typedef int (*anjay_input_ctx_nested_ctx_t)(anjay_input_ctx_t *,
+                                            anjay_input_ctx_t **);
 
 typedef struct {
     anjay_input_ctx_bytes_t some_bytes;
@@ -101,6 +106,7 @@ typedef struct {
     anjay_input_ctx_get_id_t get_id;
     anjay_input_ctx_next_entry_t next_entry;
     anjay_input_ctx_close_t close;
+    anjay_input_ctx_nested_ctx_t nested_ctx;
 } anjay_input_ctx_vtable_t;
 
 VISIBILITY_PRIVATE_HEADER_END
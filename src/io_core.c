@@ -158,6 +158,34 @@ int anjay_ret_bytes(anjay_output_ctx_t *ctx, const void *data, size_t length) {
     }
 }
 
+/* The chunk lives on the stack of a data model handler. Output contexts buffer
+ * the data on their own anyway, so bigger chunks would only save a few reader
+ * calls. */
+#define RET_BYTES_READER_CHUNK_SIZE 256
+
+int anjay_ret_bytes_from_reader(anjay_output_ctx_t *ctx,
+                                size_t length,
+                                anjay_ret_bytes_reader_t *reader,
+                                void *arg) {
+    assert(reader);
+    anjay_ret_bytes_ctx_t *bytes = anjay_ret_bytes_begin(ctx, length);
+    if (!bytes) {
+        return -1;
+    }
+    uint8_t chunk[RET_BYTES_READER_CHUNK_SIZE];
+    size_t offset = 0;
+    int result = 0;
+    while (!result && offset < length) {
+        size_t chunk_size = AVS_MIN(sizeof(chunk), length - offset);
+        if (!(result = reader(arg, offset, chunk, chunk_size))
+                && !(result = anjay_ret_bytes_append(bytes, chunk,
+                                                     chunk_size))) {
+            offset += chunk_size;
+        }
+    }
+    return result;
+}
+
 int anjay_ret_string(anjay_output_ctx_t *ctx, const char *value) {
     if (!ctx->vtable->string) {
         set_errno_not_implemented(ctx);
@@ -227,6 +255,10 @@ int anjay_ret_array_index(anjay_output_ctx_t *array_ctx, anjay_riid_t index) {
     return _anjay_output_set_id(array_ctx, ANJAY_ID_RIID, index);
 }
 
+int anjay_ret_resource_id(anjay_output_ctx_t *ctx, anjay_rid_t rid) {
+    return _anjay_output_set_id(ctx, ANJAY_ID_RID, rid);
+}
+
 int anjay_ret_array_finish(anjay_output_ctx_t *array_ctx) {
     if (!array_ctx->vtable->array_finish) {
         set_errno_not_implemented(array_ctx);
@@ -243,6 +275,17 @@ anjay_output_ctx_t * _anjay_output_object_start(anjay_output_ctx_t *ctx) {
     return ctx->vtable->object_start(ctx);
 }
 
+anjay_output_ctx_t *
+_anjay_output_object_start_sized(anjay_output_ctx_t *ctx, size_t length) {
+    if (!ctx->vtable->object_start_sized) {
+        // sized entries are specific to TLV, so any other format is
+        // a mismatch rather than a missing feature
+        set_out_errno(ctx, ANJAY_OUTCTXERR_FORMAT_MISMATCH);
+        return NULL;
+    }
+    return ctx->vtable->object_start_sized(ctx, length);
+}
+
 int _anjay_output_object_finish(anjay_output_ctx_t *ctx) {
     if (!ctx->vtable->object_finish) {
         set_errno_not_implemented(ctx);
@@ -428,9 +471,15 @@ int _anjay_input_attach_child(anjay_input_ctx_t *ctx,
 
 anjay_input_ctx_t *_anjay_input_nested_ctx(anjay_input_ctx_t *ctx) {
     anjay_input_ctx_t *retval = NULL;
-    avs_stream_abstract_t *stream = _anjay_input_bytes_stream(ctx);
-    if (stream && _anjay_input_tlv_create(&retval, &stream, true)) {
-        avs_stream_cleanup(&stream);
+    if (ctx->vtable->nested_ctx) {
+        if (ctx->vtable->nested_ctx(ctx, &retval)) {
+            _anjay_input_ctx_destroy(&retval);
+        }
+    } else {
+        avs_stream_abstract_t *stream = _anjay_input_bytes_stream(ctx);
+        if (stream && _anjay_input_tlv_create(&retval, &stream, true)) {
+            avs_stream_cleanup(&stream);
+        }
     }
     if (retval && _anjay_input_attach_child(ctx, retval)) {
         _anjay_input_ctx_destroy(&retval);
@@ -42,6 +42,15 @@ anjay_input_ctx_constructor_t _anjay_input_dynamic_create;
 anjay_input_ctx_constructor_t _anjay_input_opaque_create;
 anjay_input_ctx_constructor_t _anjay_input_text_create;
 
+/**
+ * Creates a TLV input context that parses the TLV data in place, directly from
+ * the specified buffer, without copying it. The buffer needs to remain valid
+ * for the whole lifetime of the context.
+ */
+int _anjay_input_tlv_buffer_create(anjay_input_ctx_t **out,
+                                   const void *data,
+                                   size_t size);
+
 #ifdef WITH_LEGACY_CONTENT_FORMAT_SUPPORT
 uint16_t _anjay_translate_legacy_content_format(uint16_t format);
 #else
@@ -81,16 +90,60 @@ _anjay_output_tlv_create(avs_stream_abstract_t *stream,
                          int *errno_ptr,
                          anjay_msg_details_t *inout_details);
 
+/**
+ * Creates a TLV output context that does not write any data, but only
+ * calculates the size of the TLV encoding of everything returned into it.
+ * The size can be retrieved using @ref _anjay_output_tlv_size before the
+ * context is destroyed.
+ */
+anjay_output_ctx_t *_anjay_output_tlv_size_ctx_create(int *errno_ptr);
+
+size_t _anjay_output_tlv_size(anjay_output_ctx_t *ctx);
+
 #ifdef WITH_JSON
 anjay_output_ctx_t *
 _anjay_output_json_create(avs_stream_abstract_t *stream,
                           int *errno_ptr,
                           anjay_msg_details_t *inout_details,
                           const anjay_uri_path_t *uri);
+
+/**
+ * Creates an input context parsing LwM2M JSON data. All entries in the payload
+ * are required to lie within @p uri, which shall be the request URI.
+ */
+int _anjay_input_json_create(anjay_input_ctx_t **out,
+                             avs_stream_abstract_t **stream_ptr,
+                             bool autoclose,
+                             const anjay_uri_path_t *uri);
+#endif
+
+#ifdef WITH_SENML_CBOR
+anjay_output_ctx_t *
+_anjay_output_senml_cbor_create(avs_stream_abstract_t *stream,
+                                int *errno_ptr,
+                                anjay_msg_details_t *inout_details,
+                                const anjay_uri_path_t *uri);
+
+/**
+ * Creates an input context parsing SenML CBOR data. All records in the payload
+ * are required to lie within @p uri, which shall be the request URI.
+ */
+int _anjay_input_senml_cbor_create(anjay_input_ctx_t **out,
+                                   avs_stream_abstract_t **stream_ptr,
+                                   bool autoclose,
+                                   const anjay_uri_path_t *uri);
 #endif
 
 int *_anjay_output_ctx_errno_ptr(anjay_output_ctx_t *ctx);
 anjay_output_ctx_t * _anjay_output_object_start(anjay_output_ctx_t *ctx);
+/**
+ * Works like @ref _anjay_output_object_start, but with the encoded size of
+ * Object Instance contents known in advance, which allows the contents to be
+ * written directly to the underlying stream instead of being buffered. Only
+ * supported by the TLV output context.
+ */
+anjay_output_ctx_t *
+_anjay_output_object_start_sized(anjay_output_ctx_t *ctx, size_t length);
 int _anjay_output_object_finish(anjay_output_ctx_t *ctx);
 int _anjay_output_set_id(anjay_output_ctx_t *ctx,
                          anjay_id_type_t type, uint16_t id);
@@ -112,6 +165,77 @@ typedef struct anjay_output_buf_ctx {
 
 anjay_output_buf_ctx_t _anjay_output_buf_ctx_init(avs_stream_outbuf_t *stream);
 
+typedef enum {
+    ANJAY_OUTPUT_VALUE_BYTES,
+    ANJAY_OUTPUT_VALUE_STRING,
+    ANJAY_OUTPUT_VALUE_INT,
+    ANJAY_OUTPUT_VALUE_DOUBLE,
+    ANJAY_OUTPUT_VALUE_BOOL,
+    ANJAY_OUTPUT_VALUE_OBJLNK
+} anjay_output_value_type_t;
+
+/**
+ * A single value captured from an anjay_ret_* call.
+ */
+typedef struct {
+    anjay_output_value_type_t type;
+    /* true if the value is an element of a Multiple Resource; the Resource
+     * Instance ID is then stored in @ref anjay_output_value_t#riid */
+    bool is_array_element;
+    anjay_riid_t riid;
+    union {
+        /* used for both BYTES and STRING types; string data is always
+         * null-terminated, and <c>size</c> does not include the terminator */
+        struct {
+            const void *data;
+            size_t size;
+        } bytes;
+        int64_t i;
+        double f;
+        bool b;
+        struct {
+            anjay_oid_t oid;
+            anjay_iid_t iid;
+        } objlnk;
+    } value;
+} anjay_output_value_t;
+
+/**
+ * Called by the value output context for each returned value. Pointers inside
+ * @p value are only valid for the duration of the call. Non-zero return value
+ * is propagated as the result of the anjay_ret_* call.
+ */
+typedef int anjay_output_value_handler_t(void *arg,
+                                         const anjay_output_value_t *value);
+
+/**
+ * Output context that captures anjay_ret_* calls as typed values, without any
+ * serialization or heap allocation. Opaque data returned using
+ * anjay_ret_bytes_begin() is gathered in a caller-provided buffer; values
+ * that do not fit in it cause an error.
+ */
+typedef struct anjay_output_value_ctx {
+    const void *vtable;
+    const void *ret_bytes_vtable;
+    anjay_output_value_handler_t *handler;
+    void *handler_arg;
+    char *bytes_buffer;
+    size_t bytes_buffer_size;
+    size_t bytes_expected;
+    size_t bytes_written;
+    bool in_array;
+    bool has_riid;
+    anjay_riid_t riid;
+    bool value_returned;
+    int error;
+} anjay_output_value_ctx_t;
+
+anjay_output_value_ctx_t
+_anjay_output_value_ctx_init(anjay_output_value_handler_t *handler,
+                             void *handler_arg,
+                             char *bytes_buffer,
+                             size_t bytes_buffer_size);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif /* ANJAY_IO_CORE_H */
@@ -47,6 +47,10 @@ struct anjay_observe_entry_struct {
     // (depending on whether the last unsent value in the server refers
     // to this resource+format or not)
     AVS_LIST(anjay_observe_resource_value_t) last_unsent;
+
+    // pre-encoded header of notifications, reused as long as their code and
+    // Content-Format do not change
+    coap_notify_template_t notify_template;
 };
 
 struct anjay_observe_connection_entry_struct {
@@ -700,6 +704,29 @@ static void value_sent(anjay_observe_connection_entry_t *conn_state) {
 static int sched_flush_send_queue(anjay_t *anjay,
                                   anjay_observe_connection_entry_t *conn);
 
+static int
+setup_notification_from_template(avs_stream_abstract_t *stream,
+                                 anjay_observe_entry_t *entry,
+                                 const anjay_msg_details_t *details,
+                                 const avs_coap_token_t *token,
+                                 const anjay_observe_resource_value_t *value) {
+    if (!details->observe_serial || details->location_path
+            || details->uri_path || details->uri_query) {
+        return -1;
+    }
+    if (!_anjay_coap_notify_template_matches(&entry->notify_template, token,
+                                             details->msg_code,
+                                             details->format)
+            && _anjay_coap_notify_template_init(&entry->notify_template, token,
+                                                details->msg_code,
+                                                details->format)) {
+        return -1;
+    }
+    return _anjay_coap_stream_setup_notification(
+            stream, &entry->notify_template, details->msg_type, token,
+            value->value, value->value_length);
+}
+
 static int send_entry(anjay_t *anjay,
                       anjay_observe_connection_entry_t *conn_state) {
     int result;
@@ -723,11 +750,17 @@ static int send_entry(anjay_t *anjay,
         details.msg_type = AVS_COAP_MSG_CONFIRMABLE;
     }
 
-    (void) ((result = _anjay_coap_stream_setup_request(
-                    anjay->comm_stream, &details, &id->token))
-            || (result = avs_stream_write(anjay->comm_stream,
-                                          conn_state->unsent->value,
-                                          conn_state->unsent->value_length))
+    if (setup_notification_from_template(anjay->comm_stream, entry,
+                                         &details, &id->token,
+                                         conn_state->unsent)) {
+        // e.g. notification needs a block-wise transfer
+        (void) ((result = _anjay_coap_stream_setup_request(
+                        anjay->comm_stream, &details, &id->token))
+                || (result = avs_stream_write(
+                        anjay->comm_stream, conn_state->unsent->value,
+                        conn_state->unsent->value_length)));
+    }
+    (void) (result
             || (result = _anjay_coap_stream_get_request_identity(
                     anjay->comm_stream, &notify_id))
             || (result = avs_stream_finish_message(anjay->comm_stream)));
@@ -76,6 +76,29 @@ typedef struct {
     char last_local_port[ANJAY_MAX_URL_PORT_SIZE];
 } anjay_server_connection_private_data_t;
 
+#ifdef WITH_RTT_ESTIMATION
+/**
+ * State of the round-trip time estimator kept for a single server connection,
+ * as described in draft-ietf-core-cocoa. All values are in microseconds.
+ *
+ * The "strong" estimator is fed with exchanges that finished without any
+ * retransmissions, the "weak" one - with exchanges that needed one or two of
+ * them, in which case the RTT is measured since the first transmission.
+ */
+typedef struct {
+    int64_t strong_rtt_us;
+    int64_t strong_rttvar_us;
+    uint64_t strong_samples;
+
+    int64_t weak_rtt_us;
+    int64_t weak_rttvar_us;
+    uint64_t weak_samples;
+
+    /** Current retransmission timeout, or 0 if there were no samples yet. */
+    int64_t rto_us;
+} anjay_rtt_estimator_t;
+#endif // WITH_RTT_ESTIMATION
+
 typedef struct {
     anjay_server_connection_private_data_t conn_priv_data_;
 #if defined(__GNUC__) \
@@ -87,8 +110,14 @@ typedef struct {
 
     bool queue_mode;
     anjay_sched_handle_t queue_mode_close_socket_clb_handle;
+
+#ifdef WITH_RTT_ESTIMATION
+    anjay_rtt_estimator_t rtt;
+#endif
 } anjay_server_connection_t;
 
+typedef struct anjay_async_request_struct anjay_async_request_t;
+
 typedef struct {
     anjay_ssid_t ssid; // or ANJAY_SSID_BOOTSTRAP
     anjay_url_t uri;
@@ -98,6 +127,20 @@ typedef struct {
 
     anjay_registration_info_t registration_info;
     anjay_sched_handle_t sched_update_handle;
+
+    /**
+     * Request (Register, Update, De-Register or Request Bootstrap) sent to
+     * the server that did not get its response yet, or NULL if there is none.
+     * See @ref _anjay_server_send_async_request .
+     */
+    anjay_async_request_t *pending_request;
+
+    /**
+     * Delay before the next retry of Register or Update, should the current
+     * one fail; zero if there were no failures since the last successful
+     * one. See @ref _anjay_server_next_retry_delay .
+     */
+    avs_time_duration_t registration_retry_delay;
 } anjay_active_server_info_t;
 
 // inactive servers include administratively disabled ones
@@ -106,12 +149,21 @@ typedef struct {
     anjay_ssid_t ssid;
     anjay_sched_handle_t sched_reactivate_handle;
     bool reactivate_failed;
+    // carried over from anjay_active_server_info_t on deactivation
+    avs_time_duration_t registration_retry_delay;
 } anjay_inactive_server_info_t;
 
 typedef struct {
     AVS_LIST(anjay_active_server_info_t) active;
     AVS_LIST(anjay_inactive_server_info_t) inactive;
 
+    /**
+     * Servers removed from @ref active whose De-Register exchange is still
+     * pending. Each of them is deleted once the exchange is finished, either
+     * by receiving a response or by giving up on retransmissions.
+     */
+    AVS_LIST(anjay_active_server_info_t) deregistering;
+
     AVS_LIST(avs_net_abstract_socket_t *const) public_sockets;
 } anjay_servers_t;
 
@@ -127,19 +179,22 @@ typedef struct {
 
 static inline anjay_servers_t
 _anjay_servers_create(void) {
-    return (anjay_servers_t){ NULL, NULL, NULL };
+    return (anjay_servers_t){ NULL, NULL, NULL, NULL };
 }
 
 void _anjay_servers_inactive_cleanup(anjay_t *anjay);
 
 /**
  * Clears up the <c>anjay->servers</c> struct, sending De-Register messages for
- * each active server and releasing any allocated resources.
+ * each active server and releasing any allocated resources. De-Register
+ * exchanges are performed synchronously, as there is no event loop left to
+ * drive them; the ones still pending for already removed servers are canceled.
  */
 void _anjay_servers_cleanup(anjay_t *anjay);
 
 /**
- * Returns an active server object associated with given @p socket .
+ * Returns an active or de-registering server object associated with given
+ * @p socket .
  */
 anjay_active_server_info_t *
 _anjay_servers_find_by_udp_socket(anjay_servers_t *servers,
@@ -191,6 +246,113 @@ int _anjay_connection_bring_online(anjay_server_connection_t *connection,
 
 void _anjay_connection_suspend(anjay_connection_ref_t conn_ref);
 
+/**
+ * Returns transmission parameters to use for Confirmable messages sent over
+ * the connection referenced by @p ref . These are the ones configured for the
+ * whole Anjay object, with ACK_TIMEOUT replaced by the estimated retransmission
+ * timeout if RTT estimation is enabled and any samples have been taken.
+ */
+avs_coap_tx_params_t _anjay_connection_tx_params(anjay_t *anjay,
+                                                 anjay_connection_ref_t ref);
+
+#ifdef WITH_RTT_ESTIMATION
+
+/**
+ * Feeds the RTT estimator of @p connection with a round-trip time of
+ * a Confirmable exchange, measured since its first transmission.
+ *
+ * @param retransmissions Number of retransmissions performed before the
+ *                        exchange got acknowledged. Samples with more than two
+ *                        retransmissions are ambiguous and thus ignored.
+ */
+void _anjay_connection_rtt_sample(anjay_t *anjay,
+                                  anjay_server_connection_t *connection,
+                                  avs_time_duration_t rtt,
+                                  unsigned retransmissions);
+
+/**
+ * Replaces ACK_TIMEOUT in @p inout_tx_params with the retransmission timeout
+ * estimated for @p connection , if any samples have been taken.
+ */
+void _anjay_connection_rtt_apply(const anjay_server_connection_t *connection,
+                                 avs_coap_tx_params_t *inout_tx_params);
+
+void _anjay_connection_rtt_reset(anjay_server_connection_t *connection);
+
+#else // WITH_RTT_ESTIMATION
+
+#define _anjay_connection_rtt_sample(Anjay, Connection, Rtt, Retransmissions) \
+        ((void) 0)
+#define _anjay_connection_rtt_apply(Connection, InoutTxParams) \
+        ((void) (Connection), (void) (InoutTxParams))
+#define _anjay_connection_rtt_reset(Connection) ((void) 0)
+
+#endif // WITH_RTT_ESTIMATION
+
+/**
+ * Handler called when an exchange started with
+ * @ref _anjay_server_send_async_request finishes.
+ *
+ * It is always called from a scheduler job, with no server stream bound, so
+ * it is free to start another exchange with the same or other server.
+ *
+ * @param anjay    Anjay object.
+ * @param server   Server the request was sent to.
+ * @param response Response received from the server, or NULL if there is none.
+ * @param result   0 if @p response is set; otherwise a negative value, e.g.
+ *                 AVS_COAP_CTX_ERR_TIMEOUT if the server did not respond, or
+ *                 AVS_COAP_CTX_ERR_NETWORK in case of a network error.
+ * @param arg      Argument passed to @ref _anjay_server_send_async_request .
+ */
+typedef void anjay_async_response_handler_t(anjay_t *anjay,
+                                            anjay_active_server_info_t *server,
+                                            const avs_coap_msg_t *response,
+                                            int result,
+                                            void *arg);
+
+typedef void anjay_async_request_arg_free_t(void *arg);
+
+/**
+ * Sends the request prepared on the server stream (bound to the current
+ * connection) without waiting for the response. Retransmissions are performed
+ * by scheduler jobs, and the response is dispatched from @ref anjay_serve ;
+ * @p on_response is called when the exchange is finished.
+ *
+ * Any request still pending for the same server is canceled.
+ *
+ * If the request payload did not fit in a single message, and a block-wise
+ * transfer has been started, the transfer is finished synchronously;
+ * @p on_response is still called from a scheduler job.
+ *
+ * @p arg is owned by the request since this call, whether it succeeds or not.
+ * It is released with @p free_arg (if not NULL) after the exchange finishes
+ * or is canceled.
+ *
+ * @returns 0 if the request has been sent, a negative value otherwise (in which
+ *          case @p on_response is not called).
+ */
+int _anjay_server_send_async_request(anjay_t *anjay,
+                                     anjay_async_response_handler_t *on_response,
+                                     void *arg,
+                                     anjay_async_request_arg_free_t *free_arg);
+
+/**
+ * Passes a message received on the current connection, which is not a request,
+ * to the exchange pending for the current server.
+ *
+ * @returns 0 if the message has been consumed, a non-zero value if it does not
+ *          belong to the pending exchange.
+ */
+int _anjay_server_handle_async_response(anjay_t *anjay,
+                                        const avs_coap_msg_t *msg);
+
+/**
+ * Cancels the exchange pending for @p server , if any, without calling its
+ * response handler.
+ */
+void _anjay_server_cancel_async_request(anjay_t *anjay,
+                                        anjay_active_server_info_t *server);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif // ANJAY_SERVERS_H
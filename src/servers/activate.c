@@ -186,12 +186,52 @@ static int activate_server_job(anjay_t *anjay, void *ssid_) {
      */
     if (*inactive_server_ptr) {
         // might have been removed by start_bootstrap_if_not_already_started()
+        new_server->registration_retry_delay =
+                (*inactive_server_ptr)->registration_retry_delay;
         AVS_LIST_DELETE(inactive_server_ptr);
     }
     _anjay_servers_add_active(&anjay->servers, new_server);
     return 0;
 }
 
+avs_time_duration_t
+_anjay_server_next_retry_delay(avs_time_duration_t *inout_retry_delay) {
+    const anjay_sched_retryable_backoff_t backoff =
+            ANJAY_SERVER_RETRYABLE_BACKOFF;
+    avs_time_duration_t delay = *inout_retry_delay;
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO, delay)) {
+        delay = backoff.delay;
+    }
+    *inout_retry_delay = avs_time_duration_mul(delay, 2);
+    if (avs_time_duration_less(backoff.max_delay, *inout_retry_delay)) {
+        *inout_retry_delay = backoff.max_delay;
+    }
+    return delay;
+}
+
+void _anjay_server_on_registration_failure(anjay_t *anjay, anjay_ssid_t ssid) {
+    anjay_active_server_info_t *server =
+            _anjay_servers_find_active(&anjay->servers, ssid);
+    if (!server) {
+        anjay_log(TRACE, "not an active server: SSID = %u", ssid);
+        return;
+    }
+    avs_time_duration_t retry_delay = server->registration_retry_delay;
+    avs_time_duration_t reactivate_delay =
+            _anjay_server_next_retry_delay(&retry_delay);
+
+    anjay_inactive_server_info_t *inactive_server =
+            _anjay_server_deactivate(anjay, &anjay->servers, ssid,
+                                     reactivate_delay);
+    if (inactive_server) {
+        inactive_server->reactivate_failed = true;
+        inactive_server->registration_retry_delay = retry_delay;
+    }
+    if (should_retry_bootstrap(anjay)) {
+        _anjay_bootstrap_account_prepare(anjay);
+    }
+}
+
 static int sched_reactivate_server(anjay_t *anjay,
                                    anjay_inactive_server_info_t *server,
                                    avs_time_duration_t reactivate_delay) {
@@ -271,11 +311,7 @@ _anjay_server_deactivate(anjay_t *anjay,
         return NULL;
     }
 
-    // Return value intentionally ignored.
-    // There isn't much we can do in case it fails and De-Register is optional
-    // anyway. _anjay_serve_deregister logs the error cause.
-    _anjay_server_deregister(anjay, *active_server_ptr);
-    active_server_detach_delete(anjay, active_server_ptr);
+    _anjay_server_deregister_and_delete(anjay, servers, active_server_ptr);
 
     _anjay_servers_add_inactive(servers, new_server);
     return new_server;
@@ -311,3 +347,7 @@ void _anjay_servers_add_inactive(anjay_servers_t *servers,
 
     AVS_LIST_INSERT(insert_ptr, server);
 }
+
+#ifdef ANJAY_TEST
+#include "test/activate.c"
+#endif
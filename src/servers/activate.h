@@ -69,6 +69,15 @@ _anjay_server_deactivate(anjay_t *anjay,
                          anjay_ssid_t ssid,
                          avs_time_duration_t reactivate_delay);
 
+/**
+ * Handles a failed Register exchange with an active server identified by
+ * @p ssid : deactivates it, schedules a reactivation after a delay that grows
+ * exponentially with consecutive failures (see
+ * @ref _anjay_server_next_retry_delay ) and falls back to Bootstrap if no
+ * other server may be reachable.
+ */
+void _anjay_server_on_registration_failure(anjay_t *anjay, anjay_ssid_t ssid);
+
 /**
  * Creates a new detached inactive server entry for given @p ssid .
  *
@@ -0,0 +1,374 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <time.h>
+
+#include <avsystem/commons/coap/msg.h>
+#include <avsystem/commons/coap/msg_identity.h>
+#include <avsystem/commons/coap/tx_params.h>
+
+#include <anjay_modules/time_defs.h>
+
+#include "../anjay_core.h"
+#include "../coap/coap_stream.h"
+#include "../servers.h"
+
+#define ANJAY_SERVERS_INTERNALS
+
+#include "servers_internal.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+struct anjay_async_request_struct {
+    anjay_connection_type_t conn_type;
+    avs_coap_msg_identity_t identity;
+    avs_coap_msg_t *msg;
+
+    avs_coap_tx_params_t tx_params;
+    avs_coap_retry_state_t retry_state;
+    anjay_rand_seed_t rand_seed;
+    bool separate_ack_received;
+#ifdef WITH_RTT_ESTIMATION
+    avs_time_monotonic_t first_send_time;
+#endif // WITH_RTT_ESTIMATION
+
+    /*
+     * While waiting for the ACK: handle to the retransmission job.
+     * After receiving a Separate ACK: handle to a job aborting the exchange
+     * if no Separate Response was received.
+     * After the exchange is finished: handle to a job calling on_response.
+     */
+    anjay_sched_handle_t sched_job;
+
+    bool finished;
+    int result;
+    avs_coap_msg_t *response;
+
+    anjay_async_response_handler_t *on_response;
+    void *arg;
+    anjay_async_request_arg_free_t *free_arg;
+};
+
+static avs_coap_msg_t *copy_msg(const avs_coap_msg_t *msg) {
+    const size_t size = offsetof(avs_coap_msg_t, header) + msg->length;
+    avs_coap_msg_t *copy = (avs_coap_msg_t *) malloc(size);
+    if (copy) {
+        memcpy(copy, msg, size);
+    } else {
+        anjay_log(ERROR, "out of memory");
+    }
+    return copy;
+}
+
+static void request_delete(anjay_t *anjay, anjay_async_request_t **request) {
+    _anjay_sched_del(anjay->sched, &(*request)->sched_job);
+    if ((*request)->free_arg) {
+        (*request)->free_arg((*request)->arg);
+    }
+    free((*request)->msg);
+    free((*request)->response);
+    free(*request);
+    *request = NULL;
+}
+
+static anjay_server_connection_t *
+get_request_connection(anjay_active_server_info_t *server) {
+    return _anjay_get_server_connection((anjay_connection_ref_t) {
+        .server = server,
+        .conn_type = server->pending_request->conn_type
+    });
+}
+
+static avs_net_abstract_socket_t *
+get_request_socket(anjay_active_server_info_t *server) {
+    return _anjay_connection_get_online_socket(
+            get_request_connection(server));
+}
+
+static int async_request_job(anjay_t *anjay, void *request);
+
+/*
+ * The job is identified by the request itself rather than by SSID, as a server
+ * that is still waiting for a De-Register response may share the SSID with
+ * a newly activated one. The job never outlives the request, see
+ * request_delete().
+ */
+static int schedule_job(anjay_t *anjay,
+                        anjay_active_server_info_t *server,
+                        avs_time_duration_t delay) {
+    anjay_async_request_t *request = server->pending_request;
+    _anjay_sched_del(anjay->sched, &request->sched_job);
+    return _anjay_sched(anjay->sched, &request->sched_job, delay,
+                        async_request_job, request);
+}
+
+static int finish_request(anjay_t *anjay,
+                          anjay_active_server_info_t *server,
+                          int result,
+                          const avs_coap_msg_t *response) {
+    anjay_async_request_t *request = server->pending_request;
+    request->finished = true;
+    request->result = result;
+    if (response && !(request->response = copy_msg(response))) {
+        request->result = -1;
+    }
+    if (schedule_job(anjay, server, AVS_TIME_DURATION_ZERO)) {
+        anjay_log(ERROR, "could not schedule response handler for SSID %u",
+                  server->ssid);
+        request_delete(anjay, &server->pending_request);
+        return -1;
+    }
+    return 0;
+}
+
+static int send_request(anjay_t *anjay, anjay_active_server_info_t *server) {
+    anjay_async_request_t *request = server->pending_request;
+    assert(request->conn_type == ANJAY_CONNECTION_UDP);
+
+    avs_net_abstract_socket_t *socket = get_request_socket(server);
+    if (!socket) {
+        anjay_log(ERROR, "server connection is not online");
+        return AVS_COAP_CTX_ERR_NETWORK;
+    }
+
+    int result = avs_coap_ctx_send(anjay->coap_ctx, socket, request->msg);
+    if (result) {
+        anjay_log(DEBUG, "send failed: %d", result);
+        return result;
+    }
+
+#ifdef WITH_RTT_ESTIMATION
+    if (!request->retry_state.retry_count) {
+        request->first_send_time = avs_time_monotonic_now();
+    }
+#endif // WITH_RTT_ESTIMATION
+    avs_coap_update_retry_state(&request->retry_state, &request->tx_params,
+                                &request->rand_seed);
+    return schedule_job(anjay, server, request->retry_state.recv_timeout);
+}
+
+static anjay_active_server_info_t *
+find_request_server(AVS_LIST(anjay_active_server_info_t) servers,
+                    const anjay_async_request_t *request) {
+    AVS_LIST(anjay_active_server_info_t) server;
+    AVS_LIST_FOREACH(server, servers) {
+        if (server->pending_request == request) {
+            return server;
+        }
+    }
+    return NULL;
+}
+
+static int async_request_job(anjay_t *anjay, void *request_) {
+    anjay_async_request_t *request = (anjay_async_request_t *) request_;
+    anjay_active_server_info_t *server =
+            find_request_server(anjay->servers.active, request);
+    if (!server) {
+        server = find_request_server(anjay->servers.deregistering, request);
+    }
+    if (!server) {
+        anjay_log(TRACE, "request not pending for any server");
+        return 0;
+    }
+
+    const anjay_ssid_t ssid = server->ssid;
+    if (!request->finished) {
+        if (request->separate_ack_received) {
+            anjay_log(ERROR, "Separate Response not received from SSID %u",
+                      ssid);
+            request->result = AVS_COAP_CTX_ERR_TIMEOUT;
+        } else if (request->retry_state.retry_count
+                       > request->tx_params.max_retransmit) {
+            anjay_log(ERROR, "Limit of retransmissions reached for SSID %u",
+                      ssid);
+            request->result = AVS_COAP_CTX_ERR_TIMEOUT;
+        } else {
+            anjay_log(DEBUG, "retransmitting request to SSID %u, next timeout: "
+                      "%" PRId64 ".%09" PRId32 " s", ssid,
+                      request->retry_state.recv_timeout.seconds,
+                      request->retry_state.recv_timeout.nanoseconds);
+            if (!(request->result = send_request(anjay, server))) {
+                return 0;
+            }
+        }
+    }
+
+    // the handler may start another exchange, or even delete the server
+    server->pending_request = NULL;
+    request->on_response(anjay, server, request->response, request->result,
+                         request->arg);
+    request_delete(anjay, &request);
+    return 0;
+}
+
+static int finish_blockwise_request(anjay_t *anjay,
+                                    anjay_active_server_info_t *server) {
+    anjay_log(DEBUG, "request too big for a single message, finishing "
+              "block-wise transfer synchronously");
+    const avs_coap_msg_t *response = NULL;
+    int result = avs_stream_finish_message(anjay->comm_stream);
+    if (!result) {
+        result = _anjay_coap_stream_get_incoming_msg(anjay->comm_stream,
+                                                     &response);
+    }
+    return finish_request(anjay, server, result, result ? NULL : response);
+}
+
+int _anjay_server_send_async_request(anjay_t *anjay,
+                                     anjay_async_response_handler_t *on_response,
+                                     void *arg,
+                                     anjay_async_request_arg_free_t *free_arg) {
+    anjay_active_server_info_t *server = anjay->current_connection.server;
+    assert(server);
+
+    _anjay_server_cancel_async_request(anjay, server);
+
+    anjay_async_request_t *request =
+            (anjay_async_request_t *) calloc(1, sizeof(anjay_async_request_t));
+    if (!request) {
+        anjay_log(ERROR, "out of memory");
+        if (free_arg) {
+            free_arg(arg);
+        }
+        return -1;
+    }
+    request->conn_type = anjay->current_connection.conn_type;
+    request->tx_params =
+            _anjay_connection_tx_params(anjay, anjay->current_connection);
+    request->rand_seed = (anjay_rand_seed_t) time(NULL);
+    request->on_response = on_response;
+    request->arg = arg;
+    request->free_arg = free_arg;
+    server->pending_request = request;
+
+    const avs_coap_msg_t *msg;
+    int result = _anjay_coap_stream_get_request_identity(anjay->comm_stream,
+                                                         &request->identity);
+    if (!result) {
+        if (_anjay_coap_stream_build_request(anjay->comm_stream, &msg)) {
+            result = finish_blockwise_request(anjay, server);
+        } else if (!(request->msg = copy_msg(msg))) {
+            result = -1;
+        } else {
+            result = send_request(anjay, server);
+        }
+    }
+    if (result && server->pending_request) {
+        request_delete(anjay, &server->pending_request);
+    }
+    return result;
+}
+
+static bool is_response_code(uint8_t code) {
+    return code != AVS_COAP_CODE_EMPTY && !avs_coap_msg_code_is_request(code);
+}
+
+#ifdef WITH_RTT_ESTIMATION
+static void record_rtt_sample(anjay_t *anjay,
+                              anjay_active_server_info_t *server) {
+    anjay_async_request_t *request = server->pending_request;
+    _anjay_connection_rtt_sample(
+            anjay, get_request_connection(server),
+            avs_time_monotonic_diff(avs_time_monotonic_now(),
+                                    request->first_send_time),
+            request->retry_state.retry_count - 1);
+}
+#else // WITH_RTT_ESTIMATION
+#define record_rtt_sample(Anjay, Server) ((void) 0)
+#endif // WITH_RTT_ESTIMATION
+
+int _anjay_server_handle_async_response(anjay_t *anjay,
+                                        const avs_coap_msg_t *msg) {
+    anjay_active_server_info_t *server = anjay->current_connection.server;
+    if (!server || !server->pending_request
+            || server->pending_request->finished
+            || server->pending_request->conn_type
+                    != anjay->current_connection.conn_type) {
+        return -1;
+    }
+
+    anjay_async_request_t *request = server->pending_request;
+    const uint8_t code = avs_coap_msg_get_code(msg);
+    const bool id_matches =
+            (avs_coap_msg_get_id(msg) == request->identity.msg_id);
+
+    switch (avs_coap_msg_get_type(msg)) {
+    case AVS_COAP_MSG_RESET:
+        if (!id_matches) {
+            return -1;
+        }
+        anjay_log(DEBUG, "Reset response");
+        return finish_request(anjay, server, -1, NULL) ? -1 : 0;
+
+    case AVS_COAP_MSG_ACKNOWLEDGEMENT:
+        if (!id_matches) {
+            return -1;
+        }
+        if (code == AVS_COAP_CODE_EMPTY) {
+            if (!request->separate_ack_received) {
+                anjay_log(DEBUG, "Separate Response: ACK");
+                record_rtt_sample(anjay, server);
+                request->separate_ack_received = true;
+                if (schedule_job(anjay, server,
+                                 AVS_COAP_SEPARATE_RESPONSE_TIMEOUT)) {
+                    return finish_request(anjay, server, -1, NULL) ? -1 : 0;
+                }
+            }
+            return 0;
+        }
+        if (!avs_coap_msg_token_matches(msg, &request->identity)) {
+            anjay_log(DEBUG, "invalid response: token mismatch");
+            return -1;
+        }
+        if (!request->separate_ack_received) {
+            record_rtt_sample(anjay, server);
+        }
+        return finish_request(anjay, server, 0, msg) ? -1 : 0;
+
+    case AVS_COAP_MSG_CONFIRMABLE:
+    case AVS_COAP_MSG_NON_CONFIRMABLE:
+        if (!is_response_code(code)
+                || !avs_coap_msg_token_matches(msg, &request->identity)) {
+            return -1;
+        }
+        anjay_log(TRACE, "Separate Response received");
+        if (avs_coap_msg_get_type(msg) == AVS_COAP_MSG_CONFIRMABLE) {
+            avs_coap_ctx_send_empty(anjay->coap_ctx, get_request_socket(server),
+                                    AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                                    avs_coap_msg_get_id(msg));
+        }
+        return finish_request(anjay, server, 0, msg) ? -1 : 0;
+    }
+
+    return -1;
+}
+
+void _anjay_server_cancel_async_request(anjay_t *anjay,
+                                        anjay_active_server_info_t *server) {
+    if (server->pending_request) {
+        anjay_log(DEBUG, "canceling request pending for SSID %u",
+                  server->ssid);
+        request_delete(anjay, &server->pending_request);
+    }
+}
+
+#ifdef ANJAY_TEST
+#include "test/async_request.c"
+#endif
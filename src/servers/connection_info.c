@@ -75,6 +75,7 @@ _anjay_connection_internal_clean_socket(anjay_server_connection_t *connection) {
     avs_net_socket_cleanup(&connection->conn_priv_data_.socket);
     memset(&connection->conn_priv_data_, 0,
            sizeof(connection->conn_priv_data_));
+    _anjay_connection_rtt_reset(connection);
 }
 
 static anjay_binding_mode_t read_binding_mode(anjay_t *anjay,
@@ -22,6 +22,7 @@
 #define ANJAY_SERVERS_INTERNALS
 
 #include "connection_info.h"
+#include "servers_internal.h"
 
 VISIBILITY_SOURCE_BEGIN
 
@@ -39,9 +40,14 @@ static int enter_offline_job(anjay_t *anjay,
     (void) dummy;
     AVS_LIST(anjay_active_server_info_t) server;
     AVS_LIST_FOREACH(server, anjay->servers.active) {
+        _anjay_server_cancel_async_request(anjay, server);
         disable_connection(&server->udp_connection);
         _anjay_sched_del(anjay->sched, &server->sched_update_handle);
     }
+    // pending De-Register exchanges cannot be finished without the network
+    AVS_LIST_CLEAR(&anjay->servers.deregistering) {
+        _anjay_server_cleanup(anjay, anjay->servers.deregistering);
+    }
     _anjay_sched_del(anjay->sched, &anjay->reload_servers_sched_job_handle);
     anjay->offline = true;
     return 0;
@@ -119,10 +119,8 @@ static int send_update_sched_job(anjay_t *anjay, void *args) {
                     .conn_type = server->registration_info.conn_type
                 });
             }
-        } else {
-            // Updates are retryable, we only need to reschedule after success
-            result = _anjay_server_reschedule_update_job(anjay, server);
         }
+        // on success, next Update is scheduled once the exchange is finished
     }
     return result;
 }
@@ -171,6 +169,51 @@ schedule_next_update(anjay_t *anjay,
                            SOCKET_NEEDS_NOTHING);
 }
 
+static void update_finished(anjay_t *anjay,
+                            anjay_active_server_info_t *server,
+                            int result) {
+    anjay_connection_ref_t connection = {
+        .server = server,
+        .conn_type = server->registration_info.conn_type
+    };
+
+    if (result == ANJAY_REGISTRATION_UPDATE_REJECTED) {
+        anjay_log(DEBUG, "update rejected for SSID = %u; re-registering",
+                  server->ssid);
+        if (_anjay_server_register(anjay, server)) {
+            anjay_log(DEBUG, "re-registration failed");
+            // mark that the registration connection is no longer valid;
+            // prevents superfluous Deregister
+            server->registration_info.conn_type = ANJAY_CONNECTION_UNSET;
+            _anjay_server_on_registration_failure(anjay, server->ssid);
+        }
+        return;
+    } else if (result) {
+        anjay_log(ERROR, "could not update registration for SSID %u: %d",
+                  server->ssid, result);
+        if (result == AVS_COAP_CTX_ERR_NETWORK) {
+            // see comment in send_update_sched_job()
+            _anjay_connection_suspend(connection);
+        }
+        _anjay_sched_del(anjay->sched, &server->sched_update_handle);
+        if (schedule_update(anjay, &server->sched_update_handle, server,
+                            _anjay_server_next_retry_delay(
+                                    &server->registration_retry_delay),
+                            SOCKET_NEEDS_NOTHING)) {
+            anjay_log(ERROR, "could not schedule Update retry for SSID %u",
+                      server->ssid);
+        }
+        return;
+    }
+
+    server->registration_retry_delay = AVS_TIME_DURATION_ZERO;
+    if (!_anjay_bind_server_stream(anjay, connection)) {
+        _anjay_observe_sched_flush_current_connection(anjay);
+        _anjay_release_server_stream(anjay);
+    }
+    _anjay_server_reschedule_update_job(anjay, server);
+}
+
 static int
 send_update(anjay_t *anjay,
             anjay_active_server_info_t *server,
@@ -185,23 +228,13 @@ send_update(anjay_t *anjay,
         return -1;
     }
 
-    int result = _anjay_update_registration(anjay);
-    if (result == 0) {
-        _anjay_observe_sched_flush_current_connection(anjay);
+    int result = _anjay_update_registration(anjay, update_finished);
+    if (result) {
+        anjay_log(ERROR, "could not send registration update: %d", result);
     }
 
     avs_stream_reset(anjay->comm_stream);
     _anjay_release_server_stream(anjay);
-
-    if (result == ANJAY_REGISTRATION_UPDATE_REJECTED) {
-        anjay_log(DEBUG, "update rejected for SSID = %u; re-registering",
-                  server->ssid);
-        *out_attempted_operation = SERVER_REGISTRATION_RETRY;
-        result = _anjay_server_register(anjay, server);
-    } else if (result != 0) {
-        anjay_log(ERROR, "could not send registration update: %d", result);
-    }
-
     return result;
 }
 
@@ -230,6 +263,15 @@ int _anjay_server_update_or_reregister(
         anjay_t *anjay,
         anjay_active_server_info_t *server,
         server_registration_operation_t *out_attempted_operation) {
+    if (server->pending_request) {
+        // previous Register or Update is still in progress; it will schedule
+        // the next Update by itself, so just let the scheduler retry later
+        anjay_log(DEBUG, "registration exchange with SSID = %u already in "
+                  "progress", server->ssid);
+        *out_attempted_operation = SERVER_REGISTRATION_UPDATE;
+        return -1;
+    }
+
     *out_attempted_operation = SERVER_REGISTRATION_RETRY;
 
     if (_anjay_server_registration_connection_valid(server)) {
@@ -326,6 +368,35 @@ int _anjay_schedule_server_reconnect(anjay_t *anjay,
     return reschedule_update_for_server(anjay, server, SOCKET_NEEDS_RECONNECT);
 }
 
+static void registration_finished(anjay_t *anjay,
+                                  anjay_active_server_info_t *server,
+                                  int result) {
+    if (result) {
+        anjay_log(ERROR, "could not register to server SSID %u", server->ssid);
+        // mark that the registration connection is no longer valid;
+        // prevents superfluous Deregister
+        server->registration_info.conn_type = ANJAY_CONNECTION_UNSET;
+        _anjay_server_on_registration_failure(anjay, server->ssid);
+        return;
+    }
+
+    server->registration_retry_delay = AVS_TIME_DURATION_ZERO;
+    if (_anjay_server_reschedule_update_job(anjay, server)) {
+        anjay_log(WARNING, "could not schedule Update for server %u",
+                  server->ssid);
+    }
+
+    anjay_connection_ref_t connection = {
+        .server = server,
+        .conn_type = server->registration_info.conn_type
+    };
+    if (!_anjay_bind_server_stream(anjay, connection)) {
+        _anjay_observe_sched_flush_current_connection(anjay);
+        _anjay_bootstrap_notify_regular_connection_available(anjay);
+        _anjay_release_server_stream(anjay);
+    }
+}
+
 int _anjay_server_register(anjay_t *anjay,
                            anjay_active_server_info_t *server) {
     if (_anjay_server_setup_registration_connection(server)) {
@@ -339,25 +410,27 @@ int _anjay_server_register(anjay_t *anjay,
         return -1;
     }
 
-    int result = _anjay_register(anjay);
+    int result = _anjay_register(anjay, registration_finished);
     avs_stream_reset(anjay->comm_stream);
-
-    if (!result) {
-        _anjay_sched_del(anjay->sched, &server->sched_update_handle);
-        if (schedule_next_update(anjay, &server->sched_update_handle, server)) {
-            anjay_log(WARNING, "could not schedule Update for server %u",
-                      server->ssid);
-        }
-
-        _anjay_observe_sched_flush_current_connection(anjay);
-        _anjay_bootstrap_notify_regular_connection_available(anjay);
-    }
     _anjay_release_server_stream(anjay);
     return result;
 }
 
-int _anjay_server_deregister(anjay_t *anjay,
-                             anjay_active_server_info_t *server) {
+static void deregistration_finished(anjay_t *anjay,
+                                    anjay_active_server_info_t *server,
+                                    int result) {
+    (void) result;
+    AVS_LIST(anjay_active_server_info_t) *server_ptr =
+            AVS_LIST_FIND_PTR(&anjay->servers.deregistering, server);
+    if (server_ptr) {
+        _anjay_server_cleanup(anjay, *server_ptr);
+        AVS_LIST_DELETE(server_ptr);
+    }
+}
+
+static int deregister(anjay_t *anjay,
+                      anjay_active_server_info_t *server,
+                      bool wait_for_response) {
     anjay_connection_ref_t connection = {
         .server = server,
         .conn_type = server->registration_info.conn_type
@@ -369,7 +442,9 @@ int _anjay_server_deregister(anjay_t *anjay,
         return 0;
     }
 
-    int result = _anjay_deregister(anjay);
+    int result = wait_for_response
+            ? _anjay_deregister(anjay)
+            : _anjay_deregister_async(anjay, deregistration_finished);
     if (result) {
         anjay_log(ERROR, "could not send De-Register request: %d", result);
     }
@@ -378,3 +453,32 @@ int _anjay_server_deregister(anjay_t *anjay,
     _anjay_release_server_stream_without_scheduling_queue(anjay);
     return result;
 }
+
+void _anjay_server_deregister_and_delete(
+        anjay_t *anjay,
+        anjay_servers_t *servers,
+        AVS_LIST(anjay_active_server_info_t) *server_ptr) {
+    // a Register or Update still in progress is not interesting anymore
+    _anjay_server_cancel_async_request(anjay, *server_ptr);
+
+    // Return value intentionally ignored.
+    // There isn't much we can do in case it fails and De-Register is optional
+    // anyway. deregister() logs the error cause.
+    deregister(anjay, *server_ptr, false);
+
+    if (!(*server_ptr)->pending_request) {
+        _anjay_server_cleanup(anjay, *server_ptr);
+        AVS_LIST_DELETE(server_ptr);
+        return;
+    }
+
+    anjay_log(TRACE, "waiting for De-Register response from SSID %u",
+              (*server_ptr)->ssid);
+    _anjay_sched_del(anjay->sched, &(*server_ptr)->sched_update_handle);
+    AVS_LIST_INSERT(&servers->deregistering, AVS_LIST_DETACH(server_ptr));
+}
+
+int _anjay_server_deregister_sync(anjay_t *anjay,
+                                  anjay_active_server_info_t *server) {
+    return deregister(anjay, server, true);
+}
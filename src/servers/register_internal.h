@@ -46,8 +46,23 @@ int _anjay_server_update_or_reregister(
 int _anjay_server_reschedule_update_job(anjay_t *anjay,
                                         anjay_active_server_info_t *server);
 
-int _anjay_server_deregister(anjay_t *anjay,
-                             anjay_active_server_info_t *server);
+/**
+ * Sends De-Register to the server at @p server_ptr and removes it from the
+ * list. If the exchange is still pending, the server is moved to
+ * <c>servers->deregistering</c> , so that the request may be retransmitted,
+ * and deleted once it is finished. Otherwise it is deleted immediately.
+ */
+void _anjay_server_deregister_and_delete(
+        anjay_t *anjay,
+        anjay_servers_t *servers,
+        AVS_LIST(anjay_active_server_info_t) *server_ptr);
+
+/**
+ * Sends De-Register to @p server and waits for the response. Does not delete
+ * the server.
+ */
+int _anjay_server_deregister_sync(anjay_t *anjay,
+                                  anjay_active_server_info_t *server);
 
 VISIBILITY_PRIVATE_HEADER_END
 
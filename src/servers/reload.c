@@ -162,6 +162,8 @@ static int reload_servers_sched_job(anjay_t *anjay, void *unused) {
             _anjay_servers_add_active(&reloaded_servers,
                                       AVS_LIST_DETACH(&anjay->servers.active));
         }
+        _anjay_servers_deregister_removed(anjay, &anjay->servers,
+                                          &reloaded_servers);
         _anjay_servers_cleanup(anjay);
         anjay->servers = reloaded_servers;
         anjay_log(ERROR, "reloading servers failed, re-scheduling job");
@@ -173,6 +175,8 @@ static int reload_servers_sched_job(anjay_t *anjay, void *unused) {
             anjay_log(WARNING,
                       "Security object not present, no servers to create");
         }
+        _anjay_servers_deregister_removed(anjay, &anjay->servers,
+                                          &reloaded_servers);
         _anjay_servers_cleanup(anjay);
         anjay->servers = reloaded_servers;
     }
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <anjay/stats.h>
+
+#include "../anjay_core.h"
+#include "../servers.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+#ifdef WITH_RTT_ESTIMATION
+
+// avs_coap_tx_params_valid() rejects ACK_TIMEOUT shorter than 1 second,
+// following RFC 7252, 4.8.1
+#define RTO_MIN_US INT64_C(1000000)
+// upper bound suggested by RFC 6298, 2.5
+#define RTO_MAX_US INT64_C(60000000)
+
+// number of retransmissions above which the sample is too ambiguous to use
+#define WEAK_SAMPLE_MAX_RETRANSMISSIONS 2
+
+static int64_t abs_diff(int64_t a, int64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+/**
+ * Updates a single RTT estimator as specified in RFC 6298, 2.2-2.3, with
+ * alpha = 1/8 and beta = 1/4.
+ */
+static void update_estimator(int64_t *rtt_us,
+                             int64_t *rttvar_us,
+                             uint64_t *samples,
+                             int64_t sample_us) {
+    if (!*samples) {
+        *rtt_us = sample_us;
+        *rttvar_us = sample_us / 2;
+    } else {
+        *rttvar_us = (3 * *rttvar_us + abs_diff(*rtt_us, sample_us)) / 4;
+        *rtt_us = (7 * *rtt_us + sample_us) / 8;
+    }
+    ++*samples;
+}
+
+static int64_t clamp_rto(int64_t rto_us) {
+    if (rto_us < RTO_MIN_US) {
+        return RTO_MIN_US;
+    } else if (rto_us > RTO_MAX_US) {
+        return RTO_MAX_US;
+    }
+    return rto_us;
+}
+
+void _anjay_connection_rtt_sample(anjay_t *anjay,
+                                  anjay_server_connection_t *connection,
+                                  avs_time_duration_t rtt,
+                                  unsigned retransmissions) {
+    anjay_rtt_estimator_t *est = &connection->rtt;
+    int64_t sample_us;
+    if (retransmissions > WEAK_SAMPLE_MAX_RETRANSMISSIONS
+            || avs_time_duration_to_scalar(&sample_us, AVS_TIME_US, rtt)
+            || sample_us < 0) {
+        return;
+    }
+
+    if (!est->rto_us
+            && avs_time_duration_to_scalar(&est->rto_us, AVS_TIME_US,
+                                           anjay->udp_tx_params.ack_timeout)) {
+        est->rto_us = RTO_MIN_US;
+    }
+
+    if (retransmissions == 0) {
+        // strong estimator: K = 4, RTO = 0.5 * RTO_strong + 0.5 * RTO
+        update_estimator(&est->strong_rtt_us, &est->strong_rttvar_us,
+                         &est->strong_samples, sample_us);
+        const int64_t strong_rto_us =
+                est->strong_rtt_us + 4 * est->strong_rttvar_us;
+        est->rto_us = clamp_rto((strong_rto_us + est->rto_us) / 2);
+    } else {
+        // weak estimator: K = 1, RTO = 0.25 * RTO_weak + 0.75 * RTO
+        update_estimator(&est->weak_rtt_us, &est->weak_rttvar_us,
+                         &est->weak_samples, sample_us);
+        const int64_t weak_rto_us = est->weak_rtt_us + est->weak_rttvar_us;
+        est->rto_us = clamp_rto((weak_rto_us + 3 * est->rto_us) / 4);
+    }
+
+    anjay_log(TRACE, "RTT sample: %" PRId64 " us, %u retransmission(s); "
+              "RTO: %" PRId64 " us", sample_us, retransmissions, est->rto_us);
+}
+
+void _anjay_connection_rtt_apply(const anjay_server_connection_t *connection,
+                                 avs_coap_tx_params_t *inout_tx_params) {
+    if (connection->rtt.rto_us) {
+        inout_tx_params->ack_timeout =
+                avs_time_duration_from_scalar(connection->rtt.rto_us,
+                                              AVS_TIME_US);
+    }
+}
+
+void _anjay_connection_rtt_reset(anjay_server_connection_t *connection) {
+    memset(&connection->rtt, 0, sizeof(connection->rtt));
+}
+
+#endif // WITH_RTT_ESTIMATION
+
+int anjay_get_server_rtt_stats(anjay_t *anjay,
+                               anjay_ssid_t ssid,
+                               anjay_server_rtt_stats_t *out_stats) {
+#ifdef WITH_RTT_ESTIMATION
+    anjay_active_server_info_t *server =
+            _anjay_servers_find_active(&anjay->servers, ssid);
+    if (!server) {
+        anjay_log(ERROR, "no active server with SSID %u", ssid);
+        return -1;
+    }
+    const anjay_connection_ref_t ref = {
+        .server = server,
+        .conn_type = ANJAY_CONNECTION_UDP
+    };
+    const anjay_rtt_estimator_t *est = &_anjay_get_server_connection(ref)->rtt;
+    out_stats->strong_rtt =
+            avs_time_duration_from_scalar(est->strong_rtt_us, AVS_TIME_US);
+    out_stats->strong_rttvar =
+            avs_time_duration_from_scalar(est->strong_rttvar_us, AVS_TIME_US);
+    out_stats->strong_samples = est->strong_samples;
+    out_stats->weak_rtt =
+            avs_time_duration_from_scalar(est->weak_rtt_us, AVS_TIME_US);
+    out_stats->weak_rttvar =
+            avs_time_duration_from_scalar(est->weak_rttvar_us, AVS_TIME_US);
+    out_stats->weak_samples = est->weak_samples;
+    out_stats->ack_timeout = _anjay_connection_tx_params(anjay, ref).ack_timeout;
+    return 0;
+#else
+    (void) anjay;
+    (void) ssid;
+    (void) out_stats;
+    anjay_log(ERROR, "RTT estimation support disabled");
+    return -1;
+#endif
+}
+
+#ifdef ANJAY_TEST
+#include "test/rtt_estimator.c"
+#endif
@@ -45,6 +45,7 @@ static void connection_cleanup(anjay_t *anjay,
 void _anjay_server_cleanup(anjay_t *anjay, anjay_active_server_info_t *server) {
     anjay_log(TRACE, "clear_server SSID %u", server->ssid);
 
+    _anjay_server_cancel_async_request(anjay, server);
     _anjay_sched_del(anjay->sched, &server->sched_update_handle);
     _anjay_registration_info_cleanup(&server->registration_info);
     connection_cleanup(anjay, &server->udp_connection);
@@ -56,10 +57,30 @@ static void active_servers_delete_and_deregister(anjay_t *anjay) {
 
     AVS_LIST_CLEAR(&anjay->servers.active) {
         if (anjay->servers.active->ssid != ANJAY_SSID_BOOTSTRAP) {
-            _anjay_server_deregister(anjay, anjay->servers.active);
+            _anjay_server_cancel_async_request(anjay, anjay->servers.active);
+            _anjay_server_deregister_sync(anjay, anjay->servers.active);
         }
         _anjay_server_cleanup(anjay, anjay->servers.active);
     }
+    AVS_LIST_CLEAR(&anjay->servers.deregistering) {
+        _anjay_server_cleanup(anjay, anjay->servers.deregistering);
+    }
+}
+
+void _anjay_servers_deregister_removed(anjay_t *anjay,
+                                       anjay_servers_t *old_servers,
+                                       anjay_servers_t *new_servers) {
+    while (old_servers->active) {
+        if (old_servers->active->ssid == ANJAY_SSID_BOOTSTRAP) {
+            _anjay_server_cleanup(anjay, old_servers->active);
+            AVS_LIST_DELETE(&old_servers->active);
+        } else {
+            _anjay_server_deregister_and_delete(anjay, new_servers,
+                                                &old_servers->active);
+        }
+    }
+    AVS_LIST_APPEND(&new_servers->deregistering, old_servers->deregistering);
+    old_servers->deregistering = NULL;
 }
 
 void _anjay_servers_inactive_cleanup(anjay_t *anjay) {
@@ -127,6 +148,14 @@ AVS_LIST(avs_net_abstract_socket_t *const) anjay_get_sockets(anjay_t *anjay) {
             sms_active = true;
         }
     }
+    // De-Register responses still need to be received on these
+    AVS_LIST_FOREACH(server, anjay->servers.deregistering) {
+        avs_net_abstract_socket_t *udp_socket =
+                get_online_connection_socket(server, ANJAY_CONNECTION_UDP);
+        if (udp_socket && !add_socket_onto_list(tail_ptr, udp_socket)) {
+            tail_ptr = AVS_LIST_NEXT_PTR(tail_ptr);
+        }
+    }
 
     if (sms_active) {
         assert(_anjay_sms_router(anjay));
@@ -139,11 +168,11 @@ AVS_LIST(avs_net_abstract_socket_t *const) anjay_get_sockets(anjay_t *anjay) {
     return anjay->servers.public_sockets;
 }
 
-anjay_active_server_info_t *
-_anjay_servers_find_by_udp_socket(anjay_servers_t *servers,
-                                  avs_net_abstract_socket_t *socket) {
+static anjay_active_server_info_t *
+find_by_udp_socket(AVS_LIST(anjay_active_server_info_t) servers,
+                   avs_net_abstract_socket_t *socket) {
     AVS_LIST(anjay_active_server_info_t) it;
-    AVS_LIST_FOREACH(it, servers->active) {
+    AVS_LIST_FOREACH(it, servers) {
         if (_anjay_connection_internal_get_socket(&it->udp_connection)
                 == socket) {
             return it;
@@ -153,6 +182,17 @@ _anjay_servers_find_by_udp_socket(anjay_servers_t *servers,
     return NULL;
 }
 
+anjay_active_server_info_t *
+_anjay_servers_find_by_udp_socket(anjay_servers_t *servers,
+                                  avs_net_abstract_socket_t *socket) {
+    anjay_active_server_info_t *server =
+            find_by_udp_socket(servers->active, socket);
+    if (!server) {
+        server = find_by_udp_socket(servers->deregistering, socket);
+    }
+    return server;
+}
+
 static int deactivate_server_job(anjay_t *anjay,
                                  void *ssid_) {
     return _anjay_server_deactivate(anjay, &anjay->servers,
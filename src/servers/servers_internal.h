@@ -37,6 +37,16 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
         .max_delay = { 120, 0 } \
      })
 
+/**
+ * Returns the delay to wait before retrying a failed Register or Update, and
+ * advances @p inout_retry_delay so that consecutive failures are retried with
+ * an exponential backoff, as configured by ANJAY_SERVER_RETRYABLE_BACKOFF.
+ *
+ * @p inout_retry_delay equal to zero means that there were no failures yet.
+ */
+avs_time_duration_t
+_anjay_server_next_retry_delay(avs_time_duration_t *inout_retry_delay);
+
 /**
  * Cleans up server data. Does not send De-Register message.
  */
@@ -50,6 +60,15 @@ int _anjay_server_security_iid(anjay_t *anjay,
                                anjay_ssid_t ssid,
                                anjay_iid_t *out_iid);
 
+/**
+ * Sends De-Register to all servers left in the active list of @p old_servers ,
+ * and moves the ones whose De-Register exchange is pending, including those
+ * already in <c>old_servers->deregistering</c> , to @p new_servers .
+ */
+void _anjay_servers_deregister_removed(anjay_t *anjay,
+                                       anjay_servers_t *old_servers,
+                                       anjay_servers_t *new_servers);
+
 AVS_LIST(anjay_active_server_info_t) *
 _anjay_servers_find_active_insert_ptr(anjay_servers_t *servers,
                                       anjay_ssid_t ssid);
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <avsystem/commons/unit/test.h>
+
+#define S(Value) avs_time_duration_from_scalar((Value), AVS_TIME_S)
+
+#define ASSERT_DURATION_EQUAL(Actual, Expected) \
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal((Actual), (Expected)))
+
+AVS_UNIT_TEST(activate, retry_delay_backoff) {
+    avs_time_duration_t retry_delay = AVS_TIME_DURATION_ZERO;
+    ASSERT_DURATION_EQUAL(_anjay_server_next_retry_delay(&retry_delay), S(1));
+    ASSERT_DURATION_EQUAL(_anjay_server_next_retry_delay(&retry_delay), S(2));
+    ASSERT_DURATION_EQUAL(_anjay_server_next_retry_delay(&retry_delay), S(4));
+    for (int i = 0; i < 4; ++i) {
+        _anjay_server_next_retry_delay(&retry_delay);
+    }
+    ASSERT_DURATION_EQUAL(_anjay_server_next_retry_delay(&retry_delay),
+                          S(120));
+    ASSERT_DURATION_EQUAL(_anjay_server_next_retry_delay(&retry_delay),
+                          S(120));
+
+    // reset after a successful exchange
+    retry_delay = AVS_TIME_DURATION_ZERO;
+    ASSERT_DURATION_EQUAL(_anjay_server_next_retry_delay(&retry_delay), S(1));
+}
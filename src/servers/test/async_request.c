@@ -0,0 +1,308 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <avsystem/commons/unit/mocksock.h>
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay_test/dm.h>
+
+#include "../activate.h"
+
+typedef struct {
+    unsigned calls;
+    int result;
+    uint8_t code;
+    bool arg_freed;
+} response_log_t;
+
+static void log_response(anjay_t *anjay,
+                         anjay_active_server_info_t *server,
+                         const avs_coap_msg_t *response,
+                         int result,
+                         void *log_) {
+    (void) anjay;
+    AVS_UNIT_ASSERT_NULL(server->pending_request);
+    response_log_t *log = (response_log_t *) log_;
+    ++log->calls;
+    log->result = result;
+    log->code = response ? avs_coap_msg_get_code(response) : 0;
+}
+
+static void mark_arg_freed(void *log) {
+    ((response_log_t *) log)->arg_freed = true;
+}
+
+// CON POST, Message ID 0x69ED, no token
+static const char REQUEST[] = "\x40\x02\x69\xED";
+
+static void send_test_request(anjay_t *anjay,
+                              avs_net_abstract_socket_t *mocksock,
+                              response_log_t *log) {
+    // make retransmission timeouts deterministic: 2, 4, 8, 16, 32 s
+    anjay->udp_tx_params.ack_random_factor = 1.0;
+
+    const anjay_msg_details_t details = {
+        .msg_type = AVS_COAP_MSG_CONFIRMABLE,
+        .msg_code = AVS_COAP_CODE_POST,
+        .format = AVS_COAP_FORMAT_NONE
+    };
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_bind_server_stream(
+            anjay, (anjay_connection_ref_t) {
+                .server = anjay->servers.active,
+                .conn_type = ANJAY_CONNECTION_UDP
+            }));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_coap_stream_setup_request(
+            anjay->comm_stream, &details, NULL));
+    avs_unit_mocksock_expect_output(mocksock, REQUEST, sizeof(REQUEST) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_server_send_async_request(
+            anjay, log_response, log, mark_arg_freed));
+    avs_stream_reset(anjay->comm_stream);
+    _anjay_release_server_stream(anjay);
+    AVS_UNIT_ASSERT_NOT_NULL(anjay->servers.active->pending_request);
+}
+
+static int64_t time_to_next_ms(anjay_t *anjay) {
+    int delay_ms;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_time_to_next_ms(anjay, &delay_ms));
+    return delay_ms;
+}
+
+static void advance_and_run(anjay_t *anjay, int64_t delay_s) {
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(delay_s,
+                                                            AVS_TIME_S));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+}
+
+AVS_UNIT_TEST(async_request, piggybacked_response) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    static const char RESPONSE[] = "\x60\x44\x69\xED"; // ACK 2.04 Changed
+    avs_unit_mocksock_input(mocksocks[0], RESPONSE, sizeof(RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    // the handler is always called from a scheduler job
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 0);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(log.result, 0);
+    AVS_UNIT_ASSERT_EQUAL(log.code, AVS_COAP_CODE_CHANGED);
+    AVS_UNIT_ASSERT_TRUE(log.arg_freed);
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, retransmissions_and_timeout) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    int64_t timeout_s = 2;
+    for (int i = 0; i < 4; ++i) {
+        AVS_UNIT_ASSERT_EQUAL(time_to_next_ms(anjay), timeout_s * 1000);
+        // nothing happens before the timeout elapses
+        advance_and_run(anjay, timeout_s - 1);
+        avs_unit_mocksock_expect_output(mocksocks[0], REQUEST,
+                                        sizeof(REQUEST) - 1);
+        advance_and_run(anjay, 1);
+        avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+        timeout_s *= 2;
+    }
+
+    // MAX_RETRANSMIT reached - waiting for the last timeout and giving up
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_ms(anjay), timeout_s * 1000);
+    advance_and_run(anjay, timeout_s);
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(log.result, AVS_COAP_CTX_ERR_TIMEOUT);
+    AVS_UNIT_ASSERT_EQUAL(log.code, 0);
+    AVS_UNIT_ASSERT_TRUE(log.arg_freed);
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, separate_response) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    static const char EMPTY_ACK[] = "\x60\x00\x69\xED";
+    avs_unit_mocksock_input(mocksocks[0], EMPTY_ACK, sizeof(EMPTY_ACK) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 0);
+    // no more retransmissions - waiting for the Separate Response instead
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_ms(anjay), 30000);
+    advance_and_run(anjay, 10);
+
+    static const char SEPARATE_RESPONSE[] = "\x40\x44\x12\x34"; // CON 2.04
+    static const char SEPARATE_ACK[] = "\x60\x00\x12\x34";
+    avs_unit_mocksock_input(mocksocks[0], SEPARATE_RESPONSE,
+                            sizeof(SEPARATE_RESPONSE) - 1);
+    avs_unit_mocksock_expect_output(mocksocks[0], SEPARATE_ACK,
+                                    sizeof(SEPARATE_ACK) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(log.result, 0);
+    AVS_UNIT_ASSERT_EQUAL(log.code, AVS_COAP_CODE_CHANGED);
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, separate_response_timeout) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    static const char EMPTY_ACK[] = "\x60\x00\x69\xED";
+    avs_unit_mocksock_input(mocksocks[0], EMPTY_ACK, sizeof(EMPTY_ACK) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+
+    _anjay_mock_clock_advance(AVS_COAP_SEPARATE_RESPONSE_TIMEOUT);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(log.result, AVS_COAP_CTX_ERR_TIMEOUT);
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, reset) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    static const char RESET[] = "\x70\x00\x69\xED";
+    avs_unit_mocksock_input(mocksocks[0], RESET, sizeof(RESET) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 1);
+    AVS_UNIT_ASSERT_FAILED(log.result);
+    AVS_UNIT_ASSERT_EQUAL(log.code, 0);
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, mismatched_responses_ignored) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    // ACK with a different Message ID
+    static const char OTHER_ID[] = "\x60\x44\x69\xEE";
+    avs_unit_mocksock_input(mocksocks[0], OTHER_ID, sizeof(OTHER_ID) - 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_serve(anjay, mocksocks[0]));
+
+    // piggybacked response with a token that was not sent in the request
+    static const char OTHER_TOKEN[] = "\x61\x44\x69\xED" "t";
+    avs_unit_mocksock_input(mocksocks[0], OTHER_TOKEN, sizeof(OTHER_TOKEN) - 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_serve(anjay, mocksocks[0]));
+
+    // Separate Response with a token that was not sent in the request
+    static const char SEPARATE_OTHER_TOKEN[] = "\x41\x44\x12\x34" "t";
+    static const char SEPARATE_RESET[] = "\x70\x00\x12\x34";
+    avs_unit_mocksock_input(mocksocks[0], SEPARATE_OTHER_TOKEN,
+                            sizeof(SEPARATE_OTHER_TOKEN) - 1);
+    avs_unit_mocksock_expect_output(mocksocks[0], SEPARATE_RESET,
+                                    sizeof(SEPARATE_RESET) - 1);
+    AVS_UNIT_ASSERT_FAILED(anjay_serve(anjay, mocksocks[0]));
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 0);
+    AVS_UNIT_ASSERT_NOT_NULL(anjay->servers.active->pending_request);
+
+    // the matching response is still accepted
+    static const char RESPONSE[] = "\x60\x44\x69\xED";
+    avs_unit_mocksock_input(mocksocks[0], RESPONSE, sizeof(RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(log.result, 0);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, canceled_on_server_cleanup) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    AVS_LIST(anjay_active_server_info_t) server =
+            AVS_LIST_DETACH(&anjay->servers.active);
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+    _anjay_server_cleanup(anjay, server);
+    AVS_LIST_DELETE(&server);
+    AVS_UNIT_ASSERT_TRUE(log.arg_freed);
+
+    // neither retransmissions nor the handler are called afterwards
+    advance_and_run(anjay, 60);
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 0);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, canceled_when_going_offline) {
+    DM_TEST_INIT;
+    response_log_t log = { 0 };
+    send_test_request(anjay, mocksocks[0], &log);
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_enter_offline(anjay));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_TRUE(anjay_is_offline(anjay));
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active->pending_request);
+    AVS_UNIT_ASSERT_TRUE(log.arg_freed);
+
+    advance_and_run(anjay, 60);
+    AVS_UNIT_ASSERT_EQUAL(log.calls, 0);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(async_request, deregister_retransmitted) {
+    DM_TEST_INIT;
+    // make retransmission timeouts deterministic: 2, 4, 8, 16, 32 s
+    anjay->udp_tx_params.ack_random_factor = 1.0;
+
+    // CON DELETE, Message ID 0x69ED, no token
+    static const char DEREGISTER[] = "\x40\x04\x69\xED";
+    avs_unit_mocksock_expect_output(mocksocks[0], DEREGISTER,
+                                    sizeof(DEREGISTER) - 1);
+    AVS_UNIT_ASSERT_NOT_NULL(_anjay_server_deactivate(
+            anjay, &anjay->servers, 1,
+            avs_time_duration_from_scalar(3600, AVS_TIME_S)));
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+
+    // the server waits for the response outside of the active list
+    AVS_UNIT_ASSERT_NULL(anjay->servers.active);
+    AVS_UNIT_ASSERT_NOT_NULL(anjay->servers.deregistering);
+    AVS_LIST(avs_net_abstract_socket_t *const) sockets =
+            anjay_get_sockets(anjay);
+    AVS_UNIT_ASSERT_EQUAL(AVS_LIST_SIZE(sockets), 1);
+    AVS_UNIT_ASSERT_TRUE(*sockets == mocksocks[0]);
+
+    // the first De-Register got lost
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_ms(anjay), 2000);
+    avs_unit_mocksock_expect_output(mocksocks[0], DEREGISTER,
+                                    sizeof(DEREGISTER) - 1);
+    advance_and_run(anjay, 2);
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+
+    static const char RESPONSE[] = "\x60\x42\x69\xED"; // ACK 2.02 Deleted
+    avs_unit_mocksock_input(mocksocks[0], RESPONSE, sizeof(RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_NULL(anjay->servers.deregistering);
+    DM_TEST_FINISH;
+}
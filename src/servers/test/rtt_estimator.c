@@ -0,0 +1,96 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <avsystem/commons/unit/test.h>
+
+#ifdef WITH_RTT_ESTIMATION
+
+#define MS(Value) avs_time_duration_from_scalar((Value), AVS_TIME_MS)
+
+static anjay_t test_anjay(void) {
+    return (anjay_t) {
+        .udp_tx_params = ANJAY_COAP_DEFAULT_UDP_TX_PARAMS
+    };
+}
+
+AVS_UNIT_TEST(rtt_estimator, strong_samples) {
+    anjay_t anjay = test_anjay();
+    anjay_server_connection_t connection;
+    memset(&connection, 0, sizeof(connection));
+
+    _anjay_connection_rtt_sample(&anjay, &connection, MS(100), 0);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_samples, 1);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_rtt_us, 100000);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_rttvar_us, 50000);
+    // (100 ms + 4 * 50 ms + 2 s) / 2
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.rto_us, 1150000);
+
+    _anjay_connection_rtt_sample(&anjay, &connection, MS(100), 0);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_samples, 2);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_rttvar_us, 37500);
+    // (100 ms + 4 * 37.5 ms + 1.15 s) / 2 = 700 ms, clamped to 1 s
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.rto_us, 1000000);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.weak_samples, 0);
+}
+
+AVS_UNIT_TEST(rtt_estimator, weak_sample) {
+    anjay_t anjay = test_anjay();
+    anjay_server_connection_t connection;
+    memset(&connection, 0, sizeof(connection));
+
+    _anjay_connection_rtt_sample(&anjay, &connection, MS(6000), 1);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_samples, 0);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.weak_samples, 1);
+    // (6 s + 3 s + 3 * 2 s) / 4
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.rto_us, 3750000);
+
+    avs_coap_tx_params_t tx_params = anjay.udp_tx_params;
+    _anjay_connection_rtt_apply(&connection, &tx_params);
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(tx_params.ack_timeout,
+                                                 MS(3750)));
+    AVS_UNIT_ASSERT_EQUAL(tx_params.max_retransmit,
+                          anjay.udp_tx_params.max_retransmit);
+}
+
+AVS_UNIT_TEST(rtt_estimator, ambiguous_sample_ignored) {
+    anjay_t anjay = test_anjay();
+    anjay_server_connection_t connection;
+    memset(&connection, 0, sizeof(connection));
+
+    _anjay_connection_rtt_sample(&anjay, &connection, MS(6000), 3);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.weak_samples, 0);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.rto_us, 0);
+
+    avs_coap_tx_params_t tx_params = anjay.udp_tx_params;
+    _anjay_connection_rtt_apply(&connection, &tx_params);
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(
+            tx_params.ack_timeout, anjay.udp_tx_params.ack_timeout));
+}
+
+AVS_UNIT_TEST(rtt_estimator, rto_upper_bound) {
+    anjay_t anjay = test_anjay();
+    anjay_server_connection_t connection;
+    memset(&connection, 0, sizeof(connection));
+
+    _anjay_connection_rtt_sample(&anjay, &connection, MS(50000), 0);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.rto_us, 60000000);
+
+    _anjay_connection_rtt_reset(&connection);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.strong_samples, 0);
+    AVS_UNIT_ASSERT_EQUAL(connection.rtt.rto_us, 0);
+}
+
+#endif // WITH_RTT_ESTIMATION
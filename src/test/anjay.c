@@ -35,24 +35,31 @@ AVS_UNIT_GLOBAL_INIT(verbose) {
 #endif
 }
 
-#define TEST_NULLABLE_STRING_EQUAL(Actual, Expected) \
-    do { \
-        if (Expected != NULL) { \
-            AVS_UNIT_ASSERT_NOT_NULL((Actual)); \
-            AVS_UNIT_ASSERT_EQUAL_STRING((Actual), (Expected)); \
-        } else { \
-            AVS_UNIT_ASSERT_NULL((Actual)); \
-        } \
-    } while (0)
+static opt_string_t make_opt_string(const char *str) {
+    return (opt_string_t) {
+        .data = str,
+        .size = str ? strlen(str) : 0
+    };
+}
+
+static void assert_opt_string_equal(opt_string_t actual,
+                                    const char *expected) {
+    if (expected) {
+        AVS_UNIT_ASSERT_NOT_NULL(actual.data);
+        AVS_UNIT_ASSERT_EQUAL(actual.size, strlen(expected));
+        AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(actual.data, expected, actual.size);
+    } else {
+        AVS_UNIT_ASSERT_NULL(actual.data);
+    }
+}
 
 #define TEST_SPLIT_QUERY_STRING(QueryString, ExpectedKey, ExpectedValue) \
     do { \
-        char buf[] = QueryString; \
-        const char *key; \
-        const char *value; \
-        split_query_string(buf, &key, &value); \
-        TEST_NULLABLE_STRING_EQUAL(key, ExpectedKey); \
-        TEST_NULLABLE_STRING_EQUAL(value, ExpectedValue); \
+        opt_string_t key; \
+        opt_string_t value; \
+        split_query_string(make_opt_string(QueryString), &key, &value); \
+        assert_opt_string_equal(key, (ExpectedKey)); \
+        assert_opt_string_equal(value, (ExpectedValue)); \
     } while (0)
 
 AVS_UNIT_TEST(parse_headers, split_query_string) {
@@ -61,17 +68,18 @@ AVS_UNIT_TEST(parse_headers, split_query_string) {
     TEST_SPLIT_QUERY_STRING("key=", "key", "");
     TEST_SPLIT_QUERY_STRING("=value", "", "value");
     TEST_SPLIT_QUERY_STRING("key=value", "key", "value");
+    TEST_SPLIT_QUERY_STRING("key=a=b", "key", "a=b");
 }
 
 #undef TEST_SPLIT_QUERY_STRING
-#undef TEST_NULLABLE_STRING_EQUAL
 
 #define TEST_PARSE_ATTRIBUTE_SUCCESS(Key, Value, ExpectedField, \
                                      ExpectedHasField, ExpectedValue) \
     do { \
         anjay_request_attributes_t attrs; \
         memset(&attrs, 0, sizeof(attrs)); \
-        AVS_UNIT_ASSERT_SUCCESS(parse_attribute(&attrs, (Key), (Value))); \
+        AVS_UNIT_ASSERT_SUCCESS(parse_attribute( \
+                &attrs, make_opt_string(Key), make_opt_string(Value))); \
         AVS_UNIT_ASSERT_EQUAL(attrs.values.ExpectedField, (ExpectedValue)); \
         anjay_request_attributes_t expected; \
         memset(&expected, 0, sizeof(expected)); \
@@ -85,7 +93,8 @@ AVS_UNIT_TEST(parse_headers, split_query_string) {
     do { \
         anjay_request_attributes_t attrs; \
         memset(&attrs, 0, sizeof(attrs)); \
-        AVS_UNIT_ASSERT_FAILED(parse_attribute(&attrs, (Key), (Value))); \
+        AVS_UNIT_ASSERT_FAILED(parse_attribute( \
+                &attrs, make_opt_string(Key), make_opt_string(Value))); \
     } while (0);
 
 AVS_UNIT_TEST(parse_headers, parse_attribute) {
@@ -96,6 +105,7 @@ AVS_UNIT_TEST(parse_headers, parse_attribute) {
     TEST_PARSE_ATTRIBUTE_FAIL("pmin", "123.4");
     TEST_PARSE_ATTRIBUTE_FAIL("pmin", "woof");
     TEST_PARSE_ATTRIBUTE_FAIL("pmin", "");
+    TEST_PARSE_ATTRIBUTE_FAIL("pmin", "-1");
 
     TEST_PARSE_ATTRIBUTE_SUCCESS("pmax", "234", standard.common.max_period,
                                  has_max_period, 234);
@@ -438,6 +448,48 @@ AVS_UNIT_TEST(parse_headers, parse_observe) {
     AVS_UNIT_ASSERT_EQUAL(observe, ANJAY_COAP_OBSERVE_NONE);
 }
 
+AVS_UNIT_TEST(parse_headers, block_request_equality_validator) {
+    uint64_t fingerprint = request_fingerprint(
+            COAP_MSG(CON, PUT, ID(0), BLOCK1(0, 16, "0123456789abcdef0123"),
+                     PATH("1", "2"), QUERY("pmin=10")));
+
+    // subsequent block of the same request
+    AVS_UNIT_ASSERT_SUCCESS(block_request_equality_validator(
+            COAP_MSG(CON, PUT, ID(1), BLOCK1(1, 16, "0123456789abcdef0123"),
+                     PATH("1", "2"), QUERY("pmin=10")),
+            &fingerprint));
+
+    // different method
+    AVS_UNIT_ASSERT_FAILED(block_request_equality_validator(
+            COAP_MSG(CON, POST, ID(1), BLOCK1(1, 16, "0123456789abcdef0123"),
+                     PATH("1", "2"), QUERY("pmin=10")),
+            &fingerprint));
+
+    // different Uri-Path
+    AVS_UNIT_ASSERT_FAILED(block_request_equality_validator(
+            COAP_MSG(CON, PUT, ID(1), BLOCK1(1, 16, "0123456789abcdef0123"),
+                     PATH("1", "3"), QUERY("pmin=10")),
+            &fingerprint));
+
+    // segments split differently
+    AVS_UNIT_ASSERT_FAILED(block_request_equality_validator(
+            COAP_MSG(CON, PUT, ID(1), BLOCK1(1, 16, "0123456789abcdef0123"),
+                     PATH("12"), QUERY("pmin=10")),
+            &fingerprint));
+
+    // different Uri-Query
+    AVS_UNIT_ASSERT_FAILED(block_request_equality_validator(
+            COAP_MSG(CON, PUT, ID(1), BLOCK1(1, 16, "0123456789abcdef0123"),
+                     PATH("1", "2"), QUERY("pmin=20")),
+            &fingerprint));
+
+    // missing Uri-Query
+    AVS_UNIT_ASSERT_FAILED(block_request_equality_validator(
+            COAP_MSG(CON, PUT, ID(1), BLOCK1(1, 16, "0123456789abcdef0123"),
+                     PATH("1", "2")),
+            &fingerprint));
+}
+
 static time_t sched_time_to_next_s(anjay_sched_t *sched) {
     avs_time_duration_t sched_delay;
     AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_next(sched, &sched_delay));
@@ -693,8 +745,11 @@ AVS_UNIT_TEST(queue_mode, change) {
             "\xFF" "</1>,</42>";
     avs_unit_mocksock_expect_output(mocksocks[0], UPDATE, sizeof(UPDATE) - 1);
     static const char UPDATE_RESPONSE[] = "\x60\x44\x69\xED";
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    // the response is handled asynchronously, by anjay_serve()
     avs_unit_mocksock_input(mocksocks[0],
                             UPDATE_RESPONSE, sizeof(UPDATE_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
     AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
 
     AVS_UNIT_ASSERT_NOT_NULL(
@@ -710,6 +765,77 @@ AVS_UNIT_TEST(queue_mode, change) {
     DM_TEST_FINISH;
 }
 
+static void expect_read_request(anjay_t *anjay,
+                                avs_net_abstract_socket_t *mocksock,
+                                uint8_t msg_id_lsb) {
+    char request[] =
+            "\x40\x01\xFA\x00" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "69" // IID
+            "\x01" "4"; // RID
+    request[3] = (char) msg_id_lsb;
+    avs_unit_mocksock_input(mocksock, request, sizeof(request) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ, 69, 4, 1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ, 69, 4, 0,
+                                        ANJAY_MOCK_DM_INT(0, 514));
+    char response[] =
+            "\x60\x45\xFA\x00" // CoAP header
+            "\xc0" // Content-Format
+            "\xff" "514";
+    response[3] = (char) msg_id_lsb;
+    avs_unit_mocksock_expect_output(mocksock, response, sizeof(response) - 1);
+}
+
+static void assert_recv_timeout_restored(avs_net_abstract_socket_t *mocksock) {
+    avs_net_socket_opt_value_t opt;
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_get_opt(
+            mocksock, AVS_NET_SOCKET_OPT_RECV_TIMEOUT, &opt));
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(
+            opt.recv_timeout, avs_time_duration_from_scalar(1, AVS_TIME_S)));
+}
+
+AVS_UNIT_TEST(serve, max_messages_per_serve_limit) {
+    DM_TEST_INIT_WITH_CONFIG(.max_messages_per_serve = 3);
+    expect_read_request(anjay, mocksocks[0], 0x01);
+    expect_read_request(anjay, mocksocks[0], 0x02);
+    expect_read_request(anjay, mocksocks[0], 0x03);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+    assert_recv_timeout_restored(mocksocks[0]);
+
+    // the fourth message is left for the next call
+    expect_read_request(anjay, mocksocks[0], 0x04);
+    avs_unit_mocksock_input_fail(mocksocks[0], -1);
+    avs_unit_mocksock_expect_errno(mocksocks[0], ETIMEDOUT);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    assert_recv_timeout_restored(mocksocks[0]);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(serve, queued_messages_stop_on_timeout) {
+    DM_TEST_INIT_WITH_CONFIG(.max_messages_per_serve = 10);
+    expect_read_request(anjay, mocksocks[0], 0x01);
+    expect_read_request(anjay, mocksocks[0], 0x02);
+    avs_unit_mocksock_input_fail(mocksocks[0], -1);
+    avs_unit_mocksock_expect_errno(mocksocks[0], ETIMEDOUT);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    assert_recv_timeout_restored(mocksocks[0]);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(serve, queued_messages_stop_on_network_error) {
+    DM_TEST_INIT_WITH_CONFIG(.max_messages_per_serve = 10);
+    expect_read_request(anjay, mocksocks[0], 0x01);
+    expect_read_request(anjay, mocksocks[0], 0x02);
+    // no more receive attempts are expected after this one
+    avs_unit_mocksock_input_fail(mocksocks[0], -1);
+    avs_unit_mocksock_expect_errno(mocksocks[0], ECONNREFUSED);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    assert_recv_timeout_restored(mocksocks[0]);
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(anjay_new, no_endpoint_name) {
     const anjay_configuration_t configuration = {
         .endpoint_name = NULL,
@@ -192,6 +192,302 @@ AVS_UNIT_TEST(dm_read, instance_some) {
     DM_TEST_FINISH;
 }
 
+static int read_all_test_handler(anjay_t *anjay,
+                                 const anjay_dm_object_def_t *const *obj_ptr,
+                                 anjay_iid_t iid,
+                                 anjay_output_ctx_t *ctx) {
+    (void) anjay;
+    (void) obj_ptr;
+    AVS_UNIT_ASSERT_EQUAL(iid, 13);
+    int result = 0;
+    (void) ((result = anjay_ret_resource_id(ctx, 0))
+            || (result = anjay_ret_i32(ctx, 69))
+            || (result = anjay_ret_resource_id(ctx, 6))
+            || (result = anjay_ret_string(ctx, "Hello")));
+    return result;
+}
+
+static const anjay_dm_object_def_t *const OBJ_WITH_READ_ALL =
+        &(const anjay_dm_object_def_t) {
+            .oid = 42,
+            .supported_rids = ANJAY_DM_SUPPORTED_RIDS(0, 1, 2, 3, 4, 5, 6),
+            .handlers = {
+                ANJAY_MOCK_DM_HANDLERS,
+                .instance_read_all = read_all_test_handler
+            }
+        };
+
+AVS_UNIT_TEST(dm_read, instance_read_all) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_ALL, &FAKE_SECURITY);
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "13"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_ALL, 13, 1);
+    // no resource_present nor resource_read calls expected
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0],
+            "\x60\x45\xFA\x3E" // CoAP header
+            "\xc2\x2d\x16" // Content-Format
+            "\xff"
+            "\xc1\x00\x45"
+            "\xc5\x06" "Hello");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    DM_TEST_FINISH;
+}
+
+static const anjay_dm_module_t RESOURCE_PRESENT_OVERLAY;
+
+static int overlay_resource_present(anjay_t *anjay,
+                                    const anjay_dm_object_def_t *const *obj_ptr,
+                                    anjay_iid_t iid,
+                                    anjay_rid_t rid) {
+    ++*(unsigned *) _anjay_dm_module_get_arg(anjay,
+                                             &RESOURCE_PRESENT_OVERLAY);
+    return _anjay_dm_resource_present(anjay, obj_ptr, iid, rid,
+                                      &RESOURCE_PRESENT_OVERLAY);
+}
+
+static const anjay_dm_module_t RESOURCE_PRESENT_OVERLAY = {
+    .overlay_handlers = {
+        .resource_present = overlay_resource_present
+    }
+};
+
+AVS_UNIT_TEST(dm_read, instance_read_all_shadowed_by_overlay) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_ALL, &FAKE_SECURITY);
+    unsigned overlay_calls = 0;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_dm_module_install(
+            anjay, &RESOURCE_PRESENT_OVERLAY, &overlay_calls));
+    AVS_UNIT_ASSERT_FALSE(
+            _anjay_dm_instance_read_all_usable(anjay, &OBJ_WITH_READ_ALL,
+                                               NULL));
+
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "13"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_ALL, 13, 1);
+    // the overlay needs to see every Resource, so per-Resource reads are used
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_ALL, 13, 0,
+                                           1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ_WITH_READ_ALL, 13, 0, 0,
+                                        ANJAY_MOCK_DM_INT(0, 69));
+    for (anjay_rid_t i = 1; i < 6; ++i) {
+        _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_ALL, 13,
+                                               i, 0);
+    }
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_ALL, 13, 6,
+                                           1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ_WITH_READ_ALL, 13, 6, 0,
+                                        ANJAY_MOCK_DM_STRING(0, "Hello"));
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0],
+            "\x60\x45\xFA\x3E" // CoAP header
+            "\xc2\x2d\x16" // Content-Format
+            "\xff"
+            "\xc1\x00\x45"
+            "\xc5\x06" "Hello");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_EQUAL(overlay_calls, 7);
+
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_dm_module_uninstall(anjay, &RESOURCE_PRESENT_OVERLAY));
+    AVS_UNIT_ASSERT_TRUE(
+            _anjay_dm_instance_read_all_usable(anjay, &OBJ_WITH_READ_ALL,
+                                               NULL));
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_read, object_read_all) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_ALL, &FAKE_SECURITY);
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42"; // OID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ_WITH_READ_ALL, 0, 0, 13);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ_WITH_READ_ALL, 1, 0,
+                                      ANJAY_IID_INVALID);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0],
+            "\x60\x45\xFA\x3E" // CoAP header
+            "\xc2\x2d\x16" // Content-Format
+            "\xff"
+            "\x08\x0d\x0a"
+            "\xc1\x00\x45"
+            "\xc5\x06" "Hello");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_read, object_two_pass) {
+    DM_TEST_INIT_GENERIC((&OBJ_WITH_READ_ALL, &FAKE_SECURITY), (1),
+                         (.two_pass_tlv_object_reads = true));
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42"; // OID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ_WITH_READ_ALL, 0, 0, 13);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ_WITH_READ_ALL, 1, 0,
+                                      ANJAY_IID_INVALID);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0],
+            "\x60\x45\xFA\x3E" // CoAP header
+            "\xc2\x2d\x16" // Content-Format
+            "\xff"
+            "\x08\x0d\x0a"
+            "\xc1\x00\x45"
+            "\xc5\x06" "Hello");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    DM_TEST_FINISH;
+}
+
+#ifdef WITH_DM_STATS
+AVS_UNIT_TEST(dm_stats, handler_calls_accounted) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_ALL, &FAKE_SECURITY);
+    anjay_reset_dm_handler_stats(anjay);
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "13"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_ALL, 13, 1);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0],
+            "\x60\x45\xFA\x3E" // CoAP header
+            "\xc2\x2d\x16" // Content-Format
+            "\xff"
+            "\xc1\x00\x45"
+            "\xc5\x06" "Hello");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+
+    anjay_dm_handler_stats_t stats;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_dm_handler_stats(
+            anjay, 42, ANJAY_DM_HANDLER_INSTANCE_PRESENT, &stats));
+    AVS_UNIT_ASSERT_EQUAL(stats.call_count, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_dm_handler_stats(
+            anjay, 42, ANJAY_DM_HANDLER_INSTANCE_READ_ALL, &stats));
+    AVS_UNIT_ASSERT_EQUAL(stats.call_count, 1);
+    AVS_UNIT_ASSERT_FALSE(avs_time_duration_less(stats.total_time,
+                                                 stats.max_time));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_dm_handler_stats(
+            anjay, 42, ANJAY_DM_HANDLER_RESOURCE_READ, &stats));
+    AVS_UNIT_ASSERT_EQUAL(stats.call_count, 0);
+
+    anjay_reset_dm_handler_stats(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_dm_handler_stats(
+            anjay, 42, ANJAY_DM_HANDLER_INSTANCE_READ_ALL, &stats));
+    AVS_UNIT_ASSERT_EQUAL(stats.call_count, 0);
+    DM_TEST_FINISH;
+}
+#endif // WITH_DM_STATS
+
+static int instance_list_test_handler(anjay_t *anjay,
+                                      const anjay_dm_object_def_t *const *obj_ptr,
+                                      const anjay_iid_t **out_iids,
+                                      size_t *out_count) {
+    (void) anjay;
+    (void) obj_ptr;
+    static const anjay_iid_t IIDS[] = { 3, 7, 514 };
+    *out_iids = IIDS;
+    *out_count = AVS_ARRAY_SIZE(IIDS);
+    return 0;
+}
+
+static const anjay_dm_object_def_t *const OBJ_WITH_INSTANCE_LIST =
+        &(const anjay_dm_object_def_t) {
+            .oid = 42,
+            .supported_rids = ANJAY_DM_SUPPORTED_RIDS(0, 1, 2, 3, 4, 5, 6),
+            .handlers = {
+                ANJAY_MOCK_DM_HANDLERS,
+                .instance_list = instance_list_test_handler
+            }
+        };
+
+AVS_UNIT_TEST(dm_read, instance_list_present) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_INSTANCE_LIST, &FAKE_SECURITY);
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x01" "7"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    // no instance_present call expected
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_INSTANCE_LIST, 7,
+                                           0, 1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ_WITH_INSTANCE_LIST, 7, 0,
+                                        0, ANJAY_MOCK_DM_INT(0, 69));
+    for (anjay_rid_t i = 1; i <= 6; ++i) {
+        _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_INSTANCE_LIST,
+                                               7, i, 0);
+    }
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0],
+            "\x60\x45\xFA\x3E" // CoAP header
+            "\xc2\x2d\x16" // Content-Format
+            "\xff"
+            "\xc1\x00\x45");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_read, instance_list_not_present) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_INSTANCE_LIST, &FAKE_SECURITY);
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x01" "5"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\x84\xFA\x3E");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_instance_list, instance_it) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_INSTANCE_LIST, &FAKE_SECURITY);
+    static const anjay_iid_t EXPECTED[] = { 3, 7, 514, ANJAY_IID_INVALID };
+    void *cookie = NULL;
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(EXPECTED); ++i) {
+        anjay_iid_t iid;
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_dm_instance_it(
+                anjay, &OBJ_WITH_INSTANCE_LIST, &iid, &cookie, NULL));
+        AVS_UNIT_ASSERT_EQUAL(iid, EXPECTED[i]);
+    }
+    DM_TEST_FINISH;
+}
+
+#ifndef NDEBUG
+static int instance_list_unsorted_handler(
+        anjay_t *anjay,
+        const anjay_dm_object_def_t *const *obj_ptr,
+        const anjay_iid_t **out_iids,
+        size_t *out_count) {
+    (void) anjay;
+    (void) obj_ptr;
+    static const anjay_iid_t IIDS[] = { 3, 514, 7 };
+    *out_iids = IIDS;
+    *out_count = AVS_ARRAY_SIZE(IIDS);
+    return 0;
+}
+
+static const anjay_dm_object_def_t *const OBJ_WITH_UNSORTED_INSTANCE_LIST =
+        &(const anjay_dm_object_def_t) {
+            .oid = 42,
+            .supported_rids = ANJAY_DM_SUPPORTED_RIDS(0, 1, 2, 3, 4, 5, 6),
+            .handlers = {
+                ANJAY_MOCK_DM_HANDLERS,
+                .instance_list = instance_list_unsorted_handler
+            }
+        };
+
+AVS_UNIT_TEST(dm_instance_list, unsorted) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_UNSORTED_INSTANCE_LIST,
+                              &FAKE_SECURITY);
+    void *cookie = NULL;
+    anjay_iid_t iid;
+    AVS_UNIT_ASSERT_EQUAL(_anjay_dm_instance_it(anjay,
+                                                &OBJ_WITH_UNSORTED_INSTANCE_LIST,
+                                                &iid, &cookie, NULL),
+                          ANJAY_ERR_INTERNAL);
+    DM_TEST_FINISH;
+}
+#endif // NDEBUG
+
 AVS_UNIT_TEST(dm_read, instance_resource_doesnt_support_read) {
     DM_TEST_INIT;
     static const char REQUEST[] =
@@ -156,3 +156,78 @@ AVS_UNIT_TEST(input_array, example) {
 
     TEST_TEARDOWN;
 }
+
+typedef struct {
+    const char *data;
+    size_t calls;
+    size_t max_chunk;
+} reader_source_t;
+
+static int read_from_source(void *source_,
+                            size_t offset,
+                            void *buffer,
+                            size_t buffer_size) {
+    reader_source_t *source = (reader_source_t *) source_;
+    ++source->calls;
+    source->max_chunk = AVS_MAX(source->max_chunk, buffer_size);
+    memcpy(buffer, source->data + offset, buffer_size);
+    return 0;
+}
+
+typedef struct {
+    char data[3000];
+    size_t size;
+} captured_bytes_t;
+
+static int capture_bytes(void *captured_, const anjay_output_value_t *value) {
+    captured_bytes_t *captured = (captured_bytes_t *) captured_;
+    AVS_UNIT_ASSERT_EQUAL(value->type, ANJAY_OUTPUT_VALUE_BYTES);
+    AVS_UNIT_ASSERT_TRUE(value->value.bytes.size <= sizeof(captured->data));
+    memcpy(captured->data, value->value.bytes.data, value->value.bytes.size);
+    captured->size = value->value.bytes.size;
+    return 0;
+}
+
+AVS_UNIT_TEST(ret_bytes_from_reader, chunked) {
+    static char data[2500];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (char) i;
+    }
+    reader_source_t source = {
+        .data = data
+    };
+    captured_bytes_t captured = {
+        .size = 0
+    };
+    char buf[sizeof(data)];
+    anjay_output_value_ctx_t value_ctx =
+            _anjay_output_value_ctx_init(capture_bytes, &captured,
+                                         buf, sizeof(buf));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_ret_bytes_from_reader(
+            (anjay_output_ctx_t *) &value_ctx, sizeof(data),
+            read_from_source, &source));
+    AVS_UNIT_ASSERT_EQUAL(source.calls,
+                          (sizeof(data) + RET_BYTES_READER_CHUNK_SIZE - 1)
+                                  / RET_BYTES_READER_CHUNK_SIZE);
+    AVS_UNIT_ASSERT_EQUAL(source.max_chunk, RET_BYTES_READER_CHUNK_SIZE);
+    AVS_UNIT_ASSERT_EQUAL(captured.size, sizeof(data));
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(captured.data, data, sizeof(data));
+}
+
+static int failing_reader(void *arg,
+                          size_t offset,
+                          void *buffer,
+                          size_t buffer_size) {
+    (void) arg; (void) offset; (void) buffer; (void) buffer_size;
+    return ANJAY_ERR_INTERNAL;
+}
+
+AVS_UNIT_TEST(ret_bytes_from_reader, reader_error) {
+    char buf[16];
+    anjay_output_value_ctx_t value_ctx =
+            _anjay_output_value_ctx_init(capture_bytes, NULL, buf, sizeof(buf));
+    AVS_UNIT_ASSERT_EQUAL(anjay_ret_bytes_from_reader(
+                                  (anjay_output_ctx_t *) &value_ctx, 10,
+                                  failing_reader, NULL),
+                          ANJAY_ERR_INTERNAL);
+}
@@ -0,0 +1,780 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Benchmarks of Anjay running over an emulated UDP link (see
+ * anjay_test/coap/lossy_socket.h), with the LwM2M Server played by the code
+ * below. Time is virtual: the mock clock is advanced straight to the next
+ * event, so a benchmark takes as long as the CPU work it involves, and its
+ * results only depend on the link profile and seed.
+ *
+ * The client socket is injected by wrapping avs_net_socket_create() at link
+ * time (see CMakeLists.txt), so the whole client - Security and Server
+ * Objects, connection handling, Register - runs unmodified.
+ */
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include <avsystem/commons/coap/block_utils.h>
+#include <avsystem/commons/coap/ctx.h>
+#include <avsystem/commons/coap/msg.h>
+#include <avsystem/commons/coap/msg_builder.h>
+#include <avsystem/commons/coap/msg_info.h>
+#include <avsystem/commons/log.h>
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay/anjay.h>
+#include <anjay/security.h>
+#include <anjay/server.h>
+
+#include <anjay_test/coap/lossy_socket.h>
+#include <anjay_test/mock_clock.h>
+
+#include "../../src/anjay_core.h"
+#include "../../src/coap/content_format.h"
+#include "../../src/servers.h"
+
+#define MS(Ms) { (Ms) / 1000, (int32_t) (((Ms) % 1000) * 1000000) }
+
+#define BENCH_SSID 1
+#define BENCH_OID 1000
+#define BENCH_RID_COUNTER 0
+#define BENCH_RID_BLOB 1
+#define BENCH_BLOB_SIZE (32 * 1024)
+
+#define REGISTER_RUNS 20
+#define NOTIFY_COUNT 100
+
+// RFC 7252 defaults, minus randomization to keep runs reproducible
+#define SERVER_ACK_TIMEOUT_MS 2000
+#define SERVER_MAX_RETRANSMIT 4
+
+static const avs_coap_tx_params_t CLIENT_TX_PARAMS = {
+    .ack_timeout = MS(2000),
+    .ack_random_factor = 1.0,
+    .max_retransmit = 4
+};
+
+typedef struct {
+    const char *name;
+    anjay_lossy_link_config_t link;
+} link_profile_t;
+
+static const link_profile_t PROFILES[] = {
+    {
+        .name = "lan",
+        .link = {
+            .delay = MS(1),
+            .mtu = 1500
+        }
+    },
+    {
+        .name = "cellular",
+        .link = {
+            .delay = MS(100),
+            .jitter = MS(50),
+            .loss_percent = 2,
+            .reorder_percent = 2,
+            .reorder_delay = MS(100),
+            .mtu = 1280
+        }
+    },
+    {
+        .name = "lossy",
+        .link = {
+            .delay = MS(300),
+            .jitter = MS(200),
+            .loss_percent = 10,
+            .reorder_percent = 5,
+            .reorder_delay = MS(300),
+            .mtu = 576
+        }
+    }
+};
+
+typedef struct bench_env bench_env_t;
+
+typedef void server_response_handler_t(bench_env_t *env,
+                                       const avs_coap_msg_t *response);
+
+typedef union {
+    avs_max_align_t align;
+    uint8_t bytes[65536];
+} msg_buffer_t;
+
+/** The only request the Server has in flight, retransmitted until answered */
+typedef struct {
+    bool pending;
+    bool failed;
+    bool separate_ack_received;
+    avs_coap_msg_identity_t identity;
+    const avs_coap_msg_t *msg;
+    unsigned retry_count;
+    avs_time_monotonic_t retry_time;
+    server_response_handler_t *on_response;
+    msg_buffer_t buffer;
+} server_request_t;
+
+struct bench_env {
+    anjay_lossy_link_t *link;
+    anjay_t *anjay;
+    const anjay_dm_object_def_t **security_obj;
+    const anjay_dm_object_def_t **server_obj;
+
+    avs_coap_ctx_t *server_coap;
+    avs_net_abstract_socket_t *server_socket;
+    uint16_t next_msg_id;
+    uint32_t next_token;
+    server_request_t request;
+    uint64_t server_retransmissions;
+    msg_buffer_t in_buffer;
+    msg_buffer_t out_buffer;
+
+    int32_t counter;
+    avs_coap_token_t observe_token;
+    int32_t last_notified_value;
+    uint64_t notifications_received;
+
+    uint32_t block_size;
+    uint64_t blob_bytes_received;
+    uint64_t blob_blocks_received;
+    bool blob_finished;
+};
+
+static anjay_lossy_link_t *CURRENT_LINK;
+static bench_env_t *CURRENT_ENV;
+static uint8_t BLOB[BENCH_BLOB_SIZE];
+
+AVS_UNIT_GLOBAL_INIT(verbose) {
+#ifdef WITH_AVS_LOG
+    if (verbose < 2) {
+        avs_log_set_default_level(AVS_LOG_QUIET);
+    }
+#endif
+    for (size_t i = 0; i < sizeof(BLOB); ++i) {
+        BLOB[i] = (uint8_t) i;
+    }
+}
+
+int __real_avs_net_socket_create(avs_net_abstract_socket_t **socket,
+                                 avs_net_socket_type_t type,
+                                 const void *configuration);
+int __wrap_avs_net_socket_create(avs_net_abstract_socket_t **socket,
+                                 avs_net_socket_type_t type,
+                                 const void *configuration);
+
+int __wrap_avs_net_socket_create(avs_net_abstract_socket_t **socket,
+                                 avs_net_socket_type_t type,
+                                 const void *configuration) {
+    if (CURRENT_LINK && type == AVS_NET_UDP_SOCKET) {
+        *socket = _anjay_lossy_link_socket(CURRENT_LINK,
+                                           ANJAY_LOSSY_LINK_CLIENT);
+        return 0;
+    }
+    return __real_avs_net_socket_create(socket, type, configuration);
+}
+
+static int bench_resource_read(anjay_t *anjay,
+                               const anjay_dm_object_def_t *const *obj_ptr,
+                               anjay_iid_t iid,
+                               anjay_rid_t rid,
+                               anjay_output_ctx_t *ctx) {
+    (void) anjay; (void) obj_ptr; (void) iid;
+    switch (rid) {
+    case BENCH_RID_COUNTER:
+        return anjay_ret_i32(ctx, CURRENT_ENV->counter);
+    case BENCH_RID_BLOB:
+        return anjay_ret_bytes(ctx, BLOB, sizeof(BLOB));
+    default:
+        return ANJAY_ERR_NOT_FOUND;
+    }
+}
+
+static const anjay_dm_object_def_t BENCH_OBJECT_DEF = {
+    .oid = BENCH_OID,
+    .supported_rids = ANJAY_DM_SUPPORTED_RIDS(BENCH_RID_COUNTER,
+                                              BENCH_RID_BLOB),
+    .handlers = {
+        .instance_it = anjay_dm_instance_it_SINGLE,
+        .instance_present = anjay_dm_instance_present_SINGLE,
+        .resource_present = anjay_dm_resource_present_TRUE,
+        .resource_read = bench_resource_read
+    }
+};
+
+static const anjay_dm_object_def_t *const BENCH_OBJECT = &BENCH_OBJECT_DEF;
+
+static double to_seconds(avs_time_duration_t duration) {
+    return avs_time_duration_to_fscalar(duration, AVS_TIME_S);
+}
+
+static double elapsed_since(avs_time_monotonic_t start) {
+    return to_seconds(avs_time_monotonic_diff(avs_time_monotonic_now(), start));
+}
+
+/** @returns CPU time used by the process so far, in microseconds */
+static int64_t cpu_time_us(void) {
+    struct rusage usage;
+    AVS_UNIT_ASSERT_SUCCESS(getrusage(RUSAGE_SELF, &usage));
+    return (int64_t) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static avs_coap_aligned_msg_buffer_t *aligned(msg_buffer_t *buffer) {
+    return avs_coap_ensure_aligned_buffer(buffer->bytes);
+}
+
+/**** LwM2M Server ************************************************************/
+
+static void server_transmit(bench_env_t *env) {
+    // send errors, e.g. EMSGSIZE, count as a lost datagram
+    avs_coap_ctx_send(env->server_coap, env->server_socket, env->request.msg);
+    avs_time_duration_t timeout = avs_time_duration_mul(
+            avs_time_duration_from_scalar(SERVER_ACK_TIMEOUT_MS, AVS_TIME_MS),
+            (int32_t) (1 << env->request.retry_count));
+    env->request.retry_time =
+            avs_time_monotonic_add(avs_time_monotonic_now(), timeout);
+}
+
+static void server_send_request(bench_env_t *env,
+                                avs_coap_msg_info_t *info,
+                                server_response_handler_t *on_response) {
+    info->type = AVS_COAP_MSG_CONFIRMABLE;
+    info->identity.msg_id = env->next_msg_id++;
+    info->identity.token.size = sizeof(env->next_token);
+    memcpy(info->identity.token.bytes, &env->next_token,
+           sizeof(env->next_token));
+    ++env->next_token;
+
+    env->request.msg = avs_coap_msg_build_without_payload(
+            aligned(&env->request.buffer), sizeof(env->request.buffer), info);
+    AVS_UNIT_ASSERT_NOT_NULL(env->request.msg);
+    env->request.identity = info->identity;
+    env->request.pending = true;
+    env->request.failed = false;
+    env->request.separate_ack_received = false;
+    env->request.retry_count = 0;
+    env->request.on_response = on_response;
+    avs_coap_msg_info_reset(info);
+    server_transmit(env);
+}
+
+static void server_retransmit_if_needed(bench_env_t *env) {
+    if (!env->request.pending || env->request.separate_ack_received
+            || avs_time_monotonic_before(avs_time_monotonic_now(),
+                                         env->request.retry_time)) {
+        return;
+    }
+    if (env->request.retry_count >= SERVER_MAX_RETRANSMIT) {
+        env->request.pending = false;
+        env->request.failed = true;
+        return;
+    }
+    ++env->request.retry_count;
+    ++env->server_retransmissions;
+    server_transmit(env);
+}
+
+static void server_respond(bench_env_t *env,
+                           const avs_coap_msg_t *request,
+                           uint8_t code) {
+    avs_coap_msg_info_t info = avs_coap_msg_info_init();
+    info.type = AVS_COAP_MSG_ACKNOWLEDGEMENT;
+    info.code = code;
+    info.identity = avs_coap_msg_get_identity(request);
+    if (code == AVS_COAP_CODE_CREATED) {
+        AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+                &info, AVS_COAP_OPT_LOCATION_PATH, "rd"));
+        AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+                &info, AVS_COAP_OPT_LOCATION_PATH, "bench"));
+    }
+    const avs_coap_msg_t *response = avs_coap_msg_build_without_payload(
+            aligned(&env->out_buffer), sizeof(env->out_buffer), &info);
+    AVS_UNIT_ASSERT_NOT_NULL(response);
+    avs_coap_ctx_send(env->server_coap, env->server_socket, response);
+    avs_coap_msg_info_reset(&info);
+}
+
+/**
+ * Handles requests from the client. Register and Update are both answered
+ * with 2.01 Created, as the client does not care about the difference;
+ * anything else is acknowledged with 2.02 Deleted, i.e. Deregister succeeds.
+ */
+static void server_handle_client_request(bench_env_t *env,
+                                         const avs_coap_msg_t *request) {
+    if (avs_coap_msg_get_type(request) != AVS_COAP_MSG_CONFIRMABLE) {
+        return;
+    }
+    server_respond(env, request,
+                   avs_coap_msg_get_code(request) == AVS_COAP_CODE_POST
+                           ? AVS_COAP_CODE_CREATED
+                           : AVS_COAP_CODE_DELETED);
+}
+
+static int32_t parse_counter(const avs_coap_msg_t *msg) {
+    char buffer[16];
+    const size_t length = avs_coap_msg_payload_length(msg);
+    if (length >= sizeof(buffer)) {
+        return -1;
+    }
+    memcpy(buffer, avs_coap_msg_payload(msg), length);
+    buffer[length] = '\0';
+    return (int32_t) strtol(buffer, NULL, 10);
+}
+
+static void server_handle_msg(bench_env_t *env, const avs_coap_msg_t *msg) {
+    const avs_coap_msg_type_t type = avs_coap_msg_get_type(msg);
+    const uint8_t code = avs_coap_msg_get_code(msg);
+    const bool id_matches = env->request.pending
+            && avs_coap_msg_get_id(msg) == env->request.identity.msg_id;
+
+    if (avs_coap_msg_code_is_request(code)) {
+        server_handle_client_request(env, msg);
+        return;
+    }
+    if (type == AVS_COAP_MSG_RESET) {
+        if (id_matches) {
+            env->request.pending = false;
+            env->request.failed = true;
+        }
+        return;
+    }
+    if (code == AVS_COAP_CODE_EMPTY) {
+        if (type == AVS_COAP_MSG_ACKNOWLEDGEMENT && id_matches) {
+            env->request.separate_ack_received = true;
+        }
+        return;
+    }
+
+    if (type == AVS_COAP_MSG_CONFIRMABLE) {
+        avs_coap_ctx_send_empty(env->server_coap, env->server_socket,
+                                AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                                avs_coap_msg_get_id(msg));
+    }
+
+    const avs_coap_token_t token = avs_coap_msg_get_token(msg);
+    if (env->request.pending
+            && avs_coap_token_equal(&token, &env->request.identity.token)) {
+        env->request.pending = false;
+        if (env->request.on_response) {
+            env->request.on_response(env, msg);
+        }
+    } else if (type != AVS_COAP_MSG_ACKNOWLEDGEMENT
+            && code == AVS_COAP_CODE_CONTENT
+            && avs_coap_token_equal(&token, &env->observe_token)) {
+        env->last_notified_value = parse_counter(msg);
+        ++env->notifications_received;
+    }
+}
+
+static void server_poll(bench_env_t *env) {
+    avs_coap_msg_t *msg = (avs_coap_msg_t *) aligned(&env->in_buffer);
+    while (_anjay_lossy_link_readable(env->link, ANJAY_LOSSY_LINK_SERVER)) {
+        if (!avs_coap_ctx_recv(env->server_coap, env->server_socket, msg,
+                               sizeof(env->in_buffer))) {
+            server_handle_msg(env, msg);
+        }
+    }
+    server_retransmit_if_needed(env);
+}
+
+/**** Event loop **************************************************************/
+
+static avs_time_monotonic_t earlier(avs_time_monotonic_t a,
+                                    avs_time_monotonic_t b) {
+    return avs_time_monotonic_before(a, b) ? a : b;
+}
+
+static avs_time_monotonic_t next_event_time(bench_env_t *env,
+                                            avs_time_monotonic_t deadline) {
+    const avs_time_monotonic_t now = avs_time_monotonic_now();
+    avs_time_monotonic_t result = deadline;
+    avs_time_monotonic_t delivery_time;
+    avs_time_duration_t sched_delay;
+
+    if (!anjay_sched_time_to_next(env->anjay, &sched_delay)) {
+        result = earlier(result, avs_time_duration_less(sched_delay,
+                                                        AVS_TIME_DURATION_ZERO)
+                                         ? now
+                                         : avs_time_monotonic_add(now,
+                                                                  sched_delay));
+    }
+    if (!_anjay_lossy_link_next_delivery(env->link, &delivery_time)) {
+        result = earlier(result, delivery_time);
+    }
+    if (env->request.pending && !env->request.separate_ack_received) {
+        result = earlier(result, env->request.retry_time);
+    }
+    return result;
+}
+
+typedef bool bench_condition_t(bench_env_t *env);
+
+/**
+ * Runs both the client and the Server, advancing the mock clock from one event
+ * to another, until @p condition is met or @p timeout of virtual time passes.
+ *
+ * @returns true if @p condition was met.
+ */
+static bool run_until(bench_env_t *env,
+                      bench_condition_t *condition,
+                      avs_time_duration_t timeout) {
+    const avs_time_monotonic_t deadline =
+            avs_time_monotonic_add(avs_time_monotonic_now(), timeout);
+    avs_net_abstract_socket_t *const client_socket =
+            _anjay_lossy_link_socket(env->link, ANJAY_LOSSY_LINK_CLIENT);
+
+    while (!condition(env)) {
+        server_poll(env);
+        if (_anjay_lossy_link_readable(env->link, ANJAY_LOSSY_LINK_CLIENT)) {
+            anjay_serve(env->anjay, client_socket);
+        }
+        anjay_sched_run(env->anjay);
+        if (condition(env)) {
+            break;
+        }
+
+        const avs_time_monotonic_t now = avs_time_monotonic_now();
+        if (!avs_time_monotonic_before(now, deadline)) {
+            return false;
+        }
+        const avs_time_monotonic_t next = next_event_time(env, deadline);
+        if (avs_time_monotonic_before(now, next)) {
+            _anjay_mock_clock_advance(avs_time_monotonic_diff(next, now));
+        }
+    }
+    return true;
+}
+
+static bool is_registered(bench_env_t *env) {
+    anjay_active_server_info_t *server =
+            _anjay_servers_find_active(&env->anjay->servers, BENCH_SSID);
+    return server && server->registration_info.endpoint_path;
+}
+
+static bool request_finished(bench_env_t *env) {
+    return !env->request.pending;
+}
+
+static bool counter_notified(bench_env_t *env) {
+    return env->last_notified_value == env->counter;
+}
+
+static bool blob_finished(bench_env_t *env) {
+    return env->blob_finished || env->request.failed;
+}
+
+/**** Setup *******************************************************************/
+
+static bench_env_t *bench_setup(const link_profile_t *profile,
+                                uint32_t seed,
+                                bool confirmable_notifications) {
+    _anjay_mock_clock_start(avs_time_monotonic_from_scalar(1000, AVS_TIME_S));
+
+    bench_env_t *env = (bench_env_t *) calloc(1, sizeof(bench_env_t));
+    AVS_UNIT_ASSERT_NOT_NULL(env);
+    CURRENT_ENV = env;
+
+    anjay_lossy_link_config_t link_config = profile->link;
+    link_config.seed = seed;
+    AVS_UNIT_ASSERT_NOT_NULL((env->link = _anjay_lossy_link_create(&link_config)));
+    CURRENT_LINK = env->link;
+
+    env->server_socket =
+            _anjay_lossy_link_socket(env->link, ANJAY_LOSSY_LINK_SERVER);
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_connect(env->server_socket,
+                                                   "127.0.0.1", "56830"));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_ctx_create(&env->server_coap, 0));
+    env->next_msg_id = (uint16_t) seed;
+    env->last_notified_value = -1;
+
+    const anjay_configuration_t config = {
+        .endpoint_name = "urn:dev:os:anjay-benchmark",
+        .in_buffer_size = 4000,
+        .out_buffer_size = 4000,
+        .msg_cache_size = 4000,
+        .udp_tx_params = &CLIENT_TX_PARAMS,
+        .confirmable_notifications = confirmable_notifications
+    };
+    AVS_UNIT_ASSERT_NOT_NULL((env->anjay = anjay_new(&config)));
+
+    const anjay_security_instance_t security_instance = {
+        .ssid = BENCH_SSID,
+        .server_uri = "coap://127.0.0.1:5683",
+        .security_mode = ANJAY_UDP_SECURITY_NOSEC
+    };
+    const anjay_server_instance_t server_instance = {
+        .ssid = BENCH_SSID,
+        .lifetime = 86400,
+        .default_min_period = -1,
+        .default_max_period = -1,
+        .disable_timeout = -1,
+        .binding = ANJAY_BINDING_U
+    };
+    anjay_iid_t iid = ANJAY_IID_INVALID;
+    AVS_UNIT_ASSERT_NOT_NULL((env->security_obj = anjay_security_object_create()));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_security_object_add_instance(
+            env->security_obj, &security_instance, &iid));
+    iid = ANJAY_IID_INVALID;
+    AVS_UNIT_ASSERT_NOT_NULL((env->server_obj = anjay_server_object_create()));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_server_object_add_instance(
+            env->server_obj, &server_instance, &iid));
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(env->anjay,
+                                                  env->security_obj));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(env->anjay,
+                                                  env->server_obj));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(env->anjay, &BENCH_OBJECT));
+    return env;
+}
+
+static void bench_teardown(bench_env_t *env) {
+    anjay_delete(env->anjay);
+    anjay_security_object_delete(env->security_obj);
+    anjay_server_object_delete(env->server_obj);
+    avs_coap_ctx_cleanup(&env->server_coap);
+    CURRENT_LINK = NULL;
+    _anjay_lossy_link_delete(&env->link);
+    CURRENT_ENV = NULL;
+    free(env);
+    _anjay_mock_clock_finish();
+}
+
+static void bench_register(bench_env_t *env) {
+    AVS_UNIT_ASSERT_TRUE(run_until(env, is_registered,
+                                   avs_time_duration_from_scalar(
+                                           300, AVS_TIME_S)));
+}
+
+static void print_link_stats(bench_env_t *env) {
+    const anjay_lossy_link_stats_t client =
+            _anjay_lossy_link_stats(env->link, ANJAY_LOSSY_LINK_CLIENT);
+    const anjay_lossy_link_stats_t server =
+            _anjay_lossy_link_stats(env->link, ANJAY_LOSSY_LINK_SERVER);
+    printf("    client sent %" PRIu64 " (%" PRIu64 " lost, %" PRIu64
+           " oversized), server sent %" PRIu64 " (%" PRIu64 " lost, %" PRIu64
+           " retransmitted)\n",
+           client.sent, client.lost, client.oversized,
+           server.sent, server.lost, env->server_retransmissions);
+}
+
+/**** Benchmarks **************************************************************/
+
+AVS_UNIT_TEST(benchmark, register_latency) {
+    for (size_t p = 0; p < AVS_ARRAY_SIZE(PROFILES); ++p) {
+        double min_s = 0.0;
+        double max_s = 0.0;
+        double total_s = 0.0;
+        unsigned succeeded = 0;
+        uint64_t client_sent = 0;
+
+        for (uint32_t seed = 1; seed <= REGISTER_RUNS; ++seed) {
+            bench_env_t *env = bench_setup(&PROFILES[p], seed, false);
+            const avs_time_monotonic_t start = avs_time_monotonic_now();
+            if (run_until(env, is_registered,
+                          avs_time_duration_from_scalar(300, AVS_TIME_S))) {
+                const double latency_s = elapsed_since(start);
+                if (!succeeded || latency_s < min_s) {
+                    min_s = latency_s;
+                }
+                if (latency_s > max_s) {
+                    max_s = latency_s;
+                }
+                total_s += latency_s;
+                ++succeeded;
+            }
+            client_sent += _anjay_lossy_link_stats(
+                    env->link, ANJAY_LOSSY_LINK_CLIENT).sent;
+            bench_teardown(env);
+        }
+
+        printf("register %-10s %u/%u registered, latency min %.3f s, "
+               "avg %.3f s, max %.3f s, %.2f datagrams sent per run\n",
+               PROFILES[p].name, succeeded, REGISTER_RUNS, min_s,
+               succeeded ? total_s / succeeded : 0.0, max_s,
+               (double) client_sent / REGISTER_RUNS);
+    }
+}
+
+static void on_observe_response(bench_env_t *env,
+                                const avs_coap_msg_t *response) {
+    if (avs_coap_msg_get_code(response) == AVS_COAP_CODE_CONTENT) {
+        env->observe_token = avs_coap_msg_get_token(response);
+        env->last_notified_value = parse_counter(response);
+    }
+}
+
+static void send_observe(bench_env_t *env) {
+    char oid[8];
+    snprintf(oid, sizeof(oid), "%u", BENCH_OID);
+
+    avs_coap_msg_info_t info = avs_coap_msg_info_init();
+    info.code = AVS_COAP_CODE_GET;
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_u32(
+            &info, AVS_COAP_OPT_OBSERVE, 0));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+            &info, AVS_COAP_OPT_URI_PATH, oid));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+            &info, AVS_COAP_OPT_URI_PATH, "0"));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+            &info, AVS_COAP_OPT_URI_PATH, "0"));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_u16(
+            &info, AVS_COAP_OPT_ACCEPT, ANJAY_COAP_FORMAT_PLAINTEXT));
+    server_send_request(env, &info, on_observe_response);
+}
+
+static void bench_notify(bool confirmable) {
+    for (size_t p = 0; p < AVS_ARRAY_SIZE(PROFILES); ++p) {
+        bench_env_t *env = bench_setup(&PROFILES[p], 1, confirmable);
+        bench_register(env);
+        send_observe(env);
+        AVS_UNIT_ASSERT_TRUE(run_until(env, request_finished,
+                                       avs_time_duration_from_scalar(
+                                               300, AVS_TIME_S)));
+        AVS_UNIT_ASSERT_FALSE(env->request.failed);
+
+        const avs_time_monotonic_t start = avs_time_monotonic_now();
+        const int64_t start_cpu_us = cpu_time_us();
+        unsigned delivered = 0;
+        for (int32_t i = 1; i <= NOTIFY_COUNT; ++i) {
+            env->counter = i;
+            AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(
+                    env->anjay, BENCH_OID, 0, BENCH_RID_COUNTER));
+            // a lost Non-confirmable notification is never repeated
+            if (run_until(env, counter_notified,
+                          avs_time_duration_from_scalar(10, AVS_TIME_S))) {
+                ++delivered;
+            }
+        }
+        const double elapsed_s = elapsed_since(start);
+        const int64_t cpu_us = cpu_time_us() - start_cpu_us;
+
+        printf("notify   %-10s %s: %u/%u delivered in %.3f s (%.2f/s), "
+               "%.1f us CPU per notification\n",
+               PROFILES[p].name, confirmable ? "CON" : "NON", delivered,
+               NOTIFY_COUNT, elapsed_s,
+               elapsed_s > 0.0 ? delivered / elapsed_s : 0.0,
+               (double) cpu_us / NOTIFY_COUNT);
+        print_link_stats(env);
+        bench_teardown(env);
+    }
+}
+
+AVS_UNIT_TEST(benchmark, notify_throughput_non) {
+    bench_notify(false);
+}
+
+AVS_UNIT_TEST(benchmark, notify_throughput_con) {
+    bench_notify(true);
+}
+
+static void request_blob_block(bench_env_t *env, uint32_t seq_num);
+
+static void on_blob_response(bench_env_t *env,
+                             const avs_coap_msg_t *response) {
+    if (avs_coap_msg_get_code(response) != AVS_COAP_CODE_CONTENT) {
+        env->request.failed = true;
+        return;
+    }
+    env->blob_bytes_received += avs_coap_msg_payload_length(response);
+    ++env->blob_blocks_received;
+
+    avs_coap_block_info_t block2;
+    if (!avs_coap_get_block_info(response, AVS_COAP_BLOCK2, &block2)
+            && block2.valid && block2.has_more) {
+        env->block_size = block2.size;
+        request_blob_block(env, block2.seq_num + 1);
+    } else {
+        env->blob_finished = true;
+    }
+}
+
+static void request_blob_block(bench_env_t *env, uint32_t seq_num) {
+    char oid[8];
+    char rid[8];
+    snprintf(oid, sizeof(oid), "%u", BENCH_OID);
+    snprintf(rid, sizeof(rid), "%u", BENCH_RID_BLOB);
+
+    avs_coap_msg_info_t info = avs_coap_msg_info_init();
+    info.code = AVS_COAP_CODE_GET;
+    const avs_coap_block_info_t block2 = {
+        .type = AVS_COAP_BLOCK2,
+        .valid = true,
+        .seq_num = seq_num,
+        .size = (uint16_t) env->block_size,
+        .has_more = false
+    };
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+            &info, AVS_COAP_OPT_URI_PATH, oid));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+            &info, AVS_COAP_OPT_URI_PATH, "0"));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_string(
+            &info, AVS_COAP_OPT_URI_PATH, rid));
+    AVS_UNIT_ASSERT_SUCCESS(avs_coap_msg_info_opt_block(&info, &block2));
+    server_send_request(env, &info, on_blob_response);
+}
+
+/**
+ * @returns the largest block size that leaves room for CoAP headers in
+ *          a datagram of @p mtu bytes.
+ */
+static uint32_t block_size_for_mtu(int32_t mtu) {
+    // generous estimate of header and options size, Block2 included
+    static const int32_t HEADERS_SIZE = 64;
+    uint32_t size = AVS_COAP_MSG_BLOCK_MAX_SIZE;
+    while (size > AVS_COAP_MSG_BLOCK_MIN_SIZE
+            && (int32_t) size + HEADERS_SIZE > mtu) {
+        size /= 2;
+    }
+    return size;
+}
+
+AVS_UNIT_TEST(benchmark, block_goodput) {
+    for (size_t p = 0; p < AVS_ARRAY_SIZE(PROFILES); ++p) {
+        bench_env_t *env = bench_setup(&PROFILES[p], 1, false);
+        bench_register(env);
+
+        env->block_size = block_size_for_mtu(PROFILES[p].link.mtu);
+        const avs_time_monotonic_t start = avs_time_monotonic_now();
+        const int64_t start_cpu_us = cpu_time_us();
+        request_blob_block(env, 0);
+        run_until(env, blob_finished,
+                  avs_time_duration_from_scalar(3600, AVS_TIME_S));
+        const double elapsed_s = elapsed_since(start);
+        const int64_t cpu_us = cpu_time_us() - start_cpu_us;
+
+        printf("block    %-10s %s: %" PRIu64 " B in %" PRIu64 " blocks of %"
+               PRIu32 " B, %.3f s, goodput %.1f B/s, %.1f us CPU per block\n",
+               PROFILES[p].name, env->blob_finished ? "finished" : "FAILED",
+               env->blob_bytes_received, env->blob_blocks_received,
+               env->block_size, elapsed_s,
+               elapsed_s > 0.0
+                       ? (double) env->blob_bytes_received / elapsed_s
+                       : 0.0,
+               env->blob_blocks_received
+                       ? (double) cpu_us
+                                 / (double) env->blob_blocks_received
+                       : 0.0);
+        print_link_stats(env);
+        bench_teardown(env);
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_TEST_COAP_LOSSY_SOCKET_H
+#define ANJAY_TEST_COAP_LOSSY_SOCKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <avsystem/commons/net.h>
+#include <avsystem/commons/time.h>
+
+/**
+ * In-process emulation of a UDP link between two sockets, one for each
+ * endpoint. Datagrams sent through one socket become readable on the other one
+ * after a configurable delay, and may be dropped or reordered on the way.
+ *
+ * All timing uses avs_time_monotonic_now(), so the link is meant to be driven
+ * with a mock clock: receiving never blocks, and fails with ETIMEDOUT if no
+ * datagram is due yet. All random decisions come from a PRNG seeded with
+ * @ref anjay_lossy_link_config_t::seed , so the same seed and the same
+ * sequence of calls always produce the same sequence of link events.
+ */
+typedef struct anjay_lossy_link anjay_lossy_link_t;
+
+typedef struct {
+    /** Time each datagram spends in flight */
+    avs_time_duration_t delay;
+    /** Upper bound of a uniformly distributed extra delay of each datagram */
+    avs_time_duration_t jitter;
+    /** Probability of dropping a datagram, in percent */
+    unsigned loss_percent;
+    /** Probability of holding a datagram back by @ref reorder_delay , letting
+     * datagrams sent after it overtake it, in percent */
+    unsigned reorder_percent;
+    avs_time_duration_t reorder_delay;
+    /** Largest datagram accepted by send(); larger ones fail with EMSGSIZE.
+     * Also reported as both MTU and INNER_MTU socket options. If not positive,
+     * datagrams of any size are accepted and these options are unavailable. */
+    int32_t mtu;
+    /** Seed of the PRNG; 0 is treated as 1 */
+    uint32_t seed;
+} anjay_lossy_link_config_t;
+
+typedef enum {
+    ANJAY_LOSSY_LINK_CLIENT,
+    ANJAY_LOSSY_LINK_SERVER
+} anjay_lossy_link_side_t;
+
+/** Counters of datagrams sent by one side of the link */
+typedef struct {
+    uint64_t sent;
+    uint64_t lost;
+    uint64_t oversized;
+    uint64_t delivered;
+    uint64_t bytes_delivered;
+} anjay_lossy_link_stats_t;
+
+anjay_lossy_link_t *
+_anjay_lossy_link_create(const anjay_lossy_link_config_t *config);
+
+/**
+ * Frees the link along with both of its sockets. avs_net_socket_cleanup()
+ * called on a link socket only closes it, so that the link may outlive the
+ * code using the socket and vice versa.
+ */
+void _anjay_lossy_link_delete(anjay_lossy_link_t **link_ptr);
+
+avs_net_abstract_socket_t *
+_anjay_lossy_link_socket(anjay_lossy_link_t *link,
+                         anjay_lossy_link_side_t side);
+
+/**
+ * @returns true if a datagram is due to be received on given side, i.e.
+ *          if calling avs_net_socket_receive() on it would not time out.
+ */
+bool _anjay_lossy_link_readable(anjay_lossy_link_t *link,
+                                anjay_lossy_link_side_t side);
+
+/**
+ * Retrieves the time at which the earliest datagram in flight, in any
+ * direction, becomes due.
+ *
+ * @returns 0 on success, a negative value if no datagrams are in flight.
+ */
+int _anjay_lossy_link_next_delivery(anjay_lossy_link_t *link,
+                                    avs_time_monotonic_t *out_time);
+
+anjay_lossy_link_stats_t
+_anjay_lossy_link_stats(anjay_lossy_link_t *link,
+                        anjay_lossy_link_side_t sender);
+
+#endif /* ANJAY_TEST_COAP_LOSSY_SOCKET_H */
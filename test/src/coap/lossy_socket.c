@@ -0,0 +1,466 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avsystem/commons/list.h>
+#include <avsystem/commons/socket_v_table.h>
+
+#include <anjay_test/coap/lossy_socket.h>
+
+typedef struct {
+    avs_time_monotonic_t delivery_time;
+    size_t size;
+    uint8_t data[];
+} datagram_t;
+
+typedef struct {
+    const avs_net_socket_v_table_t *const vtable;
+    anjay_lossy_link_t *link;
+    anjay_lossy_link_side_t side;
+    avs_net_socket_state_t state;
+    avs_time_duration_t recv_timeout;
+    int error_code;
+    char remote_host[64];
+    char remote_port[8];
+    char local_port[8];
+    // sorted by delivery_time; datagrams due at the same time keep send order
+    AVS_LIST(datagram_t) inbox;
+    // datagrams sent from this endpoint
+    anjay_lossy_link_stats_t stats;
+} lossy_endpoint_t;
+
+struct anjay_lossy_link {
+    anjay_lossy_link_config_t config;
+    uint32_t rand_state;
+    lossy_endpoint_t endpoints[2];
+};
+
+/** xorshift32 - good enough for link emulation, and trivially reproducible */
+static uint32_t next_rand(anjay_lossy_link_t *link) {
+    uint32_t x = link->rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return link->rand_state = x;
+}
+
+static bool roll_percent(anjay_lossy_link_t *link, unsigned percent) {
+    return percent > 0 && next_rand(link) % 100 < percent;
+}
+
+static avs_time_duration_t random_jitter(anjay_lossy_link_t *link) {
+    int64_t jitter_us;
+    if (avs_time_duration_to_scalar(&jitter_us, AVS_TIME_US,
+                                    link->config.jitter)
+            || jitter_us <= 0) {
+        return AVS_TIME_DURATION_ZERO;
+    }
+    return avs_time_duration_from_scalar(
+            (int64_t) (next_rand(link) % (uint64_t) (jitter_us + 1)),
+            AVS_TIME_US);
+}
+
+static lossy_endpoint_t *get_endpoint(avs_net_abstract_socket_t *socket) {
+    return (lossy_endpoint_t *) socket;
+}
+
+static lossy_endpoint_t *get_peer(lossy_endpoint_t *endpoint) {
+    return &endpoint->link->endpoints[endpoint->side == ANJAY_LOSSY_LINK_CLIENT
+                                              ? ANJAY_LOSSY_LINK_SERVER
+                                              : ANJAY_LOSSY_LINK_CLIENT];
+}
+
+static int fail_with(lossy_endpoint_t *endpoint, int error_code) {
+    endpoint->error_code = error_code;
+    return -1;
+}
+
+static int copy_string(lossy_endpoint_t *endpoint,
+                       char *out_buffer,
+                       size_t out_buffer_size,
+                       const char *value) {
+    if (!*value) {
+        return fail_with(endpoint, ENOTCONN);
+    }
+    int result = snprintf(out_buffer, out_buffer_size, "%s", value);
+    if (result < 0 || (size_t) result >= out_buffer_size) {
+        return fail_with(endpoint, ERANGE);
+    }
+    return 0;
+}
+
+static void enqueue(lossy_endpoint_t *endpoint, AVS_LIST(datagram_t) datagram) {
+    AVS_LIST(datagram_t) *insert_ptr;
+    AVS_LIST_FOREACH_PTR(insert_ptr, &endpoint->inbox) {
+        if (avs_time_monotonic_before(datagram->delivery_time,
+                                      (*insert_ptr)->delivery_time)) {
+            break;
+        }
+    }
+    AVS_LIST_INSERT(insert_ptr, datagram);
+}
+
+static bool datagram_due(const datagram_t *datagram) {
+    return datagram && !avs_time_monotonic_before(avs_time_monotonic_now(),
+                                                  datagram->delivery_time);
+}
+
+static int lossy_connect(avs_net_abstract_socket_t *socket,
+                         const char *host,
+                         const char *port) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    if (!host || !port
+            || (size_t) snprintf(endpoint->remote_host,
+                                 sizeof(endpoint->remote_host), "%s", host)
+                   >= sizeof(endpoint->remote_host)
+            || (size_t) snprintf(endpoint->remote_port,
+                                 sizeof(endpoint->remote_port), "%s", port)
+                   >= sizeof(endpoint->remote_port)) {
+        endpoint->remote_host[0] = '\0';
+        endpoint->remote_port[0] = '\0';
+        return fail_with(endpoint, EINVAL);
+    }
+    endpoint->state = AVS_NET_SOCKET_STATE_CONNECTED;
+    endpoint->error_code = 0;
+    return 0;
+}
+
+static int lossy_bind(avs_net_abstract_socket_t *socket,
+                      const char *localaddr,
+                      const char *port) {
+    (void) localaddr;
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    if (port && *port) {
+        if ((size_t) snprintf(endpoint->local_port,
+                              sizeof(endpoint->local_port), "%s", port)
+                >= sizeof(endpoint->local_port)) {
+            return fail_with(endpoint, EINVAL);
+        }
+    }
+    endpoint->state = AVS_NET_SOCKET_STATE_BOUND;
+    endpoint->error_code = 0;
+    return 0;
+}
+
+static int lossy_send(avs_net_abstract_socket_t *socket,
+                      const void *buffer,
+                      size_t buffer_length) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    anjay_lossy_link_t *link = endpoint->link;
+    if (endpoint->state != AVS_NET_SOCKET_STATE_CONNECTED) {
+        return fail_with(endpoint, ENOTCONN);
+    }
+
+    ++endpoint->stats.sent;
+    if (link->config.mtu > 0 && buffer_length > (size_t) link->config.mtu) {
+        ++endpoint->stats.oversized;
+        return fail_with(endpoint, EMSGSIZE);
+    }
+    endpoint->error_code = 0;
+    if (roll_percent(link, link->config.loss_percent)) {
+        ++endpoint->stats.lost;
+        return 0;
+    }
+
+    AVS_LIST(datagram_t) datagram = (AVS_LIST(datagram_t))
+            AVS_LIST_NEW_BUFFER(sizeof(datagram_t) + buffer_length);
+    if (!datagram) {
+        return fail_with(endpoint, ENOMEM);
+    }
+    avs_time_duration_t delay =
+            avs_time_duration_add(link->config.delay, random_jitter(link));
+    if (roll_percent(link, link->config.reorder_percent)) {
+        delay = avs_time_duration_add(delay, link->config.reorder_delay);
+    }
+    datagram->delivery_time =
+            avs_time_monotonic_add(avs_time_monotonic_now(), delay);
+    datagram->size = buffer_length;
+    memcpy(datagram->data, buffer, buffer_length);
+    enqueue(get_peer(endpoint), datagram);
+    return 0;
+}
+
+static int lossy_receive(avs_net_abstract_socket_t *socket,
+                         size_t *out_bytes_received,
+                         void *buffer,
+                         size_t buffer_length) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    *out_bytes_received = 0;
+    if (endpoint->state != AVS_NET_SOCKET_STATE_CONNECTED
+            && endpoint->state != AVS_NET_SOCKET_STATE_BOUND) {
+        return fail_with(endpoint, ENOTCONN);
+    }
+    // there is no way to wait in virtual time, so recv_timeout is ignored
+    if (!datagram_due(endpoint->inbox)) {
+        return fail_with(endpoint, ETIMEDOUT);
+    }
+
+    AVS_LIST(datagram_t) datagram = AVS_LIST_DETACH(&endpoint->inbox);
+    lossy_endpoint_t *sender = get_peer(endpoint);
+    ++sender->stats.delivered;
+    sender->stats.bytes_delivered += datagram->size;
+
+    // like a real datagram socket, discard whatever does not fit
+    *out_bytes_received = datagram->size < buffer_length ? datagram->size
+                                                         : buffer_length;
+    memcpy(buffer, datagram->data, *out_bytes_received);
+    const bool truncated = (datagram->size > buffer_length);
+    AVS_LIST_DELETE(&datagram);
+    if (truncated) {
+        return fail_with(endpoint, EMSGSIZE);
+    }
+    endpoint->error_code = 0;
+    return 0;
+}
+
+static int lossy_close(avs_net_abstract_socket_t *socket) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    // datagrams queued for a closed socket would never reach it
+    AVS_LIST_CLEAR(&endpoint->inbox);
+    endpoint->state = AVS_NET_SOCKET_STATE_CLOSED;
+    endpoint->remote_host[0] = '\0';
+    endpoint->remote_port[0] = '\0';
+    return 0;
+}
+
+static int lossy_cleanup(avs_net_abstract_socket_t **socket) {
+    // the endpoint itself is owned by the link
+    lossy_close(*socket);
+    *socket = NULL;
+    return 0;
+}
+
+static const void *lossy_get_system_socket(avs_net_abstract_socket_t *socket) {
+    (void) socket;
+    return NULL;
+}
+
+static int lossy_get_remote_host(avs_net_abstract_socket_t *socket,
+                                 char *out_buffer,
+                                 size_t out_buffer_size) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    return copy_string(endpoint, out_buffer, out_buffer_size,
+                       endpoint->remote_host);
+}
+
+static int lossy_get_remote_port(avs_net_abstract_socket_t *socket,
+                                 char *out_buffer,
+                                 size_t out_buffer_size) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    return copy_string(endpoint, out_buffer, out_buffer_size,
+                       endpoint->remote_port);
+}
+
+static int lossy_get_local_port(avs_net_abstract_socket_t *socket,
+                                char *out_buffer,
+                                size_t out_buffer_size) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    return copy_string(endpoint, out_buffer, out_buffer_size,
+                       endpoint->local_port);
+}
+
+static int lossy_get_opt(avs_net_abstract_socket_t *socket,
+                         avs_net_socket_opt_key_t option_key,
+                         avs_net_socket_opt_value_t *out_option_value) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    switch (option_key) {
+    case AVS_NET_SOCKET_OPT_RECV_TIMEOUT:
+        out_option_value->recv_timeout = endpoint->recv_timeout;
+        return 0;
+    case AVS_NET_SOCKET_OPT_STATE:
+        out_option_value->state = endpoint->state;
+        return 0;
+    case AVS_NET_SOCKET_OPT_MTU:
+    case AVS_NET_SOCKET_OPT_INNER_MTU:
+        if (endpoint->link->config.mtu > 0) {
+            out_option_value->mtu = endpoint->link->config.mtu;
+            return 0;
+        }
+        break;
+    default:
+        break;
+    }
+    return fail_with(endpoint, EINVAL);
+}
+
+static int lossy_set_opt(avs_net_abstract_socket_t *socket,
+                         avs_net_socket_opt_key_t option_key,
+                         avs_net_socket_opt_value_t option_value) {
+    lossy_endpoint_t *endpoint = get_endpoint(socket);
+    if (option_key == AVS_NET_SOCKET_OPT_RECV_TIMEOUT) {
+        endpoint->recv_timeout = option_value.recv_timeout;
+        return 0;
+    }
+    return fail_with(endpoint, EINVAL);
+}
+
+static int lossy_get_errno(avs_net_abstract_socket_t *socket) {
+    return get_endpoint(socket)->error_code;
+}
+
+static int lossy_decorate(avs_net_abstract_socket_t *socket,
+                          avs_net_abstract_socket_t *backend_socket) {
+    (void) backend_socket;
+    return fail_with(get_endpoint(socket), ENOTSUP);
+}
+
+static int lossy_send_to(avs_net_abstract_socket_t *socket,
+                         const void *buffer,
+                         size_t buffer_length,
+                         const char *host,
+                         const char *port) {
+    (void) buffer; (void) buffer_length; (void) host; (void) port;
+    return fail_with(get_endpoint(socket), ENOTSUP);
+}
+
+static int lossy_receive_from(avs_net_abstract_socket_t *socket,
+                              size_t *out_bytes_received,
+                              void *buffer,
+                              size_t buffer_length,
+                              char *host,
+                              size_t host_size,
+                              char *port,
+                              size_t port_size) {
+    (void) buffer; (void) buffer_length;
+    (void) host; (void) host_size; (void) port; (void) port_size;
+    *out_bytes_received = 0;
+    return fail_with(get_endpoint(socket), ENOTSUP);
+}
+
+static int lossy_accept(avs_net_abstract_socket_t *server_socket,
+                        avs_net_abstract_socket_t *new_socket) {
+    (void) new_socket;
+    return fail_with(get_endpoint(server_socket), ENOTSUP);
+}
+
+static int lossy_shutdown(avs_net_abstract_socket_t *socket) {
+    return fail_with(get_endpoint(socket), ENOTSUP);
+}
+
+static int lossy_get_interface(avs_net_abstract_socket_t *socket,
+                               avs_net_socket_interface_name_t *if_name) {
+    (void) if_name;
+    return fail_with(get_endpoint(socket), ENOTSUP);
+}
+
+static const avs_net_socket_v_table_t LOSSY_SOCKET_VTABLE = {
+    .connect = lossy_connect,
+    .decorate = lossy_decorate,
+    .send = lossy_send,
+    .send_to = lossy_send_to,
+    .receive = lossy_receive,
+    .receive_from = lossy_receive_from,
+    .bind = lossy_bind,
+    .accept = lossy_accept,
+    .close = lossy_close,
+    .shutdown = lossy_shutdown,
+    .cleanup = lossy_cleanup,
+    .get_system_socket = lossy_get_system_socket,
+    .get_interface_name = lossy_get_interface,
+    .get_remote_host = lossy_get_remote_host,
+    .get_remote_hostname = lossy_get_remote_host,
+    .get_remote_port = lossy_get_remote_port,
+    .get_local_port = lossy_get_local_port,
+    .get_opt = lossy_get_opt,
+    .set_opt = lossy_set_opt,
+    .get_errno = lossy_get_errno
+};
+
+static void init_endpoint(anjay_lossy_link_t *link,
+                          anjay_lossy_link_side_t side,
+                          const char *local_port) {
+    lossy_endpoint_t endpoint = {
+        .vtable = &LOSSY_SOCKET_VTABLE,
+        .link = link,
+        .side = side,
+        .state = AVS_NET_SOCKET_STATE_CLOSED,
+        .recv_timeout = AVS_TIME_DURATION_ZERO
+    };
+    snprintf(endpoint.local_port, sizeof(endpoint.local_port), "%s",
+             local_port);
+    // vtable is const, so the endpoint cannot be simply assigned
+    memcpy(&link->endpoints[side], &endpoint, sizeof(endpoint));
+}
+
+anjay_lossy_link_t *
+_anjay_lossy_link_create(const anjay_lossy_link_config_t *config) {
+    anjay_lossy_link_t *link =
+            (anjay_lossy_link_t *) calloc(1, sizeof(anjay_lossy_link_t));
+    if (!link) {
+        return NULL;
+    }
+    link->config = *config;
+    link->rand_state = config->seed ? config->seed : 1;
+    init_endpoint(link, ANJAY_LOSSY_LINK_CLIENT, "56830");
+    init_endpoint(link, ANJAY_LOSSY_LINK_SERVER, "5683");
+    return link;
+}
+
+void _anjay_lossy_link_delete(anjay_lossy_link_t **link_ptr) {
+    if (link_ptr && *link_ptr) {
+        AVS_LIST_CLEAR(&(*link_ptr)->endpoints[ANJAY_LOSSY_LINK_CLIENT].inbox);
+        AVS_LIST_CLEAR(&(*link_ptr)->endpoints[ANJAY_LOSSY_LINK_SERVER].inbox);
+        free(*link_ptr);
+        *link_ptr = NULL;
+    }
+}
+
+avs_net_abstract_socket_t *
+_anjay_lossy_link_socket(anjay_lossy_link_t *link,
+                         anjay_lossy_link_side_t side) {
+    return (avs_net_abstract_socket_t *) &link->endpoints[side];
+}
+
+bool _anjay_lossy_link_readable(anjay_lossy_link_t *link,
+                                anjay_lossy_link_side_t side) {
+    return datagram_due(link->endpoints[side].inbox);
+}
+
+int _anjay_lossy_link_next_delivery(anjay_lossy_link_t *link,
+                                    avs_time_monotonic_t *out_time) {
+    const datagram_t *client_next =
+            link->endpoints[ANJAY_LOSSY_LINK_CLIENT].inbox;
+    const datagram_t *server_next =
+            link->endpoints[ANJAY_LOSSY_LINK_SERVER].inbox;
+    if (!client_next && !server_next) {
+        return -1;
+    }
+    if (!server_next
+            || (client_next
+                && avs_time_monotonic_before(client_next->delivery_time,
+                                             server_next->delivery_time))) {
+        *out_time = client_next->delivery_time;
+    } else {
+        *out_time = server_next->delivery_time;
+    }
+    return 0;
+}
+
+anjay_lossy_link_stats_t
+_anjay_lossy_link_stats(anjay_lossy_link_t *link,
+                        anjay_lossy_link_side_t sender) {
+    return link->endpoints[sender].stats;
+}
+
+#ifdef ANJAY_TEST
+#include "test/lossy_socket.c"
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay_test/mock_clock.h>
+
+typedef struct {
+    anjay_lossy_link_t *link;
+    avs_net_abstract_socket_t *client;
+    avs_net_abstract_socket_t *server;
+} link_env_t;
+
+static link_env_t link_setup(const anjay_lossy_link_config_t *config) {
+    _anjay_mock_clock_start(avs_time_monotonic_from_scalar(1000, AVS_TIME_S));
+    link_env_t env;
+    AVS_UNIT_ASSERT_NOT_NULL((env.link = _anjay_lossy_link_create(config)));
+    env.client = _anjay_lossy_link_socket(env.link, ANJAY_LOSSY_LINK_CLIENT);
+    env.server = _anjay_lossy_link_socket(env.link, ANJAY_LOSSY_LINK_SERVER);
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_connect(env.client, "server",
+                                                   "5683"));
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_connect(env.server, "client",
+                                                   "56830"));
+    return env;
+}
+
+static void link_teardown(link_env_t *env) {
+    _anjay_lossy_link_delete(&env->link);
+    _anjay_mock_clock_finish();
+}
+
+static void assert_nothing_received(avs_net_abstract_socket_t *socket) {
+    uint8_t buffer[16];
+    size_t bytes_received;
+    AVS_UNIT_ASSERT_FAILED(avs_net_socket_receive(socket, &bytes_received,
+                                                  buffer, sizeof(buffer)));
+    AVS_UNIT_ASSERT_EQUAL(avs_net_socket_errno(socket), ETIMEDOUT);
+}
+
+static uint32_t receive_u32(avs_net_abstract_socket_t *socket) {
+    uint32_t value;
+    size_t bytes_received;
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_receive(socket, &bytes_received,
+                                                   &value, sizeof(value)));
+    AVS_UNIT_ASSERT_EQUAL(bytes_received, sizeof(value));
+    return value;
+}
+
+AVS_UNIT_TEST(lossy_socket, delivery_after_delay) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .delay = avs_time_duration_from_scalar(100, AVS_TIME_MS)
+    });
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.client, "hello", 5));
+
+    avs_time_monotonic_t delivery_time;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_lossy_link_next_delivery(env.link, &delivery_time));
+    AVS_UNIT_ASSERT_FALSE(
+            _anjay_lossy_link_readable(env.link, ANJAY_LOSSY_LINK_SERVER));
+    assert_nothing_received(env.server);
+
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(100, AVS_TIME_MS));
+    AVS_UNIT_ASSERT_FALSE(avs_time_monotonic_before(avs_time_monotonic_now(),
+                                                    delivery_time));
+    AVS_UNIT_ASSERT_TRUE(
+            _anjay_lossy_link_readable(env.link, ANJAY_LOSSY_LINK_SERVER));
+    AVS_UNIT_ASSERT_FALSE(
+            _anjay_lossy_link_readable(env.link, ANJAY_LOSSY_LINK_CLIENT));
+
+    char buffer[16];
+    size_t bytes_received;
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_receive(env.server, &bytes_received,
+                                                   buffer, sizeof(buffer)));
+    AVS_UNIT_ASSERT_EQUAL(bytes_received, 5);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buffer, "hello", 5);
+    AVS_UNIT_ASSERT_FAILED(
+            _anjay_lossy_link_next_delivery(env.link, &delivery_time));
+
+    anjay_lossy_link_stats_t stats =
+            _anjay_lossy_link_stats(env.link, ANJAY_LOSSY_LINK_CLIENT);
+    AVS_UNIT_ASSERT_EQUAL(stats.sent, 1);
+    AVS_UNIT_ASSERT_EQUAL(stats.lost, 0);
+    AVS_UNIT_ASSERT_EQUAL(stats.delivered, 1);
+    AVS_UNIT_ASSERT_EQUAL(stats.bytes_delivered, 5);
+    link_teardown(&env);
+}
+
+AVS_UNIT_TEST(lossy_socket, jitter_bounds) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .delay = avs_time_duration_from_scalar(10, AVS_TIME_MS),
+        .jitter = avs_time_duration_from_scalar(5, AVS_TIME_MS)
+    });
+    for (uint32_t i = 0; i < 10; ++i) {
+        AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.client, &i,
+                                                    sizeof(i)));
+    }
+    // nothing arrives before the base delay...
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(9, AVS_TIME_MS));
+    assert_nothing_received(env.server);
+
+    // ...and everything arrives once the maximum jitter has passed as well
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(7, AVS_TIME_MS));
+    for (uint32_t i = 0; i < 10; ++i) {
+        receive_u32(env.server);
+    }
+    assert_nothing_received(env.server);
+    link_teardown(&env);
+}
+
+static uint64_t count_lost(uint32_t seed) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .loss_percent = 30,
+        .seed = seed
+    });
+    for (uint32_t i = 0; i < 1000; ++i) {
+        AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.client, &i,
+                                                    sizeof(i)));
+    }
+    uint32_t received = 0;
+    uint32_t last_value = 0;
+    while (_anjay_lossy_link_readable(env.link, ANJAY_LOSSY_LINK_SERVER)) {
+        uint32_t value = receive_u32(env.server);
+        // without reordering, survivors keep their order
+        AVS_UNIT_ASSERT_TRUE(received == 0 || value > last_value);
+        last_value = value;
+        ++received;
+    }
+
+    anjay_lossy_link_stats_t stats =
+            _anjay_lossy_link_stats(env.link, ANJAY_LOSSY_LINK_CLIENT);
+    AVS_UNIT_ASSERT_EQUAL(stats.sent, 1000);
+    AVS_UNIT_ASSERT_EQUAL(stats.delivered, received);
+    AVS_UNIT_ASSERT_EQUAL(stats.lost + stats.delivered, stats.sent);
+    link_teardown(&env);
+    return stats.lost;
+}
+
+AVS_UNIT_TEST(lossy_socket, loss) {
+    uint64_t lost = count_lost(42);
+    AVS_UNIT_ASSERT_TRUE(lost > 200 && lost < 400);
+    // the same seed yields the same link behavior
+    AVS_UNIT_ASSERT_EQUAL(count_lost(42), lost);
+}
+
+AVS_UNIT_TEST(lossy_socket, total_loss) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .loss_percent = 100
+    });
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.client, "hello", 5));
+    avs_time_monotonic_t delivery_time;
+    AVS_UNIT_ASSERT_FAILED(
+            _anjay_lossy_link_next_delivery(env.link, &delivery_time));
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_S));
+    assert_nothing_received(env.server);
+    AVS_UNIT_ASSERT_EQUAL(
+            _anjay_lossy_link_stats(env.link, ANJAY_LOSSY_LINK_CLIENT).lost, 1);
+    link_teardown(&env);
+}
+
+AVS_UNIT_TEST(lossy_socket, reordering) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .delay = avs_time_duration_from_scalar(10, AVS_TIME_MS),
+        .reorder_percent = 50,
+        .reorder_delay = avs_time_duration_from_scalar(50, AVS_TIME_MS),
+        .seed = 42
+    });
+    for (uint32_t i = 0; i < 20; ++i) {
+        AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.server, &i,
+                                                    sizeof(i)));
+    }
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_S));
+
+    bool seen[20] = { false };
+    bool overtaken = false;
+    uint32_t last_value = 0;
+    for (uint32_t i = 0; i < 20; ++i) {
+        uint32_t value = receive_u32(env.client);
+        AVS_UNIT_ASSERT_TRUE(value < 20);
+        AVS_UNIT_ASSERT_FALSE(seen[value]);
+        seen[value] = true;
+        if (i > 0 && value < last_value) {
+            overtaken = true;
+        }
+        last_value = value;
+    }
+    AVS_UNIT_ASSERT_TRUE(overtaken);
+    assert_nothing_received(env.client);
+    link_teardown(&env);
+}
+
+AVS_UNIT_TEST(lossy_socket, mtu) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .mtu = 8
+    });
+    avs_net_socket_opt_value_t opt;
+    AVS_UNIT_ASSERT_SUCCESS(
+            avs_net_socket_get_opt(env.client, AVS_NET_SOCKET_OPT_MTU, &opt));
+    AVS_UNIT_ASSERT_EQUAL(opt.mtu, 8);
+
+    AVS_UNIT_ASSERT_FAILED(avs_net_socket_send(env.client, "123456789", 9));
+    AVS_UNIT_ASSERT_EQUAL(avs_net_socket_errno(env.client), EMSGSIZE);
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.client, "12345678", 8));
+
+    // a datagram that does not fit in the receive buffer is truncated
+    char buffer[4];
+    size_t bytes_received;
+    AVS_UNIT_ASSERT_FAILED(avs_net_socket_receive(env.server, &bytes_received,
+                                                  buffer, sizeof(buffer)));
+    AVS_UNIT_ASSERT_EQUAL(avs_net_socket_errno(env.server), EMSGSIZE);
+    AVS_UNIT_ASSERT_EQUAL(bytes_received, sizeof(buffer));
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buffer, "1234", sizeof(buffer));
+    assert_nothing_received(env.server);
+
+    anjay_lossy_link_stats_t stats =
+            _anjay_lossy_link_stats(env.link, ANJAY_LOSSY_LINK_CLIENT);
+    AVS_UNIT_ASSERT_EQUAL(stats.sent, 2);
+    AVS_UNIT_ASSERT_EQUAL(stats.oversized, 1);
+    AVS_UNIT_ASSERT_EQUAL(stats.delivered, 1);
+    link_teardown(&env);
+}
+
+AVS_UNIT_TEST(lossy_socket, close_discards_datagrams_in_flight) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .delay = avs_time_duration_from_scalar(10, AVS_TIME_MS)
+    });
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_send(env.client, "hello", 5));
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_close(env.server));
+    avs_time_monotonic_t delivery_time;
+    AVS_UNIT_ASSERT_FAILED(
+            _anjay_lossy_link_next_delivery(env.link, &delivery_time));
+
+    AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_connect(env.server, "client",
+                                                   "56830"));
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_S));
+    assert_nothing_received(env.server);
+    link_teardown(&env);
+}
+
+AVS_UNIT_TEST(lossy_socket, unsupported_operations) {
+    link_env_t env = link_setup(&(const anjay_lossy_link_config_t) {
+        .delay = AVS_TIME_DURATION_ZERO
+    });
+    AVS_UNIT_ASSERT_FAILED(
+            avs_net_socket_send_to(env.client, "hello", 5, "server", "5683"));
+    AVS_UNIT_ASSERT_EQUAL(avs_net_socket_errno(env.client), ENOTSUP);
+
+    char buffer[16];
+    char host[16];
+    char port[8];
+    size_t bytes_received;
+    AVS_UNIT_ASSERT_FAILED(avs_net_socket_receive_from(
+            env.client, &bytes_received, buffer, sizeof(buffer),
+            host, sizeof(host), port, sizeof(port)));
+    AVS_UNIT_ASSERT_EQUAL(avs_net_socket_errno(env.client), ENOTSUP);
+
+    AVS_UNIT_ASSERT_FAILED(avs_net_socket_shutdown(env.client));
+    AVS_UNIT_ASSERT_EQUAL(avs_net_socket_errno(env.client), ENOTSUP);
+    link_teardown(&env);
+}